@@ -1036,6 +1036,8 @@ CCanvas::scales_type_e CCanvas::getScalesType() { return map->getScalesType(); }
 
 qreal CCanvas::getElevationAt(const QPointF& pos) const { return dem->getElevationAt(pos); }
 
+void CCanvas::getOnlineMaps(QList<QPointer<IMapOnline>>& maps) const { map->getOnlineMaps(maps); }
+
 void CCanvas::getElevationAt(const QPolygonF& pos, QPolygonF& ele) const { return dem->getElevationAt(pos, ele); }
 
 qreal CCanvas::getSlopeAt(const QPointF& pos) const { return dem->getSlopeAt(pos); }
@@ -1143,20 +1145,88 @@ bool CCanvas::setDrawContextSize(const QSize& s) {
   return done;
 }
 
+QList<QRect> CCanvas::getPrintTiles(const QSize& area, qint32 tileSize) {
+  QList<QRect> tiles;
+  if (area.isEmpty() || tileSize <= 0) {
+    return tiles;
+  }
+
+  const QSize sizeTile(qMin(tileSize, area.width()), qMin(tileSize, area.height()));
+  for (qint32 y = 0; y < area.height(); y += sizeTile.height()) {
+    for (qint32 x = 0; x < area.width(); x += sizeTile.width()) {
+      tiles << QRect(QPoint(x, y), sizeTile);
+    }
+  }
+  return tiles;
+}
+
 void CCanvas::print(QPainter& p, const QRectF& area, const QPointF& focus, bool printScale) {
+  const QSize sizeArea(area.size().toSize());
+  const QList<QRect>& tiles = getPrintTiles(sizeArea);
+  if (tiles.isEmpty()) {
+    return;
+  }
+
+  const QSize oldSize = size();
+  setDrawContextSize(tiles.first().size());
+
+  const QRect rectArea(QPoint(0, 0), sizeArea);
+  for (const QRect& tile : tiles) {
+    p.save();
+    // the tiles of the last row and column exceed the area
+    p.setClipRect(tile.intersected(rectArea), p.hasClipping() ? Qt::IntersectClip : Qt::ReplaceClip);
+    p.translate(tile.topLeft());
+    printTile(p, tile, sizeArea, focus, printScale);
+    p.restore();
+  }
+
+  setDrawContextSize(oldSize);
+}
+
+bool CCanvas::printTiles(const QSize& area, const QPointF& focus, bool printScale, const fPrintTile& sink) {
+  const QList<QRect>& tiles = getPrintTiles(area);
+  if (tiles.isEmpty()) {
+    return true;
+  }
+
   const QSize oldSize = size();
-  const QSize newSize(area.size().toSize());
+  setDrawContextSize(tiles.first().size());
+
+  bool success = true;
+  for (const QRect& tile : tiles) {
+    // a new image for each tile, the sink might still use the last one
+    QImage image(tile.size(), QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+
+    QPainter p(&image);
+    USE_ANTI_ALIASING(p, true);
+    printTile(p, tile, area, focus, printScale);
+    p.end();
 
-  setDrawContextSize(newSize);
+    if (!sink(image, tile.topLeft())) {
+      success = false;
+      break;
+    }
+  }
+
+  setDrawContextSize(oldSize);
+  return success;
+}
+
+void CCanvas::printTile(QPainter& p, const QRect& tile, const QSize& area, const QPointF& focus, bool printScale) {
+  // the tile's point of focus is its center
+  QPointF focusTile = focus;
+  map->offsetPx(focusTile, QRectF(tile).center() - QPointF(area.width(), area.height()) / 2);
 
   // ----- start to draw thread based content -----
-  // move coordinate system to center of the screen
-  p.translate(newSize.width() >> 1, newSize.height() >> 1);
+  p.save();
+  // move coordinate system to center of the tile
+  p.translate(tile.width() >> 1, tile.height() >> 1);
 
   redraw_e redraw = eRedrawAll;
 
   for (IDrawContext* context : qAsConst(allDrawContext)) {
-    context->draw(p, redraw, focus);
+    context->draw(p, redraw, focusTile);
   }
 
   for (IDrawContext* context : qAsConst(allDrawContext)) {
@@ -1164,23 +1234,22 @@ void CCanvas::print(QPainter& p, const QRectF& area, const QPointF& focus, bool
   }
 
   for (IDrawContext* context : qAsConst(allDrawContext)) {
-    context->draw(p, redraw, focus);
+    context->draw(p, redraw, focusTile);
   }
 
-  // restore coordinate system to default
-  p.resetTransform();
+  // restore coordinate system to the tile's top left corner
+  p.restore();
   // ----- start to draw fast content -----
 
-  QRect r(QPoint(0, 0), area.size().toSize());
+  const QRect r(QPoint(0, 0), tile.size());
 
   grid->draw(p, r);
   gis->draw(p, r);
   rt->draw(p, r);
   if (printScale) {
-    drawScale(p, r);
+    // the scale is placed relative to the area, anything outside the tile is clipped
+    drawScale(p, QRect(-tile.topLeft(), area));
   }
-
-  setDrawContextSize(oldSize);
 }
 
 bool CCanvas::event(QEvent* event) {
@@ -24,11 +24,15 @@
 #include <QPainter>
 #include <QPointer>
 #include <QWidget>
+#include <functional>
 
 #include "gis/IGisItem.h"
 
+using fPrintTile = std::function<bool(const QImage& tile, const QPoint& pos)>;
+
 class IDrawContext;
 class CMapDraw;
+class IMapOnline;
 class CGrid;
 class CDemDraw;
 class CPoiDraw;
@@ -86,6 +90,9 @@ class CCanvas : public QWidget {
   void getElevationAt(const QPolygonF& pos, QPolygonF& ele) const;
   void getElevationAt(SGisLine& line) const;
 
+  /// get all active maps of this canvas that request their tiles from a server
+  void getOnlineMaps(QList<QPointer<IMapOnline>>& maps) const;
+
   qreal getSlopeAt(const QPointF& pos) const;
   void getSlopeAt(const QPolygonF& pos, QPolygonF& slope) const;
 
@@ -163,8 +170,53 @@ class CCanvas : public QWidget {
    */
   bool findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qint32 threshold, QPolygonF& polyline);
 
+  /// the maximum width and height of the tiles drawn by print() and printTiles() [px]
+  static constexpr qint32 kPrintTileSize = 2048;
+
+  /**
+     @brief Split an area into tiles of equal size, row by row
+
+     The tiles of the last row and column exceed the area if its size is not a multiple of the tile size.
+
+     @param area          the size of the area in [px]
+     @param tileSize      the maximum width and height of a tile in [px]
+     @return The tiles in coordinates of the area.
+   */
+  static QList<QRect> getPrintTiles(const QSize& area, qint32 tileSize = kPrintTileSize);
+
+  /**
+     @brief Print an area of the canvas to a painter
+
+     The area is drawn tile by tile. Thus the draw context buffers are limited to the tile size
+     instead of the size of the area.
+
+     @param p             the painter to draw on, the area's top left corner is its origin
+     @param area          the area in [px]
+     @param focus         the point of focus in [rad] drawn in the middle of the area
+     @param printScale    set true to draw the scale in the bottom right corner of the area
+   */
   void print(QPainter& p, const QRectF& area, const QPointF& focus, bool printScale = true);
 
+  /**
+     @brief Print an area of the canvas into tiles of separate images
+
+     Other than print() this does not need a painter on a target holding the whole area.
+     Each tile is passed to the sink as soon as it is drawn. The sink must not keep the
+     image longer than needed. Thus memory does not depend on the size of the area.
+
+     The tiles are drawn one after the other, as all of them use the draw contexts and
+     map objects of this canvas. Only the layers of a tile are drawn in parallel by their
+     draw context threads. The sink can process a tile while the next one is drawn.
+
+     @param area          the size of the area in [px]
+     @param focus         the point of focus in [rad] drawn in the middle of the area
+     @param printScale    set true to draw the scale in the bottom right corner of the area
+     @param sink          called with each tile and its top left corner in the area. Return
+                          false to abort. The tiles of the last row and column exceed the area.
+     @return False if the sink aborted.
+   */
+  bool printTiles(const QSize& area, const QPointF& focus, bool printScale, const fPrintTile& sink);
+
   /**
      @brief Set a single map file to be shown on the canvas
 
@@ -217,6 +269,18 @@ class CCanvas : public QWidget {
   void drawStatusMessages(QPainter& p);
   void drawTrackStatistic(QPainter& p);
   void drawScale(QPainter& p, QRectF drawRect);
+  /**
+     @brief Draw a single tile of an area to be printed
+
+     The draw context size must be set to the tile's size.
+
+     @param p             the painter to draw on, the tile's top left corner is its origin
+     @param tile          the tile in coordinates of the area
+     @param area          the size of the area in [px]
+     @param focus         the point of focus in [rad] of the area
+     @param printScale    set true to draw the part of the area's scale within the tile
+   */
+  void printTile(QPainter& p, const QRect& tile, const QSize& area, const QPointF& focus, bool printScale);
   void drawScale(QPainter& p)  // Default use, drawRect is introduced for correct printing
   {
     drawScale(p, rect());
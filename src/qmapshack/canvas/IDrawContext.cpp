@@ -242,6 +242,16 @@ void IDrawContext::convertRad2Px(QPointF& p) const {
   mutex.unlock();  // --------- stop serialize with thread
 }
 
+void IDrawContext::convertRad2M(QPolygonF& poly) const {
+  if (!proj.isValid()) {
+    return;
+  }
+
+  mutex.lock();  // --------- start serialize with thread
+  projectRad2M(poly);
+  mutex.unlock();  // --------- stop serialize with thread
+}
+
 void IDrawContext::convertRad2Px(QPolygonF& poly) const {
   if (!proj.isValid()) {
     return;
@@ -251,7 +261,29 @@ void IDrawContext::convertRad2Px(QPolygonF& poly) const {
 
   QPointF f = focus;
   convertRad2M(f);
+  projectRad2M(poly);
+
+  for (QPointF& pt : poly) {
+    pt = (pt - f) / (scale * zoomFactor) + center;
+  }
+
+  mutex.unlock();  // --------- stop serialize with thread
+}
+
+QTransform IDrawContext::getTransformM2Px() const {
+  mutex.lock();  // --------- start serialize with thread
 
+  QPointF f = focus;
+  convertRad2M(f);
+  const QPointF s = scale * zoomFactor;
+  const QPointF c = center;
+
+  mutex.unlock();  // --------- stop serialize with thread
+
+  return QTransform(1 / s.x(), 0, 0, 1 / s.y(), c.x() - f.x() / s.x(), c.y() - f.y() / s.y());
+}
+
+void IDrawContext::projectRad2M(QPolygonF& poly) const {
   const int N = poly.size();
 
   struct p_t {
@@ -299,9 +331,15 @@ void IDrawContext::convertRad2Px(QPolygonF& poly) const {
       convertRad2M(o);
       pPt->rx() = 2 * o.x() + pPt->x();
     }
-
-    *pPt = (*pPt - f) / (scale * zoomFactor) + center;
   }
+}
+
+void IDrawContext::offsetPx(QPointF& p, const QPointF& off) const {
+  mutex.lock();  // --------- start serialize with thread
+
+  convertRad2M(p);
+  p += off * scale * zoomFactor;
+  convertM2Rad(p);
 
   mutex.unlock();  // --------- stop serialize with thread
 }
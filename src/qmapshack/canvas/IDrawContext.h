@@ -23,6 +23,7 @@
 #include <QMutex>
 #include <QPointF>
 #include <QThread>
+#include <QTransform>
 
 #include "canvas/CCanvas.h"
 #include "gis/proj_x.h"
@@ -73,6 +74,7 @@ class IDrawContext : public QThread {
      @param p             the point to convert
    */
   void convertRad2M(QPointF& p) const;
+  void convertRad2M(QPolygonF& poly) const;
   /**
      @brief Convert a geo coordinate of the currently used projection/datum to lon/lat WGS84
      @note  The unit is dependent on the currently used projection and must not necessarily be meter
@@ -90,6 +92,19 @@ class IDrawContext : public QThread {
    */
   void convertRad2Px(QPointF& p) const;
   void convertRad2Px(QPolygonF& poly) const;
+  /**
+     @brief Get the transformation from the coordinates of the currently used projection to pixel coordinates of the viewport
+     @note  The transformation is valid until the point of focus or the scale changes.
+     @return convertRad2M() followed by the returned transformation is the same as convertRad2Px()
+   */
+  QTransform getTransformM2Px() const;
+  /**
+     @brief Move a geo coordinate by an offset in pixel of the viewport
+     @note  This does not depend on the point of focus.
+     @param p             the point in [rad] to move
+     @param off           the offset in [pixel]
+   */
+  void offsetPx(QPointF& p, const QPointF& off) const;
 
   /**
      @brief Check if the internal needs redraw flag is set
@@ -191,6 +206,9 @@ class IDrawContext : public QThread {
   int zoomIndex = 0;
 
  private:
+  /// convertRad2M() for a polygon, the caller has to lock the mutex
+  void projectRad2M(QPolygonF& poly) const;
+
   /// the used scales and the type of scale levels
   const qreal* scales = nullptr;
   CCanvas::scales_type_e scalesType;
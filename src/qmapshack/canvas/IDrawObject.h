@@ -109,8 +109,8 @@ class IDrawObject : public QObject {
      @brief Setup a map cache using cachePath, cacheSizeMB and cacheExpiration
 
      The default implementation does noting. Streaming maps will probably override
-     it to reconfigure their cache. The method is called when ever a cache property is
-     changed.
+     it to reconfigure their cache. The method is called once for a batch of changed
+     cache properties, see IMap::applyCacheSettings().
    */
   virtual void configureCache() {}
 
@@ -0,0 +1,166 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "dem/CDemKernels.h"
+
+#include <QtCore>
+#include <cmath>
+
+#include "units/IUnit.h"
+
+// Only GCC and Clang can compile single functions for another instruction set
+// and check the CPU at runtime.
+#if defined(Q_CC_GNU) && defined(Q_PROCESSOR_X86)
+#define HAVE_AVX2_KERNELS
+#endif
+
+#if defined(Q_PROCESSOR_X86_64) || defined(__SSE2__)
+#define BASELINE_NAME "SSE2"
+#else
+#define BASELINE_NAME "scalar"
+#endif
+
+#define ZFACT 0.125
+#define ZFACT_BY_ZFACT (ZFACT * ZFACT)
+// altitude and azimuth of the light are 45° and 315°
+#define SIN_ALT M_SQRT1_2
+#define ZFACT_COS_ALT (ZFACT * M_SQRT1_2)
+#define SIN_AZ (-M_SQRT1_2)
+#define COS_AZ M_SQRT1_2
+
+using row_t = CDemKernels::row_t;
+using nodata_t = CDemKernels::nodata_t;
+
+static Q_ALWAYS_INLINE void hillshadeImpl(const row_t& row, qreal xscale, qreal yscale, const nodata_t& nodata,
+                                          quint8* out) {
+  const float* a = row.above;
+  const float* c = row.row;
+  const float* b = row.below;
+  const qint32 w = row.w;
+  const bool hasNoData = nodata.hasNoData;
+  const float noData = nodata.noData;
+
+  for (qint32 n = 0; n < w; n++) {
+    const qreal dx = ((a[n] + c[n] + c[n] + b[n]) - (a[n + 2] + c[n + 2] + c[n + 2] + b[n + 2])) / xscale;
+    const qreal dy = ((b[n] + b[n + 1] + b[n + 1] + b[n + 2]) - (a[n] + a[n + 1] + a[n + 1] + a[n + 2])) / yscale;
+    const qreal xx_plus_yy = dx * dx + dy * dy;
+
+    // With aspect = atan2(dy, dx) the term sqrt(xx_plus_yy) * sin(aspect - AZ) is
+    // the same as dy * cos(AZ) - dx * sin(AZ). No need for trigonometric functions.
+    const qreal cang =
+        (SIN_ALT - ZFACT_COS_ALT * (dy * COS_AZ - dx * SIN_AZ)) / std::sqrt(1 + ZFACT_BY_ZFACT * xx_plus_yy);
+
+    // no branches in the loop, otherwise it will not be vectorized
+    const bool isNoData = hasNoData & (c[n + 1] == noData);
+    const qint32 value = 1.0 + 254.0 * qMax(cang, 0.0);
+    out[n] = isNoData ? 255 : value;
+  }
+}
+
+static Q_ALWAYS_INLINE void slopeImpl(const row_t& row, qreal xscale, qreal yscale, const nodata_t& nodata,
+                                      qreal* out) {
+  const float* a = row.above;
+  const float* c = row.row;
+  const float* b = row.below;
+  const qint32 w = row.w;
+  const bool hasNoData = nodata.hasNoData;
+  const float noData = nodata.noData;
+
+  for (qint32 n = 0; n < w; n++) {
+    const bool isNoData = hasNoData & ((a[n] == noData) | (a[n + 1] == noData) | (a[n + 2] == noData) |
+                                        (c[n] == noData) | (c[n + 1] == noData) | (c[n + 2] == noData) |
+                                        (b[n] == noData) | (b[n + 1] == noData) | (b[n + 2] == noData));
+
+    const qreal dx =
+        ((qreal(a[n]) + c[n] + c[n] + b[n]) - (qreal(a[n + 2]) + c[n + 2] + c[n + 2] + b[n + 2])) / xscale;
+    const qreal dy =
+        ((qreal(b[n]) + b[n + 1] + b[n + 1] + b[n + 2]) - (qreal(a[n]) + a[n + 1] + a[n + 1] + a[n + 2])) / yscale;
+    const qreal tangent = std::sqrt(dx * dx + dy * dy) / 8.0;
+
+    out[n] = isNoData ? NOFLOAT : tangent;
+  }
+}
+
+static Q_ALWAYS_INLINE float validOrMin(float value, float noData) { return value != noData ? value : -2.0f; }
+
+static Q_ALWAYS_INLINE void maximumImpl(const row_t& row, const nodata_t& nodata, qreal* out) {
+  const float* a = row.above;
+  const float* c = row.row;
+  const float* b = row.below;
+  const qint32 w = row.w;
+  const float noData = nodata.noData;
+
+  for (qint32 n = 0; n < w; n++) {
+    float meters = -2.0f;
+    for (qint32 i = 0; i < 3; i++) {
+      meters = qMax(meters, validOrMin(a[n + i], noData));
+      meters = qMax(meters, validOrMin(c[n + i], noData));
+      meters = qMax(meters, validOrMin(b[n + i], noData));
+    }
+    out[n] = meters;
+  }
+}
+
+static void hillshadeBaseline(const row_t& row, qreal xscale, qreal yscale, const nodata_t& nodata, quint8* out) {
+  hillshadeImpl(row, xscale, yscale, nodata, out);
+}
+
+static void slopeBaseline(const row_t& row, qreal xscale, qreal yscale, const nodata_t& nodata, qreal* out) {
+  slopeImpl(row, xscale, yscale, nodata, out);
+}
+
+static void maximumBaseline(const row_t& row, const nodata_t& nodata, qreal* out) { maximumImpl(row, nodata, out); }
+
+static const CDemKernels::kernels_t kernelsBaseline = {BASELINE_NAME, hillshadeBaseline, slopeBaseline,
+                                                       maximumBaseline};
+
+#ifdef HAVE_AVX2_KERNELS
+__attribute__((target("avx2"))) static void hillshadeAvx2(const row_t& row, qreal xscale, qreal yscale,
+                                                          const nodata_t& nodata, quint8* out) {
+  hillshadeImpl(row, xscale, yscale, nodata, out);
+}
+
+__attribute__((target("avx2"))) static void slopeAvx2(const row_t& row, qreal xscale, qreal yscale,
+                                                      const nodata_t& nodata, qreal* out) {
+  slopeImpl(row, xscale, yscale, nodata, out);
+}
+
+__attribute__((target("avx2"))) static void maximumAvx2(const row_t& row, const nodata_t& nodata, qreal* out) {
+  maximumImpl(row, nodata, out);
+}
+
+static const CDemKernels::kernels_t kernelsAvx2 = {"AVX2", hillshadeAvx2, slopeAvx2, maximumAvx2};
+#endif  // HAVE_AVX2_KERNELS
+
+const CDemKernels::kernels_t& CDemKernels::get() {
+  static const kernels_t& kernels = *getAll().last();
+  return kernels;
+}
+
+QList<const CDemKernels::kernels_t*> CDemKernels::getAll() {
+  QList<const kernels_t*> all = {&kernelsBaseline};
+
+#ifdef HAVE_AVX2_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    all << &kernelsAvx2;
+  }
+#endif  // HAVE_AVX2_KERNELS
+
+  return all;
+}
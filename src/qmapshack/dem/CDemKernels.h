@@ -0,0 +1,88 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CDEMKERNELS_H
+#define CDEMKERNELS_H
+
+#include <QList>
+
+/**
+   @brief Row kernels for the shading of DEM data
+
+   Each kernel processes a complete row of w output pixels. It gets the row itself
+   and the rows above and below. All rows have w + 2 values as the 3x3 window needs
+   a border of one pixel.
+
+   The kernels are plain loops without branches, calls to the math library or
+   dependencies between the pixels. Thus the compiler can vectorize them. They are
+   compiled twice: for the baseline instruction set (SSE2 on x86-64) and for AVX2.
+   get() returns the best variant supported by the CPU.
+
+   All kernels are stateless and can be used from several threads at once.
+ */
+class CDemKernels {
+ public:
+  struct row_t {
+    const float* above;
+    const float* row;
+    const float* below;
+    qint32 w;  //< number of output pixels
+  };
+
+  struct nodata_t {
+    bool hasNoData;
+    float noData;
+  };
+
+  struct kernels_t {
+    const char* name;
+
+    /**
+       @brief Hillshading with light from north west
+
+       @param xscale, yscale  the scale of the data [m/px] multiplied by the hillshading factor
+       @param out             the gray value [1..255], 255 if the pixel has no data
+     */
+    void (*hillshade)(const row_t& row, qreal xscale, qreal yscale, const nodata_t& nodata, quint8* out);
+
+    /**
+       @brief Tangent of the slope
+
+       @param xscale, yscale  the scale of the data [m/px]
+       @param out             the tangent or NOFLOAT if any pixel of the window has no data
+     */
+    void (*slope)(const row_t& row, qreal xscale, qreal yscale, const nodata_t& nodata, qreal* out);
+
+    /**
+       @brief Maximum of the window
+
+       Pixels with a value of noData are ignored, even if hasNoData is not set.
+
+       @param out   the maximum elevation [m], at least -2
+     */
+    void (*maximum)(const row_t& row, const nodata_t& nodata, qreal* out);
+  };
+
+  /// the best variant for this CPU
+  static const kernels_t& get();
+
+  /// all variants supported by this CPU, the first one is the baseline
+  static QList<const kernels_t*> getAll();
+};
+
+#endif  // CDEMKERNELS_H
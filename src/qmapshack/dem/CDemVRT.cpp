@@ -28,7 +28,12 @@
 #include "helpers/CDraw.h"
 #include "units/IUnit.h"
 
+#define BLOCK_SIZE 256                //< [px]
+#define BLOCK_CACHE_SIZE (32 * 1024)  //< [kByte]
+
 CDemVRT::CDemVRT(const QString& filename, CDemDraw* parent) : IDem(parent), filename(filename) {
+  blockCache.setMaxCost(BLOCK_CACHE_SIZE);
+
   qDebug() << "------------------------------";
   qDebug() << "VRT: try to open" << filename;
 
@@ -113,7 +118,12 @@ CDemVRT::CDemVRT(const QString& filename, CDemDraw* parent) : IDem(parent), file
   isActivated = true;
 }
 
-CDemVRT::~CDemVRT() { GDALClose(dataset); }
+CDemVRT::~CDemVRT() {
+  GDALClose(dataset);
+  for (GDALDataset* ds : qAsConst(freeDatasets)) {
+    GDALClose(ds);
+  }
+}
 
 void CDemVRT::slotNeedsRedraw() { threadPool.clear(); }
 
@@ -157,6 +167,104 @@ qreal CDemVRT::getElevationAt(const QPointF& pos, bool checkScale) {
   return ele;
 }
 
+const CDemVRT::block_t* CDemVRT::getBlock(qint32 bx, qint32 by) {
+  const quint64 key = (quint64(quint32(bx)) << 32) | quint32(by);
+  const block_t* block = blockCache.object(key);
+  if (block != nullptr) {
+    return block;
+  }
+
+  block_t* newBlock = new block_t();
+  newBlock->x = bx * BLOCK_SIZE;
+  newBlock->y = by * BLOCK_SIZE;
+  newBlock->w = qMin(BLOCK_SIZE + 1, xsize_px - newBlock->x);
+  newBlock->h = qMin(BLOCK_SIZE + 1, ysize_px - newBlock->y);
+
+  if ((newBlock->w > 0) && (newBlock->h > 0)) {
+    newBlock->data.resize(newBlock->w * newBlock->h);
+    CPLErr err = dataset->RasterIO(GF_Read, newBlock->x, newBlock->y, newBlock->w, newBlock->h, newBlock->data.data(),
+                                   newBlock->w, newBlock->h, GDT_Float32, 1, 0, 0, 0, 0);
+    if (err == CE_Failure) {
+      newBlock->data.clear();
+    }
+  }
+
+  // a block that failed to read is cached, too. There is no need to try again.
+  blockCache.insert(key, newBlock, qMax(1, int(newBlock->data.size() * sizeof(float)) >> 10));
+  return newBlock;
+}
+
+void CDemVRT::getElevationAt(const QPolygonF& pos, QPolygonF& ele, bool checkScale) {
+  if (!proj.isValid() || (checkScale && outOfScale)) {
+    return;
+  }
+
+  QPolygonF pts = pos;
+  proj.transform(pts, PJ_INV);
+
+  // sort the points by block to read each block only once
+  QVector<QPair<quint64, qint32>> queries;
+  queries.reserve(pts.size());
+  const int N = pts.size();
+  for (int i = 0; i < N; i++) {
+    if (ele[i].y() != NOFLOAT || !boundingBox.contains(pts[i])) {
+      continue;
+    }
+
+    QPointF& pt = pts[i];
+    pt = trInv.map(pt);
+    if (pt.x() < 0 || pt.y() < 0) {
+      continue;
+    }
+
+    const quint32 bx = qFloor(pt.x()) / BLOCK_SIZE;
+    const quint32 by = qFloor(pt.y()) / BLOCK_SIZE;
+    queries << qMakePair((quint64(bx) << 32) | by, i);
+  }
+  std::sort(queries.begin(), queries.end());
+
+  QMutexLocker lock(&mutex);
+  const block_t* block = nullptr;
+  quint64 blockKey = 0;
+  for (const QPair<quint64, qint32>& query : qAsConst(queries)) {
+    if (block == nullptr || blockKey != query.first) {
+      blockKey = query.first;
+      block = getBlock(blockKey >> 32, blockKey & 0x0FFFFFFFF);
+    }
+
+    if (block->data.isEmpty()) {
+      continue;
+    }
+
+    const QPointF& pt = pts[query.second];
+    const qint32 px = qFloor(pt.x()) - block->x;
+    const qint32 py = qFloor(pt.y()) - block->y;
+
+    // the 2x2 window must not exceed the DEM
+    if ((px + 1) >= block->w || (py + 1) >= block->h) {
+      continue;
+    }
+
+    const float* e0 = block->data.constData() + py * block->w + px;
+    const float* e2 = e0 + block->w;
+    const float e[4] = {e0[0], e0[1], e2[0], e2[1]};
+
+    if (hasNoData && ((e[0] == noData) || (e[1] == noData) || (e[2] == noData) || (e[3] == noData))) {
+      continue;
+    }
+
+    const qreal x = pt.x() - qFloor(pt.x());
+    const qreal y = pt.y() - qFloor(pt.y());
+
+    const qreal b1 = e[0];
+    const qreal b2 = e[1] - e[0];
+    const qreal b3 = e[2] - e[0];
+    const qreal b4 = e[0] - e[1] - e[2] + e[3];
+
+    ele[query.second].ry() = b1 + b2 * x + b3 * y + b4 * x * y;
+  }
+}
+
 qreal CDemVRT::getSlopeAt(const QPointF& pos, bool checkScale) {
   if (!proj.isValid() || (checkScale && outOfScale)) {
     return NOFLOAT;
@@ -274,27 +382,68 @@ void CDemVRT::draw(IDrawContext::buffer_t& buf) {
 
   qreal o1 = getOpacity() / 100.0;
   qreal o2 = ((o1 + 0.4) >= 1.0) ? o1 : (o1 + 0.4);
-  p.setOpacity(o1);
 
+  QVector<QPoint> tiles;
   for (qint32 y = top - 1; y < bottom; y += h) {
+    for (qint32 x = left - 1; x < right; x += w) {
+      tiles << QPoint(x, y);
+    }
+  }
+
+  /*
+     Each tile is rendered by a task into its own images. The tasks share
+     nothing but the dataset handle pool. Only the draw thread paints.
+   */
+  QVector<QVector<layer_t>> layers(tiles.size());
+  for (int i = 0; i < tiles.size(); i++) {
     if (dem->needsRedraw()) {
       break;
     }
 
-    for (qint32 x = left - 1; x < right; x += w) {
-      if (dem->needsRedraw()) {
-        break;
-      }
-      // queue task to render tile
-      threadPool.start([this, x, y, w, h, &p, o1, o2]() { drawTile(x, y, w, h, o1, o2, p); });
-    }
+    const QPoint& tile = tiles[i];
+    QVector<layer_t>* tileLayers = &layers[i];
+    threadPool.start(
+        [this, tile, w, h, o1, o2, tileLayers]() { drawTile(tile.x(), tile.y(), w, h, o1, o2, *tileLayers); });
   }
   threadPool.waitForDone();
+
+  for (QVector<layer_t>& tileLayers : layers) {
+    if (dem->needsRedraw()) {
+      return;
+    }
+
+    for (layer_t& layer : tileLayers) {
+      p.setOpacity(layer.opacity);
+      drawTile(layer.img, layer.l, p);
+    }
+  }
+
+  p.setOpacity(o1);
   drawElevationShadeScale(p);
 }
 
+GDALDataset* CDemVRT::acquireDataset() {
+  {
+    QMutexLocker lock(&mutexDatasets);
+    if (!freeDatasets.isEmpty()) {
+      return freeDatasets.takeLast();
+    }
+  }
+
+  return (GDALDataset*)GDALOpen(filename.toUtf8(), GA_ReadOnly);
+}
+
+void CDemVRT::releaseDataset(GDALDataset* ds) {
+  QMutexLocker lock(&mutexDatasets);
+  freeDatasets << ds;
+}
+
 void CDemVRT::drawTile(const qint32 x, const qint32 y, const qint32 w, const qint32 h, const qreal o1, const qreal o2,
-                       QPainter& p) const {
+                       QVector<layer_t>& layers) {
+  if (dem->needsRedraw()) {
+    return;
+  }
+
   /*
       As the 3x3 window will create a border of one pixel
       more data is read than displayed to compensate.
@@ -322,14 +471,17 @@ void CDemVRT::drawTile(const qint32 x, const qint32 y, const qint32 w, const qin
     }
   }
 
+  GDALDataset* ds = acquireDataset();
+  if (ds == nullptr) {
+    return;
+  }
+
   QVector<float> data(wp2_used * hp2_used);
-  {
-    QMutexLocker lock(&mutex);
-    CPLErr err = dataset->RasterIO(GF_Read, x, y, wp2_used, hp2_used, data.data(), wp2_used, hp2_used, GDT_Float32, 1,
-                                   0, 0, 0, 0);
-    if (err != CE_None) {
-      return;
-    }
+  CPLErr err =
+      ds->RasterIO(GF_Read, x, y, wp2_used, hp2_used, data.data(), wp2_used, hp2_used, GDT_Float32, 1, 0, 0, 0, 0);
+  releaseDataset(ds);
+  if (err != CE_None) {
+    return;
   }
 
   QPolygonF l(4);
@@ -342,67 +494,38 @@ void CDemVRT::drawTile(const qint32 x, const qint32 y, const qint32 w, const qin
   proj.transform(l, PJ_FWD);
 
   if (doHillshading()) {
-    QPolygonF r = l;
     QImage img(w_used, h_used, QImage::Format_Indexed8);
     img.setColorTable(graytable);
 
     hillshading(data, w_used, h_used, img);
-
-    {
-      QMutexLocker lock(&mutex);
-      drawTile(img, r, p);
-    }
+    layers << layer_t{img, l, o1};
   }
 
   if (doSlopeShading()) {
-    QPolygonF r = l;
     QImage img(w_used, h_used, QImage::Format_Alpha8);
     slopeShading(data, w_used, h_used, img);
-
-    {
-      QMutexLocker lock(&mutex);
-      drawTile(img, r, p);
-    }
+    layers << layer_t{img, l, o1};
   }
 
   if (doSlopeColor()) {
-    QPolygonF r = l;
     QImage img(w_used, h_used, QImage::Format_Indexed8);
     img.setColorTable(slopetable);
     slopecolor(data, w_used, h_used, img);
-
-    {
-      QMutexLocker lock(&mutex);
-      p.setOpacity(o2);
-      drawTile(img, r, p);
-      p.setOpacity(o1);
-    }
+    layers << layer_t{img, l, o2};
   }
 
   if (doElevationLimit()) {
-    QPolygonF r = l;
     QImage img(w_used, h_used, QImage::Format_Indexed8);
     img.setColorTable(elevationtable);
     elevationLimit(data, w_used, h_used, img);
-
-    {
-      QMutexLocker lock(&mutex);
-      p.setOpacity(o2);
-      drawTile(img, r, p);
-      p.setOpacity(o1);
-    }
+    layers << layer_t{img, l, o2};
   }
 
   if (doElevationShading()) {
-    QPolygonF r = l;
     QImage img(w_used, h_used, QImage::Format_Indexed8);
     img.setColorTable(elevationShadeTable);
     elevationShading(data, w_used, h_used, img);
-
-    {
-      QMutexLocker lock(&mutex);
-      drawTile(img, r, p);
-    }
+    layers << layer_t{img, l, o1};
   }
 }
 
@@ -19,6 +19,8 @@
 #ifndef CDEMVRT_H
 #define CDEMVRT_H
 
+#include <QCache>
+#include <QImage>
 #include <QMutex>
 #include <QThreadPool>
 
@@ -36,17 +38,60 @@ class CDemVRT : public IDem {
   void draw(IDrawContext::buffer_t& buf) override;
 
   qreal getElevationAt(const QPointF& pos, bool checkScale) override;
+  void getElevationAt(const QPolygonF& pos, QPolygonF& ele, bool checkScale) override;
   qreal getSlopeAt(const QPointF& pos, bool checkScale) override;
 
  private slots:
   void slotNeedsRedraw();
 
  private:
+  /// a layer of a rendered tile to be drawn by the draw thread
+  struct layer_t {
+    QImage img;
+    QPolygonF l;
+    qreal opacity;
+  };
+
   using IDem::drawTile;
   void drawElevationShadeScale(QPainter& p) const;
-  void drawTile(const qint32 x, const qint32 y, const qint32 w, const qint32 h,
-                const qreal o1, const qreal o2, QPainter& p) const;
-
+  void drawTile(const qint32 x, const qint32 y, const qint32 w, const qint32 h, const qreal o1, const qreal o2,
+                QVector<layer_t>& layers);
+
+  /**
+     @brief Get a dataset handle for a render thread
+
+     GDAL datasets must not be used by several threads at the same time. Thus
+     each render thread uses its own handle. Handles are reused and only
+     opened if all others are busy.
+
+     @return The handle or nullptr if the file could not be opened
+   */
+  GDALDataset* acquireDataset();
+  void releaseDataset(GDALDataset* ds);
+
+  /// a block of elevation data for the batch elevation lookup
+  struct block_t {
+    qint32 x = 0;  //< left of block in the DEM [px]
+    qint32 y = 0;  //< top of block in the DEM [px]
+    qint32 w = 0;  //< width of data [px]
+    qint32 h = 0;  //< height of data [px]
+    QVector<float> data;
+  };
+
+  /**
+     @brief Get a block of elevation data from the cache or read it from the dataset
+
+     The block overlaps by one pixel with the next block to the right and bottom.
+     Thus the 2x2 window for bilinear interpolation is always part of a single block.
+     The mutex must be locked by the caller.
+
+     @param bx  the block's column
+     @param by  the block's row
+     @return The block. Its data is empty if it could not be read.
+   */
+  const block_t* getBlock(qint32 bx, qint32 by);
+
+  /// protect dataset and blockCache
   mutable QMutex mutex;
 
   QString filename;
@@ -66,7 +111,15 @@ class CDemVRT : public IDem {
 
   QRectF boundingBox;
 
+  /// blocks of elevation data read by the batch lookup, the cost is in [kByte]
+  QCache<quint64, block_t> blockCache;
+
   QThreadPool threadPool;
+
+  /// protect freeDatasets
+  QMutex mutexDatasets;
+  /// dataset handles of the render threads that are not in use
+  QList<GDALDataset*> freeDatasets;
 };
 
 #endif  // CDEMVRT_H
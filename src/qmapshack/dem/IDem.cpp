@@ -22,26 +22,15 @@
 #include <QtWidgets>
 
 #include "dem/CDemDraw.h"
+#include "dem/CDemKernels.h"
 #include "dem/CDemPropSetup.h"
+#include "units/IUnit.h"
 
 template <typename T>
 inline T getValue(QVector<T>& data, int x, int y, int dx) {
   return data[x + y * dx];
 }
 
-template <typename T>
-inline void fillWindow(QVector<T>& data, int x, int y, int dx, T* w) {
-  w[0] = getValue(data, x - 1, y - 1, dx);
-  w[1] = getValue(data, x, y - 1, dx);
-  w[2] = getValue(data, x + 1, y - 1, dx);
-  w[3] = getValue(data, x - 1, y, dx);
-  w[4] = getValue(data, x, y, dx);
-  w[5] = getValue(data, x + 1, y, dx);
-  w[6] = getValue(data, x - 1, y + 1, dx);
-  w[7] = getValue(data, x, y + 1, dx);
-  w[8] = getValue(data, x + 1, y + 1, dx);
-}
-
 template <typename T>
 inline void fillWindow4x4(QVector<T>& data, qreal x, qreal y, int dx, T* w) {
   x = qFloor(x);
@@ -77,6 +66,17 @@ const struct SlopePresets IDem::slopePresets[7]{
     {"secondary mountain", {4.0, 7.0, 10.0, 15.0, 20.0}},
     {"lofty mountain", {10.0, 15.0, 20.0, 30.0, 50.0}}};
 
+static CDemKernels::nodata_t toKernelNoData(bool hasNoData, double noData) {
+  // the kernels compare floats. A value that is not a float will never match a pixel.
+  const float value = qreal(float(noData)) == noData ? float(noData) : float(qQNaN());
+  return {hasNoData, value};
+}
+
+static CDemKernels::row_t toKernelRow(const QVector<float>& data, int m, int w) {
+  const float* row = data.constData() + m * (w + 2);
+  return {row - (w + 2), row, row + (w + 2), w};
+}
+
 IDem::IDem(CDemDraw* parent) : IDrawObject(parent), dem(parent) {
   slotSetOpacity(17);
 
@@ -101,6 +101,15 @@ IDem::IDem(CDemDraw* parent) : IDrawObject(parent), dem(parent) {
 
 IDem::~IDem() {}
 
+void IDem::getElevationAt(const QPolygonF& pos, QPolygonF& ele, bool checkScale) {
+  const int N = pos.size();
+  for (int i = 0; i < N; i++) {
+    if (ele[i].y() == NOFLOAT) {
+      ele[i].ry() = getElevationAt(pos[i], checkScale);
+    }
+  }
+}
+
 void IDem::saveConfig(QSettings& cfg) {
   IDrawObject::saveConfig(cfg);
 
@@ -214,70 +223,37 @@ int IDem::getFactorHillshading() const {
 }
 
 void IDem::hillshading(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
-
-#define ZFACT 0.125
-#define ZFACT_BY_ZFACT (ZFACT * ZFACT)
-#define SIN_ALT (qSin(45 * DEG_TO_RAD))
-#define ZFACT_COS_ALT (ZFACT * qCos(45 * DEG_TO_RAD))
-#define AZ (315 * DEG_TO_RAD)
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
-
-      if (hasNoData && win[4] == noData) {
-        scan[n - 1] = 255;
-        continue;
-      }
-
-      qreal dx =
-          ((win[0] + win[3] + win[3] + win[6]) - (win[2] + win[5] + win[5] + win[8])) / (xscale * factorHillshading);
-      qreal dy =
-          ((win[6] + win[7] + win[7] + win[8]) - (win[0] + win[1] + win[1] + win[2])) / (yscale * factorHillshading);
-      qreal aspect = qAtan2(dy, dx);
-      qreal xx_plus_yy = dx * dx + dy * dy;
-      qreal cang =
-          (SIN_ALT - ZFACT_COS_ALT * qSqrt(xx_plus_yy) * qSin(aspect - AZ)) / qSqrt(1 + ZFACT_BY_ZFACT * xx_plus_yy);
-
-      if (cang <= 0.0) {
-        cang = 1.0;
-      } else {
-        cang = 1.0 + (254.0 * cang);
-      }
+  const CDemKernels::kernels_t& kernels = CDemKernels::get();
+  const CDemKernels::nodata_t nodata = toKernelNoData(hasNoData, noData);
 
-      scan[n - 1] = cang;
-    }
+  for (int m = 1; m <= h; m++) {
+    kernels.hillshade(toKernelRow(data, m, w), xscale * factorHillshading, yscale * factorHillshading, nodata,
+                      img.scanLine(m - 1));
   }
 }
 
 int IDem::getFactorSlopeShading() const { return factorSlopeShading * 100.; }
 
 void IDem::slopeShading(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
+  const CDemKernels::kernels_t& kernels = CDemKernels::get();
+  const CDemKernels::nodata_t nodata = toKernelNoData(hasNoData, noData);
+  QVector<qreal> tangents(w);
 
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
+  for (int m = 1; m <= h; m++) {
+    kernels.slope(toKernelRow(data, m, w), xscale, yscale, nodata, tangents.data());
 
-      if (hasNoData && win[4] == noData) {
-        scan[n - 1] = 0;
-        continue;
-      }
-
-      qreal slope = slopeOfWindowInterp(win, eWinsize3x3, 0, 0);
-      if (slope == NOFLOAT) {
-        scan[n - 1] = 0;
+    unsigned char* scan = img.scanLine(m - 1);
+    for (int n = 0; n < w; n++) {
+      if (tangents[n] == NOFLOAT) {
+        scan[n] = 0;
       } else {
+        qreal slope = qAtan(tangents[n]) * 180.0 / M_PI;
         int alphaValue = slope * 255. / 90.     // map slope angle to alpha [0 .. 255]
                          * factorSlopeShading;  // apply slider value [0.25 .. 3.0]
         if (alphaValue > 255) {
           alphaValue = 255;
         }
-        scan[n - 1] = alphaValue;
+        scan[n] = alphaValue;
       }
     }
   }
@@ -334,97 +310,87 @@ qreal IDem::slopeOfWindowInterp(float* win2, winsize_e size, qreal x, qreal y) c
 }
 
 void IDem::slopecolor(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
+  const CDemKernels::kernels_t& kernels = CDemKernels::get();
+  const CDemKernels::nodata_t nodata = toKernelNoData(hasNoData, noData);
+  QVector<qreal> tangents(w);
+
+  // compare the tangent of the slope to save the qAtan() for each pixel
+  const qreal* currentSlopeStepTable = getCurrentSlopeStepTable();
+  qreal limits[5];
+  for (int i = 0; i < 5; i++) {
+    const qreal step = currentSlopeStepTable[i];
+    limits[i] = step < 0 ? -1.0 : step >= 90 ? qInf() : qTan(step * DEG_TO_RAD);
+  }
+
+  for (int m = 1; m <= h; m++) {
+    kernels.slope(toKernelRow(data, m, w), xscale, yscale, nodata, tangents.data());
 
-  for (unsigned int m = 1; m <= h; m++) {
     unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
-      qreal slope = slopeOfWindowInterp(win, eWinsize3x3, 0, 0);
-
-      const qreal* currentSlopeStepTable = getCurrentSlopeStepTable();
-
-      if (slope > currentSlopeStepTable[4]) {
-        scan[n - 1] = 5;
-      } else if (slope > currentSlopeStepTable[3]) {
-        scan[n - 1] = 4;
-      } else if (slope > currentSlopeStepTable[2]) {
-        scan[n - 1] = 3;
-      } else if (slope > currentSlopeStepTable[1]) {
-        scan[n - 1] = 2;
-      } else if (slope > currentSlopeStepTable[0]) {
-        scan[n - 1] = 1;
+    for (int n = 0; n < w; n++) {
+      const qreal tangent = tangents[n];
+      if (tangent == NOFLOAT || tangent > limits[4]) {
+        scan[n] = 5;
+      } else if (tangent > limits[3]) {
+        scan[n] = 4;
+      } else if (tangent > limits[2]) {
+        scan[n] = 3;
+      } else if (tangent > limits[1]) {
+        scan[n] = 2;
+      } else if (tangent > limits[0]) {
+        scan[n] = 1;
       } else {
-        scan[n - 1] = 0;
+        scan[n] = 0;
       }
     }
   }
 }
 
 void IDem::elevationLimit(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
+  const CDemKernels::kernels_t& kernels = CDemKernels::get();
+  const CDemKernels::nodata_t nodata = toKernelNoData(hasNoData, noData);
+  QVector<qreal> meters(w);
 
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
-
-      // get maximum of window (_not_ mean)
-      //
-      qreal meters = -2.0;
-      for (unsigned int i = 0; i < eWinsize3x3; i++) {
-        if (win[i] != noData && win[i] > meters) {
-          meters = win[i];
-        }
-      }
+  // the same as IUnit::meter2elevation() but without the overhead for each pixel
+  const qreal elevationFactor = IUnit::self().elevationFactor;
+  const int limit = getElevationLimit();
 
-      qreal elevation;  // elevation in the units set by the user
-      QString unit;     // result not used
-      IUnit::self().meter2elevation(meters, elevation, unit);
-      if (elevation >= getElevationLimit()) {
-        scan[n - 1] = 1;
-      } else {
-        scan[n - 1] = 0;
-      }
+  for (int m = 1; m <= h; m++) {
+    // get maximum of window (_not_ mean)
+    kernels.maximum(toKernelRow(data, m, w), nodata, meters.data());
+
+    unsigned char* scan = img.scanLine(m - 1);
+    for (int n = 0; n < w; n++) {
+      const qreal elevation = meters[n] * elevationFactor;  // elevation in the units set by the user
+      scan[n] = elevation >= limit ? 1 : 0;
     }
   }
 }
 
 void IDem::elevationShading(QVector<float>& data, qreal w, qreal h, QImage& img) const {
-  int wp2 = w + 2;
+  const CDemKernels::kernels_t& kernels = CDemKernels::get();
+  const CDemKernels::nodata_t nodata = toKernelNoData(hasNoData, noData);
+  QVector<qreal> meters(w);
 
-  for (unsigned int m = 1; m <= h; m++) {
-    unsigned char* scan = img.scanLine(m - 1);
-    for (unsigned int n = 1; n <= w; n++) {
-      float win[eWinsize3x3];
-      fillWindow(data, n, m, wp2, win);
-
-      // get maximum of window (_not_ mean)
-      //
-      qreal meters = -2.0;
-      for (unsigned int i = 0; i < eWinsize3x3; i++) {
-        if (win[i] != noData && win[i] > meters) {
-          meters = win[i];
-        }
-      }
+  // the same as IUnit::meter2elevation() but without the overhead for each pixel
+  const qreal elevationFactor = IUnit::self().elevationFactor;
+  // calc shade of elevation based and  clip set min and max values
+  const int limitLow = std::min(getElevationShadeLimitLow(), getElevationShadeLimitHi());
+  const int limitHi = std::max(getElevationShadeLimitLow(), getElevationShadeLimitHi());
 
-      qreal elevation;  // elevation in the units set by the user
-      QString unit;     // result not used
-      IUnit::self().meter2elevation(meters, elevation, unit);
-
-      // calc shade of elevation based and  clip set min and max values
-      int limitLow = std::min(getElevationShadeLimitLow(), getElevationShadeLimitHi());
-      int limitHi = std::max(getElevationShadeLimitLow(), getElevationShadeLimitHi());
+  for (int m = 1; m <= h; m++) {
+    // get maximum of window (_not_ mean)
+    kernels.maximum(toKernelRow(data, m, w), nodata, meters.data());
 
+    unsigned char* scan = img.scanLine(m - 1);
+    for (int n = 0; n < w; n++) {
+      const qreal elevation = meters[n] * elevationFactor;  // elevation in the units set by the user
       if (elevation < limitLow) {
-        scan[n - 1] = 0;
+        scan[n] = 0;
       } else if (elevation < limitHi) {
         qreal relLimit = (elevation - limitLow) / (limitHi - limitLow);
-        scan[n - 1] = 1 + relLimit * 253;
+        scan[n] = 1 + relLimit * 253;
       } else {
-        scan[n - 1] = 255;
+        scan[n] = 255;
       }
     }
   }
@@ -51,6 +51,17 @@ class IDem : public IDrawObject {
   virtual void draw(IDrawContext::buffer_t& buf) = 0;
 
   virtual qreal getElevationAt(const QPointF& pos, bool checkScale) = 0;
+  /**
+     @brief Get the elevation of many points at once
+
+     Only points with an elevation of NOFLOAT are looked up. Thus several DEM files
+     can fill in the missing values one after the other.
+
+     @param pos         the points [rad]
+     @param ele         the elevation [m] of each point is stored in y(). Must have the same size as pos.
+     @param checkScale  if true return NOFLOAT if the DEM is out of scale
+   */
+  virtual void getElevationAt(const QPolygonF& pos, QPolygonF& ele, bool checkScale);
   virtual qreal getSlopeAt(const QPointF& pos, bool checkScale) = 0;
 
   bool activated() const { return isActivated; }
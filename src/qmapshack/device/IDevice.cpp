@@ -72,38 +72,6 @@ void IDevice::umount(const QString& path) {
 
 QString IDevice::getName() const { return text(CGisListWks::eColumnName); }
 
-void IDevice::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items) {
-  const int N = childCount();
-  for (int n = 0; n < N; n++) {
-    IGisProject* project = dynamic_cast<IGisProject*>(child(n));
-    if (project != nullptr) {
-      project->getItemsByPos(pos, items);
-      continue;
-    }
-
-    IDevice* device = dynamic_cast<IDevice*>(child(n));
-    if (device != nullptr) {
-      device->getItemsByPos(pos, items);
-    }
-  }
-}
-
-void IDevice::getItemsByArea(const QRectF& area, IGisItem::selflags_t flags, QList<IGisItem*>& items) {
-  const int N = childCount();
-  for (int n = 0; n < N; n++) {
-    IGisProject* project = dynamic_cast<IGisProject*>(child(n));
-    if (project != nullptr) {
-      project->getItemsByArea(area, flags, items);
-      continue;
-    }
-
-    IDevice* device = dynamic_cast<IDevice*>(child(n));
-    if (device != nullptr) {
-      device->getItemsByArea(area, flags, items);
-    }
-  }
-}
-
 void IDevice::getNogoAreas(QList<IGisItem*>& nogos) {
   const int N = childCount();
   for (int n = 0; n < N; n++) {
@@ -48,8 +48,6 @@ class IDevice : public QTreeWidgetItem {
 
   QString getName() const;
 
-  void getItemsByPos(const QPointF& pos, QList<IGisItem*>& items);
-  void getItemsByArea(const QRectF& area, IGisItem::selflags_t flags, QList<IGisItem*>& items);
   void getNogoAreas(QList<IGisItem*>& nogos);
   IGisItem* getItemByKey(const IGisItem::key_t& key);
   void getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisItem*>& items);
@@ -0,0 +1,219 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/CGisKeyIndex.h"
+
+#include <QTreeWidget>
+
+#include "device/IDevice.h"
+#include "gis/prj/IGisProject.h"
+
+CGisKeyIndex::CGisKeyIndex(QTreeWidget* tree) : QObject(tree), tree(tree) {
+  QAbstractItemModel* model = tree->model();
+  connect(model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex& parent, int first, int last) {
+    for (int row = first; row <= last; row++) {
+      add(itemFromIndex(tree->model()->index(row, 0, parent)));
+    }
+  });
+  connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+          [this](const QModelIndex& parent, int first, int last) {
+            for (int row = first; row <= last; row++) {
+              remove(itemFromIndex(tree->model()->index(row, 0, parent)));
+            }
+          });
+
+  // the order of items only matters if they share a key
+  auto reorder = [this]() { isDirty = isDirty || !keysShared.isEmpty() || !projectKeysShared.isEmpty(); };
+  connect(model, &QAbstractItemModel::rowsMoved, this, reorder);
+  connect(model, &QAbstractItemModel::layoutChanged, this, reorder);
+
+  // the items are already gone, thus forget about them
+  connect(model, &QAbstractItemModel::modelReset, this, [this]() {
+    clear();
+    isDirty = true;
+  });
+}
+
+IGisItem* CGisKeyIndex::getItemByKey(const IGisItem::key_t& key) {
+  if (key.item.isEmpty()) {
+    return nullptr;
+  }
+
+  check();
+  return itemsByKey.value(key, nullptr);
+}
+
+IGisProject* CGisKeyIndex::getProjectByKey(const QString& key) {
+  check();
+  return projectsByKey.value(key, nullptr);
+}
+
+void CGisKeyIndex::check() {
+  const QSet<const QTreeWidgetItem*>& changed = IGisItem::takeKeysChanged();
+  if (isDirty) {
+    rebuild();
+    return;
+  }
+
+  // items and projects with a new key are indexed anew, with all their children
+  for (const QTreeWidgetItem* item : changed) {
+    QTreeWidgetItem* treeItem = const_cast<QTreeWidgetItem*>(item);
+    if (keysIndexed.contains(treeItem) || projectKeysIndexed.contains(treeItem)) {
+      remove(treeItem);
+      add(treeItem);
+    }
+  }
+
+  const QSet<QTreeWidgetItem*> items = pending;
+  pending.clear();
+  for (QTreeWidgetItem* item : items) {
+    index(item);
+  }
+
+  if (isDirty) {
+    // a key is shared by several items or projects, let the order in the tree decide
+    rebuild();
+  }
+}
+
+void CGisKeyIndex::rebuild() {
+  clear();
+
+  // walk the tree in order, thus the first of several entries with the same key wins
+  for (QTreeWidgetItemIterator it(tree); *it != nullptr; ++it) {
+    index(*it);
+  }
+
+  isDirty = false;
+}
+
+void CGisKeyIndex::clear() {
+  pending.clear();
+  keysIndexed.clear();
+  keysShared.clear();
+  itemsByKey.clear();
+  projectKeysIndexed.clear();
+  projectKeysShared.clear();
+  projectsByKey.clear();
+}
+
+QTreeWidgetItem* CGisKeyIndex::itemFromIndex(const QModelIndex& index) const {
+  if (!index.isValid()) {
+    return nullptr;
+  }
+  QTreeWidgetItem* parent = itemFromIndex(index.parent());
+  return parent == nullptr ? tree->topLevelItem(index.row()) : parent->child(index.row());
+}
+
+void CGisKeyIndex::add(QTreeWidgetItem* item) {
+  if (item == nullptr) {
+    return;
+  }
+
+  pending.insert(item);
+  for (int i = 0; i < item->childCount(); i++) {
+    add(item->child(i));
+  }
+}
+
+void CGisKeyIndex::remove(QTreeWidgetItem* item) {
+  // The item might be in its destructor already. Thus only the pointer and the
+  // QTreeWidgetItem part are used.
+  if (item == nullptr) {
+    return;
+  }
+
+  pending.remove(item);
+
+  auto it = keysIndexed.find(item);
+  if (it != keysIndexed.end()) {
+    const IGisItem::key_t key = it.value();
+    keysIndexed.erase(it);
+    if (keysShared.contains(key)) {
+      isDirty = true;
+    } else if (!key.item.isEmpty()) {
+      itemsByKey.remove(key);
+    }
+  } else if (projectKeysIndexed.contains(item)) {
+    const QString key = projectKeysIndexed.take(item);
+    if (projectKeysShared.contains(key)) {
+      isDirty = true;
+    } else if (!key.isEmpty()) {
+      projectsByKey.remove(key);
+    }
+  }
+
+  for (int i = 0; i < item->childCount(); i++) {
+    remove(item->child(i));
+  }
+}
+
+void CGisKeyIndex::index(QTreeWidgetItem* treeItem) {
+  IGisItem* item = dynamic_cast<IGisItem*>(treeItem);
+  if (item != nullptr) {
+    // items not matching their position are remembered, too, to index them on a key change
+    const IGisItem::key_t& key = isAtKeyPosition(item) ? item->getKey() : IGisItem::key_t();
+    keysIndexed[treeItem] = key;
+    if (key.item.isEmpty()) {
+      return;
+    }
+
+    IGisItem*& entry = itemsByKey[key];
+    if (entry == nullptr) {
+      entry = item;
+    } else if (entry != item) {
+      keysShared.insert(key);
+      isDirty = true;
+    }
+    return;
+  }
+
+  IGisProject* project = dynamic_cast<IGisProject*>(treeItem);
+  if (project != nullptr) {
+    // projects on devices are remembered, too, to index their items on a key change
+    const QString& key = project->parent() == nullptr ? project->getKey() : QString();
+    projectKeysIndexed[treeItem] = key;
+    if (key.isEmpty()) {
+      return;
+    }
+
+    IGisProject*& entry = projectsByKey[key];
+    if (entry == nullptr) {
+      entry = project;
+    } else if (entry != project) {
+      projectKeysShared.insert(key);
+      isDirty = true;
+    }
+  }
+}
+
+bool CGisKeyIndex::isAtKeyPosition(const IGisItem* item) {
+  // the item's key has to match the project it belongs to
+  const IGisProject* project = item->getParentProject();
+  if (project == nullptr || item->getKey().project != project->getKey()) {
+    return false;
+  }
+
+  // and the device on top of it, if any
+  const QTreeWidgetItem* top = project;
+  while (top->parent() != nullptr) {
+    top = top->parent();
+  }
+  const IDevice* device = dynamic_cast<const IDevice*>(top);
+  return device == nullptr || item->getKey().device == device->getKey();
+}
@@ -0,0 +1,88 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CGISKEYINDEX_H
+#define CGISKEYINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+
+#include "gis/IGisItem.h"
+
+class QModelIndex;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+   @brief Hash index of the items and top level projects of a tree by their keys
+
+   The index follows the tree's model. Inserted items are queued and indexed with
+   the next lookup, as the item's key is not known while it is constructed.
+   Removed items are taken out of the index right away. Items and projects
+   reported by IGisItem::keyChanged() are indexed anew, projects with all their
+   items.
+
+   A full rebuild is done only if a key is shared by several items or projects,
+   as the first of them in the tree wins.
+ */
+class CGisKeyIndex : public QObject {
+  Q_OBJECT
+ public:
+  CGisKeyIndex(QTreeWidget* tree);
+  virtual ~CGisKeyIndex() = default;
+
+  IGisItem* getItemByKey(const IGisItem::key_t& key);
+  IGisProject* getProjectByKey(const QString& key);
+
+ private:
+  /// bring the index up to date with the changes queued since the last lookup
+  void check();
+  void rebuild();
+  void clear();
+
+  QTreeWidgetItem* itemFromIndex(const QModelIndex& index) const;
+  /// queue an item and its children to be indexed
+  void add(QTreeWidgetItem* item);
+  /// remove an item and its children from the index
+  void remove(QTreeWidgetItem* item);
+  void index(QTreeWidgetItem* item);
+
+  static bool isAtKeyPosition(const IGisItem* item);
+
+  QTreeWidget* tree;
+
+  /// true if the index has to be rebuilt with the next lookup
+  bool isDirty = true;
+
+  /// items inserted into the tree but not indexed yet
+  QSet<QTreeWidgetItem*> pending;
+  /// the key each item is indexed with, an empty key if the item is not in the index
+  QHash<QTreeWidgetItem*, IGisItem::key_t> keysIndexed;
+  /// keys used by more than one item
+  QSet<IGisItem::key_t> keysShared;
+
+  QHash<IGisItem::key_t, IGisItem*> itemsByKey;
+  /// the key each project is indexed with, an empty key for projects on a device
+  QHash<QTreeWidgetItem*, QString> projectKeysIndexed;
+  /// keys used by more than one top level project
+  QSet<QString> projectKeysShared;
+  QHash<QString, IGisProject*> projectsByKey;
+};
+
+#endif  // CGISKEYINDEX_H
@@ -35,7 +35,9 @@
 
 #include "device/IDevice.h"
 #include "gis/CGisDatabase.h"
+#include "gis/CGisKeyIndex.h"
 #include "gis/CGisListWks.h"
+#include "gis/CGisListWksWriter.h"
 #include "gis/CGisWorkspace.h"
 #include "gis/CSelDevices.h"
 #include "gis/IGisItem.h"
@@ -63,6 +65,7 @@
 #include "helpers/CSelectProjectDialog.h"
 #include "helpers/CSettings.h"
 #include "helpers/CWptIconManager.h"
+#include "map/CTileSeedDialog.h"
 #include "setup/IAppSetup.h"
 
 #undef DB_VERSION
@@ -95,6 +98,11 @@ CGisListWks::CGisListWks(QWidget* parent) : QTreeWidget(parent) {
   db.open();
   configDB();
 
+  writer = new CGisListWksWriter(config, this);
+  writer->start();
+  // the table is in an unknown state, thus write everything with the next save
+  connect(writer, &CGisListWksWriter::sigFailed, this, [this]() { saveAll = true; });
+
   // workspace project related actions
   actionEditPrj = addAction(QIcon("://icons/32x32/EditDetails.png"), tr("Edit.."), this, &CGisListWks::slotEditPrj);
   actionCopyPrj = addAction(QIcon("://icons/32x32/Copy.png"), tr("Copy to..."), this, &CGisListWks::slotCopyProject);
@@ -206,12 +214,37 @@ CGisListWks::CGisListWks(QWidget* parent) : QTreeWidget(parent) {
       addAction(QIcon("://icons/32x32/Route.png"), tr("Create Route..."), this, &CGisListWks::slotRteFromWpt);
   actionEditPrxWpt =
       addAction(QIcon("://icons/32x32/WptEditProx.png"), tr("Change Proximity..."), this, &CGisListWks::slotEditPrxWpt);
-
-  connect(qApp, &QApplication::aboutToQuit, this, &CGisListWks::slotSaveWorkspace);
+  actionSeedMapCache =
+      addAction(QIcon("://icons/32x32/Map.png"), tr("Seed Map Cache..."), this, &CGisListWks::slotSeedMapCache);
+
+  connect(qApp, &QApplication::aboutToQuit, this, [this]() {
+    slotSaveWorkspace();
+    // block until the workspace is on disk
+    writer->flush();
+  });
   connect(this, &CGisListWks::customContextMenuRequested, this, &CGisListWks::slotContextMenu);
   connect(this, &CGisListWks::itemDoubleClicked, this, &CGisListWks::slotItemDoubleClicked);
   connect(this, &CGisListWks::itemChanged, this, &CGisListWks::slotItemChanged);
 
+  // projects loaded without their items get them when they are used
+  connect(this, &CGisListWks::itemExpanded, this, [](QTreeWidgetItem* item) {
+    IGisProject* project = dynamic_cast<IGisProject*>(item);
+    if (nullptr != project) {
+      project->restorePendingItems();
+    }
+  });
+  connect(this, &CGisListWks::itemSelectionChanged, this, [this]() {
+    const QList<QTreeWidgetItem*>& items = selectedItems();
+    for (QTreeWidgetItem* item : items) {
+      IGisProject* project = dynamic_cast<IGisProject*>(item);
+      if (nullptr != project) {
+        project->restorePendingItems();
+      }
+    }
+  });
+
+  keyIndex = new CGisKeyIndex(this);
+
   SETTINGS;
   saveOnExit = cfg.value("Database/saveOnExit", saveOnExit).toBool();
   saveEvery = cfg.value("Database/saveEvery", saveEvery).toInt();
@@ -693,14 +726,20 @@ bool CGisListWks::hasProject(IGisProject* project) {
 
 IGisProject* CGisListWks::getProjectByKey(const QString& key) {
   CGisListWksEditLock lock(true, IGisItem::mutexItems);
+  return keyIndex->getProjectByKey(key);
+}
 
-  for (int i = 0; i < topLevelItemCount(); i++) {
-    IGisProject* item = dynamic_cast<IGisProject*>(topLevelItem(i));
-    if (item && item->getKey() == key) {
-      return item;
+IGisItem* CGisListWks::getItemByKey(const IGisItem::key_t& key) {
+  IGisItem* item = keyIndex->getItemByKey(key);
+  if (item == nullptr) {
+    // the item might belong to a project whose items are not restored yet
+    IGisProject* project = keyIndex->getProjectByKey(key.project);
+    if (project != nullptr && project->hasPendingItems()) {
+      project->restorePendingItems();
+      item = keyIndex->getItemByKey(key);
     }
   }
-  return nullptr;
+  return item;
 }
 
 CDBProject* CGisListWks::getProjectById(quint64 id, const QString& db) {
@@ -715,53 +754,105 @@ CDBProject* CGisListWks::getProjectById(quint64 id, const QString& db) {
   return nullptr;
 }
 
+// the data of a project's row in the workspace table, must be called with IGisItem::mutexItems locked
+static CGisListWksWriter::project_t getProjectRow(IGisProject* project) {
+  CGisListWksWriter::project_t row;
+  row.type = project->getType();
+  row.key = project->getKey();
+  row.name = project->getName();
+  row.changed = project->isChanged();
+  row.visible = (project->checkState(CGisListDB::eColumnCheckbox) == Qt::Checked);
+  row.snapshot = project->getSnapshot();
+  return row;
+}
+
+static QByteArray getFingerprint(const CGisListWksWriter::project_t& row) {
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream << row.type << row.key << row.name << row.changed << row.visible << row.snapshot.getFingerprint();
+  return data;
+}
+
 void CGisListWks::slotSaveWorkspace() {
-  CGisListWksEditLock lock(true, IGisItem::mutexItems);
+  CGisListWksEditLock lock(false, IGisItem::mutexItems);
 
   if (!saveOnExit) {
     return;
   }
 
-  QSqlQuery query(db);
-  QUERY_RUN("DELETE FROM workspace", return )
-
   qDebug() << "slotSaveWorkspace()";
 
-  const int total = topLevelItemCount();
-  PROGRESS_SETUP(tr("Saving workspace. Please wait."), 0, total, this);
+  // The writer has a connection of its own. As the database is locked
+  // exclusively the connection used to load the workspace has to be closed.
+  if (db.isOpen()) {
+    db.close();
+  }
 
-  for (int i = 0; i < total; i++) {
-    PROGRESS(i, return );
+  // Only projects that changed since the last save are passed to the writer.
+  // The rows have to keep the order of the projects. Thus new projects get
+  // increasing ids. If a project has been moved, everything is written again.
+  QList<const IGisProject*> order;
+  QList<CGisListWksWriter::project_t> rows;
+  QList<bool> dirty;
+  QHash<const IGisProject*, saved_project_t> projects;
+  qint64 nextId = nextRowId;
+  qint64 lastId = 0;
+  bool inOrder = true;
 
+  for (int i = 0; i < topLevelItemCount(); i++) {
     IGisProject* project = dynamic_cast<IGisProject*>(topLevelItem(i));
     if (nullptr == project) {
       continue;
     }
 
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    stream.setVersion(QDataStream::Qt_5_2);
-    stream.setByteOrder(QDataStream::LittleEndian);
+    CGisListWksWriter::project_t row = getProjectRow(project);
+    saved_project_t saved = savedProjects.value(project, {0, QByteArray()});
+    if (saved.id == 0) {
+      saved.id = nextId++;
+    }
+    inOrder = inOrder && (saved.id > lastId);
+    lastId = saved.id;
 
-    project->IGisProject::operator>>(stream);
+    const QByteArray fingerprint = getFingerprint(row);
+    dirty << (fingerprint != saved.fingerprint);
+    saved.fingerprint = fingerprint;
+    row.id = saved.id;
+
+    order << project;
+    rows << row;
+    projects[project] = saved;
+  }
 
-    query.prepare(
-        "INSERT INTO workspace (type, keyqms, name, changed, visible, data) VALUES (:type, :keyqms, :name, :changed, "
-        ":visible, :data)");
-    query.bindValue(":type", project->getType());
-    query.bindValue(":keyqms", project->getKey());
-    query.bindValue(":name", project->getName());
-    query.bindValue(":changed", project->isChanged());
+  CGisListWksWriter::job_t job;
+  job.userFocus = IGisProject::getUserFocus();
 
-    bool visible = (project->checkState(CGisListDB::eColumnCheckbox) == Qt::Checked);
-    query.bindValue(":visible", visible);
-    query.bindValue(":data", data);
-    QUERY_EXEC(continue);
+  if (saveAll || !inOrder) {
+    job.removeAll = true;
+    for (int i = 0; i < rows.size(); i++) {
+      rows[i].id = projects[order[i]].id = i + 1;
+      job.projects << rows[i];
+    }
+    nextId = rows.size() + 1;
+  } else {
+    for (int i = 0; i < rows.size(); i++) {
+      if (dirty[i]) {
+        job.projects << rows[i];
+      }
+    }
+    job.removed = orphanedRows;
+    for (auto it = savedProjects.constBegin(); it != savedProjects.constEnd(); it++) {
+      if (!projects.contains(it.key())) {
+        job.removed << it->id;
+      }
+    }
   }
 
-  query.prepare("UPDATE userfocus set focus=:focus");
-  query.bindValue(":focus", IGisProject::getUserFocus());
-  QUERY_EXEC();
+  writer->enqueue(job);
+
+  savedProjects = projects;
+  orphanedRows.clear();
+  nextRowId = nextId;
+  saveAll = false;
 
   if (saveEvery) {
     QTimer::singleShot(saveEvery * 60000, this, &CGisListWks::slotSaveWorkspace);
@@ -771,122 +862,181 @@ void CGisListWks::slotSaveWorkspace() {
 void CGisListWks::slotLoadWorkspace() {
   CGisListWksEditLock lock(true, IGisItem::mutexItems);
 
+  QElapsedTimer timer;
+  timer.start();
+
   QSqlQuery query(db);
+  // do not keep all blobs in the query's cache
+  query.setForwardOnly(true);
 
-  QUERY_RUN("SELECT type, keyqms, name, changed, visible, data FROM workspace", return )
+  QUERY_RUN("SELECT type, keyqms, name, changed, visible, data, id FROM workspace ORDER BY id", return )
 
-  {  // open context for progress dialog
-    const int total = query.size();
-    PROGRESS_SETUP(tr("Loading workspace. Please wait."), 0, total, this);
-    quint32 progCnt = 0;
-
-    while (query.next()) {
-      PROGRESS(progCnt++, return );
-
-      int type = query.value(0).toInt();
-      QString name = query.value(2).toString();
-      bool changed = query.value(3).toBool();
-      Qt::CheckState visible = query.value(4).toBool() ? Qt::Checked : Qt::Unchecked;
-      QByteArray data = query.value(5).toByteArray();
-
-      QDataStream stream(&data, QIODevice::ReadOnly);
-      stream.setVersion(QDataStream::Qt_5_2);
-      stream.setByteOrder(QDataStream::LittleEndian);
-
-      IGisProject* project = nullptr;
-      switch (type) {
-        case IGisProject::eTypeQms: {
-          project = new CQmsProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1a)
-          *project << stream;
-          break;
-        }
+  struct row_t {
+    qint64 id = 0;
+    bool changed = false;
+    bool withItems = true;
+    QByteArray data;
+    IGisProject* project = nullptr;
+    IGisProject::snapshot_t snapshot;
+    bool isValid = false;
+  };
+
+  // Create all projects from the metadata columns first. Thus the workspace
+  // shows the projects while they are still loading.
+  QVector<row_t> rows;
+  while (query.next()) {
+    row_t row;
+    int type = query.value(0).toInt();
+    QString name = query.value(2).toString();
+    Qt::CheckState visible = query.value(4).toBool() ? Qt::Checked : Qt::Unchecked;
+    row.changed = query.value(3).toBool();
+    row.data = query.value(5).toByteArray();
+    row.id = query.value(6).toLongLong();
+    nextRowId = qMax(nextRowId, row.id + 1);
+
+    // The items of projects not shown on the map are restored on first use.
+    // Database projects are always restored as they are linked to the database.
+    row.withItems = (visible == Qt::Checked) || (type == IGisProject::eTypeDb);
+
+    switch (type) {
+      case IGisProject::eTypeQms:
+        row.project = new CQmsProject(name, this);
+        break;
 
-        case IGisProject::eTypeQlb: {
-          project = new CQlbProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1a)
-          *project << stream;
-          break;
-        }
+      case IGisProject::eTypeQlb:
+        row.project = new CQlbProject(name, this);
+        break;
 
-        case IGisProject::eTypeGpx: {
-          project = new CGpxProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1b)
-          *project << stream;
-          break;
-        }
+      case IGisProject::eTypeGpx:
+        row.project = new CGpxProject(name, this);
+        break;
 
-        case IGisProject::eTypeDb: {
-          CDBProject* dbProject;
-          project = dbProject = new CDBProject(this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1c)
+      case IGisProject::eTypeDb:
+        row.project = new CDBProject(this);
+        break;
 
-          project->IGisProject::operator<<(stream);
-          dbProject->restoreDBLink();
+      case IGisProject::eTypeSlf:
+        row.project = new CSlfProject(name, false);
+        // the CSlfProject does not - as the other C*Project - register itself in the list
+        // of currently opened projects. This is done manually here.
+        addProject(row.project);
+        break;
 
-          if (!project->isValid()) {
-            delete project;
-            project = nullptr;
-          } else {
-            dbProject->postStatus(false);
-          }
-          break;
-        }
+      case IGisProject::eTypeFit:
+        row.project = new CFitProject(name, this);
+        break;
 
-        case IGisProject::eTypeSlf: {
-          project = new CSlfProject(name, false);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);  // (1d)
-          *project << stream;
+      case IGisProject::eTypeTcx:
+        row.project = new CTcxProject(name, this);
+        break;
 
-          // the CSlfProject does not - as the other C*Project - register itself in the list
-          // of currently opened projects. This is done manually here.
-          addProject(project);
-          break;
-        }
+      case IGisProject::eTypeSml:
+      case IGisProject::eTypeLog:
+        row.project = new CSmlProject(name, this);
+        break;
+    }
 
-        case IGisProject::eTypeFit: {
-          project = new CFitProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);
-          *project << stream;
-          break;
-        }
+    if (nullptr != row.project) {
+      // Hiding the project from the map right after construction avoids a
+      // visible `blinking` of the check mark.
+      row.project->setCheckState(CGisListDB::eColumnCheckbox, visible);
+    }
+    rows << row;
+  }
 
-        case IGisProject::eTypeTcx: {
-          project = new CTcxProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);
-          *project << stream;
-          break;
-        }
+  qDebug() << "Workspace: created" << rows.size() << "projects in" << timer.restart() << "ms";
 
-        case IGisProject::eTypeSml: {
-          project = new CSmlProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);
-          *project << stream;
-          break;
+  {  // open context for progress dialog
+    const int total = rows.size();
+    PROGRESS_SETUP(tr("Loading workspace. Please wait."), 0, 2 * total, this);
+    bool canceled = false;
+
+    // The serialized projects are decoded in parallel. This does not create
+    // any items. Thus it does not touch the workspace.
+    row_t* rowsData = rows.data();
+    QAtomicInt cnt = 0;
+    QAtomicInt abort = 0;
+    QThreadPool threadPool;
+    for (int i = 0; i < total; i++) {
+      threadPool.start([rowsData, i, &cnt, &abort]() {
+        row_t& row = rowsData[i];
+        if (row.project != nullptr && abort.loadAcquire() == 0) {
+          QDataStream stream(&row.data, QIODevice::ReadOnly);
+          stream.setVersion(QDataStream::Qt_5_2);
+          stream.setByteOrder(QDataStream::LittleEndian);
+          row.isValid = IGisProject::readSnapshot(stream, row.snapshot, row.withItems);
         }
+        row.data.clear();
+        cnt.fetchAndAddOrdered(1);
+      });
+    }
 
-        case IGisProject::eTypeLog: {
-          project = new CSmlProject(name, this);
-          project->setCheckState(CGisListDB::eColumnCheckbox, visible);
-          *project << stream;
-          break;
-        }
+    while (!threadPool.waitForDone(100)) {
+      PROGRESS(cnt.loadAcquire(), abort.storeRelease(1); canceled = true);
+    }
+
+    qDebug() << "Workspace: decoded" << total << "projects in" << timer.restart() << "ms";
+
+    // The items are tree widget items. They are created by the main thread.
+    qint32 cntPending = 0;
+    for (int i = 0; i < total; i++) {
+      row_t& row = rows[i];
+      IGisProject* project = row.project;
+      if (!canceled) {
+        PROGRESS(total + i, canceled = true);
       }
 
-      if (nullptr != project) {
-        // Hiding the individual projects from the map (1a, 1b, 1c) could be done here within a single statement,
-        // but this results in a visible `the checkbox is being unchecked`, especially in case the project
-        // is large and takes some time to load.
-        // When done directly after construction there is no `blinking` of the check mark
-
-        project->setToolTip(eColumnName, project->getInfo());
-        if (changed) {
-          project->setChanged();
+      // like before, projects not restored yet are dropped if loading is canceled
+      if (canceled) {
+        delete project;
+        continue;
+      }
+
+      if (nullptr == project) {
+        orphanedRows << row.id;
+        continue;
+      }
+
+      if (row.isValid) {
+        project->restoreSnapshot(row.snapshot);
+      }
+      row.snapshot = IGisProject::snapshot_t();
+
+      CDBProject* dbProject = dynamic_cast<CDBProject*>(project);
+      if (dbProject != nullptr) {
+        dbProject->restoreDBLink();
+
+        if (!project->isValid()) {
+          delete project;
+          orphanedRows << row.id;
+          continue;
         }
+        dbProject->postStatus(false);
+      }
+
+      project->setToolTip(eColumnName, project->getInfo());
+      if (row.changed) {
+        project->setChanged();
+      }
+      if (project->hasPendingItems()) {
+        cntPending++;
       }
+
+      // the next save has to write the project only if it is changed
+      savedProjects[project] = {row.id, getFingerprint(getProjectRow(project))};
+    }
+
+    qDebug() << "Workspace: restored" << total << "projects in" << timer.restart() << "ms," << cntPending
+             << "of them without items";
+
+    if (canceled) {
+      return;
     }
   }  // close context for progress dialog
 
+  // all rows are known now, the next save can be incremental
+  saveAll = false;
+
   slotGeoSearch(static_cast<QAction*>(CMainWindow::self().findChild<QAction*>("actionGeoSearch"))->isChecked());
 
   for (const QString& filename : qlOpts->arguments) {
@@ -902,9 +1052,25 @@ void CGisListWks::slotLoadWorkspace() {
     }
   }
 
+  // restore the items of the projects not shown on the map, too, without blocking the GUI
+  QTimer::singleShot(0, this, &CGisListWks::slotRestorePendingItems);
+
   emit sigChanged();
 }
 
+void CGisListWks::slotRestorePendingItems() {
+  const int N = topLevelItemCount();
+  for (int n = 0; n < N; n++) {
+    IGisProject* project = dynamic_cast<IGisProject*>(topLevelItem(n));
+    if (project != nullptr && project->hasPendingItems()) {
+      project->restorePendingItems();
+      // give the event loop a chance to process user input before the next project
+      QTimer::singleShot(0, this, &CGisListWks::slotRestorePendingItems);
+      return;
+    }
+  }
+}
+
 void CGisListWks::showMenuProjectWks(const QPoint& p) {
   QMenu menu(this);
   menu.addAction(actionEditPrj);
@@ -972,6 +1138,7 @@ void CGisListWks::showMenuItemTrk(const QPoint& p, const IGisItem::key_t& key) {
   menu.addAction(actionCopyTrkWithWpt);
   menu.addAction(actionToRoute);
   menu.addAction(actionNogoTrk);
+  menu.addAction(actionSeedMapCache);
   menu.addSeparator();
   menu.addAction(actionDelete);
   menu.exec(p);
@@ -1016,6 +1183,7 @@ void CGisListWks::showMenuItemRte(const QPoint& p) {
   menu.addAction(actionReverseRte);
   menu.addAction(actionRte2Trk);
   menu.addAction(actionNogoRte);
+  menu.addAction(actionSeedMapCache);
   menu.addSeparator();
   menu.addAction(actionDelete);
   menu.exec(p);
@@ -1031,6 +1199,7 @@ void CGisListWks::showMenuItemOvl(const QPoint& p) {
   menu.addSeparator();
   menu.addAction(actionEditArea);
   menu.addAction(actionNogoArea);
+  menu.addAction(actionSeedMapCache);
   menu.addSeparator();
   menu.addAction(actionDelete);
   menu.exec(p);
@@ -1465,10 +1634,15 @@ void CGisListWks::slotItemDoubleClicked(QTreeWidgetItem* item, int) {
   }
 }
 
-void CGisListWks::slotItemChanged(QTreeWidgetItem* /*item*/, int column) {
+void CGisListWks::slotItemChanged(QTreeWidgetItem* item, int column) {
   CGisListWksEditLock lock(true, IGisItem::mutexItems);
 
   if (column == eColumnCheckBox) {
+    IGisProject* project = dynamic_cast<IGisProject*>(item);
+    if (nullptr != project && project->isVisible()) {
+      project->restorePendingItems();
+    }
+
     CGisWorkspace::self().slotWksItemSelectionReset();
     emit sigChanged();
   }
@@ -1723,6 +1897,30 @@ void CGisListWks::slotEditArea() {
   }
 }
 
+void CGisListWks::slotSeedMapCache() {
+  CGisListWksEditLock lock(false, IGisItem::mutexItems);
+
+  IGisItem* gisItem = dynamic_cast<IGisItem*>(currentItem());
+  IGisLine* gisLine = dynamic_cast<IGisLine*>(currentItem());
+  if (gisItem == nullptr || gisLine == nullptr) {
+    return;
+  }
+
+  QPolygonF line;
+  gisLine->getPolylineDegFromData(line);
+  if (line.isEmpty()) {
+    return;
+  }
+  for (QPointF& pt : line) {
+    pt *= DEG_TO_RAD;
+  }
+
+  // areas are seeded as they are, tracks and routes along a corridor
+  const bool isArea = gisItem->type() == IGisItem::eTypeOvl;
+  CTileSeedDialog* dlg = new CTileSeedDialog(gisItem->getName(), line, isArea, &CMainWindow::self());
+  dlg->show();
+}
+
 void CGisListWks::slotAddEmptyProject() {
   CGisListWksEditLock lock(false, IGisItem::mutexItems);
 
@@ -1884,6 +2082,8 @@ QSet<QString> CGisListWks::getAllDeviceKeys() const {
 }
 
 void CGisListWks::syncPrjToDevices(IGisProject* project, const QSet<QString>& keys) {
+  project->restorePendingItems();
+
   const int N = topLevelItemCount();
   CCanvas* canvas = CMainWindow::self().getVisibleCanvas();
   for (int n = 0; n < N; n++) {
@@ -20,6 +20,7 @@
 #ifndef CGISLISTWKS_H
 #define CGISLISTWKS_H
 
+#include <QHash>
 #include <QPointer>
 #include <QSqlDatabase>
 #include <QTreeWidget>
@@ -32,6 +33,8 @@ class QAction;
 class CGeoSearch;
 class IGisProject;
 class CDBProject;
+class CGisListWksWriter;
+class CGisKeyIndex;
 class IDeviceWatcher;
 class QActionGroup;
 
@@ -53,6 +56,18 @@ class CGisListWks : public QTreeWidget {
   bool hasProject(IGisProject* project);
 
   IGisProject* getProjectByKey(const QString& key);
+  /**
+     @brief Get an item on the workspace or a device by its key
+
+     The lookup is done by a hash index, see CGisKeyIndex. It is kept up to date
+     with the items added, removed or moved and the keys changed.
+     If the item's project has been restored without its items, they are
+     restored first.
+
+     @param key  the item's key
+     @return A pointer to the item or nullptr.
+   */
+  IGisItem* getItemByKey(const IGisItem::key_t& key);
   CDBProject* getProjectById(quint64 id, const QString& db);
 
   bool event(QEvent* e) override;
@@ -74,6 +89,8 @@ class CGisListWks : public QTreeWidget {
 
  private slots:
   void slotSaveWorkspace();
+  /// restore the items of the next project loaded without them, one project per call
+  void slotRestorePendingItems();
   void slotContextMenu(const QPoint& point);
   void slotSaveProject();
   void slotSaveAsProject();
@@ -110,6 +127,7 @@ class CGisListWks : public QTreeWidget {
   void slotReverseRte();
   void slotRte2Trk();
   void slotEditArea();
+  void slotSeedMapCache();
   void slotAddEmptyProject();
   void slotCloseAllProjects();
   void slotGeoSearch(bool on);
@@ -176,6 +194,8 @@ class CGisListWks : public QTreeWidget {
 
   QSqlDatabase db;
 
+  CGisKeyIndex* keyIndex;
+
   QActionGroup* actionGroupSort;
   QAction* actionSave;
   QAction* actionSaveAs;
@@ -228,6 +248,7 @@ class CGisListWks : public QTreeWidget {
   QAction* actionToRoute;
 
   QAction* actionEleWptTrk;
+  QAction* actionSeedMapCache;
 
   QMenu* menuNone = nullptr;
 
@@ -236,6 +257,20 @@ class CGisListWks : public QTreeWidget {
   bool saveOnExit = true;
   qint32 saveEvery = 5;
 
+  CGisListWksWriter* writer;
+
+  /// the row of a project in the workspace table and its fingerprint as passed to the writer
+  struct saved_project_t {
+    qint64 id;
+    QByteArray fingerprint;
+  };
+  QHash<const IGisProject*, saved_project_t> savedProjects;
+  /// rows of the workspace table that do not belong to a project (anymore)
+  QList<qint64> orphanedRows;
+  qint64 nextRowId = 1;
+  /// true if the workspace table does not match savedProjects and has to be written from scratch
+  bool saveAll = true;
+
   IDeviceWatcher* deviceWatcher = nullptr;
 
   bool blockSorting = false;
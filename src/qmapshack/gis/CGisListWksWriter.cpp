@@ -0,0 +1,160 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/CGisListWksWriter.h"
+
+#include <QtSql>
+
+#include "gis/db/macros.h"
+
+#define CONNECTION "Workspace2"
+
+CGisListWksWriter::CGisListWksWriter(const QString& filename, QObject* parent)
+    : QThread(parent), filename(filename) {}
+
+CGisListWksWriter::~CGisListWksWriter() { stop(); }
+
+void CGisListWksWriter::enqueue(const job_t& job) {
+  QMutexLocker lock(&mutex);
+  if (!keepGoing) {
+    return;
+  }
+  queue.enqueue(job);
+  condition.wakeOne();
+}
+
+void CGisListWksWriter::flush() {
+  QMutexLocker lock(&mutex);
+  while ((!queue.isEmpty() || busy) && isRunning()) {
+    conditionIdle.wait(&mutex, 100);
+  }
+}
+
+void CGisListWksWriter::stop() {
+  {
+    QMutexLocker lock(&mutex);
+    keepGoing = false;
+    condition.wakeOne();
+  }
+  wait();
+}
+
+void CGisListWksWriter::run() {
+  {  // open context for the database connection
+    QSqlDatabase db;
+    while (1) {
+      job_t job;
+      {
+        QMutexLocker lock(&mutex);
+        busy = false;
+        if (queue.isEmpty()) {
+          conditionIdle.wakeAll();
+        }
+        while (queue.isEmpty() && keepGoing) {
+          condition.wait(&mutex);
+        }
+
+        // stop only after all pending jobs have been written
+        if (queue.isEmpty()) {
+          break;
+        }
+        job = queue.dequeue();
+        busy = true;
+      }
+
+      if (!open(db) || !write(db, job)) {
+        emit sigFailed();
+      }
+    }
+    db.close();
+  }  // close context for the database connection
+
+  // the connection must not be in use anymore when it is removed
+  if (QSqlDatabase::contains(CONNECTION)) {
+    QSqlDatabase::removeDatabase(CONNECTION);
+  }
+}
+
+bool CGisListWksWriter::open(QSqlDatabase& db) {
+  if (db.isOpen()) {
+    return true;
+  }
+
+  db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION);
+  db.setDatabaseName(filename);
+  if (!db.open()) {
+    qWarning() << "Failed to open workspace database:" << db.lastError();
+    return false;
+  }
+
+  // the same setup as the connection of CGisListWks
+  QSqlQuery query(db);
+  QUERY_RUN("PRAGMA locking_mode=EXCLUSIVE", return false)
+  QUERY_RUN("PRAGMA synchronous=OFF", return false)
+  QUERY_RUN("PRAGMA temp_store=MEMORY", return false)
+  QUERY_RUN("PRAGMA default_cache_size=50", return false)
+  return true;
+}
+
+bool CGisListWksWriter::write(QSqlDatabase& db, const job_t& job) {
+  QSqlQuery query(db);
+
+  QUERY_RUN("BEGIN TRANSACTION;", return false)
+
+  try {
+    if (job.removeAll) {
+      QUERY_RUN("DELETE FROM workspace", throw -1)
+    }
+
+    query.prepare("DELETE FROM workspace WHERE id=:id");
+    for (qint64 id : job.removed) {
+      query.bindValue(":id", id);
+      QUERY_EXEC(throw -1)
+    }
+
+    query.prepare(
+        "INSERT OR REPLACE INTO workspace (id, type, keyqms, name, changed, visible, data) VALUES (:id, :type, "
+        ":keyqms, :name, :changed, :visible, :data)");
+    for (const project_t& project : job.projects) {
+      QByteArray data;
+      QDataStream stream(&data, QIODevice::WriteOnly);
+      stream.setVersion(QDataStream::Qt_5_2);
+      stream.setByteOrder(QDataStream::LittleEndian);
+      stream << project.snapshot;
+
+      query.bindValue(":id", project.id);
+      query.bindValue(":type", project.type);
+      query.bindValue(":keyqms", project.key);
+      query.bindValue(":name", project.name);
+      query.bindValue(":changed", project.changed);
+      query.bindValue(":visible", project.visible);
+      query.bindValue(":data", data);
+      QUERY_EXEC(throw -1)
+    }
+
+    query.prepare("UPDATE userfocus set focus=:focus");
+    query.bindValue(":focus", job.userFocus);
+    QUERY_EXEC(throw -1)
+  } catch (int) {
+    QUERY_RUN("ROLLBACK;", NO_CMD)
+    return false;
+  }
+
+  QUERY_RUN("COMMIT;", return false)
+  return true;
+}
@@ -0,0 +1,105 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CGISLISTWKSWRITER_H
+#define CGISLISTWKSWRITER_H
+
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "gis/prj/IGisProject.h"
+
+class QSqlDatabase;
+
+/**
+   @brief Write-behind queue for the workspace database
+
+   The GUI thread takes snapshots of the changed projects and passes them to
+   this thread. The thread serializes the projects and writes them with a
+   single transaction. Thus the GUI is not blocked while the workspace is saved.
+
+   The thread uses a database connection of its own. It is opened with the first
+   job. As the workspace database is locked exclusively, all other connections
+   have to be closed by then.
+ */
+class CGisListWksWriter : public QThread {
+  Q_OBJECT
+ public:
+  CGisListWksWriter(const QString& filename, QObject* parent);
+  virtual ~CGisListWksWriter();
+
+  /// a row of the workspace table
+  struct project_t {
+    qint64 id = 0;
+    qint32 type = 0;
+    QString key;
+    QString name;
+    bool changed = false;
+    bool visible = true;
+    IGisProject::snapshot_t snapshot;
+  };
+
+  struct job_t {
+    bool removeAll = false;     //< remove all rows before writing the projects
+    QList<qint64> removed;      //< the ids of rows to remove
+    QList<project_t> projects;  //< the rows to insert or replace
+    QString userFocus;
+  };
+
+  void enqueue(const job_t& job);
+
+  /**
+     @brief Write all queued jobs
+
+     This will block until the queue is empty and the last job is written. The
+     thread keeps running for later jobs.
+   */
+  void flush();
+
+  /**
+     @brief Write all queued jobs and stop the thread for good
+
+     Jobs queued after this are not written.
+   */
+  void stop();
+
+ signals:
+  /// a job failed and has been rolled back, the database does not match the workspace
+  void sigFailed();
+
+ protected:
+  void run() override;
+
+ private:
+  bool open(QSqlDatabase& db);
+  bool write(QSqlDatabase& db, const job_t& job);
+
+  const QString filename;
+
+  QMutex mutex;
+  QWaitCondition condition;
+  /// signaled when the queue is empty and no job is written
+  QWaitCondition conditionIdle;
+  QQueue<job_t> queue;
+  bool keepGoing = true;
+  bool busy = false;  //< a job is written right now
+};
+
+#endif  // CGISLISTWKSWRITER_H
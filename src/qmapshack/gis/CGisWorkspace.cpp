@@ -323,22 +323,57 @@ IGisProject* CGisWorkspace::selectProject(bool forceSelect) {
   return project;
 }
 
-void CGisWorkspace::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items) {
-  QMutexLocker lock(&IGisItem::mutexItems);
+// the path of child indices from the top level item down to the item
+static QVector<qint32> getTreePath(const QTreeWidgetItem* item) {
+  QVector<qint32> path;
+  for (; item->parent() != nullptr; item = item->parent()) {
+    path.prepend(item->parent()->indexOfChild(const_cast<QTreeWidgetItem*>(item)));
+  }
+  path.prepend(item->treeWidget()->indexOfTopLevelItem(const_cast<QTreeWidgetItem*>(item)));
+  return path;
+}
 
-  for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
-    QTreeWidgetItem* item = treeWks->topLevelItem(i);
-    IGisProject* project = dynamic_cast<IGisProject*>(item);
-    if (project) {
-      project->getItemsByPos(pos, items);
-      continue;
+// items found by the spatial index are in random order, restore the order of the workspace
+static void sortByTreeOrder(QList<IGisItem*>& items) {
+  if (items.size() < 2) {
+    return;
+  }
+
+  QList<QPair<QVector<qint32>, IGisItem*>> paths;
+  for (IGisItem* item : qAsConst(items)) {
+    paths << qMakePair(getTreePath(item), item);
+  }
+  std::sort(paths.begin(), paths.end(),
+            [](const QPair<QVector<qint32>, IGisItem*>& p1, const QPair<QVector<qint32>, IGisItem*>& p2) {
+              return p1.first < p2.first;
+            });
+
+  items.clear();
+  for (const QPair<QVector<qint32>, IGisItem*>& path : qAsConst(paths)) {
+    items << path.second;
+  }
+}
+
+void CGisWorkspace::getItemsByPos(const QPointF& pos, CGisDraw* gis, QList<IGisItem*>& items) {
+  // the area in geo coordinates covered by the tolerance of IGisItem::isCloseTo()
+  constexpr qreal kTolerance = 22;
+  QPolygonF area;
+  for (qreal dy : {-kTolerance, 0.0, kTolerance}) {
+    for (qreal dx : {-kTolerance, 0.0, kTolerance}) {
+      QPointF pt = pos + QPointF(dx, dy);
+      gis->convertPx2Rad(pt);
+      area << pt;
     }
-    IDevice* device = dynamic_cast<IDevice*>(item);
-    if (device) {
-      device->getItemsByPos(pos, items);
-      continue;
+  }
+
+  QList<IGisItem*> candidates;
+  IGisItem::getItemsByRect(area.boundingRect(), candidates);
+  for (IGisItem* item : qAsConst(candidates)) {
+    if (isVisibleOnWorkspace(item) && item->isCloseTo(pos)) {
+      items << item;
     }
   }
+  sortByTreeOrder(items);
 
   /*
       If there is an item selected by the workspace limit
@@ -357,7 +392,6 @@ void CGisWorkspace::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items) {
 }
 
 void CGisWorkspace::getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisItem*>& items) {
-  QMutexLocker lock(&IGisItem::mutexItems);
   for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
     QTreeWidgetItem* item = treeWks->topLevelItem(i);
     IGisProject* project = dynamic_cast<IGisProject*>(item);
@@ -374,20 +408,25 @@ void CGisWorkspace::getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGi
 }
 
 void CGisWorkspace::getItemsByArea(const QRectF& area, IGisItem::selflags_t flags, QList<IGisItem*>& items) {
-  QMutexLocker lock(&IGisItem::mutexItems);
-  for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
-    QTreeWidgetItem* item = treeWks->topLevelItem(i);
-    IGisProject* project = dynamic_cast<IGisProject*>(item);
-    if (project) {
-      project->getItemsByArea(area, flags, items);
-      continue;
-    }
-    IDevice* device = dynamic_cast<IDevice*>(item);
-    if (device) {
-      device->getItemsByArea(area, flags, items);
-      continue;
+  const QRectF& rect = area.normalized();
+
+  QList<IGisItem*> candidates;
+  IGisItem::getItemsByRect(QRectF(rect.topLeft() * DEG_TO_RAD, rect.bottomRight() * DEG_TO_RAD), candidates);
+  for (IGisItem* item : qAsConst(candidates)) {
+    if (isVisibleOnWorkspace(item) && item->isWithin(area, flags)) {
+      items << item;
     }
   }
+  sortByTreeOrder(items);
+}
+
+bool CGisWorkspace::isVisibleOnWorkspace(IGisItem* item) const {
+  if (item->isHidden() || item->treeWidget() != treeWks) {
+    return false;
+  }
+
+  const IGisProject* project = item->getParentProject();
+  return project != nullptr && project->isVisible();
 }
 
 void CGisWorkspace::getNogoAreas(QList<IGisItem*>& nogos) {
@@ -408,7 +447,6 @@ void CGisWorkspace::getNogoAreas(QList<IGisItem*>& nogos) {
 }
 
 void CGisWorkspace::mouseMove(const QPointF& pos) {
-  QMutexLocker lock(&IGisItem::mutexItems);
   for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
     QTreeWidgetItem* item = treeWks->topLevelItem(i);
     IGisProject* project = dynamic_cast<IGisProject*>(item);
@@ -419,40 +457,7 @@ void CGisWorkspace::mouseMove(const QPointF& pos) {
   }
 }
 
-IGisItem* CGisWorkspace::getItemByKey(const IGisItem::key_t& key) {
-  IGisItem* item = nullptr;
-  QMutexLocker lock(&IGisItem::mutexItems);
-  for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
-    QTreeWidgetItem* item1 = treeWks->topLevelItem(i);
-    IGisProject* project = dynamic_cast<IGisProject*>(item1);
-    if (project) {
-      if (project->getKey() != key.project) {
-        continue;
-      }
-
-      item = project->getItemByKey(key);
-      if (nullptr != item) {
-        break;
-      }
-
-      continue;
-    }
-
-    IDevice* device = dynamic_cast<IDevice*>(item1);
-    if (device) {
-      if (device->getKey() != key.device) {
-        continue;
-      }
-
-      item = device->getItemByKey(key);
-      if (nullptr != item) {
-        break;
-      }
-    }
-  }
-
-  return item;
-}
+IGisItem* CGisWorkspace::getItemByKey(const IGisItem::key_t& key) { return treeWks->getItemByKey(key); }
 
 void CGisWorkspace::delItemByKey(const IGisItem::key_t& key) {
   QMutexLocker lock(&IGisItem::mutexItems);
@@ -1101,13 +1106,18 @@ void CGisWorkspace::draw(QPainter& p, const QPolygonF& viewport, CGisDraw* gis)
   QFontMetricsF fm(CMainWindow::self().getMapFont());
   QList<QRectF> blockedAreas;
 
-  QMutexLocker lock(&IGisItem::mutexItems);
+  // The items are locked for one project or device at a time. Thus an edit does
+  // not wait for the complete pass. A change in between triggers a new pass anyway.
   // draw mandatory stuff first
-  for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
+  for (int i = 0;; i++) {
     if (gis->needsRedraw()) {
       break;
     }
 
+    QMutexLocker lock(&IGisItem::mutexItems);
+    if (i >= treeWks->topLevelItemCount()) {
+      break;
+    }
     QTreeWidgetItem* item = treeWks->topLevelItem(i);
 
     IGisProject* project = dynamic_cast<IGisProject*>(item);
@@ -1123,11 +1133,15 @@ void CGisWorkspace::draw(QPainter& p, const QPolygonF& viewport, CGisDraw* gis)
   }
 
   // draw optional labels second
-  for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
+  for (int i = 0;; i++) {
     if (gis->needsRedraw()) {
       break;
     }
 
+    QMutexLocker lock(&IGisItem::mutexItems);
+    if (i >= treeWks->topLevelItemCount()) {
+      break;
+    }
     QTreeWidgetItem* item = treeWks->topLevelItem(i);
 
     IGisProject* project = dynamic_cast<IGisProject*>(item);
@@ -1144,11 +1158,9 @@ void CGisWorkspace::draw(QPainter& p, const QPolygonF& viewport, CGisDraw* gis)
 }
 
 void CGisWorkspace::fastDraw(QPainter& p, const QRectF& viewport, CGisDraw* gis) {
-  /*
-      Mutex locking will make map moving very slow if there are many GIS items
-      visible. Remove it for now. But I am not sure if that is a good idea.
-   */
-  // QMutexLocker lock(&IGisItem::mutexItems);
+  // No lock needed, see IGisItem::mutexItems. The fast draw runs in the main
+  // thread, which is the only one to change items. The screen coordinates are
+  // read from the snapshots published by the last draw pass.
   for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
     QTreeWidgetItem* item = treeWks->topLevelItem(i);
 
@@ -1174,7 +1186,6 @@ void CGisWorkspace::fastDraw(QPainter& p, const QRectF& viewport, CGisDraw* gis)
 }
 
 bool CGisWorkspace::findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qint32 threshold, QPolygonF& polyline) {
-  QMutexLocker lock(&IGisItem::mutexItems);
   for (int i = 0; i < treeWks->topLevelItemCount(); i++) {
     QTreeWidgetItem* item1 = treeWks->topLevelItem(i);
     IGisProject* project = dynamic_cast<IGisProject*>(item1);
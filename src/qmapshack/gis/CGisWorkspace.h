@@ -221,15 +221,24 @@ class CGisWorkspace : public QWidget, private Ui::IGisWorkspace {
      Note: Do not store the pointers of items permanently as they can become invalid
      once you reach the main event loop again. Store the key instead.
 
+     The candidates are taken from the spatial index of all items (see
+     IGisItem::getItemsByRect()). Thus only items close by are tested in detail.
+     The test uses the screen coordinates of the last draw pass. It does not lock
+     IGisItem::mutexItems and thus does not wait for the draw thread. Call it from
+     the main thread only.
+
      @param pos       the position in pixel
+     @param gis       the draw context to convert the position to geo coordinates
      @param items     an empty item list that will get filled with temporary pointers
    */
-  void getItemsByPos(const QPointF& pos, QList<IGisItem*>& items);
+  void getItemsByPos(const QPointF& pos, CGisDraw* gis, QList<IGisItem*>& items);
 
   /**
      @brief Get items matching the given area
 
-     @param area      a rectangle in screen pixel coordinates
+     Like getItemsByPos() the candidates are taken from the spatial index of all items.
+
+     @param area      a rectangle in geo coordinates [deg]
      @param flags     flag field with IGisItem::selection_e flags set
      @param items     a list to receive the temporary pointers to the found items
    */
@@ -237,6 +246,10 @@ class CGisWorkspace : public QWidget, private Ui::IGisWorkspace {
 
   /**
      @brief Find first item with matching key
+
+     Like getItemsByPos() this does not lock IGisItem::mutexItems. Call it from
+     the main thread only. The item is looked up by the key index of the item list.
+
      @param key       the item's key as it is returned from IGisItem::getKey()
      @return If no item is found 0 is returned.
    */
@@ -415,6 +428,9 @@ class CGisWorkspace : public QWidget, private Ui::IGisWorkspace {
 
   static CGisWorkspace* pSelf;
 
+  /// true if the item is shown by a visible project of the workspace
+  bool isVisibleOnWorkspace(IGisItem* item) const;
+
   /**
       The item key of last item pressed in the workspace list.
       The key will be reset by getItemsByPos() which is used by
@@ -36,18 +36,26 @@
 #include "gis/rte/CGisItemRte.h"
 #include "gis/trk/CGisItemTrk.h"
 #include "gis/wpt/CGisItemWpt.h"
+#include "helpers/CRTree.h"
 #include "helpers/CSettings.h"
 #include "misc.h"
 #include "units/IUnit.h"
 
 QRecursiveMutex IGisItem::mutexItems;
 
+QSet<const QTreeWidgetItem*> IGisItem::keysChanged;
+QMutex IGisItem::mutexKeysChanged;
+
 const QString IGisItem::noKey;
 
 const QString IGisItem::noName = IGisItem::tr("[no name]");
 
 QVector<IGisItem::color_t> IGisItem::colorMap;
 
+// the spatial index of all items, see getItemsByRect()
+static QMutex mutexItemIndex;
+static CRTree<IGisItem*> itemIndex;
+
 IGisItem::IGisItem(IGisProject* parent, type_e typ, int idx) : QTreeWidgetItem(parent, typ) {
   int n = -1;
   setFlags(QTreeWidgetItem::flags() & ~Qt::ItemIsDropEnabled);
@@ -120,7 +128,27 @@ IGisItem::IGisItem(IGisProject* parent, type_e typ, int idx) : QTreeWidgetItem(p
   }
 }
 
-IGisItem::~IGisItem() {}
+IGisItem::~IGisItem() {
+  removeFromIndex();
+  keyDestroyed(this);
+}
+
+void IGisItem::keyChanged(const QTreeWidgetItem* item) {
+  QMutexLocker lock(&mutexKeysChanged);
+  keysChanged.insert(item);
+}
+
+void IGisItem::keyDestroyed(const QTreeWidgetItem* item) {
+  QMutexLocker lock(&mutexKeysChanged);
+  keysChanged.remove(item);
+}
+
+QSet<const QTreeWidgetItem*> IGisItem::takeKeysChanged() {
+  QMutexLocker lock(&mutexKeysChanged);
+  QSet<const QTreeWidgetItem*> items;
+  items.swap(keysChanged);
+  return items;
+}
 
 void IGisItem::init() {
   colorMap = {{"Black", tr("Black"), QColor(Qt::black), QString("://icons/8x8/bullet_black.png"),
@@ -194,6 +222,43 @@ QMenu* IGisItem::getColorMenu(const QString& title, QObject* obj, const char* sl
   return menu;
 }
 
+void IGisItem::getItemsByRect(const QRectF& rect, QList<IGisItem*>& items) {
+  QList<IGisItem*> found;
+  {
+    QMutexLocker lock(&mutexItemIndex);
+    itemIndex.search(rect, found);
+  }
+
+  // an item indexed by several rectangles is found several times
+  QSet<IGisItem*> seen;
+  for (IGisItem* item : qAsConst(found)) {
+    if (!seen.contains(item)) {
+      seen << item;
+      items << item;
+    }
+  }
+}
+
+void IGisItem::setBoundingRect(const QRectF& rect, const QVector<QRectF>& parts) {
+  boundingRect = rect;
+
+  removeFromIndex();
+  rectsIndexed = parts.isEmpty() ? QVector<QRectF>({rect}) : parts;
+
+  QMutexLocker lock(&mutexItemIndex);
+  for (const QRectF& r : qAsConst(rectsIndexed)) {
+    itemIndex.insert(r, this);
+  }
+}
+
+void IGisItem::removeFromIndex() {
+  QMutexLocker lock(&mutexItemIndex);
+  for (const QRectF& r : qAsConst(rectsIndexed)) {
+    itemIndex.remove(r, this);
+  }
+  rectsIndexed.clear();
+}
+
 IGisProject* IGisItem::getParentProject() const { return dynamic_cast<IGisProject*>(parent()); }
 
 void IGisItem::genKey() const {
@@ -208,11 +273,13 @@ void IGisItem::genKey() const {
     QCryptographicHash md5(QCryptographicHash::Md5);
     md5.addData(buffer);
     key.item = md5.result().toHex();
+    keyChanged(this);
   }
   if (key.project.isEmpty()) {
     IGisProject* project = getParentProject();
     if (project) {
       key.project = project->getKey();
+      keyChanged(this);
     }
   }
 }
@@ -244,6 +311,7 @@ void IGisItem::loadFromDb(quint64 id, QSqlDatabase& db) {
         key.item = keyFromDB;
         updateHistory();
       }
+      keyChanged(this);
     }
 
     lastDatabaseHash = query.value(2).toString();
@@ -350,6 +418,186 @@ void IGisItem::updateDecoration(quint32 enable, quint32 disable) {
   }
 }
 
+// a delta is used if it's less than 1/HISTORY_DELTA_RATIO of the full data
+#define HISTORY_DELTA_RATIO 4
+// the size of the blocks matched between the full data and the data
+#define HISTORY_BLOCK_SIZE 64
+
+static quint32 hashBlock(const char* data) {
+  quint32 hash = 0;
+  for (qint32 i = 0; i < HISTORY_BLOCK_SIZE; i++) {
+    hash = hash * 31 + quint8(data[i]);
+  }
+  return hash;
+}
+
+/*
+    A delta is a sequence of operations. Each one appends some literal bytes and
+    then copies a range of the full event's data. Blocks of the full data are
+    found by a rolling hash over the new data, like rsync does. Most edits are
+    local, like moving or deleting a few points of a track. Thus most of the
+    data is copied and the delta is small compared to the complete item.
+ */
+static QByteArray makeDelta(const QByteArray& base, const QByteArray& data) {
+  QByteArray delta;
+  QDataStream stream(&delta, QIODevice::WriteOnly);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setVersion(QDataStream::Qt_5_2);
+
+  const char* pBase = base.constData();
+  const char* pData = data.constData();
+  const qint32 sizeBase = base.size();
+  const qint32 sizeData = data.size();
+
+  QHash<quint32, qint32> blocks;
+  for (qint32 off = 0; off + HISTORY_BLOCK_SIZE <= sizeBase; off += HISTORY_BLOCK_SIZE) {
+    const quint32 hash = hashBlock(pBase + off);
+    if (!blocks.contains(hash)) {
+      blocks.insert(hash, off);
+    }
+  }
+
+  // 31^(HISTORY_BLOCK_SIZE - 1) to remove the oldest byte from the rolling hash
+  quint32 power = 1;
+  for (qint32 i = 1; i < HISTORY_BLOCK_SIZE; i++) {
+    power *= 31;
+  }
+
+  qint32 pos = 0;
+  qint32 literal = 0;
+  quint32 hash = sizeData >= HISTORY_BLOCK_SIZE ? hashBlock(pData) : 0;
+  while (!blocks.isEmpty() && pos + HISTORY_BLOCK_SIZE <= sizeData) {
+    qint32 off = blocks.value(hash, NOIDX);
+    if (off != NOIDX && memcmp(pBase + off, pData + pos, HISTORY_BLOCK_SIZE) == 0) {
+      // extend the match in both directions
+      qint32 len = HISTORY_BLOCK_SIZE;
+      while (pos + len < sizeData && off + len < sizeBase && pBase[off + len] == pData[pos + len]) {
+        len++;
+      }
+      while (pos > literal && off > 0 && pBase[off - 1] == pData[pos - 1]) {
+        pos--;
+        off--;
+        len++;
+      }
+
+      stream << data.mid(literal, pos - literal) << off << len;
+      pos += len;
+      literal = pos;
+      if (pos + HISTORY_BLOCK_SIZE <= sizeData) {
+        hash = hashBlock(pData + pos);
+      }
+    } else if (pos + HISTORY_BLOCK_SIZE < sizeData) {
+      hash = (hash - quint8(pData[pos]) * power) * 31 + quint8(pData[pos + HISTORY_BLOCK_SIZE]);
+      pos++;
+    } else {
+      break;
+    }
+  }
+
+  stream << data.mid(literal) << qint32(0) << qint32(0);
+  return delta;
+}
+
+static QByteArray applyDelta(const QByteArray& base, const QByteArray& delta) {
+  QDataStream stream(delta);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setVersion(QDataStream::Qt_5_2);
+
+  QByteArray data;
+  data.reserve(base.size());
+  while (!stream.atEnd()) {
+    QByteArray literal;
+    qint32 off;
+    qint32 len;
+    stream >> literal >> off >> len;
+    if (stream.status() != QDataStream::Ok || off < 0 || len < 0 || off + len > base.size()) {
+      return QByteArray();
+    }
+
+    data.append(literal);
+    data.append(base.constData() + off, len);
+  }
+  return data;
+}
+
+QByteArray IGisItem::history_t::getData(qint32 idx) const {
+  const history_event_t& event = events[idx];
+  if (!event.isDelta) {
+    return event.data;
+  }
+
+  const qint32 base = getBase(idx);
+  return base == NOIDX ? QByteArray() : applyDelta(events[base].data, event.data);
+}
+
+void IGisItem::history_t::setData(qint32 idx, const QByteArray& data) {
+  const QList<QPair<qint32, QByteArray>>& dependents = takeDependents(idx);
+  encode(idx, data);
+  for (const QPair<qint32, QByteArray>& dependent : dependents) {
+    encode(dependent.first, dependent.second);
+  }
+}
+
+void IGisItem::history_t::clearData(qint32 idx) {
+  const QList<QPair<qint32, QByteArray>>& dependents = takeDependents(idx);
+  events[idx].data.clear();
+  events[idx].isDelta = false;
+  for (const QPair<qint32, QByteArray>& dependent : dependents) {
+    encode(dependent.first, dependent.second);
+  }
+}
+
+void IGisItem::history_t::compress() {
+  // setData() re-encodes the deltas based on a full event turned into a delta
+  for (qint32 idx = 0; idx < events.size(); idx++) {
+    if (!events[idx].isDelta && !events[idx].data.isEmpty()) {
+      const QByteArray data = events[idx].data;
+      setData(idx, data);
+    }
+  }
+}
+
+qint32 IGisItem::history_t::getBase(qint32 idx) const {
+  for (qint32 i = idx - 1; i >= 0; i--) {
+    if (!events[i].isDelta && !events[i].data.isEmpty()) {
+      return i;
+    }
+  }
+  return NOIDX;
+}
+
+QList<QPair<qint32, QByteArray>> IGisItem::history_t::takeDependents(qint32 idx) const {
+  // all deltas up to the next full event might get a different base if this event changes
+  QList<QPair<qint32, QByteArray>> dependents;
+  for (qint32 i = idx + 1; i < events.size(); i++) {
+    if (!events[i].isDelta) {
+      if (events[i].data.isEmpty()) {
+        continue;
+      }
+      break;
+    }
+    dependents << qMakePair(i, getData(i));
+  }
+  return dependents;
+}
+
+void IGisItem::history_t::encode(qint32 idx, const QByteArray& data) {
+  history_event_t& event = events[idx];
+
+  const qint32 base = getBase(idx);
+  if (base != NOIDX && !data.isEmpty()) {
+    const QByteArray& delta = makeDelta(events[base].data, data);
+    if (delta.size() * HISTORY_DELTA_RATIO < data.size()) {
+      event.data = delta;
+      event.isDelta = true;
+      return;
+    }
+  }
+
+  event.data = data;
+  event.isDelta = false;
+}
+
 void IGisItem::changed(const QString& what, const QString& icon) {
   /*
       If item gets changed but if it's origin is not QMapShack
@@ -373,17 +621,19 @@ void IGisItem::changed(const QString& what, const QString& icon) {
   event.icon = icon;
   event.who = CMainWindow::getUser();
 
-  QDataStream stream(&event.data, QIODevice::WriteOnly);
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
   stream.setByteOrder(QDataStream::LittleEndian);
   stream.setVersion(QDataStream::Qt_5_2);
 
   *this >> stream;
 
   QCryptographicHash md5(QCryptographicHash::Md5);
-  md5.addData(event.data);
+  md5.addData(data);
   event.hash = md5.result().toHex();
 
   history.histIdxCurrent = history.events.size() - 1;
+  history.setData(history.histIdxCurrent, data);
 
   updateDecoration(eMarkChanged, eMarkNone);
 }
@@ -393,18 +643,17 @@ void IGisItem::updateHistory() {
     return;
   }
 
-  history_event_t& event = history.events[history.histIdxCurrent];
-  event.data.clear();
-
-  QDataStream stream(&event.data, QIODevice::WriteOnly);
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
   stream.setByteOrder(QDataStream::LittleEndian);
   stream.setVersion(QDataStream::Qt_5_2);
 
   *this >> stream;
 
   QCryptographicHash md5(QCryptographicHash::Md5);
-  md5.addData(event.data);
-  event.hash = md5.result().toHex();
+  md5.addData(data);
+  history.events[history.histIdxCurrent].hash = md5.result().toHex();
+  history.setData(history.histIdxCurrent, data);
 
   updateDecoration(eMarkChanged, eMarkNone);
 }
@@ -434,18 +683,18 @@ void IGisItem::setupHistory() {
   // if no initial item can be found fill the last item with data
   // and make it the initial item
   if (history.histIdxInitial == NOIDX) {
-    history_event_t& event = history.events.last();
-
-    QDataStream stream(&event.data, QIODevice::WriteOnly);
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
     stream.setByteOrder(QDataStream::LittleEndian);
     stream.setVersion(QDataStream::Qt_5_2);
     *this >> stream;
 
     QCryptographicHash md5(QCryptographicHash::Md5);
-    md5.addData(event.data);
-    event.hash = md5.result().toHex();
+    md5.addData(data);
+    history.events.last().hash = md5.result().toHex();
 
     history.histIdxInitial = history.events.size() - 1;
+    history.setData(history.histIdxInitial, data);
   }
 
   history.histIdxCurrent = history.events.size() - 1;
@@ -457,18 +706,19 @@ void IGisItem::loadHistory(int idx) {
     return;
   }
 
-  history_event_t& event = history.events[idx];
-
   // test for no data
-  if (event.data.isEmpty()) {
+  QByteArray data = history.getData(idx);
+  if (data.isEmpty()) {
     return;
   }
 
   // restore item from history entry
-  QDataStream stream(&event.data, QIODevice::ReadOnly);
+  QDataStream stream(&data, QIODevice::ReadOnly);
   stream.setByteOrder(QDataStream::LittleEndian);
   stream.setVersion(QDataStream::Qt_5_2);
   *this << stream;
+  // the restored entry might have been stored with another key
+  keyChanged(this);
 
   history.histIdxCurrent = idx;
 }
@@ -481,7 +731,7 @@ void IGisItem::cutHistoryAfter() {
 
 void IGisItem::cutHistoryBefore() {
   for (int i = 0; i < history.histIdxCurrent; i++) {
-    history.events[i].data.clear();
+    history.clearData(i);
   }
 }
 
@@ -498,6 +748,10 @@ void IGisItem::squashHistory() {
   last.icon = first.icon;
   last.comment = first.comment;
 
+  // the last event will be the only one, thus it has to be a full event
+  last.data = history.getData(history.events.size() - 1);
+  last.isDelta = false;
+
   history.histIdxCurrent = 0;
   history.histIdxInitial = 0;
 
@@ -27,6 +27,7 @@
 #include <QMap>
 #include <QMutex>
 #include <QPainter>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QTreeWidgetItem>
@@ -52,9 +53,22 @@ class IGisItem : public QTreeWidgetItem {
     QString who = "QMapShack";
     QString icon;
     QString comment;
+    /// the serialized item or a delta to it, empty if the event has no data
     QByteArray data;
+    /// true if data is a delta to the data of the closest full event before
+    bool isDelta = false;
   };
 
+  /**
+     @brief The history of an item
+
+     Each event's data is either the complete serialization of the item (a full
+     event) or a delta to the data of the closest full event before. A delta is
+     just used if it is much smaller. As deltas are not stacked, getting the data
+     of an event never takes more than applying one delta.
+
+     Always use getData() and setData() to access an event's data.
+   */
   struct history_t {
     history_t() : histIdxInitial(NOIDX), histIdxCurrent(NOIDX) {}
 
@@ -64,9 +78,23 @@ class IGisItem : public QTreeWidgetItem {
       events.clear();
     }
 
+    /// get the serialized item of an event, empty if the event has no data
+    QByteArray getData(qint32 idx) const;
+    /// set the serialized item of an event, events depending on it are updated
+    void setData(qint32 idx, const QByteArray& data);
+    /// drop the data of an event, events depending on it are updated
+    void clearData(qint32 idx);
+    /// store the data of all full events as delta, if possible
+    void compress();
+
     qint32 histIdxInitial;
     qint32 histIdxCurrent;
     QList<history_event_t> events;
+
+   private:
+    qint32 getBase(qint32 idx) const;
+    QList<QPair<qint32, QByteArray>> takeDependents(qint32 idx) const;
+    void encode(qint32 idx, const QByteArray& data);
   };
 
   struct link_t {
@@ -170,9 +198,35 @@ class IGisItem : public QTreeWidgetItem {
   IGisItem(IGisProject* parent, type_e typ, int idx);
   virtual ~IGisItem();
 
-  /// this mutex has to be locked when ever the item list is accessed.
+  /**
+     @brief Serialize changes of items with the draw thread
+
+     Items and the workspace's item list are changed by the main thread only. It
+     has to lock this mutex while doing so. The draw thread locks it while drawing
+     a project or device, not for the full pass. Thus the main thread can read
+     items without the lock and does not wait for the draw thread, e.g. while
+     testing items under the mouse cursor or during the fast draw.
+
+     Data written by the draw thread and read by the main thread, like the screen
+     coordinates of a track line, is published as a CSnapshot instead. The fast
+     draw takes the lines from these snapshots.
+   */
   static QRecursiveMutex mutexItems;
 
+  /**
+     @brief Report the change of an item's or a project's key to the key index
+
+     Call this each time a key is set or cleared. The index updates just this
+     item or project, see CGisKeyIndex.
+
+     @param item  the item or project with the changed key
+   */
+  static void keyChanged(const QTreeWidgetItem* item);
+  /// to be called by the destructor of items and projects
+  static void keyDestroyed(const QTreeWidgetItem* item);
+  /// get and clear the items and projects passed to keyChanged() since the last call
+  static QSet<const QTreeWidgetItem*> takeKeysChanged();
+
   static void init();
   static QMenu* getColorMenu(const QString& title, QObject* obj, const char* slot, QWidget* parent);
   static qint32 selectColor(QWidget* parent);
@@ -292,6 +346,18 @@ class IGisItem : public QTreeWidgetItem {
    */
   virtual const QRectF& getBoundingRect() const { return boundingRect; }
 
+  /**
+     @brief Get all items with a bounding rectangle intersecting with a rectangle
+
+     All items are kept in a spatial index, no matter if they are on the workspace
+     or not. The index is updated each time an item sets its bounding rectangle.
+     The index just finds candidates. It's up to the caller to test them in detail.
+
+     @param rect    the rectangle [rad]
+     @param items   a list to append each item found once
+   */
+  static void getItemsByRect(const QRectF& rect, QList<IGisItem*>& items);
+
   /**
      @brief Get screen option object to display and handle actions for this item.
      @param mouse     a pointer to the mouse object initiating the action
@@ -552,6 +618,13 @@ class IGisItem : public QTreeWidgetItem {
   bool isVisible(const QPointF& point, const QPolygonF& viewport, CGisDraw* gis);
   bool isWithin(const QRectF& area, selflags_t flags, const QPolygonF& points);
   void setNogoFlag(bool yes);
+  /**
+     @brief Set the bounding rectangle and update the spatial index
+
+     @param rect    the new bounding rectangle [rad]
+     @param parts   rectangles covering parts of the item [rad], if given the item is indexed by them instead of rect
+   */
+  void setBoundingRect(const QRectF& rect, const QVector<QRectF>& parts = QVector<QRectF>());
 
   /**
      @brief Converts a string with HTML tags to a string without HTML depending on the device
@@ -593,9 +666,21 @@ class IGisItem : public QTreeWidgetItem {
 
  private:
   void showIcon();
+  void removeFromIndex();
+
+  /// the rectangles the item is registered with in the spatial index
+  QVector<QRectF> rectsIndexed;
+
+  /// the items and projects passed to keyChanged(), removed by keyDestroyed()
+  static QSet<const QTreeWidgetItem*> keysChanged;
+  static QMutex mutexKeysChanged;
 };
 
 QDataStream& operator>>(QDataStream& stream, IGisItem::history_t& h);
 QDataStream& operator<<(QDataStream& stream, const IGisItem::history_t& h);
 
+inline uint qHash(const IGisItem::key_t& key, uint seed = 0) {
+  return qHash(key.item, seed) ^ qHash(key.project, seed) ^ qHash(key.device, seed);
+}
+
 #endif  // IGISITEM_H
@@ -38,15 +38,28 @@ SGisLine::SGisLine(const QPolygonF& line) {
 }
 
 void SGisLine::updateElevation(CDemDraw* dem) {
+  // query all points and subpoints at once
+  QPolygonF coords;
+  for (const IGisLine::point_t& pt : qAsConst(*this)) {
+    coords << pt.coord;
+    for (const IGisLine::subpt_t& sub : pt.subpts) {
+      coords << sub.coord;
+    }
+  }
+
+  QPolygonF ele(coords.size());
+  dem->getElevationAt(coords, ele);
+
+  int cnt = 0;
   for (int i = 0; i < size(); i++) {
     IGisLine::point_t& pt = (*this)[i];
-    qreal ele = dem->getElevationAt(pt.coord);
-    pt.ele = (ele == NOFLOAT) ? NOINT : qRound(ele);
+    pt.ele = (ele[cnt].y() == NOFLOAT) ? NOINT : qRound(ele[cnt].y());
+    ++cnt;
 
     for (int n = 0; n < pt.subpts.size(); n++) {
       IGisLine::subpt_t& sub = pt.subpts[n];
-      qreal ele = dem->getElevationAt(sub.coord);
-      sub.ele = (ele == NOFLOAT) ? NOINT : qRound(ele);
+      sub.ele = (ele[cnt].y() == NOFLOAT) ? NOINT : qRound(ele[cnt].y());
+      ++cnt;
     }
   }
 }
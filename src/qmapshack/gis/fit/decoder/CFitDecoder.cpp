@@ -28,18 +28,19 @@
 #include "gis/fit/defs/fit_const.h"
 
 CFitDecoder::CFitDecoder() {
-  stateMap[eDecoderStateFileHeader] = new CFitHeaderState(data);
-  stateMap[eDecoderStateRecord] = new CFitRecordHeaderState(data);
-  stateMap[eDecoderStateRecordContent] = new CFitRecordContentState(data);
-  stateMap[eDecoderStateFieldDef] = new CFitFieldDefinitionState(data);
-  stateMap[eDecoderStateDevFieldDef] = new CFitDevFieldDefinitionState(data);
-  stateMap[eDecoderStateFieldData] = new CFitFieldDataState(data);
-  stateMap[eDecoderStateFileCrc] = new CFitCrcState(data);
+  states[eDecoderStateFileHeader] = new CFitHeaderState(data);
+  states[eDecoderStateRecord] = new CFitRecordHeaderState(data);
+  states[eDecoderStateRecordContent] = new CFitRecordContentState(data);
+  states[eDecoderStateFieldDef] = new CFitFieldDefinitionState(data);
+  states[eDecoderStateDevFieldDef] = new CFitDevFieldDefinitionState(data);
+  states[eDecoderStateFieldData] = new CFitFieldDataState(data);
+  states[eDecoderStateFileCrc] = new CFitCrcState(data);
 }
 
 CFitDecoder::~CFitDecoder() {
-  qDeleteAll(stateMap);
-  stateMap.clear();
+  for (IFitDecoderState* state : states) {
+    delete state;
+  }
 
   data.messages.clear();
 }
@@ -81,25 +82,40 @@ QList<QString> decoderStateNames = {
     "File Header", "Record", "Record Content", "Field Definition", "Development Field Definition", "Field Data",
     "CRC",         "End"};
 
-void printByte(QFile& file, decode_state_e state, quint8 dataByte) {
+void printByte(quint32 pos, decode_state_e state, quint8 dataByte) {
   FITDEBUG(3, qDebug() << QString("decoding byte %1 - %2 - %3")
-                              .arg(file.pos(), 6, 10, QLatin1Char(' '))
+                              .arg(pos, 6, 10, QLatin1Char(' '))
                               .arg(dataByte, 8, 2, QLatin1Char('0'))
                               .arg(decoderStateNames.at(state)));
 }
 
 void CFitDecoder::decode(QFile& file) {
-  resetSharedData();
+  const qint64 size = file.size();
+  uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+  if (mapped != nullptr) {
+    try {
+      decode(mapped, quint32(size), file.fileName());
+    } catch (QString& errormsg) {
+      file.unmap(mapped);
+      throw errormsg;
+    }
+    file.unmap(mapped);
+  } else {
+    file.seek(0);
+    const QByteArray& buffer = file.readAll();
+    decode(reinterpret_cast<const quint8*>(buffer.constData()), buffer.size(), file.fileName());
+  }
+}
 
-  file.seek(0);
+void CFitDecoder::decode(const quint8* bytes, quint32 size, const QString& fileName) {
+  resetSharedData();
 
-  quint8 dataByte;
+  quint32 pos = 0;
   decode_state_e state = eDecoderStateFileHeader;
-  while (!file.atEnd()) {
-    file.getChar((char*)&dataByte);
+  while (pos < size) {
     try {
-      printByte(file, state, dataByte);
-      state = stateMap[state]->processByte(dataByte);
+      printByte(pos, state, bytes[pos]);
+      pos += states[state]->processBytes(bytes + pos, size - pos, state);
       if (state == eDecoderStateEnd) {
         // end of file, everything ok
         printDebugInfo();
@@ -112,7 +128,7 @@ void CFitDecoder::decode(QFile& file) {
   }
   // unexpected end of file
   printDebugInfo();
-  throw tr("FIT decoding error: unexpected end of file %1.").arg(file.fileName());
+  throw tr("FIT decoding error: unexpected end of file %1.").arg(fileName);
 }
 
 const QList<CFitMessage>& CFitDecoder::getMessages() const { return data.messages; }
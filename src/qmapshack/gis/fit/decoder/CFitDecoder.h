@@ -31,15 +31,23 @@ class CFitDecoder final {
   CFitDecoder();
   ~CFitDecoder();
 
+  /**
+     @brief Decode the complete file
+
+     The file is mapped into memory if possible. Else it is read at once.
+
+     @param file  the open file
+   */
   void decode(QFile& file);
   const QList<CFitMessage>& getMessages() const;
 
  private:
+  void decode(const quint8* bytes, quint32 size, const QString& fileName);
   void resetSharedData();
   void printDebugInfo();
 
-  // map containing all states for the decoder. Needs to be pointer because decoder state is abstract class
-  QMap<decode_state_e, IFitDecoderState*> stateMap;
+  // all states for the decoder, indexed by decode_state_e. Needs to be pointer because decoder state is abstract class
+  IFitDecoderState* states[eDecoderStateEnd];
 
   // shared data passed along the decoder state instances.
   IFitDecoderState::shared_state_data_t data;
@@ -24,10 +24,10 @@
 #include "gis/fit/decoder/CFitMessage.h"
 #include "gis/fit/defs/CFitBaseType.h"
 #include "gis/fit/defs/CFitFieldProfile.h"
-#include "gis/fit/defs/CFitProfileLookup.h"
 
 void CFitFieldBuilder::evaluateSubfieldsAndExpandComponents(CFitMessage& mesg) {
-  const QList<CFitField>& fields = mesg.getFields();
+  // a copy, as fields are changed and added while looping
+  const QVector<CFitField> fields = mesg.getFields();
   for (const CFitField& field : fields) {
     CFitFieldBuilder::evaluateFieldProfile(mesg, field);
   }
@@ -37,9 +37,8 @@ void CFitFieldBuilder::evaluateSubfieldsAndExpandComponents(CFitMessage& mesg) {
 }
 
 CFitField CFitFieldBuilder::buildField(const CFitFieldDefinition& def, quint8* fieldData, const CFitMessage& message) {
-  const CFitFieldProfile* fieldProfile =
-      CFitProfileLookup::getFieldForProfile(message.getGlobalMesgNr(), def.getDefNr());
-  return buildField(*fieldProfile, def, fieldData, message);
+  // the profile is looked up once when the definition is read
+  return buildField(def.profile(), def, fieldData, message);
 }
 
 CFitField CFitFieldBuilder::buildField(const CFitFieldProfile& fieldProfile, const CFitFieldDefinition& def,
@@ -89,7 +88,7 @@ void CFitFieldBuilder::evaluateFieldProfile(CFitMessage& mesg, const CFitField&
   if (fieldProfile.hasSubfields()) {
     for (const CFitSubfieldProfile* subfieldProfile : fieldProfile.getSubfields()) {
       // the referenced field is for all subfields the same
-      const QList<CFitField>& fields = mesg.getFields();
+      const QVector<CFitField> fields = mesg.getFields();
       for (const CFitField& referencedField : fields) {
         if (referencedField.getFieldDefNr() == subfieldProfile->getReferencedFieldDefNr() &&
             referencedField.getValue().toUInt() == subfieldProfile->getReferencedFieldValue()) {
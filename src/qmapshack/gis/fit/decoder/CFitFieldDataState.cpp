@@ -61,6 +61,41 @@ decode_state_e CFitFieldDataState::process(quint8& dataByte) {
   return eDecoderStateFieldData;
 }
 
+quint32 CFitFieldDataState::processBytes(const quint8* bytes, quint32 size, decode_state_e& state) {
+  // All but the last byte of a field are just copied. Do this at once. The last byte
+  // completes the field and takes the usual path.
+  const CFitFieldDefinition* fieldDef = currentFieldDefinition();
+  if (fieldDef == nullptr || fieldDef->getSize() <= fieldDataIndex + 1) {
+    return IFitDecoderState::processBytes(bytes, size, state);
+  }
+
+  quint32 n = qMin(quint32(fieldDef->getSize() - fieldDataIndex - 1), size);
+  // leave the bytes close to the end of the file to processByte(). It checks for a truncated message.
+  const quint32 bytesLeft = bytesLeftToRead();
+  n = qMin(n, bytesLeft > 3 ? bytesLeft - 3 : 0);
+  if (n == 0) {
+    return IFitDecoderState::processBytes(bytes, size, state);
+  }
+
+  skipBytes(bytes, n);
+  memcpy(fieldData + fieldDataIndex, bytes, n);
+  fieldDataIndex += n;
+
+  state = eDecoderStateFieldData;
+  return n;
+}
+
+const CFitFieldDefinition* CFitFieldDataState::currentFieldDefinition() {
+  const CFitDefinitionMessage* defMesg = definition(latestMessage()->getLocalMesgNr());
+  if (fieldIndex < defMesg->getNrOfFields()) {
+    return &defMesg->getFieldByIndex(fieldIndex);
+  }
+  if (devFieldIndex < defMesg->getNrOfDevFields()) {
+    return &defMesg->getDevFieldByIndex(devFieldIndex);
+  }
+  return nullptr;
+}
+
 bool CFitFieldDataState::handleFitField() {
   CFitMessage& mesg = *latestMessage();
   CFitDefinitionMessage* defMesg = definition(mesg.getLocalMesgNr());
@@ -120,7 +155,7 @@ void CFitFieldDataState::devProfile(CFitMessage& mesg) {
   if (mesg.getGlobalMesgNr() == eMesgNumDeveloperDataId) {
     // Get developer ID
     quint8 devDataIdx = fitDevDataIndexInvalid;
-    const QList<CFitField>& fields = mesg.getFields();
+    const QVector<CFitField>& fields = mesg.getFields();
     for (const CFitField& field : fields) {
       if (field.isValidValue() && field.getFieldDefNr() == eDeveloperDataIdDeveloperDataIndex) {
         devDataIdx = (quint8)field.getValue().toUInt();
@@ -155,7 +190,7 @@ CFitFieldProfile CFitFieldDataState::buildDevFieldProfile(CFitMessage& mesg) {
   quint8 natvieMesgNum = 0;
   quint8 nativeFieldNum = 0;
 
-  const QList<CFitField>& fields = mesg.getFields();
+  const QVector<CFitField>& fields = mesg.getFields();
   for (const CFitField& field : fields) {
     if (field.isValidValue()) {
       switch (field.getFieldDefNr()) {
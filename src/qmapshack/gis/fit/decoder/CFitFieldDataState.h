@@ -30,8 +30,11 @@ class CFitFieldDataState final : public IFitDecoderState {
   virtual ~CFitFieldDataState() {}
   void reset() override;
   decode_state_e process(quint8& dataByte) override;
+  quint32 processBytes(const quint8* bytes, quint32 size, decode_state_e& state) override;
 
  private:
+  /// the definition of the field currently read or nullptr if all fields are read
+  const CFitFieldDefinition* currentFieldDefinition();
   bool handleFitField();
   bool handleDevField();
   void devProfile(CFitMessage& mesg);
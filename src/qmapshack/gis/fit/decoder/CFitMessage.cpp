@@ -29,7 +29,10 @@ CFitMessage::CFitMessage(const CFitDefinitionMessage& def)
       devFields(),
       globalMesgNr(def.getGlobalMesgNr()),
       localMesgNr(def.getLocalMesgNr()),
-      messageProfile(CFitProfileLookup::getProfile(globalMesgNr)) {}
+      messageProfile(CFitProfileLookup::getProfile(globalMesgNr)) {
+  fields.reserve(def.getNrOfFields());
+  devFields.reserve(def.getNrOfDevFields());
+}
 
 CFitMessage::CFitMessage()
     : fields(),
@@ -40,12 +43,33 @@ CFitMessage::CFitMessage()
 
 bool CFitMessage::isValid() const { return getGlobalMesgNr() != fitGlobalMesgNrInvalid; }
 
+qint32 CFitMessage::lowerBound(const QVector<CFitField>& fields, quint8 fieldDefNr) {
+  auto it = std::lower_bound(fields.constBegin(), fields.constEnd(), fieldDefNr,
+                             [](const CFitField& field, quint8 nr) { return field.getFieldDefNr() < nr; });
+  return it - fields.constBegin();
+}
+
+const CFitField* CFitMessage::find(const QVector<CFitField>& fields, quint8 fieldDefNr) {
+  const qint32 idx = lowerBound(fields, fieldDefNr);
+  if (idx < fields.size() && fields[idx].getFieldDefNr() == fieldDefNr) {
+    return &fields[idx];
+  }
+  return nullptr;
+}
+
 void CFitMessage::updateFieldProfile(quint8 fieldDefNr, const CFitFieldProfile* fieldProfile) {
+  QVector<CFitField>* list = nullptr;
   if (fieldProfile->getFieldType() == eFieldTypeFit) {
-    fields[fieldDefNr].setProfile(fieldProfile);
+    list = &fields;
+  } else if (fieldProfile->getFieldType() == eFieldTypeDevelopment) {
+    list = &devFields;
+  } else {
+    return;
   }
-  if (fieldProfile->getFieldType() == eFieldTypeDevelopment) {
-    devFields[fieldDefNr].setProfile(fieldProfile);
+
+  const qint32 idx = lowerBound(*list, fieldDefNr);
+  if (idx < list->size() && (*list)[idx].getFieldDefNr() == fieldDefNr) {
+    (*list)[idx].setProfile(fieldProfile);
   }
 }
 
@@ -62,25 +86,36 @@ QStringList CFitMessage::messageInfo() const {
   return list;
 }
 
-bool CFitMessage::hasField(const quint8 fieldDefNum) const { return fields.contains(fieldDefNum); }
+bool CFitMessage::hasField(const quint8 fieldDefNum) const { return find(fields, fieldDefNum) != nullptr; }
 
 void CFitMessage::addField(CFitField& field) {
+  QVector<CFitField>* list = nullptr;
   if (field.profile().getFieldType() == eFieldTypeFit) {
-    if (fields.contains(field.getFieldDefNr())) {
+    list = &fields;
+  } else if (field.profile().getFieldType() == eFieldTypeDevelopment) {
+    list = &devFields;
+  } else {
+    return;
+  }
+
+  const qint32 idx = lowerBound(*list, field.getFieldDefNr());
+  if (idx < list->size() && (*list)[idx].getFieldDefNr() == field.getFieldDefNr()) {
+    if (list == &fields) {
       qCritical("fit field %d already added to map.", (int)field.getFieldDefNr());
     } else {
-      fields.insert(field.getFieldDefNr(), field);
-    }
-  }
-  if (field.profile().getFieldType() == eFieldTypeDevelopment) {
-    if (devFields.contains(field.getFieldDefNr())) {
       qCritical("fit dev field %d already added to map.", (int)field.getFieldDefNr());
-    } else {
-      devFields.insert(field.getFieldDefNr(), field);
     }
+  } else {
+    list->insert(idx, field);
   }
 }
 
-bool CFitMessage::isFieldValueValid(const quint8 fieldDefNum) const { return fields[fieldDefNum].isValidValue(); }
+bool CFitMessage::isFieldValueValid(const quint8 fieldDefNum) const {
+  const CFitField* field = find(fields, fieldDefNum);
+  return field != nullptr && field->isValidValue();
+}
 
-const QVariant CFitMessage::getFieldValue(const quint8 fieldDefNum) const { return fields[fieldDefNum].getValue(); }
+const QVariant CFitMessage::getFieldValue(const quint8 fieldDefNum) const {
+  const CFitField* field = find(fields, fieldDefNum);
+  return field != nullptr ? field->getValue() : QVariant();
+}
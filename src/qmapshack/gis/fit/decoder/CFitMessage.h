@@ -44,12 +44,19 @@ class CFitMessage final {
 
   const CFitProfile& profile() const { return *messageProfile; }
   QStringList messageInfo() const;
-  QList<CFitField> getFields() const { return fields.values(); }
+  /// the fields sorted by their field definition number, without the developer fields
+  const QVector<CFitField>& getFields() const { return fields; }
   void updateFieldProfile(quint8 fieldDefNr, const CFitFieldProfile* fieldProfile);
 
  private:
-  QMap<quint8, CFitField> fields;
-  QMap<quint8, CFitField> devFields;
+  /// the index of the field with fieldDefNr, or of the place to insert it, if it does not exist
+  static qint32 lowerBound(const QVector<CFitField>& fields, quint8 fieldDefNr);
+  /// the field with fieldDefNr or nullptr if it does not exist
+  static const CFitField* find(const QVector<CFitField>& fields, quint8 fieldDefNr);
+
+  // A message has only a few fields. Sorted vectors are much cheaper than maps here.
+  QVector<CFitField> fields;
+  QVector<CFitField> devFields;
   quint16 globalMesgNr;
   quint8 localMesgNr;
   const CFitProfile* messageProfile;
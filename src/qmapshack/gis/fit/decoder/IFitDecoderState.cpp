@@ -33,6 +33,19 @@ decode_state_e IFitDecoderState::processByte(quint8& dataByte) {
   return state;
 }
 
+quint32 IFitDecoderState::processBytes(const quint8* bytes, quint32 /*size*/, decode_state_e& state) {
+  quint8 dataByte = *bytes;
+  state = processByte(dataByte);
+  return 1;
+}
+
+void IFitDecoderState::skipBytes(const quint8* bytes, quint32 size) {
+  data.fileBytesRead += size;
+  for (quint32 i = 0; i < size; i++) {
+    buildCrc(bytes[i]);
+  }
+}
+
 void IFitDecoderState::buildCrc(quint8 byte) {
   static const quint16 crc_table[16] = {0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
                                         0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400};
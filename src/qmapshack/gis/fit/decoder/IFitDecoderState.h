@@ -59,9 +59,25 @@ class IFitDecoderState {
   virtual void reset() = 0;
   decode_state_e processByte(quint8& dataByte);
 
+  /**
+     @brief Process the next bytes of the file
+
+     By default only the first byte is processed. States that can take several bytes at
+     once override this to save the overhead per byte.
+
+     @param bytes  the next bytes of the file
+     @param size   the number of bytes available, at least 1
+     @param state  returns the state to process the next byte
+     @return The number of processed bytes, at least 1
+   */
+  virtual quint32 processBytes(const quint8* bytes, quint32 size, decode_state_e& state);
+
  protected:
   virtual decode_state_e process(quint8& dataByte) = 0;
 
+  /// count the bytes and add them to the CRC without any further processing
+  void skipBytes(const quint8* bytes, quint32 size);
+
   CFitMessage* latestMessage() const { return data.lastMessage; }
   void addMessage(const CFitDefinitionMessage& definition);
 
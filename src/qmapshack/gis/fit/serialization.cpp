@@ -70,7 +70,7 @@ static void readKnownExtensions(T& exts, const CFitMessage& mesg) {
   }
 }
 
-static bool readFitRecord(const CFitMessage& mesg, IGisItem::wpt_t& pt) {
+static bool readFitPosition(const CFitMessage& mesg, IGisItem::wpt_t& pt) {
   if (mesg.isFieldValueValid(eRecordPositionLong) && mesg.isFieldValueValid(eRecordPositionLat)) {
     pt.lon = toDegree(mesg.getFieldValue(eRecordPositionLong).toInt());
     pt.lat = toDegree(mesg.getFieldValue(eRecordPositionLat).toInt());
@@ -78,16 +78,22 @@ static bool readFitRecord(const CFitMessage& mesg, IGisItem::wpt_t& pt) {
       pt.ele = mesg.getFieldValue(eRecordEnhancedAltitude).toInt();
     }
     pt.time = toDateTime(mesg.getFieldValue(eRecordTimestamp).toUInt());
+    return true;
+  }
+  return false;
+}
 
+static bool readFitRecord(const CFitMessage& mesg, IGisItem::wpt_t& pt) {
+  if (readFitPosition(mesg, pt)) {
     readKnownExtensions(pt.extensions, mesg);
-
     return true;
   }
   return false;
 }
 
 static bool readFitRecord(const CFitMessage& mesg, CTrackData::trkpt_t& pt) {
-  if (readFitRecord(mesg, (IGisItem::wpt_t&)pt)) {
+  // track points have their own extensions, do not fill the ones of wpt_t, too
+  if (readFitPosition(mesg, pt)) {
     pt.speed = mesg.getFieldValue(eRecordSpeed).toDouble();
 
     readKnownExtensions(pt.extensions, mesg);
@@ -28,6 +28,7 @@
 #include "gis/trk/CGisItemTrk.h"
 #include "gis/trk/CKnownExtension.h"
 #include "gis/wpt/CGisItemWpt.h"
+#include "helpers/CProgressDialog.h"
 #include "helpers/CSelectCopyAction.h"
 
 CGpxProject::CGpxProject(const QString& filename, CGisListWks* parent) : IGisProject(eTypeGpx, filename, parent) {
@@ -77,6 +78,140 @@ void CGpxProject::loadGpx(const QString& filename) {
   }
 }
 
+static void copyAttributes(const QXmlStreamReader& xml, QDomElement& elem) {
+  const QXmlStreamAttributes& attributes = xml.attributes();
+  for (const QXmlStreamAttribute& attribute : attributes) {
+    elem.setAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
+  }
+
+  // depending on the Qt version namespace declarations are not reported as attributes
+  const QXmlStreamNamespaceDeclarations& declarations = xml.namespaceDeclarations();
+  for (const QXmlStreamNamespaceDeclaration& declaration : declarations) {
+    const QString& name =
+        declaration.prefix().isEmpty() ? QString("xmlns") : "xmlns:" + declaration.prefix().toString();
+    if (!elem.hasAttribute(name)) {
+      elem.setAttribute(name, declaration.namespaceUri().toString());
+    }
+  }
+}
+
+QDomElement CGpxProject::readXmlElement(QXmlStreamReader& xml, QDomNode parent) {
+  QDomDocument doc = parent.isDocument() ? parent.toDocument() : parent.ownerDocument();
+
+  QDomElement root = doc.createElement(xml.qualifiedName().toString());
+  copyAttributes(xml, root);
+  parent.appendChild(root);
+
+  QDomElement elem = root;
+  while (!xml.atEnd()) {
+    switch (xml.readNext()) {
+      case QXmlStreamReader::StartElement: {
+        QDomElement child = doc.createElement(xml.qualifiedName().toString());
+        copyAttributes(xml, child);
+        elem.appendChild(child);
+        elem = child;
+        break;
+      }
+
+      case QXmlStreamReader::EndElement:
+        if (elem == root) {
+          return root;
+        }
+        elem = elem.parentNode().toElement();
+        break;
+
+      case QXmlStreamReader::Characters:
+        if (xml.isCDATA()) {
+          elem.appendChild(doc.createCDATASection(xml.text().toString()));
+        } else if (elem.lastChild().isText() && !elem.lastChild().isCDATASection()) {
+          // the reader may split long text
+          QDomText text = elem.lastChild().toText();
+          text.appendData(xml.text().toString());
+        } else if (!xml.isWhitespace()) {
+          elem.appendChild(doc.createTextNode(xml.text().toString()));
+        }
+        break;
+
+      case QXmlStreamReader::Comment:
+        elem.appendChild(doc.createComment(xml.text().toString()));
+        break;
+
+      default:;
+    }
+  }
+
+  return root;
+}
+
+QDomElement CGpxProject::createFragment(QDomDocument& doc) {
+  QDomElement fragment = doc.createElement("fragment");
+  doc.appendChild(fragment);
+  return fragment;
+}
+
+/*
+   Write a node the way QDomDocument::save() with an indent of 1 writes it at the
+   given depth. QDomNode::save() always writes a node as if it was at depth 1. Thus
+   QDom is used for nodes without children only. The tags of elements with children,
+   the indentation and the line breaks are written here by the same rules as QDom
+   uses: no indentation after text and no line break before text.
+ */
+static void writeNode(QTextStream& out, const QDomNode& node, qint32 depth) {
+  if (!node.isElement() && !node.isComment()) {
+    // text is neither indented nor followed by a line break
+    node.save(out, -1);
+    return;
+  }
+
+  if (!node.previousSibling().isText()) {
+    out << QString(depth, ' ');
+  }
+
+  if (!node.hasChildNodes()) {
+    // an indent of -1 disables QDom's own indentation and line breaks
+    node.save(out, -1);
+  } else {
+    // the start tag is the one of an empty copy, without the trailing "/>"
+    QString tag;
+    QTextStream stream(&tag, QIODevice::WriteOnly);
+    // the codec decides what characters are written as references
+    stream.setCodec("UTF-8");
+    node.cloneNode(false).save(stream, -1);
+    stream.flush();
+    tag.chop(2);
+
+    out << tag << ">";
+    if (!node.firstChild().isText()) {
+      out << Qt::endl;
+    }
+    for (QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling()) {
+      writeNode(out, child, depth + 1);
+    }
+    if (!node.lastChild().isText()) {
+      out << QString(depth, ' ');
+    }
+    out << "</" << node.nodeName() << ">";
+  }
+
+  if (!node.nextSibling().isText()) {
+    out << Qt::endl;
+  }
+}
+
+void CGpxProject::writeFragment(QTextStream& out, QDomElement& fragment, qint32 depth) {
+  for (QDomNode node = fragment.firstChild(); !node.isNull(); node = node.nextSibling()) {
+    if (depth == 1) {
+      node.save(out, 1);
+    } else {
+      writeNode(out, node, depth);
+    }
+  }
+
+  while (fragment.hasChildNodes()) {
+    fragment.removeChild(fragment.firstChild());
+  }
+}
+
 void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
   // create file instance
   QFile file(filename);
@@ -94,20 +229,50 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
     throw tr("Failed to open %1").arg(filename);
   }
 
-  // load file content to xml document
+  /*
+      The file is read twice. The project's extensions are at the end of the
+      file. But they are needed before the items are created. Thus the first
+      pass checks the syntax and collects the <gpx> element and its extensions.
+      The second pass creates the items one by one without building a DOM of
+      the whole file.
+   */
   QDomDocument xml;
-  QString msg;
-  int line;
-  int column;
-  if (!xml.setContent(&file, false, &msg, &line, &column)) {
-    file.close();
-    throw tr("Failed to read: %1\nline %2, column %3:\n %4").arg(filename).arg(line).arg(column).arg(msg);
+  QDomElement xmlGpx;
+  QDomElement xmlExtension;
+  {
+    QXmlStreamReader reader(&file);
+    reader.setNamespaceProcessing(false);
+    if (reader.readNextStartElement()) {
+      xmlGpx = xml.createElement(reader.qualifiedName().toString());
+      copyAttributes(reader, xmlGpx);
+      xml.appendChild(xmlGpx);
+
+      while (reader.readNextStartElement()) {
+        if (xmlExtension.isNull() && reader.qualifiedName() == "extensions") {
+          xmlExtension = readXmlElement(reader, xmlGpx);
+        } else {
+          reader.skipCurrentElement();
+        }
+      }
+    }
+
+    // read up to the end to detect all errors
+    while (!reader.atEnd()) {
+      reader.readNext();
+    }
+
+    if (reader.hasError()) {
+      file.close();
+      throw tr("Failed to read: %1\nline %2, column %3:\n %4")
+          .arg(filename)
+          .arg(reader.lineNumber())
+          .arg(reader.columnNumber())
+          .arg(reader.errorString());
+    }
   }
-  file.close();
 
-  int N;
-  QDomElement xmlGpx = xml.documentElement();
   if (xmlGpx.tagName() != "gpx") {
+    file.close();
     throw tr("Not a GPX file: %1").arg(filename);
   }
 
@@ -129,7 +294,6 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
     }
   }
 
-  const QDomElement& xmlExtension = xmlGpx.namedItem("extensions").toElement();
   if (xmlExtension.namedItem("ql:key").isElement()) {
     project->key = xmlExtension.namedItem("ql:key").toElement().text();
   }
@@ -151,47 +315,63 @@ void CGpxProject::loadGpx(const QString& filename, CGpxProject* project) {
     project->invalidDataOk = bool(xmlExtension.namedItem("ql:invalidDataOk").toElement().text().toInt() != 0);
   }
 
-  const QDomNode& xmlMetadata = xmlGpx.namedItem("metadata");
-  if (xmlMetadata.isElement()) {
-    project->readMetadata(xmlMetadata, project->metadata);
+  // the progress dialog must not be used by the threads loading files in the background
+  QScopedPointer<CProgressDialog> progress;
+  if (QThread::currentThread() == qApp->thread()) {
+    progress.reset(new CProgressDialog(tr("Loading %1").arg(QFileInfo(filename).fileName()), 0, 100,
+                                       CMainWindow::getBestWidgetForParent()));
+    progress->enableCancel(false);
   }
+  const qint64 size = qMax(file.size(), qint64(1));
+  auto updateProgress = [&]() {
+    if (!progress.isNull()) {
+      progress->setValue(file.pos() * 100 / size);
+    }
+  };
 
-  /** @note   If you change the order of the item types read you have to
-              take care of the order enforced in IGisItem().
+  /** @note   The items are read in the order of the file. IGisItem() takes
+              care of the order of the item types in the project.
    */
-  const QDomNodeList& xmlTrks = xmlGpx.elementsByTagName("trk");
-  N = xmlTrks.count();
-  for (int n = 0; n < N; ++n) {
-    const QDomNode& xmlTrk = xmlTrks.item(n);
-    new CGisItemTrk(xmlTrk, project);
-  }
-
-  const QDomNodeList& xmlRtes = xmlGpx.elementsByTagName("rte");
-  N = xmlRtes.count();
-  for (int n = 0; n < N; ++n) {
-    const QDomNode& xmlRte = xmlRtes.item(n);
-    new CGisItemRte(xmlRte, project);
-  }
-
-  const QDomNodeList& xmlWpts = xmlGpx.elementsByTagName("wpt");
-  N = xmlWpts.count();
-  for (int n = 0; n < N; ++n) {
-    const QDomNode& xmlWpt = xmlWpts.item(n);
-    CGisItemWpt* wpt = new CGisItemWpt(xmlWpt, project);
-
-    /*
-        Special care for waypoints stored on Garmin devices. Images attached
-        to the waypoint are stored in the file system of the device and written
-        as links to the waypoint. Let the device object take care of this.
-     */
-    IDevice* device = dynamic_cast<IDevice*>(project->parent());
-    if (device) {
-      device->loadImages(*wpt);
+  file.seek(0);
+  QXmlStreamReader reader(&file);
+  reader.setNamespaceProcessing(false);
+  reader.readNextStartElement();
+  while (reader.readNextStartElement()) {
+    const QString& tag = reader.qualifiedName().toString();
+    if (tag == "metadata") {
+      const QDomElement& xmlMetadata = readXmlElement(reader, xmlGpx);
+      project->readMetadata(xmlMetadata, project->metadata);
+      xmlGpx.removeChild(xmlMetadata);
+    } else if (tag == "trk") {
+      new CGisItemTrk(reader, project, updateProgress);
+    } else if (tag == "rte") {
+      const QDomElement& xmlRte = readXmlElement(reader, xmlGpx);
+      new CGisItemRte(xmlRte, project);
+      xmlGpx.removeChild(xmlRte);
+    } else if (tag == "wpt") {
+      const QDomElement& xmlWpt = readXmlElement(reader, xmlGpx);
+      CGisItemWpt* wpt = new CGisItemWpt(xmlWpt, project);
+      xmlGpx.removeChild(xmlWpt);
+
+      /*
+          Special care for waypoints stored on Garmin devices. Images attached
+          to the waypoint are stored in the file system of the device and written
+          as links to the waypoint. Let the device object take care of this.
+       */
+      IDevice* device = dynamic_cast<IDevice*>(project->parent());
+      if (device) {
+        device->loadImages(*wpt);
+      }
+    } else {
+      reader.skipCurrentElement();
     }
+
+    updateProgress();
   }
+  file.close();
 
   const QDomNodeList& xmlAreas = xmlExtension.elementsByTagName("ql:area");
-  N = xmlAreas.count();
+  const int N = xmlAreas.count();
   for (int n = 0; n < N; ++n) {
     const QDomNode& xmlArea = xmlAreas.item(n);
     new CGisItemOvlArea(xmlArea, project);
@@ -218,12 +398,10 @@ bool CGpxProject::saveAs(const QString& fn, IGisProject& project, bool strictGpx
     file.open(QIODevice::ReadOnly);
     bool createdByQMS = false;
 
-    // load file content to xml document
-    QDomDocument xml;
-    if (xml.setContent(&file, false)) {
-      const QDomElement& docElem = xml.documentElement();
-      const QDomNamedNodeMap& attr = docElem.attributes();
-      createdByQMS = attr.namedItem("creator").nodeValue().startsWith("QMapShack");
+    // the attributes of the root element are all that is needed
+    QXmlStreamReader xml(&file);
+    if (xml.readNextStartElement()) {
+      createdByQMS = xml.attributes().value("creator").startsWith("QMapShack");
     }
 
     if (!createdByQMS) {
@@ -243,105 +421,142 @@ bool CGpxProject::saveAs(const QString& fn, IGisProject& project, bool strictGpx
     file.close();
   }
 
-  //  ---- start content of gpx
-  QDomDocument doc;
-  QDomNode gpx = project.writeMetadata(doc, strictGpx11);
-
   IDevice* device = dynamic_cast<IDevice*>(project.parent());
   if (device) {
     device->startSavingProject(&project);
   }
 
-  for (int i = 0; i < project.childCount(); i++) {
-    CGisItemWpt* item = dynamic_cast<CGisItemWpt*>(project.child(i));
-    if (nullptr == item) {
-      continue;
+  // the progress dialog must not be used by the thread exporting a database
+  const int N = project.childCount();
+  QScopedPointer<CProgressDialog> progress;
+  if (QThread::currentThread() == qApp->thread()) {
+    progress.reset(new CProgressDialog(tr("Saving %1").arg(QFileInfo(_fn_).fileName()), 0, N,
+                                       CMainWindow::getBestWidgetForParent()));
+    progress->enableCancel(false);
+  }
+  qint32 cnt = 0;
+  auto updateProgress = [&]() {
+    if (!progress.isNull()) {
+      progress->setValue(cnt);
     }
+  };
 
-    /*
-        Special care for waypoints stored on Garmin devices. Images attached
-        to the waypoint are stored in the file system of the device and written
-        as links to the waypoint. Let the device object take care of this.
-     */
-    if (device) {
-      device->saveImages(*item);
+  /*
+      The file is written item by item. The output is the same as the one of a
+      DOM of the complete project saved with an indent of 1. But only the DOM of
+      a single item or a chunk of track points exists at a time.
+   */
+  bool res = true;
+  try {
+    if (!file.open(QIODevice::WriteOnly)) {
+      throw tr("Failed to create file '%1'").arg(_fn_);
     }
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\" ?>" << Qt::endl;
 
-    item->save(gpx, strictGpx11);
-  }
-  for (int i = 0; i < project.childCount(); i++) {
-    CGisItemRte* item = dynamic_cast<CGisItemRte*>(project.child(i));
-    if (nullptr == item) {
-      continue;
-    }
-    item->save(gpx, strictGpx11);
-  }
-  for (int i = 0; i < project.childCount(); i++) {
-    CGisItemTrk* item = dynamic_cast<CGisItemTrk*>(project.child(i));
-    if (nullptr == item) {
-      continue;
+    //  ---- start content of gpx
+    {
+      QDomDocument doc;
+      project.writeMetadata(doc, strictGpx11);
+      const QString& head = doc.toString();
+      out << head.leftRef(head.lastIndexOf("</gpx>"));
     }
-    item->save(gpx, strictGpx11);
-  }
 
-  if (!strictGpx11) {
-    QDomElement xmlExt = doc.createElement("extensions");
-    gpx.appendChild(xmlExt);
-    for (int i = 0; i < project.childCount(); i++) {
-      CGisItemOvlArea* item = dynamic_cast<CGisItemOvlArea*>(project.child(i));
+    QDomDocument doc;
+    QDomElement fragment = createFragment(doc);
+
+    for (int i = 0; i < N; i++) {
+      CGisItemWpt* item = dynamic_cast<CGisItemWpt*>(project.child(i));
       if (nullptr == item) {
         continue;
       }
-      item->save(xmlExt, strictGpx11);
-    }
 
-    if (!project.getKey().isEmpty()) {
-      QDomElement elem = xmlExt.ownerDocument().createElement("ql:key");
-      xmlExt.appendChild(elem);
-      QDomText text = xmlExt.ownerDocument().createTextNode(project.getKey());
-      elem.appendChild(text);
-    }
+      /*
+          Special care for waypoints stored on Garmin devices. Images attached
+          to the waypoint are stored in the file system of the device and written
+          as links to the waypoint. Let the device object take care of this.
+       */
+      if (device) {
+        device->saveImages(*item);
+      }
 
-    {
-      QDomElement elem = xmlExt.ownerDocument().createElement("ql:sortingRoadbook");
-      xmlExt.appendChild(elem);
-      QDomText text = xmlExt.ownerDocument().createTextNode(QString::number(project.getSortingRoadbook()));
-      elem.appendChild(text);
+      item->save(fragment, strictGpx11);
+      writeFragment(out, fragment, 1);
+      ++cnt;
+      updateProgress();
     }
-
-    {
-      QDomElement elem = xmlExt.ownerDocument().createElement("ql:sortingFolder");
-      xmlExt.appendChild(elem);
-      QDomText text = xmlExt.ownerDocument().createTextNode(QString::number(project.getSortingFolder()));
-      elem.appendChild(text);
+    for (int i = 0; i < N; i++) {
+      CGisItemRte* item = dynamic_cast<CGisItemRte*>(project.child(i));
+      if (nullptr == item) {
+        continue;
+      }
+      item->save(fragment, strictGpx11);
+      writeFragment(out, fragment, 1);
+      ++cnt;
+      updateProgress();
     }
-
-    {
-      QDomElement elem = xmlExt.ownerDocument().createElement("ql:correlation");
-      xmlExt.appendChild(elem);
-      QDomText text = xmlExt.ownerDocument().createTextNode(QString::number(project.doCorrelation()));
-      elem.appendChild(text);
+    for (int i = 0; i < N; i++) {
+      CGisItemTrk* item = dynamic_cast<CGisItemTrk*>(project.child(i));
+      if (nullptr == item) {
+        continue;
+      }
+      item->saveGpx(out, strictGpx11, updateProgress);
+      ++cnt;
+      updateProgress();
     }
 
-    {
-      QDomElement elem = xmlExt.ownerDocument().createElement("ql:invalidDataOk");
-      xmlExt.appendChild(elem);
-      QDomText text = xmlExt.ownerDocument().createTextNode(QString::number(project.getInvalidDataOk()));
-      elem.appendChild(text);
-    }
-  }
-  //  ---- stop  content of gpx
+    if (!strictGpx11) {
+      QDomElement xmlExt = doc.createElement("extensions");
+      fragment.appendChild(xmlExt);
+      for (int i = 0; i < N; i++) {
+        CGisItemOvlArea* item = dynamic_cast<CGisItemOvlArea*>(project.child(i));
+        if (nullptr == item) {
+          continue;
+        }
+        item->save(xmlExt, strictGpx11);
+      }
 
-  bool res = true;
-  try {
-    if (!file.open(QIODevice::WriteOnly)) {
-      throw tr("Failed to create file '%1'").arg(_fn_);
+      if (!project.getKey().isEmpty()) {
+        QDomElement elem = xmlExt.ownerDocument().createElement("ql:key");
+        xmlExt.appendChild(elem);
+        QDomText text = xmlExt.ownerDocument().createTextNode(project.getKey());
+        elem.appendChild(text);
+      }
+
+      {
+        QDomElement elem = xmlExt.ownerDocument().createElement("ql:sortingRoadbook");
+        xmlExt.appendChild(elem);
+        QDomText text = xmlExt.ownerDocument().createTextNode(QString::number(project.getSortingRoadbook()));
+        elem.appendChild(text);
+      }
+
+      {
+        QDomElement elem = xmlExt.ownerDocument().createElement("ql:sortingFolder");
+        xmlExt.appendChild(elem);
+        QDomText text = xmlExt.ownerDocument().createTextNode(QString::number(project.getSortingFolder()));
+        elem.appendChild(text);
+      }
+
+      {
+        QDomElement elem = xmlExt.ownerDocument().createElement("ql:correlation");
+        xmlExt.appendChild(elem);
+        QDomText text = xmlExt.ownerDocument().createTextNode(QString::number(project.doCorrelation()));
+        elem.appendChild(text);
+      }
+
+      {
+        QDomElement elem = xmlExt.ownerDocument().createElement("ql:invalidDataOk");
+        xmlExt.appendChild(elem);
+        QDomText text = xmlExt.ownerDocument().createTextNode(QString::number(project.getInvalidDataOk()));
+        elem.appendChild(text);
+      }
+      writeFragment(out, fragment, 1);
     }
-    QTextStream out(&file);
-    out.setCodec("UTF-8");
-    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\" ?>" << Qt::endl;
+    out << "</gpx>" << Qt::endl;
+    //  ---- stop  content of gpx
 
-    out << doc.toString();
+    out.flush();
     file.close();
     if (file.error() != QFile::NoError) {
       throw tr("Failed to write file '%1'").arg(_fn_);
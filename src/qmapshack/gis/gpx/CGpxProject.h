@@ -19,10 +19,14 @@
 #ifndef CGPXPROJECT_H
 #define CGPXPROJECT_H
 
+#include <QDomElement>
+
 #include "gis/prj/IGisProject.h"
 
 class CGisListWks;
 class CGisDraw;
+class QTextStream;
+class QXmlStreamReader;
 
 class CGpxProject : public IGisProject {
   Q_DECLARE_TR_FUNCTIONS(CGpxProject)
@@ -42,6 +46,39 @@ class CGpxProject : public IGisProject {
 
   static void loadGpx(const QString& filename, CGpxProject* project);
 
+  /**
+     @brief Copy the element the reader is positioned at into a DOM
+
+     The element is read the same way QDomDocument::setContent() does without
+     namespace processing. This is used to read small parts of a large file by
+     the code written for DOM nodes.
+
+     @param xml     The reader positioned at the start tag. It is left at the end tag.
+     @param parent  The node the new element is appended to
+     @return The new element.
+   */
+  static QDomElement readXmlElement(QXmlStreamReader& xml, QDomNode parent);
+
+  /**
+     @brief Create an empty fragment to write nodes of a GPX file
+
+     Nodes appended to the returned element are written by writeFragment() as
+     if they were part of the complete DOM saved with an indent of 1.
+
+     @param doc     The document to create the fragment in
+     @return The element to append the nodes to.
+   */
+  static QDomElement createFragment(QDomDocument& doc);
+
+  /**
+     @brief Write all children of a fragment and remove them from the fragment
+
+     @param out       The stream to write to
+     @param fragment  The element returned by createFragment()
+     @param depth     The depth of the nodes, 1 for children of <gpx>
+   */
+  static void writeFragment(QTextStream& out, QDomElement& fragment, qint32 depth);
+
  private:
   void loadGpx(const QString& filename);
 };
@@ -20,6 +20,7 @@
 #include <QtXml>
 
 #include "device/CDeviceGarmin.h"
+#include "gis/gpx/CGpxProject.h"
 #include "gis/ovl/CGisItemOvlArea.h"
 #include "gis/prj/IGisProject.h"
 #include "gis/rte/CGisItemRte.h"
@@ -260,7 +261,7 @@ static void writeXml(QDomNode& xml, const QString& tag, const QPoint& offsetBubb
   elem.setAttribute("width", widthBubble);
 }
 
-static void readXml(const QDomNode& node, const QString& parentTags, QHash<QString, QVariant>& extensions) {
+static void readXml(const QDomNode& node, const QString& parentTags, CTrkPtExtensions& extensions) {
   QString tag = node.nodeName();
   if ((tag.left(8) == "ql:flags") || (tag.left(11) == "ql:activity")) {
     return;
@@ -278,7 +279,7 @@ static void readXml(const QDomNode& node, const QString& parentTags, QHash<QStri
   }
 }
 
-static void readXml(const QDomNode& ext, QHash<QString, QVariant>& extensions) {
+static void readXml(const QDomNode& ext, CTrkPtExtensions& extensions) {
   const QDomNodeList& list = ext.childNodes();
   for (int i = 0; i < list.size(); i++) {
     readXml(list.at(i), "", extensions);
@@ -287,7 +288,7 @@ static void readXml(const QDomNode& ext, QHash<QString, QVariant>& extensions) {
   extensions.squeeze();
 }
 
-static void writeXml(QDomNode& ext, const QHash<QString, QVariant>& extensions) {
+static void writeXml(QDomNode& ext, const CTrkPtExtensions& extensions) {
   if (extensions.isEmpty()) {
     return;
   }
@@ -660,13 +661,7 @@ void CGisItemWpt::writeGcExt(QDomNode& xmlCache) {
 }
 
 void CGisItemTrk::readTrk(const QDomNode& xml, CTrackData& trk) {
-  readXml(xml, "name", trk.name);
-  readXml(xml, "cmt", trk.cmt);
-  readXml(xml, "desc", trk.desc);
-  readXml(xml, "src", trk.src);
-  readXml(xml, "link", trk.links);
-  readXml(xml, "number", trk.number);
-  readXml(xml, "type", trk.type);
+  readTrkTags(xml, trk);
 
   const QDomNodeList& trksegs = xml.toElement().elementsByTagName("trkseg");
   int N = trksegs.count();
@@ -679,20 +674,61 @@ void CGisItemTrk::readTrk(const QDomNode& xml, CTrackData& trk) {
     int M = xmlTrkpts.count();
     seg.pts.resize(M);
     for (int m = 0; m < M; ++m) {
-      CTrackData::trkpt_t& trkpt = seg.pts[m];
-      const QDomNode& xmlTrkpt = xmlTrkpts.item(m);
-      readWpt(xmlTrkpt, trkpt);
-
-      const QDomNode& ext = xmlTrkpt.namedItem("extensions");
-      if (ext.isElement()) {
-        readXml(ext, "ql:flags", trkpt.flags);
-        readXml(ext, "ql:activity", trkpt.activity);
-        trkpt.sanitizeFlags();
-        readXml(ext, trkpt.extensions);
+      readTrkPt(xmlTrkpts.item(m), seg.pts[m]);
+    }
+  }
+
+  deriveSecondaryData();
+}
+
+void CGisItemTrk::readTrk(QXmlStreamReader& xml, CTrackData& trk, const std::function<void()>& progress) {
+  // All tags but the segments are small. They are collected in a DOM to
+  // be read by the same code as for a complete DOM. The points are read
+  // one by one. Each one is removed from the DOM right after reading.
+  QDomDocument doc;
+  QDomElement xmlTrk = doc.createElement("trk");
+  QDomElement xmlTrkseg = doc.createElement("trkseg");
+
+  qint32 cnt = 0;
+  while (xml.readNextStartElement()) {
+    if (xml.qualifiedName() != "trkseg") {
+      CGpxProject::readXmlElement(xml, xmlTrk);
+      continue;
+    }
+
+    CTrackData::trkseg_t seg;
+    while (xml.readNextStartElement()) {
+      if (xml.qualifiedName() != "trkpt") {
+        xml.skipCurrentElement();
+        continue;
+      }
+
+      const QDomElement& xmlTrkpt = CGpxProject::readXmlElement(xml, xmlTrkseg);
+      CTrackData::trkpt_t trkpt;
+      readTrkPt(xmlTrkpt, trkpt);
+      seg.pts << trkpt;
+      xmlTrkseg.removeChild(xmlTrkpt);
+
+      if ((++cnt % 1000) == 0) {
+        progress();
       }
     }
+    trk.segs << seg;
   }
 
+  readTrkTags(xmlTrk, trk);
+  deriveSecondaryData();
+}
+
+void CGisItemTrk::readTrkTags(const QDomNode& xml, CTrackData& trk) {
+  readXml(xml, "name", trk.name);
+  readXml(xml, "cmt", trk.cmt);
+  readXml(xml, "desc", trk.desc);
+  readXml(xml, "src", trk.src);
+  readXml(xml, "link", trk.links);
+  readXml(xml, "number", trk.number);
+  readXml(xml, "type", trk.type);
+
   // decode some well known extensions
   const QDomNode& ext = xml.namedItem("extensions");
   if (ext.isElement()) {
@@ -704,8 +740,18 @@ void CGisItemTrk::readTrk(const QDomNode& xml, CTrackData& trk) {
     readXml(gpxx, "gpxx:DisplayColor", trk.color);
     setColor(str2color(trk.color));
   }
+}
 
-  deriveSecondaryData();
+void CGisItemTrk::readTrkPt(const QDomNode& xml, CTrackData::trkpt_t& trkpt) {
+  readWpt(xml, trkpt);
+
+  const QDomNode& ext = xml.namedItem("extensions");
+  if (ext.isElement()) {
+    readXml(ext, "ql:flags", trkpt.flags);
+    readXml(ext, "ql:activity", trkpt.activity);
+    trkpt.sanitizeFlags();
+    readXml(ext, trkpt.extensions);
+  }
 }
 
 void CGisItemTrk::save(QDomNode& gpx, bool strictGpx11) {
@@ -713,6 +759,57 @@ void CGisItemTrk::save(QDomNode& gpx, bool strictGpx11) {
 
   QDomElement xmlTrk = doc.createElement("trk");
   gpx.appendChild(xmlTrk);
+  saveTrkTags(xmlTrk, strictGpx11);
+
+  for (const CTrackData::trkseg_t& seg : qAsConst(trk.segs)) {
+    QDomElement xmlTrkseg = doc.createElement("trkseg");
+    xmlTrk.appendChild(xmlTrkseg);
+
+    for (const CTrackData::trkpt_t& pt : seg.pts) {
+      saveTrkPt(xmlTrkseg, pt, strictGpx11);
+    }
+  }
+}
+
+void CGisItemTrk::saveGpx(QTextStream& out, bool strictGpx11, const std::function<void()>& progress) {
+  // The markup of <trk> and <trkseg> is written the way QDomNode::save() does
+  // with an indent of 1. Everything else is serialized by QDom in small chunks.
+  QDomDocument docTrk;
+  QDomElement xmlTrk = CGpxProject::createFragment(docTrk);
+  saveTrkTags(xmlTrk, strictGpx11);
+
+  if (!xmlTrk.hasChildNodes() && trk.segs.isEmpty()) {
+    out << " <trk/>" << Qt::endl;
+    return;
+  }
+
+  out << " <trk>" << Qt::endl;
+  CGpxProject::writeFragment(out, xmlTrk, 2);
+
+  QDomDocument docTrkseg;
+  QDomElement xmlTrkseg = CGpxProject::createFragment(docTrkseg);
+  for (const CTrackData::trkseg_t& seg : qAsConst(trk.segs)) {
+    if (seg.pts.isEmpty()) {
+      out << "  <trkseg/>" << Qt::endl;
+      continue;
+    }
+
+    out << "  <trkseg>" << Qt::endl;
+    const qint32 N = seg.pts.size();
+    for (qint32 n = 0; n < N; n++) {
+      saveTrkPt(xmlTrkseg, seg.pts[n], strictGpx11);
+      if (((n + 1) % 1000) == 0 || (n + 1) == N) {
+        CGpxProject::writeFragment(out, xmlTrkseg, 3);
+        progress();
+      }
+    }
+    out << "  </trkseg>" << Qt::endl;
+  }
+  out << " </trk>" << Qt::endl;
+}
+
+void CGisItemTrk::saveTrkTags(QDomElement& xmlTrk, bool strictGpx11) {
+  QDomDocument doc = xmlTrk.ownerDocument();
 
   writeXml(xmlTrk, "name", trk.name);
   writeXml(xmlTrk, "cmt", html2Dev(trk.cmt, strictGpx11));
@@ -735,24 +832,21 @@ void CGisItemTrk::save(QDomNode& gpx, bool strictGpx11) {
     xmlExt.appendChild(gpxx);
     writeXml(gpxx, "gpxx:DisplayColor", trk.color);
   }
+}
 
-  for (const CTrackData::trkseg_t& seg : qAsConst(trk.segs)) {
-    QDomElement xmlTrkseg = doc.createElement("trkseg");
-    xmlTrk.appendChild(xmlTrkseg);
+void CGisItemTrk::saveTrkPt(QDomElement& xmlTrkseg, const CTrackData::trkpt_t& trkpt, bool strictGpx11) {
+  QDomDocument doc = xmlTrkseg.ownerDocument();
 
-    for (const CTrackData::trkpt_t& pt : seg.pts) {
-      QDomElement xmlTrkpt = doc.createElement("trkpt");
-      xmlTrkseg.appendChild(xmlTrkpt);
-      writeWpt(xmlTrkpt, pt, strictGpx11);
-
-      if (!strictGpx11) {
-        QDomElement xmlExt = doc.createElement("extensions");
-        xmlTrkpt.appendChild(xmlExt);
-        writeXml(xmlExt, "ql:flags", pt.flags);
-        writeXml(xmlExt, "ql:activity", pt.activity);
-        writeXml(xmlExt, pt.extensions);
-      }
-    }
+  QDomElement xmlTrkpt = doc.createElement("trkpt");
+  xmlTrkseg.appendChild(xmlTrkpt);
+  writeWpt(xmlTrkpt, trkpt, strictGpx11);
+
+  if (!strictGpx11) {
+    QDomElement xmlExt = doc.createElement("extensions");
+    xmlTrkpt.appendChild(xmlExt);
+    writeXml(xmlExt, "ql:flags", trkpt.flags);
+    writeXml(xmlExt, "ql:activity", trkpt.activity);
+    writeXml(xmlExt, trkpt.extensions);
   }
 }
 
@@ -55,6 +55,7 @@ CGisItemOvlArea::CGisItemOvlArea(const CGisItemOvlArea& parentArea, IGisProject*
   if (clone) {
     area.name += tr("_Clone");
     key.clear();
+    keyChanged(this);
     history.events.clear();
     setupHistory();
   }
@@ -115,9 +116,7 @@ IGisItem* CGisItemOvlArea::createClone() {
 void CGisItemOvlArea::setSymbol() { setColor(str2color(area.color)); }
 
 bool CGisItemOvlArea::isCloseTo(const QPointF& pos) {
-  QMutexLocker lock(&mutexItems);
-
-  qreal dist = GPS_Math_DistPointPolyline(polygonArea, pos);
+  qreal dist = GPS_Math_DistPointPolyline(polygonScreen.get(), pos);
   return dist < 20;
 }
 
@@ -128,12 +127,12 @@ bool CGisItemOvlArea::isWithin(const QRectF& area, selflags_t flags) {
 }
 
 QPointF CGisItemOvlArea::getPointCloseBy(const QPoint& screenPos) {
-  QMutexLocker lock(&mutexItems);
+  const QPolygonF& polygonArea = polygonScreen.get();
 
   qint32 i = 0;
   qint32 idx = NOIDX;
   qint32 d = NOINT;
-  for (const QPointF& point : qAsConst(polygonArea)) {
+  for (const QPointF& point : polygonArea) {
     int tmp = (screenPos - point).manhattanLength();
     if (tmp < d) {
       idx = i;
@@ -200,7 +199,7 @@ void CGisItemOvlArea::deriveSecondaryData() {
     }
   }
 
-  boundingRect = QRectF(QPointF(west * DEG_TO_RAD, north * DEG_TO_RAD), QPointF(east * DEG_TO_RAD, south * DEG_TO_RAD));
+  setBoundingRect(QRectF(QPointF(west * DEG_TO_RAD, north * DEG_TO_RAD), QPointF(east * DEG_TO_RAD, south * DEG_TO_RAD)));
 
   QPolygonF line(area.pts.size());
   for (int i = 1; i < area.pts.size(); i++) {
@@ -231,8 +230,10 @@ void CGisItemOvlArea::deriveSecondaryData() {
 void CGisItemOvlArea::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& /*blockedAreas*/, CGisDraw* gis) {
   QMutexLocker lock(&mutexItems);
 
-  polygonArea.clear();
+  // build the new polygon aside and publish it as a whole when done
+  QPolygonF polygonArea;
   if (!isVisible(boundingRect, viewport, gis)) {
+    polygonScreen.publish(polygonArea);
     return;
   }
 
@@ -268,6 +269,7 @@ void CGisItemOvlArea::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRe
   pt1 *= DEG_TO_RAD;
   gis->convertRad2Px(pt1);
   polygonArea << pt1;
+  polygonScreen.publish(polygonArea);
 
   p.restore();
 }
@@ -276,6 +278,7 @@ void CGisItemOvlArea::drawLabel(QPainter& p, const QPolygonF& /*viewport*/, QLis
                                 const QFontMetricsF& fm, CGisDraw* /*gis*/) {
   QMutexLocker lock(&mutexItems);
 
+  const QPolygonF& polygonArea = polygonScreen.get();
   if (polygonArea.isEmpty()) {
     return;
   }
@@ -289,7 +292,7 @@ void CGisItemOvlArea::drawLabel(QPainter& p, const QPolygonF& /*viewport*/, QLis
 }
 
 void CGisItemOvlArea::drawHighlight(QPainter& p) {
-  QMutexLocker lock(&mutexItems);
+  const QPolygonF& polygonArea = polygonScreen.get();
 
   if (polygonArea.isEmpty() || key == keyUserFocus) {
     return;
@@ -382,8 +385,6 @@ QString CGisItemOvlArea::getInfo(quint32 feature) const {
 }
 
 void CGisItemOvlArea::getPolylineFromData(SGisLine& l) const {
-  QMutexLocker lock(&mutexItems);
-
   l.clear();
   for (const pt_t& pt : area.pts) {
     l << point_t(QPointF(pt.lon * DEG_TO_RAD, pt.lat * DEG_TO_RAD));
@@ -391,8 +392,6 @@ void CGisItemOvlArea::getPolylineFromData(SGisLine& l) const {
 }
 
 void CGisItemOvlArea::getPolylineDegFromData(QPolygonF& polygon) const {
-  QMutexLocker lock(&mutexItems);
-
   polygon.clear();
   for (const pt_t& pt : area.pts) {
     polygon << QPointF(pt.lon, pt.lat);
@@ -25,6 +25,7 @@
 
 #include "gis/IGisItem.h"
 #include "gis/IGisLine.h"
+#include "helpers/CSnapshot.h"
 
 class IGisProject;
 class CScrOptOvlArea;
@@ -153,7 +154,8 @@ class CGisItemOvlArea : public IGisItem, public IGisLine {
   /// the track line color by index
   unsigned colorIdx = 0;
 
-  QPolygonF polygonArea;
+  /// the area of the last draw pass as screen pixel coordinates, written by the draw thread and read by the GUI
+  CSnapshot<QPolygonF> polygonScreen;
 
   QPointer<CScrOptOvlArea> scrOpt;
 
@@ -98,6 +98,7 @@ IGisProject::IGisProject(type_e type, const QString& filename, IDevice* parent)
 }
 
 IGisProject::~IGisProject() {
+  IGisItem::keyDestroyed(this);
   delete dlgDetails;
   if (key == keyUserFocus) {
     keyUserFocus.clear();
@@ -180,6 +181,7 @@ void IGisProject::genKey() const {
     QCryptographicHash md5(QCryptographicHash::Md5);
     md5.addData(buffer);
     key = md5.result().toHex();
+    IGisItem::keyChanged(this);
   }
 }
 
@@ -202,6 +204,8 @@ qint32 IGisProject::isOnDevice() const {
 bool IGisProject::isChanged() const { return text(CGisListWks::eColumnDecoration).contains("*"); }
 
 void IGisProject::edit() {
+  restorePendingItems();
+
   if (dlgDetails.isNull()) {
     dlgDetails = new CDetailsPrj(*this, 0);
     dlgDetails->setObjectName(getName());
@@ -348,6 +352,8 @@ bool IGisProject::save() {
 }
 
 bool IGisProject::saveAs(QString fn, QString filter) {
+  restorePendingItems();
+
   SETTINGS;
 
   if (fn.isEmpty()) {
@@ -399,6 +405,8 @@ bool IGisProject::saveAs(QString fn, QString filter) {
 }
 
 bool IGisProject::saveAsStrictGpx11() {
+  restorePendingItems();
+
   SETTINGS;
 
   QString fn;
@@ -490,11 +498,43 @@ QString IGisProject::getInfo() const {
   if (cntItemsByType[IGisItem::eTypeOvl]) {
     str += "<br/>\n" + tr("Areas: %1").arg(cntItemsByType[IGisItem::eTypeOvl]);
   }
+  if (hasPendingItems()) {
+    str += "<br/>\n" + tr("The items are loaded on first use.");
+  }
 
   return str;
 }
 
+void IGisProject::restorePendingItems() {
+  if (pendingItems.isEmpty()) {
+    return;
+  }
+
+  QMutexLocker lock(&IGisItem::mutexItems);
+
+  // clear the pending items first, as the signals emitted below might call this again
+  QByteArray data;
+  data.swap(pendingItems);
+
+  QList<snapshot_t::item_t> items;
+  QDataStream stream(&data, QIODevice::ReadOnly);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setVersion(QDataStream::Qt_5_2);
+  readItems(stream, items);
+
+  blockUpdateItems(true);
+  restoreItems(items);
+  setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+  // sort the items and apply the filters set in the meantime
+  sortItems();
+  blockUpdateItems(false);
+
+  setToolTip(CGisListWks::eColumnName, getInfo());
+}
+
 IGisItem* IGisProject::getItemByKey(const IGisItem::key_t& key) {
+  restorePendingItems();
+
   for (int i = 0; i < childCount(); i++) {
     IGisItem* item = dynamic_cast<IGisItem*>(child(i));
     if (nullptr == item) {
@@ -521,40 +561,6 @@ void IGisProject::getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisI
   }
 }
 
-void IGisProject::getItemsByPos(const QPointF& pos, QList<IGisItem*>& items) {
-  if (!isVisible()) {
-    return;
-  }
-
-  for (int i = 0; i < childCount(); i++) {
-    IGisItem* item = dynamic_cast<IGisItem*>(child(i));
-    if (nullptr == item || item->isHidden()) {
-      continue;
-    }
-
-    if (item->isCloseTo(pos)) {
-      items << item;
-    }
-  }
-}
-
-void IGisProject::getItemsByArea(const QRectF& area, IGisItem::selflags_t flags, QList<IGisItem*>& items) {
-  if (!isVisible()) {
-    return;
-  }
-
-  for (int i = 0; i < childCount(); i++) {
-    IGisItem* item = dynamic_cast<IGisItem*>(child(i));
-    if (nullptr == item || item->isHidden()) {
-      continue;
-    }
-
-    if (item->isWithin(area, flags)) {
-      items << item;
-    }
-  }
-}
-
 void IGisProject::getNogoAreas(QList<IGisItem*>& nogos) const {
   if (!isVisible()) {
     return;
@@ -633,6 +639,8 @@ void IGisProject::editItemByKey(const IGisItem::key_t& key) {
 }
 
 void IGisProject::insertCopyOfItem(IGisItem* item, int off, CSelectCopyAction::result_e& lastResult) {
+  restorePendingItems();
+
   bool clone = false;
   IGisItem::key_t key = item->getKey();
   key.project = getKey();
@@ -983,6 +991,10 @@ void IGisProject::setProjectFilter(const CSearch& search) {
 
 void IGisProject::setWorkspaceFilter(const CSearch& search) {
   workspaceSearch = search;
+  // the search has to see all items
+  if (!workspaceSearch.getSearchText().isEmpty()) {
+    restorePendingItems();
+  }
   applyFilters();
 }
 
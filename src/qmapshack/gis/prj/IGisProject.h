@@ -124,6 +124,7 @@ class IGisProject : public QTreeWidgetItem {
 
   IGisProject& operator=(const IGisProject& p) {
     key = p.key;
+    IGisItem::keyChanged(this);
     metadata = p.metadata;
     return *this;
   }
@@ -260,18 +261,6 @@ class IGisProject : public QTreeWidgetItem {
   IGisItem* getItemByKey(const IGisItem::key_t& key);
 
   void getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisItem*>& items);
-  /**
-     @brief Get a list of items that are close to a given pixel coordinate of the screen
-
-     @note: The returned pointers are just for temporary use. Best you use them to get the item's key.
-
-     @param pos       the coordinate on the screen in pixel
-     @param items     a list the item's pointer is stored to.
-   */
-  void getItemsByPos(const QPointF& pos, QList<IGisItem*>& items);
-
-  void getItemsByArea(const QRectF& area, IGisItem::selflags_t flags, QList<IGisItem*>& items);
-
   void getNogoAreas(QList<IGisItem*>& nogos) const;
 
   int getItemCountByType(IGisItem::type_e type) const { return cntItemsByType[type]; }
@@ -385,6 +374,81 @@ class IGisProject : public QTreeWidgetItem {
    */
   virtual QDataStream& operator>>(QDataStream& stream) const;
 
+  /**
+     @brief A copy of all data written by IGisProject::operator>>()
+
+     The history of the items is shared implicitly with the items. Thus taking a
+     snapshot is cheap. And the snapshot can be serialized by another thread while
+     the project is changed.
+   */
+  struct snapshot_t {
+    struct item_t {
+      quint8 type = 0;
+      IGisItem::history_t history;
+      quint8 changed = 0;
+      QString lastDatabaseHash;
+    };
+
+    /**
+       @brief Get a short digest of the snapshot
+
+       The digest covers the project's header and for each history event
+       it's hash, time and the size and encoding of it's data. The data itself is
+       not hashed. Thus it is much cheaper to calculate than a hash of the serialized
+       snapshot, but it detects any change made by the application: editing an
+       item adds an event or moves the current index, cutting or squashing the
+       history changes the events' data.
+     */
+    QByteArray getFingerprint() const;
+
+    QString filename;
+    metadata_t metadata;
+    QString key;
+    qint32 sortingRoadbook = eSortRoadbookNone;
+    qint8 flags = 0;
+    qint32 sortingFolder = eSortFolderTime;
+    QList<item_t> items;
+    /// the serialized items of a project whose items have not been restored yet
+    QByteArray itemData;
+  };
+
+  /// get a snapshot of the project, must be called with IGisItem::mutexItems locked
+  snapshot_t getSnapshot() const;
+
+  /**
+     @brief Read a serialized project into a snapshot
+
+     No items are created. Thus this can be done by any thread.
+
+     @param stream      the binary data stream
+     @param snapshot    the snapshot to fill
+     @param withItems   if false the items are not decoded but kept as snapshot_t::itemData
+     @return False if the stream does not hold a project.
+   */
+  static bool readSnapshot(QDataStream& stream, snapshot_t& snapshot, bool withItems);
+
+  /**
+     @brief Restore the project from a snapshot
+
+     The items are created from snapshot_t::items. If the snapshot has
+     snapshot_t::itemData instead, the items are restored on first use by
+     restorePendingItems(). Must be called by the main thread.
+
+     @param snapshot  the snapshot as read by readSnapshot()
+   */
+  void restoreSnapshot(const snapshot_t& snapshot);
+
+  /**
+     @brief Create the items of a project restored without them
+
+     This is done when the project is shown on the map, expanded, selected,
+     edited or saved. Nothing is done if all items have been restored.
+   */
+  void restorePendingItems();
+
+  /// true if the items have not been restored yet
+  bool hasPendingItems() const { return !pendingItems.isEmpty(); }
+
   /**
      @brief writeMetadata
      @param doc
@@ -465,6 +529,9 @@ class IGisProject : public QTreeWidgetItem {
   void sortItems();
   void sortItems(QList<IGisItem*>& items) const;
 
+  static void readItems(QDataStream& stream, QList<snapshot_t::item_t>& items);
+  void restoreItems(const QList<snapshot_t::item_t>& items);
+
   /**
      @brief Converts a string with HTML tags to a string without HTML depending on the device
 
@@ -508,6 +575,9 @@ class IGisProject : public QTreeWidgetItem {
   metadata_t metadata;
   QString nameSuffix;
 
+  /// the serialized items as long as they have not been restored
+  QByteArray pendingItems;
+
   sorting_roadbook_e sortingRoadbook = eSortRoadbookNone;
   sorting_folder_e sortingFolder = eSortFolderTime;
 
@@ -531,6 +601,9 @@ class IGisProject : public QTreeWidgetItem {
 };
 Q_DECLARE_METATYPE(IGisProject*)
 
+/// serialize the snapshot the same way as IGisProject::operator>>()
+QDataStream& operator<<(QDataStream& stream, const IGisProject::snapshot_t& snapshot);
+
 class CProjectMountLock {
  public:
   CProjectMountLock(IGisProject& project) : project(project) { project.mount(); }
@@ -16,6 +16,7 @@
 
 **********************************************************************************************/
 
+#include <QCryptographicHash>
 #include <QtWidgets>
 
 #include "gis/CGisListWks.h"
@@ -44,8 +45,8 @@
 #define VER_PROJECT quint8(5)
 #define VER_COPYRIGHT quint8(1)
 #define VER_PERSON quint8(1)
-#define VER_HIST quint8(1)
-#define VER_HIST_EVT quint8(3)
+#define VER_HIST quint8(2)
+#define VER_HIST_EVT quint8(4)
 #define VER_ITEM quint8(3)
 #define VER_CVALUE quint8(1)
 #define VER_CLIMIT quint8(1)
@@ -129,6 +130,7 @@ QDataStream& operator<<(QDataStream& stream, const IGisItem::history_event_t& e)
   stream << e.data;
   stream << e.hash;
   stream << e.who;
+  stream << quint8(e.isDelta);
 
   return stream;
 }
@@ -146,6 +148,11 @@ QDataStream& operator>>(QDataStream& stream, IGisItem::history_event_t& e) {
   if (version > 2) {
     stream >> e.who;
   }
+  if (version > 3) {
+    quint8 isDelta;
+    stream >> isDelta;
+    e.isDelta = isDelta;
+  }
 
   return stream;
 }
@@ -184,6 +191,11 @@ QDataStream& operator>>(QDataStream& stream, IGisItem::history_t& h) {
     h.events.clear();
   }
 
+  // histories before version 2 hold events before version 4, with full data for each event
+  if (version < 2) {
+    h.compress();
+  }
+
   return stream;
 }
 
@@ -863,6 +875,14 @@ QDataStream& CGisItemOvlArea::operator>>(QDataStream& stream) const {
 }
 
 QDataStream& IGisProject::operator<<(QDataStream& stream) {
+  snapshot_t snapshot;
+  if (readSnapshot(stream, snapshot, true)) {
+    restoreSnapshot(snapshot);
+  }
+  return stream;
+}
+
+bool IGisProject::readSnapshot(QDataStream& stream, snapshot_t& snapshot, bool withItems) {
   quint8 version;
   QIODevice* dev = stream.device();
   qint64 pos = dev->pos();
@@ -872,82 +892,113 @@ QDataStream& IGisProject::operator<<(QDataStream& stream) {
 
   if (strncmp(magic, MAGIC_PROJ, MAGIC_SIZE)) {
     dev->seek(pos);
-    return stream;
+    return false;
   }
 
-  blockUpdateItems(true);
-
   stream >> version;
-  if (filename.isEmpty()) {
-    stream >> filename;
-  } else {
-    QString tmp;
-    stream >> tmp;
-  }
-  stream >> metadata.name;
-  stream >> metadata.desc;
-  stream >> metadata.author;
-  stream >> metadata.copyright;
-  stream >> metadata.links;
-  stream >> metadata.time;
-  stream >> metadata.keywords;
-  stream >> metadata.bounds;
+  stream >> snapshot.filename;
+  stream >> snapshot.metadata.name;
+  stream >> snapshot.metadata.desc;
+  stream >> snapshot.metadata.author;
+  stream >> snapshot.metadata.copyright;
+  stream >> snapshot.metadata.links;
+  stream >> snapshot.metadata.time;
+  stream >> snapshot.metadata.keywords;
+  stream >> snapshot.metadata.bounds;
   if (version > 1) {
-    stream >> key;
+    stream >> snapshot.key;
   }
   if (version > 2) {
-    qint32 tmp;
-    stream >> tmp;
-    sortingRoadbook = (sorting_roadbook_e)tmp;
+    stream >> snapshot.sortingRoadbook;
   }
   if (version > 3) {
-    qint8 tmp;
-    stream >> tmp;
-    noCorrelation = (tmp & eFlagNoCorrelation) != 0;
-    autoSave = (tmp & eFlagAutoSave) != 0;
-    invalidDataOk = (tmp & eFlagInvalidDataOk) != 0;
-    autoSyncToDev = (tmp & eFlagAutoSyncToDev) != 0;
-    updateDecoration();
+    stream >> snapshot.flags;
   }
-
   if (version > 4) {
-    qint32 tmp;
-    stream >> tmp;
-    sortingFolder = (sorting_folder_e)tmp;
+    stream >> snapshot.sortingFolder;
   }
 
+  if (withItems) {
+    readItems(stream, snapshot.items);
+  } else {
+    snapshot.itemData = dev->readAll();
+  }
+  return true;
+}
+
+void IGisProject::readItems(QDataStream& stream, QList<snapshot_t::item_t>& items) {
   while (!stream.atEnd()) {
-    QString lastDatabaseHash;
-    IGisItem::history_t history;
-    quint8 changed = 0;
-    quint8 version, type;
+    snapshot_t::item_t item;
+    quint8 version;
     stream >> version;
-    stream >> type;
-    stream >> history;
+    stream >> item.type;
+    stream >> item.history;
     if (version > 1) {
-      stream >> changed;
+      stream >> item.changed;
     }
 
     if (version > 2) {
-      stream >> lastDatabaseHash;
+      stream >> item.lastDatabaseHash;
     }
+    items << item;
+  }
+}
+
+void IGisProject::restoreSnapshot(const snapshot_t& snapshot) {
+  blockUpdateItems(true);
 
+  if (filename.isEmpty()) {
+    filename = snapshot.filename;
+  }
+  metadata.name = snapshot.metadata.name;
+  metadata.desc = snapshot.metadata.desc;
+  metadata.author = snapshot.metadata.author;
+  metadata.copyright = snapshot.metadata.copyright;
+  metadata.links = snapshot.metadata.links;
+  metadata.time = snapshot.metadata.time;
+  metadata.keywords = snapshot.metadata.keywords;
+  metadata.bounds = snapshot.metadata.bounds;
+  key = snapshot.key;
+  IGisItem::keyChanged(this);
+  sortingRoadbook = (sorting_roadbook_e)snapshot.sortingRoadbook;
+  noCorrelation = (snapshot.flags & eFlagNoCorrelation) != 0;
+  autoSave = (snapshot.flags & eFlagAutoSave) != 0;
+  invalidDataOk = (snapshot.flags & eFlagInvalidDataOk) != 0;
+  autoSyncToDev = (snapshot.flags & eFlagAutoSyncToDev) != 0;
+  updateDecoration();
+  sortingFolder = (sorting_folder_e)snapshot.sortingFolder;
+
+  if (snapshot.itemData.isEmpty()) {
+    restoreItems(snapshot.items);
+  } else {
+    pendingItems = snapshot.itemData;
+    // show the project as expandable, expanding it will restore the items
+    setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+  }
+
+  sortItems();
+
+  blockUpdateItems(false);
+}
+
+void IGisProject::restoreItems(const QList<snapshot_t::item_t>& items) {
+  for (const snapshot_t::item_t& entry : items) {
     IGisItem* item = nullptr;
-    switch (type) {
+    switch (entry.type) {
       case IGisItem::eTypeWpt:
-        item = new CGisItemWpt(history, lastDatabaseHash, this);
+        item = new CGisItemWpt(entry.history, entry.lastDatabaseHash, this);
         break;
 
       case IGisItem::eTypeTrk:
-        item = new CGisItemTrk(history, lastDatabaseHash, this);
+        item = new CGisItemTrk(entry.history, entry.lastDatabaseHash, this);
         break;
 
       case IGisItem::eTypeRte:
-        item = new CGisItemRte(history, lastDatabaseHash, this);
+        item = new CGisItemRte(entry.history, entry.lastDatabaseHash, this);
         break;
 
       case IGisItem::eTypeOvl:
-        item = new CGisItemOvlArea(history, lastDatabaseHash, this);
+        item = new CGisItemOvlArea(entry.history, entry.lastDatabaseHash, this);
         break;
 
       default:;
@@ -955,86 +1006,105 @@ QDataStream& IGisProject::operator<<(QDataStream& stream) {
 
     // Update decoration always, to set possible rating and tag markers
     if (item) {
-      if (changed) {
+      if (entry.changed) {
         item->updateDecoration(IGisItem::eMarkChanged, IGisItem::eMarkNone);
       } else {
         item->updateDecoration(IGisItem::eMarkNone, IGisItem::eMarkNone);
       }
     }
   }
+}
 
-  sortItems();
+QDataStream& IGisProject::operator>>(QDataStream& stream) const { return stream << getSnapshot(); }
+
+IGisProject::snapshot_t IGisProject::getSnapshot() const {
+  snapshot_t snapshot;
+  snapshot.filename = filename;
+  snapshot.metadata = metadata;
+  snapshot.key = key;
+  snapshot.sortingRoadbook = sortingRoadbook;
+  snapshot.flags = (noCorrelation ? eFlagNoCorrelation : 0) | (autoSave ? eFlagAutoSave : 0) |
+                   (invalidDataOk ? eFlagInvalidDataOk : 0) |
+                   (autoSyncToDev ? eFlagAutoSyncToDev : 0);  // collect trivial flags in one field.
+  snapshot.sortingFolder = sortingFolder;
+  snapshot.itemData = pendingItems;
+
+  // the items are grouped by type
+  for (int type : {IGisItem::eTypeTrk, IGisItem::eTypeRte, IGisItem::eTypeWpt, IGisItem::eTypeOvl}) {
+    for (int i = 0; i < childCount(); i++) {
+      IGisItem* item = dynamic_cast<IGisItem*>(child(i));
+      if (nullptr == item || item->type() != type) {
+        continue;
+      }
+      snapshot_t::item_t entry;
+      entry.type = item->type();
+      entry.history = item->getHistory();
+      entry.changed = item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged;
+      entry.lastDatabaseHash = item->getLastDatabaseHash();
+      snapshot.items << entry;
+    }
+  }
 
-  blockUpdateItems(false);
-  return stream;
+  return snapshot;
 }
 
-QDataStream& IGisProject::operator>>(QDataStream& stream) const {
+static void writeSnapshotHeader(QDataStream& stream, const IGisProject::snapshot_t& snapshot) {
   stream.writeRawData(MAGIC_PROJ, MAGIC_SIZE);
   stream << VER_PROJECT;
 
-  stream << filename;
-  stream << metadata.name;
-  stream << metadata.desc;
-  stream << metadata.author;
-  stream << metadata.copyright;
-  stream << metadata.links;
-  stream << metadata.time;
-  stream << metadata.keywords;
-  stream << metadata.bounds;
-  stream << key;
-  stream << qint32(sortingRoadbook);
-  stream << qint8((noCorrelation ? eFlagNoCorrelation : 0) | (autoSave ? eFlagAutoSave : 0) |
-                  (invalidDataOk ? eFlagInvalidDataOk : 0) |
-                  (autoSyncToDev ? eFlagAutoSyncToDev : 0));  // collect trivial flags in one field.
-  stream << qint32(sortingFolder);
+  stream << snapshot.filename;
+  stream << snapshot.metadata.name;
+  stream << snapshot.metadata.desc;
+  stream << snapshot.metadata.author;
+  stream << snapshot.metadata.copyright;
+  stream << snapshot.metadata.links;
+  stream << snapshot.metadata.time;
+  stream << snapshot.metadata.keywords;
+  stream << snapshot.metadata.bounds;
+  stream << snapshot.key;
+  stream << snapshot.sortingRoadbook;
+  stream << snapshot.flags;
+  stream << snapshot.sortingFolder;
+}
 
-  for (int i = 0; i < childCount(); i++) {
-    CGisItemTrk* item = dynamic_cast<CGisItemTrk*>(child(i));
-    if (nullptr == item) {
-      continue;
-    }
-    stream << VER_ITEM;
-    stream << quint8(item->type());
-    stream << item->getHistory();
-    stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
-    stream << item->getLastDatabaseHash();
-  }
-  for (int i = 0; i < childCount(); i++) {
-    CGisItemRte* item = dynamic_cast<CGisItemRte*>(child(i));
-    if (nullptr == item) {
-      continue;
-    }
-    stream << VER_ITEM;
-    stream << quint8(item->type());
-    stream << item->getHistory();
-    stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
-    stream << item->getLastDatabaseHash();
-  }
-  for (int i = 0; i < childCount(); i++) {
-    CGisItemWpt* item = dynamic_cast<CGisItemWpt*>(child(i));
-    if (nullptr == item) {
-      continue;
-    }
+QDataStream& operator<<(QDataStream& stream, const IGisProject::snapshot_t& snapshot) {
+  writeSnapshotHeader(stream, snapshot);
+
+  for (const IGisProject::snapshot_t::item_t& item : snapshot.items) {
     stream << VER_ITEM;
-    stream << quint8(item->type());
-    stream << item->getHistory();
-    stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
-    stream << item->getLastDatabaseHash();
+    stream << item.type;
+    stream << item.history;
+    stream << item.changed;
+    stream << item.lastDatabaseHash;
   }
-  for (int i = 0; i < childCount(); i++) {
-    CGisItemOvlArea* item = dynamic_cast<CGisItemOvlArea*>(child(i));
-    if (nullptr == item) {
-      continue;
+  stream.writeRawData(snapshot.itemData.constData(), snapshot.itemData.size());
+
+  return stream;
+}
+
+QByteArray IGisProject::snapshot_t::getFingerprint() const {
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_5_2);
+  stream.setByteOrder(QDataStream::LittleEndian);
+
+  writeSnapshotHeader(stream, *this);
+
+  // Each change of an item adds a history event or moves the current index. The
+  // hash of an event covers the item's data. Cutting or compressing the history
+  // does neither, but it changes the size or the encoding of the events' data.
+  for (const item_t& item : items) {
+    const IGisItem::history_t& history = item.history;
+    stream << item.type << history.histIdxInitial << history.histIdxCurrent << qint32(history.events.size());
+    for (const IGisItem::history_event_t& event : history.events) {
+      stream << event.hash << event.time << qint32(event.data.size()) << event.isDelta;
     }
-    stream << VER_ITEM;
-    stream << quint8(item->type());
-    stream << item->getHistory();
-    stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
-    stream << item->getLastDatabaseHash();
+    stream << item.changed << item.lastDatabaseHash;
   }
+  // pending items do not change, their size is sufficient
+  stream << qint32(itemData.size());
 
-  return stream;
+  return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
 }
 
 QDataStream& CDBProject::operator<<(QDataStream& stream) {
@@ -59,6 +59,7 @@ CGisItemRte::CGisItemRte(const CGisItemRte& parentRte, IGisProject* project, int
   if (clone) {
     rte.name += tr("_Clone");
     key.clear();
+    keyChanged(this);
     history.events.clear();
   }
 
@@ -236,7 +237,7 @@ void CGisItemRte::deriveSecondaryData() {
     }
   }
 
-  boundingRect = QRectF(QPointF(west * DEG_TO_RAD, north * DEG_TO_RAD), QPointF(east * DEG_TO_RAD, south * DEG_TO_RAD));
+  setBoundingRect(QRectF(QPointF(west * DEG_TO_RAD, north * DEG_TO_RAD), QPointF(east * DEG_TO_RAD, south * DEG_TO_RAD)));
 }
 
 void CGisItemRte::edit() {
@@ -256,6 +257,7 @@ void CGisItemRte::reverse() {
   rte1->rte.name = name;
   rte1->rte.pts.clear();
   rte1->key.clear();
+  keyChanged(rte1);
   rte1->history.events.clear();
 
   for (rtept_t& rtept : rte.pts) {
@@ -413,11 +415,11 @@ IScrOpt* CGisItemRte::getScreenOptions(const QPoint& origin, IMouse* mouse) {
 }
 
 QPointF CGisItemRte::getPointCloseBy(const QPoint& screenPos) {
-  QMutexLocker lock(&mutexItems);
+  const QPolygonF& line = lineScreen.get();
 
   qint32 d = NOINT;
   QPointF pt = NOPOINTF;
-  for (const QPointF& point : qAsConst(line)) {
+  for (const QPointF& point : line) {
     int tmp = (screenPos - point).manhattanLength();
     if (tmp < d) {
       pt = point;
@@ -429,9 +431,7 @@ QPointF CGisItemRte::getPointCloseBy(const QPoint& screenPos) {
 }
 
 bool CGisItemRte::isCloseTo(const QPointF& pos) {
-  QMutexLocker lock(&mutexItems);
-
-  qreal dist = GPS_Math_DistPointPolyline(line, pos);
+  qreal dist = GPS_Math_DistPointPolyline(lineScreen.get(), pos);
   return dist < 20;
 }
 
@@ -452,8 +452,10 @@ void CGisItemRte::looseUserFocus() {
 void CGisItemRte::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) {
   QMutexLocker lock(&mutexItems);
 
-  line.clear();
+  // build the new route line aside and publish it as a whole when done
+  QPolygonF line;
   if (!isVisible(boundingRect, viewport, gis)) {
+    lineScreen.publish(line);
     return;
   }
 
@@ -489,6 +491,7 @@ void CGisItemRte::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
       }
     }
   }
+  lineScreen.publish(line);
 
   p.setPen(penBackground);
   p.drawPolyline(line);
@@ -539,7 +542,6 @@ void CGisItemRte::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
 }
 
 void CGisItemRte::drawItem(QPainter& p, const QRectF& /*viewport*/, CGisDraw* gis) {
-  QMutexLocker lock(&mutexItems);
   if (rte.pts.isEmpty()) {
     return;
   }
@@ -623,7 +625,7 @@ void CGisItemRte::drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF
 }
 
 void CGisItemRte::drawHighlight(QPainter& p) {
-  QMutexLocker lock(&mutexItems);
+  const QPolygonF& line = lineScreen.get();
 
   if (line.isEmpty() || hasUserFocus()) {
     return;
@@ -670,7 +672,6 @@ void CGisItemRte::setDataFromPolyline(const SGisLine& l) {
 }
 
 void CGisItemRte::getPolylineFromData(SGisLine& l) const {
-  QMutexLocker lock(&mutexItems);
   l.clear();
   for (const rtept_t& rtept : rte.pts) {
     l << point_t(QPointF(rtept.lon * DEG_TO_RAD, rtept.lat * DEG_TO_RAD));
@@ -685,7 +686,6 @@ void CGisItemRte::getPolylineFromData(SGisLine& l) const {
 }
 
 void CGisItemRte::getPolylineDegFromData(QPolygonF& polygon) const {
-  QMutexLocker lock(&mutexItems);
   polygon.clear();
   for (const rtept_t& rtept : rte.pts) {
     polygon << QPointF(rtept.lon, rtept.lat);
@@ -728,8 +728,7 @@ void CGisItemRte::reset() {
 }
 
 QPointF CGisItemRte::setMouseFocusByPoint(const QPoint& pt, focusmode_e fmode, const QString& owner) {
-  QMutexLocker lock(&mutexItems);
-
+  const QPolygonF& line = lineScreen.get();
   const subpt_t* newPointOfFocus = nullptr;
   quint32 idx = 0;
 
@@ -737,7 +736,7 @@ QPointF CGisItemRte::setMouseFocusByPoint(const QPoint& pt, focusmode_e fmode, c
     quint32 i = 0;
     qint32 d1 = NOINT;
 
-    for (const QPointF& point : qAsConst(line)) {
+    for (const QPointF& point : line) {
       int tmp = (pt - point).manhattanLength();
       if (tmp <= d1) {
         idx = i;
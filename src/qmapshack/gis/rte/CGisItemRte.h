@@ -29,6 +29,7 @@
 #include "gis/IGisItem.h"
 #include "gis/IGisLine.h"
 #include "gis/fit/CFitStream.h"
+#include "helpers/CSnapshot.h"
 
 class QDomNode;
 class IGisProject;
@@ -199,7 +200,8 @@ class CGisItemRte : public IGisItem, public IGisLine {
   QPen penForegroundFocus{Qt::magenta, 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin};
 
   rte_t rte;
-  QPolygonF line;
+  /// the route line of the last draw pass as screen pixel coordinates, written by the draw thread and read by the GUI
+  CSnapshot<QPolygonF> lineScreen;
 
   const subpt_t* mouseMoveFocus = nullptr;
 
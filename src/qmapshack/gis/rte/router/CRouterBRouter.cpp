@@ -295,6 +295,95 @@ int CRouterBRouter::calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& c
   return synchronousRequest(points, nogos, coords, costs);
 }
 
+int CRouterBRouter::calcRouteMatrix(const QVector<QPointF>& points, QVector<QPolygonF>& routes, QVector<qreal>& costs,
+                                    const std::function<bool(int)>& progress) {
+  if (!hasFastRouting()) {
+    return -1;
+  }
+
+  if (!mutex.tryLock()) {
+    return -1;
+  }
+
+  if (setup->installMode == CRouterBRouterSetup::eModeLocal && localBRouter->isBRouterNotRunning()) {
+    localBRouter->startBRouter();
+  }
+
+  synchronous = true;
+
+  QList<IGisItem*> nogos;
+  CGisWorkspace::self().getNogoAreas(nogos);
+
+  const int N = points.size();
+  QList<int> queue;
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      if (i != j && costs[i * N + j] < 0) {
+        queue << i * N + j;
+      }
+    }
+  }
+
+  // Only a few requests are sent at a time, not to flood the server. A local
+  // BRouter can process as many requests concurrently as there are cores.
+  const int maxRunning = setup->installMode == CRouterBRouterSetup::eModeLocal
+                             ? qMax(1, QThread::idealThreadCount())
+                             : kMaxRequestsOnline;
+
+  int cnt = 0;
+  int running = 0;
+  bool canceled = false;
+  QList<QNetworkReply*> replies;
+  QEventLoop eventLoop;
+
+  std::function<void()> startRequests = [&]() {
+    while (!canceled && running < maxRunning && !queue.isEmpty()) {
+      const int idx = queue.takeFirst();
+      const QVector<QPointF> pair = {points[idx / N] * RAD_TO_DEG, points[idx % N] * RAD_TO_DEG};
+      QNetworkReply* reply = networkAccessManager->get(getRequest(pair, nogos));
+      replies << reply;
+      running++;
+
+      connect(reply, &QNetworkReply::finished, &eventLoop, [&, reply, idx]() {
+        running--;
+        if (reply->error() == QNetworkReply::NoError) {
+          try {
+            readRoute(reply->readAll(), routes[idx], &costs[idx]);
+            cnt++;
+          } catch (const QString&) {
+            routes[idx].clear();
+            costs[idx] = -1;
+          }
+        }
+
+        if (!canceled && !progress(cnt)) {
+          canceled = true;
+          for (QNetworkReply* other : qAsConst(replies)) {
+            other->abort();
+          }
+        }
+
+        startRequests();
+        if (running == 0) {
+          eventLoop.quit();
+        }
+      });
+    }
+  };
+
+  startRequests();
+  if (running > 0) {
+    eventLoop.exec(QEventLoop::AllEvents);
+  }
+
+  for (QNetworkReply* reply : qAsConst(replies)) {
+    reply->deleteLater();
+  }
+  slotCloseStatusMsg();
+  mutex.unlock();
+  return canceled ? -1 : cnt;
+}
+
 int CRouterBRouter::synchronousRequest(const QVector<QPointF>& points, const QList<IGisItem*>& nogos, QPolygonF& coords,
                                        qreal* costs = nullptr) {
   if (!mutex.tryLock()) {
@@ -329,56 +418,7 @@ int CRouterBRouter::synchronousRequest(const QVector<QPointF>& points, const QLi
     }
     slotClearError();
 
-    const QByteArray& res = reply->readAll();
-
-    if (res.isEmpty()) {
-      throw tr("response is empty");
-    }
-
-    QDomDocument xml;
-    xml.setContent(res);
-    const QDomElement& xmlGpx = xml.documentElement();
-
-    if (xmlGpx.isNull() || xmlGpx.tagName() != "gpx") {
-      throw QString(res);
-    }
-    setup->parseBRouterVersion(xmlGpx.attribute("creator"));
-
-    // read the shape
-    const QDomNodeList& xmlLatLng =
-        xmlGpx.firstChildElement("trk").firstChildElement("trkseg").elementsByTagName("trkpt");
-    for (int n = 0; n < xmlLatLng.size(); n++) {
-      const QDomElement& elem = xmlLatLng.item(n).toElement();
-      coords << QPointF();
-      QPointF& point = coords.last();
-      point.setX(elem.attribute("lon").toFloat() * DEG_TO_RAD);
-      point.setY(elem.attribute("lat").toFloat() * DEG_TO_RAD);
-    }
-
-    // find costs of route (copied and adapted from CGisItemRte::setResultFromBrouter)
-    if (costs != nullptr) {
-      const QDomNodeList& nodes = xml.childNodes();
-      for (int i = 0; i < nodes.count(); i++) {
-        const QDomNode& node = nodes.at(i);
-        if (!node.isComment()) {
-          continue;
-        }
-        const QString& commentTxt = node.toComment().data();
-        // ' track-length = 180864 filtered ascend = 428 plain-ascend = -172 cost=270249 '
-        const QRegExp rxAscDes(
-            "(\\s*track-length\\s*=\\s*)(-?\\d+)(\\s*)(filtered "
-            "ascend\\s*=\\s*-?\\d+)(\\s*)(plain-ascend\\s*=\\s*-?\\d+)(\\s*)(cost\\s*=\\s*)(-?\\d+)(\\s*)");
-        int pos = rxAscDes.indexIn(commentTxt);
-        if (pos > -1) {
-          bool ok;
-          *costs = rxAscDes.cap(9).toDouble(&ok);
-          if (!ok) {
-            *costs = -1;
-          }
-        }
-        break;
-      }
-    }
+    readRoute(reply->readAll(), coords, costs);
   } catch (const QString& msg) {
     coords.clear();
     if (!msg.isEmpty()) {
@@ -394,6 +434,57 @@ int CRouterBRouter::synchronousRequest(const QVector<QPointF>& points, const QLi
   return coords.size();
 }
 
+void CRouterBRouter::readRoute(const QByteArray& res, QPolygonF& coords, qreal* costs) {
+  if (res.isEmpty()) {
+    throw tr("response is empty");
+  }
+
+  QDomDocument xml;
+  xml.setContent(res);
+  const QDomElement& xmlGpx = xml.documentElement();
+
+  if (xmlGpx.isNull() || xmlGpx.tagName() != "gpx") {
+    throw QString(res);
+  }
+  setup->parseBRouterVersion(xmlGpx.attribute("creator"));
+
+  // read the shape
+  const QDomNodeList& xmlLatLng =
+      xmlGpx.firstChildElement("trk").firstChildElement("trkseg").elementsByTagName("trkpt");
+  for (int n = 0; n < xmlLatLng.size(); n++) {
+    const QDomElement& elem = xmlLatLng.item(n).toElement();
+    coords << QPointF();
+    QPointF& point = coords.last();
+    point.setX(elem.attribute("lon").toFloat() * DEG_TO_RAD);
+    point.setY(elem.attribute("lat").toFloat() * DEG_TO_RAD);
+  }
+
+  // find costs of route (copied and adapted from CGisItemRte::setResultFromBrouter)
+  if (costs != nullptr) {
+    const QDomNodeList& nodes = xml.childNodes();
+    for (int i = 0; i < nodes.count(); i++) {
+      const QDomNode& node = nodes.at(i);
+      if (!node.isComment()) {
+        continue;
+      }
+      const QString& commentTxt = node.toComment().data();
+      // ' track-length = 180864 filtered ascend = 428 plain-ascend = -172 cost=270249 '
+      const QRegExp rxAscDes(
+          "(\\s*track-length\\s*=\\s*)(-?\\d+)(\\s*)(filtered "
+          "ascend\\s*=\\s*-?\\d+)(\\s*)(plain-ascend\\s*=\\s*-?\\d+)(\\s*)(cost\\s*=\\s*)(-?\\d+)(\\s*)");
+      int pos = rxAscDes.indexIn(commentTxt);
+      if (pos > -1) {
+        bool ok;
+        *costs = rxAscDes.cap(9).toDouble(&ok);
+        if (!ok) {
+          *costs = -1;
+        }
+      }
+      break;
+    }
+  }
+}
+
 void CRouterBRouter::calcRoute(const IGisItem::key_t& key) {
   mutex.lock();
   if (setup->installMode == CRouterBRouterSetup::eModeLocal && localBRouter->isBRouterNotRunning()) {
@@ -44,6 +44,8 @@ class CRouterBRouter : public IRouter, private Ui::IRouterBRouter {
 
   void calcRoute(const IGisItem::key_t& key) override;
   int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr) override;
+  int calcRouteMatrix(const QVector<QPointF>& points, QVector<QPolygonF>& routes, QVector<qreal>& costs,
+                      const std::function<bool(int)>& progress) override;
   bool hasFastRouting() override;
   QString getOptions() override;
   void routerSelected() override;
@@ -71,9 +73,14 @@ class CRouterBRouter : public IRouter, private Ui::IRouterBRouter {
   void updateBRouterStatus() const;
   int synchronousRequest(const QVector<QPointF>& points, const QList<IGisItem*>& nogos, QPolygonF& coords,
                          qreal* costs);
+  /// read shape and costs from BRouter's GPX response, throws a message on error
+  void readRoute(const QByteArray& res, QPolygonF& coords, qreal* costs);
   QNetworkRequest getRequest(const QVector<QPointF>& routePoints, const QList<IGisItem*>& nogos) const;
   QUrl getServiceUrl() const;
 
+  /// the maximum number of parallel requests of calcRouteMatrix() to an online service
+  static constexpr int kMaxRequestsOnline = 2;
+
   CRouterBRouterLocal* localBRouter;
 
   QNetworkAccessManager* networkAccessManager;
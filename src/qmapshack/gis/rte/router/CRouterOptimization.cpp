@@ -18,6 +18,8 @@
 
 #include "CRouterOptimization.h"
 
+#include <numeric>
+
 #include "gis/GeoMath.h"
 #include "gis/rte/router/CRouterSetup.h"
 #include "helpers/CProgressDialog.h"
@@ -33,11 +35,19 @@ int CRouterOptimization::optimize(SGisLine& line) {
     return 0;  // There is nothing to optimize
   }
 
+  setupMatrix(line);
+  if (!calcMatrix()) {
+    return -1;
+  }
+
   CProgressDialog progress(tr("Optimizing route"), 0, line.length() + 2, nullptr);
 
+  order_t givenOrder(line.length());
+  std::iota(givenOrder.begin(), givenOrder.end(), 0);
+
   // Optimize using air distance and known distances, since this is much faster than routing, especially brouter
-  SGisLine newAirdistanceOrder;
-  SGisLine oldAirdistanceOrder = line;
+  order_t newAirdistanceOrder;
+  order_t oldAirdistanceOrder = givenOrder;
   qreal gain = createNextBestOrder(oldAirdistanceOrder, newAirdistanceOrder);
   while (gain < 0) {
     oldAirdistanceOrder = newAirdistanceOrder;
@@ -50,24 +60,25 @@ int CRouterOptimization::optimize(SGisLine& line) {
 
   // Do routing and calculate costs of the order the user supplied
   // cancel the route calculation when the cost of the airdistance order is reached
-  qreal givenOrderCosts = getRealRouteCosts(line, airdistanceOrderCosts);
+  qreal givenOrderCosts = getRealRouteCosts(givenOrder, airdistanceOrderCosts);
   if (givenOrderCosts < 0 && airdistanceOrderCosts < 0) {
     return -1;
   }
 
   // determine starting order for optimization
   qreal bestCosts = NOINT;
+  order_t bestOrder = givenOrder;
   if (givenOrderCosts > 0 && givenOrderCosts < airdistanceOrderCosts) {
     bestCosts = givenOrderCosts;
   } else {
     bestCosts = airdistanceOrderCosts;
     // the old order is the "optimal" one, since the new one didn't have a gain<0
-    line = oldAirdistanceOrder;
-    fillSubPts(line);
+    bestOrder = oldAirdistanceOrder;
+    fillSubPts(bestOrder, line);
   }
   progress.setValue(2);
 
-  SGisLine lastWorkingOrder = line;
+  order_t lastWorkingOrder = bestOrder;
   qreal lastWorkingOrderCosts = bestCosts;
   int numOfRestarts = 0;
   // The number of needed starting permutations is somewhat arbitrary,
@@ -78,7 +89,7 @@ int CRouterOptimization::optimize(SGisLine& line) {
       return -1;
     }
 
-    SGisLine newWorkingOrder;
+    order_t newWorkingOrder;
     qreal bestInsertionGain = createNextBestOrder(lastWorkingOrder, newWorkingOrder);
 
     if (bestInsertionGain < 0) {
@@ -90,11 +101,11 @@ int CRouterOptimization::optimize(SGisLine& line) {
 
         if (newWorkingOrderCosts < bestCosts) {
           bestCosts = newWorkingOrderCosts;
-          line = newWorkingOrder;
+          bestOrder = newWorkingOrder;
 
           // Do this every time, since changes to the line are displayed and the data is available anyways.
           // Gives a nice animation on screen if the subpoints are displayed aswell.
-          fillSubPts(line);
+          fillSubPts(bestOrder, line);
         }
       }
     } else {
@@ -108,10 +119,10 @@ int CRouterOptimization::optimize(SGisLine& line) {
 
   // Do this a last time, since it happens that the route is already optimal.
   // Return the return value as this is the last point the code may fail for some odd reason
-  return fillSubPts(line);
+  return fillSubPts(bestOrder, line);
 }
 
-qreal CRouterOptimization::createNextBestOrder(const SGisLine& oldOrder, SGisLine& newOrder) {
+qreal CRouterOptimization::createNextBestOrder(const order_t& oldOrder, order_t& newOrder) const {
   qreal bestInsertionGain = 0;
   int bestBaseIndex = -1;
   int bestInsertedItemIndex = -1;
@@ -139,7 +150,7 @@ qreal CRouterOptimization::createNextBestOrder(const SGisLine& oldOrder, SGisLin
     }
   }
 
-  newOrder = SGisLine(oldOrder);
+  newOrder = oldOrder;
   if (bestBaseIndex >= 0 && bestInsertedItemIndex >= 0) {
     // If the index of the inserted item was smaller than that of the base item,
     // moving it will cause the index of the base to decrease. Thus, we don't add 1 to place it after the base
@@ -152,7 +163,7 @@ qreal CRouterOptimization::createNextBestOrder(const SGisLine& oldOrder, SGisLin
   return bestInsertionGain;
 }
 
-qreal CRouterOptimization::twoOptStep(const SGisLine& oldOrder, SGisLine& newOrder) {
+qreal CRouterOptimization::twoOptStep(const order_t& oldOrder, order_t& newOrder) const {
   // NOINT and not 0, since we also want to take orders that don't seem to be improving the situation
   qreal bestTwoOptGain = NOINT;
   // Begin and End of the section that is inverted
@@ -180,21 +191,21 @@ qreal CRouterOptimization::twoOptStep(const SGisLine& oldOrder, SGisLine& newOrd
     }
   }
 
-  newOrder = SGisLine(oldOrder);
+  newOrder = oldOrder;
   if (bestEndIndex >= 0 && bestBeginIndex >= 0) {
     std::reverse(newOrder.begin() + bestBeginIndex, newOrder.begin() + bestEndIndex);
   }
   return bestTwoOptGain;
 }
 
-qreal CRouterOptimization::getRealRouteCosts(const SGisLine& line, qreal costCutoff) {
+qreal CRouterOptimization::getRealRouteCosts(const order_t& order, qreal costCutoff) {
+  const int N = matrixPoints.size();
   qreal costs = 0;
-  for (int i = 0; i < line.length() - 1; i++) {
-    const routing_cache_item_t* route = getRoute(line[i].coord, line[i + 1].coord);
-    if (route == nullptr) {
+  for (int i = 0; i < order.length() - 1; i++) {
+    if (!getRoute(order[i], order[i + 1])) {
       return -1;
     }
-    costs += route->costs;
+    costs += matrixCosts[order[i] * N + order[i + 1]];
 
     if (costCutoff > 0 && costs > costCutoff) {
       return -1;
@@ -203,70 +214,137 @@ qreal CRouterOptimization::getRealRouteCosts(const SGisLine& line, qreal costCut
   return costs;
 }
 
-qreal CRouterOptimization::bestKnownDistance(const IGisLine::point_t& start, const IGisLine::point_t& end) {
-  // 10 digits after the decimal point in exponential format should be by far enough
-  QString start_key = QString::number(start.coord.x(), 'e', 10) + QString::number(start.coord.y(), 'e', 10);
-  QString end_key = QString::number(end.coord.x(), 'e', 10) + QString::number(end.coord.y(), 'e', 10);
-
-  if (!routingCache.contains(start_key)) {
-    routingCache[start_key] = {};
+qreal CRouterOptimization::bestKnownDistance(qint32 start, qint32 end) const {
+  const int idx = start * matrixPoints.size() + end;
+  if (matrixCosts[idx] >= 0) {
+    return matrixCosts[idx];
   }
 
-  if (routingCache[start_key].contains(end_key)) {
-    return routingCache[start_key][end_key].costs;
+  // Multiply it with the average of the minimum occuring factor and the average factor
+  //  to get a reasonable compromise of optimization speed and optimality of results
+  if (totalNumOfRoutes > 0 && minAirToCostFactor > 0) {
+    return matrixAirDistances[idx] * (totalAirToCosts / totalNumOfRoutes + minAirToCostFactor) / 2;
   } else {
-    // Multiply it with the average of the minimum occuring factor and the average factor
-    //  to get a reasonable compromise of optimization speed and optimality of results
-    if (totalNumOfRoutes > 0 && minAirToCostFactor > 0) {
-      return GPS_Math_DistanceQuick(start.coord.x(), start.coord.y(), end.coord.x(), end.coord.y()) *
-             (totalAirToCosts / totalNumOfRoutes + minAirToCostFactor) / 2;
-    } else {
-      return GPS_Math_DistanceQuick(start.coord.x(), start.coord.y(), end.coord.x(), end.coord.y());
-    }
+    return matrixAirDistances[idx];
   }
 }
 
-const CRouterOptimization::routing_cache_item_t* CRouterOptimization::getRoute(const QPointF& start,
-                                                                               const QPointF& end) {
-  QString start_key = QString::number(start.x(), 'e', 10) + QString::number(start.y(), 'e', 10);
-  QString end_key = QString::number(end.x(), 'e', 10) + QString::number(end.y(), 'e', 10);
+bool CRouterOptimization::getRoute(qint32 start, qint32 end) {
+  const int idx = start * matrixPoints.size() + end;
+  if (matrixCosts[idx] >= 0) {
+    return true;
+  }
 
-  if (!routingCache.contains(start_key)) {
-    routingCache[start_key] = {};
+  QPolygonF route;
+  qreal costs = -1;
+  int response = CRouterSetup::self().calcRoute(matrixPoints[start].coord, matrixPoints[end].coord, route, &costs);
+  if (response < 0) {
+    return false;
   }
+  matrixRoutes[idx] = route;
+  matrixCosts[idx] = costs;
+  addRoute(start, end);
+  return true;
+}
 
-  if (!routingCache[start_key].contains(end_key)) {
-    routing_cache_item_t cacheItem;
-    int response = CRouterSetup::self().calcRoute(start, end, cacheItem.route, &cacheItem.costs);
-    if (response < 0) {
-      return nullptr;
-    }
-    routingCache[start_key][end_key] = cacheItem;
+void CRouterOptimization::addRoute(qint32 start, qint32 end) {
+  const int idx = start * matrixPoints.size() + end;
+  routingCache[matrixKeys[start]][matrixKeys[end]] = {matrixRoutes[idx], matrixCosts[idx]};
 
-    qreal airToCostFactor = cacheItem.costs / GPS_Math_DistanceQuick(start.x(), start.y(), end.x(), end.y());
-    if (airToCostFactor < minAirToCostFactor || minAirToCostFactor < 0) {
-      minAirToCostFactor = airToCostFactor;
-    }
-    totalAirToCosts += airToCostFactor;
-    totalNumOfRoutes++;
+  qreal airToCostFactor = matrixCosts[idx] / matrixAirDistances[idx];
+  if (airToCostFactor < minAirToCostFactor || minAirToCostFactor < 0) {
+    minAirToCostFactor = airToCostFactor;
   }
-  return &routingCache[start_key][end_key];
+  totalAirToCosts += airToCostFactor;
+  totalNumOfRoutes++;
 }
 
-int CRouterOptimization::fillSubPts(SGisLine& line) {
-  for (int i = 0; i < line.length() - 1; i++) {
+int CRouterOptimization::fillSubPts(const order_t& order, SGisLine& line) {
+  const int N = matrixPoints.size();
+  line.resize(order.size());
+  for (int i = 0; i < order.length(); i++) {
+    line[i] = matrixPoints[order[i]];
     line[i].subpts.clear();
-    const routing_cache_item_t* route = getRoute(line[i].coord, line[i + 1].coord);
-    if (route == nullptr) {
+  }
+
+  for (int i = 0; i < order.length() - 1; i++) {
+    if (!getRoute(order[i], order[i + 1])) {
       return -1;
     }
-    for (const QPointF& point : route->route) {
+    for (const QPointF& point : matrixRoutes[order[i] * N + order[i + 1]]) {
       line[i].subpts << IGisLine::subpt_t(point);
     }
   }
   return 0;
 }
 
+QString CRouterOptimization::getKey(const QPointF& point) {
+  // 10 digits after the decimal point in exponential format should be by far enough
+  return QString::number(point.x(), 'e', 10) + QString::number(point.y(), 'e', 10);
+}
+
+void CRouterOptimization::setupMatrix(const SGisLine& line) {
+  const int N = line.size();
+  matrixPoints = line;
+  matrixKeys.resize(N);
+  for (int i = 0; i < N; i++) {
+    matrixKeys[i] = getKey(line[i].coord);
+  }
+
+  matrixRoutes = QVector<QPolygonF>(N * N);
+  matrixCosts = QVector<qreal>(N * N, -1);
+  matrixAirDistances = QVector<qreal>(N * N, 0);
+  for (int i = 0; i < N; i++) {
+    const QPointF& start = line[i].coord;
+    const QMap<QString, routing_cache_item_t>& cache = routingCache.value(matrixKeys[i]);
+    for (int j = 0; j < N; j++) {
+      const QPointF& end = line[j].coord;
+      const int idx = i * N + j;
+      matrixAirDistances[idx] = GPS_Math_DistanceQuick(start.x(), start.y(), end.x(), end.y());
+
+      auto it = cache.constFind(matrixKeys[j]);
+      if (it != cache.constEnd()) {
+        matrixRoutes[idx] = it->route;
+        matrixCosts[idx] = it->costs;
+      }
+    }
+  }
+}
+
+bool CRouterOptimization::calcMatrix() {
+  const int N = matrixPoints.size();
+  if (N > kMaxMatrixPoints) {
+    return true;
+  }
+  const QVector<qreal> knownCosts = matrixCosts;
+
+  QVector<QPointF> points(N);
+  for (int i = 0; i < N; i++) {
+    points[i] = matrixPoints[i].coord;
+  }
+
+  CProgressDialog progress(tr("Calculate routes between all points"), 0, N * (N - 1), nullptr);
+  auto updateProgress = [&](int n) {
+    progress.setValue(n);
+    return !progress.wasCanceled();
+  };
+
+  // routers not able to do this return -1 at once and all routes are calculated on demand
+  if (CRouterSetup::self().calcRouteMatrix(points, matrixRoutes, matrixCosts, updateProgress) < 0) {
+    return !progress.wasCanceled();
+  }
+
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      const int idx = i * N + j;
+      if (knownCosts[idx] < 0 && matrixCosts[idx] >= 0) {
+        addRoute(i, j);
+      }
+    }
+  }
+  return true;
+}
+
 void CRouterOptimization::checkRouter() {
   const QString& options = CRouterSetup::self().getOptions();
   if (routerOptions != options) {
@@ -36,22 +36,55 @@ class CRouterOptimization {
     qreal costs;
   };
 
+  /// an order of the points as indices into the matrix
+  using order_t = QVector<qint32>;
+
   /// returns value by which the costs were changed
-  qreal createNextBestOrder(const SGisLine& oldOrder, SGisLine& newOrder);
-  qreal twoOptStep(const SGisLine& oldOrder, SGisLine& newOrder);
+  qreal createNextBestOrder(const order_t& oldOrder, order_t& newOrder) const;
+  qreal twoOptStep(const order_t& oldOrder, order_t& newOrder) const;
+
+  qreal getRealRouteCosts(const order_t& order, qreal costCutoff = -1);
+  qreal bestKnownDistance(qint32 start, qint32 end) const;
+  /// make sure the route from start to end is in the matrix, false if there is none
+  bool getRoute(qint32 start, qint32 end);
+  /// add a new route of the matrix to the statistics and the cache
+  void addRoute(qint32 start, qint32 end);
+  /// set line to the points in order with the routes as subpoints
+  int fillSubPts(const order_t& order, SGisLine& line);
+  /// setup the matrix for the points of line, with all routes known from the cache
+  void setupMatrix(const SGisLine& line);
+  /**
+     @brief Calculate all missing routes at once, if the router is able to do so
+
+     This is done for lines with up to kMaxMatrixPoints points only. The optimization
+     needs a large share of all routes for short lines anyway. For longer lines the
+     number of routes grows too fast and the routes are calculated on demand.
+   */
+  bool calcMatrix();
 
-  qreal getRealRouteCosts(const SGisLine& line, qreal costCutoff = -1);
-  qreal bestKnownDistance(const IGisLine::point_t& start, const IGisLine::point_t& end);
-  const routing_cache_item_t* getRoute(const QPointF& from, const QPointF& to);
-  int fillSubPts(SGisLine& line);
+  static constexpr qint32 kMaxMatrixPoints = 25;
   /// checks if router settings were changed and if yes, discards the routingCache
   void checkRouter();
 
+  static QString getKey(const QPointF& point);
+
   QMap<QString, QMap<QString, routing_cache_item_t> > routingCache;
   qreal minAirToCostFactor = -1;
   qreal totalAirToCosts = 0;
   qreal totalNumOfRoutes = 0;
   QString routerOptions = "";
+
+  /**
+     The points of the line to optimize and the n x n matrix of all routes
+     between them. The route from point i to j is at index i * n + j. Unknown
+     routes have costs of -1. The optimization loops look up costs by index
+     only.
+   */
+  SGisLine matrixPoints;
+  QVector<QString> matrixKeys;
+  QVector<QPolygonF> matrixRoutes;
+  QVector<qreal> matrixCosts;
+  QVector<qreal> matrixAirDistances;
 };
 
 #endif  // CROUTEROPTIMIZATION_H
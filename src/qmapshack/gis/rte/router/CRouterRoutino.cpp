@@ -21,6 +21,7 @@
 #include <routino.h>
 
 #include <QtWidgets>
+#include <cstdlib>
 
 #include "CMainWindow.h"
 #include "canvas/CCanvas.h"
@@ -248,6 +249,8 @@ void CRouterRoutino::buildDatabaseList() {
       /* determine the profile to use for each database*/
       QVariantMap dmap;
       dmap["db"] = QVariant((qulonglong)data);
+      dmap["path"] = dir.absolutePath();
+      dmap["prefix"] = prefix;
 
       /* check possible profiles.xml locations and use the first available */
       int pError = 0;
@@ -493,3 +496,129 @@ int CRouterRoutino::calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& c
   mutex.unlock();
   return coords.size();
 }
+
+int CRouterRoutino::calcRouteMatrix(const QVector<QPointF>& points, QVector<QPolygonF>& routes, QVector<qreal>& costs,
+                                    const std::function<bool(int)>& progress) {
+  if (!mutex.tryLock()) {
+    return -1;
+  }
+
+  const int N = points.size();
+  Routino_Database* data = nullptr;
+  QAtomicInt cnt = 0;
+
+  try {
+    QVariantMap map = comboDatabase->currentData(Qt::UserRole).toMap();
+    if (map["db"].toULongLong() == 0) {
+      throw QString();
+    }
+
+    loadProfiles(map["profilesPath"].toString());
+
+    QString strProfile = comboProfile->currentData(Qt::UserRole).toString();
+    QString strLanguage = comboLanguage->currentData(Qt::UserRole).toString();
+
+    Routino_Profile* profile = Routino_GetProfile(strProfile.toUtf8());
+    if (profile == NULL) {
+      throw tr("Required profile '%1' is not in the current profiles file.").arg(strProfile);
+    }
+    Routino_Translation* translation = Routino_GetTranslation(strLanguage.toUtf8());
+
+    int options = ROUTINO_ROUTE_LIST_HTML_ALL;
+    if (comboMode->currentIndex() == 0) {
+      options |= ROUTINO_ROUTE_SHORTEST;
+    }
+    if (comboMode->currentIndex() == 1) {
+      options |= ROUTINO_ROUTE_QUICKEST;
+    }
+    const bool quickest = comboMode->currentIndex() == 1;
+
+#ifdef Q_OS_WIN
+    data = Routino_LoadDatabase(map["path"].toString().toLocal8Bit(), map["prefix"].toString().toLocal8Bit());
+#else
+    data = Routino_LoadDatabase(map["path"].toString().toUtf8(), map["prefix"].toString().toUtf8());
+#endif
+    if (data == nullptr) {
+      throw xlateRoutinoError(Routino_errno);
+    }
+
+    if (Routino_ValidateProfile(data, profile) != 0) {
+      throw xlateRoutinoError(Routino_errno);
+    }
+
+    /*
+        libroutino is not documented to be thread safe. The profile is global and
+        errors are reported by the global Routino_errno. Thus all routes are calculated
+        one after the other by a single worker thread, while this thread keeps the
+        progress dialog responsive. Compared to calcRoute() the database is loaded,
+        the profile validated and the waypoints are found once for all routes.
+     */
+    QAtomicInt abort = 0;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.start([&]() {
+      QVector<Routino_Waypoint*> waypoints(N, nullptr);
+      for (int i = 0; i < N; i++) {
+        waypoints[i] = Routino_FindWaypoint(data, profile, points[i].y() * RAD_TO_DEG, points[i].x() * RAD_TO_DEG);
+      }
+
+      for (int i = 0; i < N && abort.loadAcquire() == 0; i++) {
+        for (int j = 0; j < N && abort.loadAcquire() == 0; j++) {
+          const int idx = i * N + j;
+          if (i == j || costs[idx] >= 0 || waypoints[i] == nullptr || waypoints[j] == nullptr) {
+            continue;
+          }
+
+          Routino_Waypoint* pair[2] = {waypoints[i], waypoints[j]};
+          Routino_Output* route = Routino_CalculateRoute(data, profile, translation, pair, 2, options, nullptr);
+          if (route == nullptr) {
+            // the pair is left without route, the reason does not matter
+            continue;
+          }
+
+          QPolygonF& coords = routes[idx];
+          coords.clear();
+          for (Routino_Output* next = route; next != nullptr; next = next->next) {
+            if (next->type != ROUTINO_POINT_WAYPOINT) {
+              coords << QPointF(next->lon, next->lat);
+            }
+            costs[idx] = quickest ? next->time : next->dist;
+          }
+          Routino_DeleteRoute(route);
+          cnt.fetchAndAddOrdered(1);
+        }
+      }
+
+      for (Routino_Waypoint* waypoint : qAsConst(waypoints)) {
+        free(waypoint);
+      }
+    });
+
+    while (!threadPool.waitForDone(100)) {
+      if (!progress(cnt.loadAcquire())) {
+        abort.storeRelease(1);
+      }
+    }
+
+    if (abort.loadAcquire() != 0) {
+      throw QString();
+    }
+    progress(cnt.loadAcquire());
+  } catch (const QString& msg) {
+    cnt.storeRelease(-1);
+
+    if (!msg.isEmpty()) {
+      if (data != nullptr) {
+        Routino_UnloadDatabase(data);
+      }
+      mutex.unlock();
+      throw msg;
+    }
+  }
+
+  if (data != nullptr) {
+    Routino_UnloadDatabase(data);
+  }
+  mutex.unlock();
+  return cnt.loadAcquire();
+}
@@ -36,6 +36,8 @@ class CRouterRoutino : public IRouter, private Ui::IRouterRoutino {
 
   void calcRoute(const IGisItem::key_t& key) override;
   int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs) override;
+  int calcRouteMatrix(const QVector<QPointF>& points, QVector<QPolygonF>& routes, QVector<qreal>& costs,
+                      const std::function<bool(int)>& progress) override;
 
   bool hasFastRouting() override;
 
@@ -84,6 +84,16 @@ int CRouterSetup::calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coo
   return false;
 }
 
+int CRouterSetup::calcRouteMatrix(const QVector<QPointF>& points, QVector<QPolygonF>& routes, QVector<qreal>& costs,
+                                  const std::function<bool(int)>& progress) {
+  IRouter* router = dynamic_cast<IRouter*>(stackedWidget->currentWidget());
+  if (router) {
+    return router->calcRouteMatrix(points, routes, costs, progress);
+  }
+
+  return -1;
+}
+
 QString CRouterSetup::getOptions() {
   IRouter* router = dynamic_cast<IRouter*>(stackedWidget->currentWidget());
   if (router) {
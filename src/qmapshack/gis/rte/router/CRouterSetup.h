@@ -20,6 +20,7 @@
 #define CROUTERSETUP_H
 
 #include <QWidget>
+#include <functional>
 
 #include "gis/IGisItem.h"
 #include "ui_IRouterSetup.h"
@@ -32,6 +33,8 @@ class CRouterSetup : public QWidget, private Ui::IRouterSetup {
 
   void calcRoute(const IGisItem::key_t& key);
   int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr);
+  int calcRouteMatrix(const QVector<QPointF>& points, QVector<QPolygonF>& routes, QVector<qreal>& costs,
+                      const std::function<bool(int)>& progress);
   QString getOptions();
 
   bool hasFastRouting();
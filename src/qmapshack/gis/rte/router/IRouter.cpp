@@ -21,3 +21,8 @@
 IRouter::IRouter(bool fastRouting, QWidget* parent) : QWidget(parent), fastRouting(fastRouting) {}
 
 IRouter::~IRouter() {}
+
+int IRouter::calcRouteMatrix(const QVector<QPointF>& points, QVector<QPolygonF>& routes, QVector<qreal>& costs,
+                             const std::function<bool(int)>& progress) {
+  return -1;
+}
@@ -20,6 +20,7 @@
 #define IROUTER_H
 
 #include <QWidget>
+#include <functional>
 
 #include "gis/IGisItem.h"
 
@@ -33,6 +34,23 @@ class IRouter : public QWidget {
   virtual int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr) = 0;
   virtual bool hasFastRouting() { return fastRouting; }
 
+  /**
+     @brief Calculate the routes between all pairs of points at once
+
+     The route from points[i] to points[j] is at index i * points.size() + j of
+     routes and costs. Routers able to calculate several routes concurrently
+     override this. The default implementation does not calculate anything.
+
+     @param points    The points [rad]
+     @param routes    The routes of all pairs
+     @param costs     The costs of all pairs. Pairs with costs >= 0 are known already and
+                      skipped. Pairs without a route are left at -1.
+     @param progress  Called with the number of finished routes, return false to cancel.
+     @return The number of calculated routes or -1 if not supported, failed or canceled.
+   */
+  virtual int calcRouteMatrix(const QVector<QPointF>& points, QVector<QPolygonF>& routes, QVector<qreal>& costs,
+                              const std::function<bool(int)>& progress);
+
   virtual QString getOptions() = 0;
 
   virtual void routerSelected() {}
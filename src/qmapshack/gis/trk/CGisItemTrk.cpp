@@ -149,6 +149,7 @@ CGisItemTrk::CGisItemTrk(const CGisItemTrk& parentTrk, IGisProject* project, int
   if (clone) {
     trk.name += tr("_Clone");
     key.clear();
+    keyChanged(this);
     history.events.clear();
     setupHistory();
   }
@@ -190,6 +191,19 @@ CGisItemTrk::CGisItemTrk(const QDomNode& xml, IGisProject* project)
   checkForInvalidPoints();
 }
 
+CGisItemTrk::CGisItemTrk(QXmlStreamReader& xml, IGisProject* project, const std::function<void()>& progress)
+    : IGisItem(project, eTypeTrk, project->childCount()) {
+  // --- start read and process data ----
+  setColor(penForeground.color());
+  readTrk(xml, trk, progress);
+  // --- stop read and process data ----
+
+  setupHistory();
+  updateDecoration(eMarkNone, eMarkNone);
+
+  checkForInvalidPoints();
+}
+
 CGisItemTrk::CGisItemTrk(const QString& filename, IGisProject* project)
     : IGisItem(project, eTypeTrk, project->childCount()) {
   // --- start read and process data ----
@@ -308,22 +322,18 @@ void CGisItemTrk::setDataFromPolyline(const SGisLine& l) {
 }
 
 void CGisItemTrk::getPolylineFromData(QPolygonF& l) const {
-  QMutexLocker lock(&mutexItems);
   trk.getPolyline(l);
 }
 
 void CGisItemTrk::getPolylineFromData(SGisLine& l) const {
-  QMutexLocker lock(&mutexItems);
   trk.getPolyline(l);
 }
 
 void CGisItemTrk::getPolylineRangeFromData(SGisLine& l, qint32 rangeStart, qint32 rangeEnd, bool getSubPixel) const {
-  QMutexLocker lock(&mutexItems);
   trk.getPolylineRange(l, rangeStart, rangeEnd, getSubPixel);
 }
 
 void CGisItemTrk::getPolylineDegFromData(QPolygonF& l) const {
-  QMutexLocker lock(&mutexItems);
   trk.getPolylineDeg(l);
 }
 
@@ -752,7 +762,7 @@ static qint32 getIdxPointCloseBy(const QPoint& pos, const QPolygonF& line) {
 }
 
 QPointF CGisItemTrk::getPointCloseBy(const QPoint& screenPos) {
-  QMutexLocker lock(&mutexItems);
+  const QPolygonF& lineSimple = getLineSimple();
 
   qint32 bestIdx = getIdxPointCloseBy(screenPos, lineSimple);
   return (NOIDX == bestIdx) ? NOPOINTF : lineSimple[bestIdx];
@@ -895,6 +905,7 @@ void CGisItemTrk::deriveSecondaryData() {
   totalDescent = NOFLOAT;
   totalElapsedSeconds = NOTIME;
   totalElapsedSecondsMoving = NOTIME;
+  lod.clear();
 
   trk.removeEmptySegments();
 
@@ -974,10 +985,39 @@ void CGisItemTrk::deriveSecondaryData() {
 
     lastTrkpt = &trkpt;
   }
+  trk.updateIndex();
 
   constexpr qreal kMargin = 0.0001 * DEG_TO_RAD;  // ~5m
-  boundingRect = QRectF(QPointF(west * DEG_TO_RAD - kMargin, north * DEG_TO_RAD + kMargin),
-                        QPointF(east * DEG_TO_RAD + kMargin, south * DEG_TO_RAD - kMargin));
+  auto rectWithMargin = [](qreal w, qreal n, qreal e, qreal s) {
+    return QRectF(QPointF(w * DEG_TO_RAD - kMargin, n * DEG_TO_RAD + kMargin),
+                  QPointF(e * DEG_TO_RAD + kMargin, s * DEG_TO_RAD - kMargin));
+  };
+
+  /*
+      Index the track by chunks of visible points. The last point of a chunk is
+      the first one of the next chunk. Thus the chunks cover the line between
+      them, too. For long, winding tracks this is much closer to the line than
+      the bounding rectangle of the whole track.
+   */
+  constexpr qint32 kChunkSize = 64;
+  QVector<QRectF> chunks;
+  for (qint32 i = 0; i < lintrk.size(); i += kChunkSize) {
+    qreal chunkNorth = -90;
+    qreal chunkEast = -180;
+    qreal chunkSouth = 90;
+    qreal chunkWest = 180;
+
+    const qint32 last = qMin(i + kChunkSize, lintrk.size() - 1);
+    for (qint32 j = i; j <= last; j++) {
+      chunkWest = qMin(chunkWest, lintrk[j]->lon);
+      chunkEast = qMax(chunkEast, lintrk[j]->lon);
+      chunkSouth = qMin(chunkSouth, lintrk[j]->lat);
+      chunkNorth = qMax(chunkNorth, lintrk[j]->lat);
+    }
+    chunks << rectWithMargin(chunkWest, chunkNorth, chunkEast, chunkSouth);
+  }
+
+  setBoundingRect(rectWithMargin(west, north, east, south), chunks);
 
   for (int p = 0; p < lintrk.size(); p++) {
     CTrackData::trkpt_t& trkpt = *lintrk[p];
@@ -1147,52 +1187,79 @@ void CGisItemTrk::findWaypointsCloseBy(CProgressDialog& progress, quint32& curre
     pt1.y = qSin(a1 * DEG_TO_RAD) * d;
   }
 
+  // Sort all track points into a grid with a cell size of the outer focus distance.
+  // Thus all points within that distance of a waypoint are in the 3x3 cells around
+  // the waypoint's cell.
+  const qreal cellSize = qSqrt(WPT_FOCUS_DIST_OUT);
+  auto cellKey = [](qint32 cx, qint32 cy) { return (quint64(quint32(cx)) << 32) | quint32(cy); };
+
+  QHash<quint64, QVector<qint32>> grid;
+  for (qint32 i = 0; i < line.size(); i++) {
+    grid[cellKey(qFloor(line[i].x / cellSize), qFloor(line[i].y / cellSize))] << i;
+  }
+
   bool doDeriveData = false;
+  auto attach = [&](const trkwpt_t& trkwpt, qint32 index) {
+    CTrackData::trkpt_t* trkpt = trk.getTrkPtByTotalIndex(index);
+    if (trkpt) {
+      ++numberOfAttachedWpt;
+      trkpt->keyWpt = trkwpt.key;
+      if (trkpt->isHidden()) {
+        trkpt->unsetFlag(CTrackData::trkpt_t::eFlagHidden);
+        doDeriveData = true;
+      }
+    }
+  };
+
   numberOfAttachedWpt = 0;
   for (const trkwpt_t& trkwpt : qAsConst(trkwpts)) {
-    qreal minD = WPT_FOCUS_DIST_IN;
-    qint32 index = NOIDX;
-
-    for (const pointDP& pt : qAsConst(line)) {
-      ++current;
-      qreal d = (trkwpt.x - pt.x) * (trkwpt.x - pt.x) + (trkwpt.y - pt.y) * (trkwpt.y - pt.y);
-
-      if (d < WPT_FOCUS_DIST_IN) {
-        if (d < minD) {
-          index = pt.idx;
-          minD = d;
-        }
-      } else if (withDoubles && (d > WPT_FOCUS_DIST_OUT)) {
-        CTrackData::trkpt_t* trkpt = const_cast<CTrackData::trkpt_t*>(trk.getTrkPtByTotalIndex(index));
-        if (trkpt) {
-          ++numberOfAttachedWpt;
-          trkpt->keyWpt = trkwpt.key;
-          if (trkpt->isHidden()) {
-            trkpt->unsetFlag(CTrackData::trkpt_t::eFlagHidden);
-            doDeriveData = true;
+    // collect all track points within the outer focus distance in the order of the track
+    const qint32 cx = qFloor(trkwpt.x / cellSize);
+    const qint32 cy = qFloor(trkwpt.y / cellSize);
+    QVector<qint32> candidates;
+    for (qint32 x = cx - 1; x <= cx + 1; x++) {
+      for (qint32 y = cy - 1; y <= cy + 1; y++) {
+        for (qint32 i : grid.value(cellKey(x, y))) {
+          const pointDP& pt = line[i];
+          qreal d = (trkwpt.x - pt.x) * (trkwpt.x - pt.x) + (trkwpt.y - pt.y) * (trkwpt.y - pt.y);
+          if (d <= WPT_FOCUS_DIST_OUT) {
+            candidates << i;
           }
         }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
 
+    // Each gap in the candidates is a part of the track leaving the outer focus
+    // distance. If doubles are allowed the waypoint is attached to the closest
+    // point of each pass within the inner focus distance.
+    qreal minD = WPT_FOCUS_DIST_IN;
+    qint32 index = NOIDX;
+    qint32 prev = NOIDX;
+    for (qint32 i : qAsConst(candidates)) {
+      if (withDoubles && (prev != NOIDX) && (i != prev + 1) && (index != NOIDX)) {
+        attach(trkwpt, index);
         index = NOIDX;
         minD = WPT_FOCUS_DIST_IN;
       }
+      prev = i;
 
-      if (current - lastCurrent > 100) {
-        lastCurrent = current;
-        PROGRESS(current, return );
+      const pointDP& pt = line[i];
+      qreal d = (trkwpt.x - pt.x) * (trkwpt.x - pt.x) + (trkwpt.y - pt.y) * (trkwpt.y - pt.y);
+      if (d < minD) {
+        index = pt.idx;
+        minD = d;
       }
     }
 
     if (index != NOIDX) {
-      CTrackData::trkpt_t* trkpt = const_cast<CTrackData::trkpt_t*>(trk.getTrkPtByTotalIndex(index));
-      if (trkpt) {
-        ++numberOfAttachedWpt;
-        trkpt->keyWpt = trkwpt.key;
-        if (trkpt->isHidden()) {
-          trkpt->unsetFlag(CTrackData::trkpt_t::eFlagHidden);
-          doDeriveData = true;
-        }
-      }
+      attach(trkwpt, index);
+    }
+
+    current += line.size();
+    if (current - lastCurrent > 100) {
+      lastCurrent = current;
+      PROGRESS(current, return );
     }
   }
 
@@ -1203,9 +1270,7 @@ void CGisItemTrk::findWaypointsCloseBy(CProgressDialog& progress, quint32& curre
 }
 
 bool CGisItemTrk::isCloseTo(const QPointF& pos) {
-  QMutexLocker lock(&mutexItems);
-
-  return GPS_Math_DistPointPolyline(lineSimple, pos) < 20;
+  return GPS_Math_DistPointPolyline(getLineSimple(), pos) < 20;
 }
 
 bool CGisItemTrk::isWithin(const QRectF& area, selflags_t flags) {
@@ -1371,6 +1436,7 @@ void CGisItemTrk::reverse() {
    */
   trk1->trk.segs.clear();
   trk1->key.clear();
+  keyChanged(trk1);
   trk1->history.events.clear();
 
   for (const CTrackData::trkseg_t& seg : qAsConst(trk.segs)) {
@@ -1412,6 +1478,7 @@ void CGisItemTrk::combine(const QList<IGisItem::key_t>& keys) {
    */
   trk1->trk.segs.clear();
   trk1->key.clear();
+  keyChanged(trk1);
   trk1->history.events.clear();
 
   // copy the segments of all tracks to new track
@@ -1562,17 +1629,35 @@ void CGisItemTrk::copySelectedPoints() const {
   new CGisItemTrk(name, idx1, idx2, trk, project);
 }
 
+QPolygonF CGisItemTrk::getLineSimple() {
+  const screen_t& current = screen.get();
+  if (!current.hit.isValid()) {
+    return current.lineSimple;
+  }
+
+  // Expand the line without holding the snapshot's lock. Keep it for the next
+  // call unless the draw thread has published a new pass in the meantime.
+  const QPolygonF& line = current.hit.getLine();
+  screen.modify([&current, &line](screen_t& latest) {
+    if (latest.pass == current.pass) {
+      latest.lineSimple = line;
+      latest.hit = CTrackLod::hit_t();
+    }
+  });
+  return line;
+}
+
 void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) {
   QMutexLocker lock(&mutexItems);
 
-  lineSimple.clear();
-  lineFull.clear();
-
-  if (!isVisible(boundingRect, viewport, gis)) {
-    return;
-  }
+  // build the new track line aside and publish it as a whole when done
+  screen_t next;
+  next.pass = ++drawPass;
+  QPolygonF& lineSimple = next.lineSimple;
+  QPolygonF& lineFull = next.lineFull;
 
-  if (trk.segs.isEmpty()) {
+  if (!isVisible(boundingRect, viewport, gis) || trk.segs.isEmpty()) {
+    screen.publish(next);
     return;
   }
 
@@ -1583,17 +1668,18 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
   gis->convertRad2Px(p2);
   QRectF extViewport(p1, p2);
 
+  // the line actually drawn, a simplified version of lineSimple if possible
+  QPolygonF lineDraw;
   if (mode == eModeNormal) {
-    // in normal mode the trackline without points marked as deleted is drawn
-    for (const CTrackData::trkpt_t& pt : trk) {
-      if (pt.isHidden()) {
-        continue;
-      }
-
-      pt1.setX(pt.lon);
-      pt1.setY(pt.lat);
-      pt1 *= DEG_TO_RAD;
-      lineSimple << pt1;
+    // in normal mode the trackline without points marked as deleted is drawn.
+    // Only the visible part of it is projected. The line with all points
+    // is built on demand by getLineSimple().
+    lod.getLines(trk, viewport, extViewport, gis, next.hit, lineDraw);
+    if (!getColorizeSource().isEmpty()) {
+      // colorizing needs all points
+      lineSimple = next.hit.getLine();
+      next.hit = CTrackLod::hit_t();
+      lineDraw = lineSimple;
     }
   } else {
     // in full mode the complete track including points marked as deleted
@@ -1612,9 +1698,12 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
 
       lineSimple << pt1;
     }
+
+    gis->convertRad2Px(lineSimple);
+    gis->convertRad2Px(lineFull);
+    lineDraw = lineSimple;
   }
-  gis->convertRad2Px(lineSimple);
-  gis->convertRad2Px(lineFull);
+  screen.publish(next);
 
   // draw the full line first
   if (mode == eModeRange) {
@@ -1638,7 +1727,7 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
 
   // draw the reduced track line
   QList<QPolygonF> lines;
-  splitLineToViewport(lineSimple, extViewport, lines);
+  splitLineToViewport(lineDraw, extViewport, lines);
 
   const CMainWindow& w = CMainWindow::self();
   if (key == keyUserFocus && w.isShowTrackHighlight()) {
@@ -1667,9 +1756,9 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
       p.drawPolyline(l);
     }
   } else if (getColorizeSource() == "activity") {
-    drawColorizedByActivity(p);
+    drawColorizedByActivity(p, lineSimple);
   } else {
-    drawColorized(p);
+    drawColorized(p, lineSimple);
   }
 
   if (isNogo()) {
@@ -1770,7 +1859,7 @@ void CGisItemTrk::setPen(QPainter& p, QPen& pen, trkact_t act) const {
   p.setPen(pen);
 }
 
-void CGisItemTrk::drawColorizedByActivity(QPainter& p) const {
+void CGisItemTrk::drawColorizedByActivity(QPainter& p, const QPolygonF& lineSimple) const {
   QPen pen;
   pen.setWidth(penWidthFg);
   pen.setCapStyle(Qt::RoundCap);
@@ -1799,7 +1888,7 @@ void CGisItemTrk::drawColorizedByActivity(QPainter& p) const {
   }
 }
 
-void CGisItemTrk::drawColorized(QPainter& p) const {
+void CGisItemTrk::drawColorized(QPainter& p, const QPolygonF& lineSimple) const {
   auto valueFunc = CKnownExtension::get(getColorizeSource()).valueFunc;
 
   QImage colors(1, 256, QImage::Format_RGB888);
@@ -1914,8 +2003,6 @@ void CGisItemTrk::setColorizeLimitHigh(qreal limit) {
 QString CGisItemTrk::getColorizeUnit() const { return CKnownExtension::get(getColorizeSource()).unit; }
 
 void CGisItemTrk::drawItem(QPainter& p, const QRectF& viewport, CGisDraw* gis) {
-  QMutexLocker lock(&mutexItems);
-
   if (trk.segs.isEmpty()) {
     return;
   }
@@ -2081,7 +2168,7 @@ void CGisItemTrk::drawLabel(QPainter& p, const QPolygonF&, QList<QRectF>& blocke
 }
 
 void CGisItemTrk::drawHighlight(QPainter& p) {
-  QMutexLocker lock(&mutexItems);
+  const QPolygonF lineSimple = getLineSimple();
 
   if (lineSimple.isEmpty() || hasUserFocus()) {
     return;
@@ -2099,8 +2186,6 @@ void CGisItemTrk::drawHighlight(QPainter& p) {
 }
 
 void CGisItemTrk::drawRange(QPainter& p, CGisDraw* gis) {
-  QMutexLocker lock(&mutexItems);
-
   int idx1, idx2;
   getMouseRange(idx1, idx2, mode == eModeRange);
 
@@ -2108,7 +2193,7 @@ void CGisItemTrk::drawRange(QPainter& p, CGisDraw* gis) {
     return;
   }
 
-  const QPolygonF& line = (mode == eModeRange) ? lineFull : lineSimple;
+  const QPolygonF line = (mode == eModeRange) ? screen.get().lineFull : getLineSimple();
 
   QPolygonF seg = line.mid(idx1, idx2 - idx1 + 1);
 
@@ -2323,12 +2408,10 @@ bool CGisItemTrk::setMouseFocusByTime(quint32 time, focusmode_e fmode, const QSt
 }
 
 QPointF CGisItemTrk::setMouseFocusByPoint(const QPoint& pt, focusmode_e fmode, const QString& owner) {
-  QMutexLocker lock(&mutexItems);
-
   const CTrackData::trkpt_t* newPointOfFocus = nullptr;
   quint32 idx = 0;
 
-  const QPolygonF& line = (mode == eModeRange) ? lineFull : lineSimple;
+  const QPolygonF line = (mode == eModeRange) ? screen.get().lineFull : getLineSimple();
 
   if (pt != NOPOINT && GPS_Math_DistPointPolyline(line, pt) < MIN_DIST_FOCUS) {
     /*
@@ -2708,6 +2791,7 @@ const searchValue_t CGisItemTrk::getValueByKeyword(searchProperty_e keyword) {
 }
 
 bool CGisItemTrk::findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qint32& threshold, QPolygonF& polyline) {
+  const QPolygonF lineSimple = getLineSimple();
   qreal dist1 = GPS_Math_DistPointPolyline(lineSimple, pt1, threshold);
   qreal dist2 = GPS_Math_DistPointPolyline(lineSimple, pt2, threshold);
 
@@ -32,14 +32,18 @@
 #include "gis/trk/CActivityTrk.h"
 #include "gis/trk/CEnergyCycling.h"
 #include "gis/trk/CTrackData.h"
+#include "gis/trk/CTrackLod.h"
 #include "gis/trk/filter/CFilterSpeedCycle.h"
 #include "gis/trk/filter/CFilterSpeedHike.h"
 #include "helpers/CLimit.h"
+#include "helpers/CSnapshot.h"
 #include "helpers/CValue.h"
 
 using std::numeric_limits;
 
 class QDomNode;
+class QTextStream;
+class QXmlStreamReader;
 class IGisProject;
 class INotifyTrk;
 class CDetailsTrk;
@@ -96,6 +100,15 @@ class CGisItemTrk : public IGisItem, public IGisLine {
   /** @brief Used to create track from GPX file */
   CGisItemTrk(const QDomNode& xml, IGisProject* project);
 
+  /**
+     @brief Used to create track from a GPX file read as stream
+
+     @param xml       The reader positioned at the <trk> start tag. It is left at the end tag.
+     @param project   The project this track belongs to
+     @param progress  Called every now and then while reading the points
+   */
+  CGisItemTrk(QXmlStreamReader& xml, IGisProject* project, const std::function<void()>& progress);
+
   /** @brief Used to restore track from history structure */
   CGisItemTrk(const history_t& hist, const QString& dbHash, IGisProject* project);
 
@@ -148,6 +161,17 @@ class CGisItemTrk : public IGisItem, public IGisLine {
    */
   void save(QDomNode& gpx, bool strictGpx11) override;
 
+  /**
+     @brief Write the track directly to a GPX file
+
+     The output is the same as the one of save(). But the points are written in
+     chunks. Thus the DOM of the complete track is never built.
+
+     @param out       The stream of the GPX file, the track is written as child of <gpx>
+     @param progress  Called after each chunk of points
+   */
+  void saveGpx(QTextStream& out, bool strictGpx11, const std::function<void()>& progress);
+
   /**
      @brief Save track to TwoNav track file
      @param dir   the path to store the file
@@ -294,8 +318,8 @@ class CGisItemTrk : public IGisItem, public IGisLine {
   qreal getMax(const QString& source) const;
 
  private:
-  void drawColorized(QPainter& p) const;
-  void drawColorizedByActivity(QPainter& p) const;
+  void drawColorized(QPainter& p, const QPolygonF& lineSimple) const;
+  void drawColorizedByActivity(QPainter& p, const QPolygonF& lineSimple) const;
   void setPen(QPainter& p, QPen& pen, trkact_t act) const;
   /**@}*/
 
@@ -620,6 +644,14 @@ class CGisItemTrk : public IGisItem, public IGisLine {
      @param trk   The track structure to fill
    */
   void readTrk(const QDomNode& xml, CTrackData& trk);
+  /// the same as readTrk() above, but the points are read one by one from the stream
+  void readTrk(QXmlStreamReader& xml, CTrackData& trk, const std::function<void()>& progress);
+  /// read all tags of <trk> but the segments
+  void readTrkTags(const QDomNode& xml, CTrackData& trk);
+  void readTrkPt(const QDomNode& xml, CTrackData::trkpt_t& trkpt);
+  /// append all tags of <trk> but the segments
+  void saveTrkTags(QDomElement& xmlTrk, bool strictGpx11);
+  void saveTrkPt(QDomElement& xmlTrkseg, const CTrackData::trkpt_t& trkpt, bool strictGpx11);
 
   /**
      @brief Restore track from TwoNav *trk file
@@ -805,9 +837,28 @@ class CGisItemTrk : public IGisItem, public IGisLine {
   unsigned colorIdx = 4;  //< the track line color by index
   QColor color;           //< the track line color
 
-  QPixmap bullet;        //< the trackpoint bullet icon
-  QPolygonF lineSimple;  //< the current track line as screen pixel coordinates
-  QPolygonF lineFull;    //< visible and invisible points
+  QPixmap bullet;  //< the trackpoint bullet icon
+
+  struct screen_t {
+    QPolygonF lineSimple;  //< the current track line as screen pixel coordinates, use getLineSimple()
+    QPolygonF lineFull;    //< visible and invisible points
+    CTrackLod::hit_t hit;  //< to build lineSimple on demand in normal mode
+    quint32 pass = 0;      //< the draw pass the lines belong to
+  };
+  /// the track line of the last draw pass, written by the draw thread and read by the GUI
+  CSnapshot<screen_t> screen;
+  /// the number of draw passes so far, changed with mutexItems locked
+  quint32 drawPass = 0;
+
+  /**
+     @brief Get the track line of the last draw pass with one point per visible track point
+
+     In normal mode the line is built by the first call after a draw pass.
+
+     @return The line as screen pixel coordinates
+   */
+  QPolygonF getLineSimple();
+  CTrackLod lod;  //< the levels of detail to draw the track line
 
   qint32 penWidthFg = 1;   //< inner trackline width
   qint32 penWidthBg = 3;   //< outer trackline width
@@ -170,37 +170,71 @@ bool CTrackData::isTrkPtFirstVisible(qint32 idxTotal) const {
   return true;
 }
 
+void CTrackData::updateIndex() {
+  indexTotal.clear();
+  indexVisible.clear();
+
+  for (qint32 s = 0; s < segs.size(); s++) {
+    const QVector<trkpt_t>& pts = segs[s].pts;
+    for (qint32 p = 0; p < pts.size(); p++) {
+      indexTotal << trkpt_pos_t{s, p};
+      if (!pts[p].isHidden()) {
+        indexVisible << trkpt_pos_t{s, p};
+      }
+    }
+  }
+}
+
 const CTrackData::trkpt_t* CTrackData::getTrkPtByVisibleIndex(qint32 idx) const {
   if (idx == NOIDX) {
     return nullptr;
   }
 
+  if (idx >= 0 && idx < indexVisible.size()) {
+    const trkpt_pos_t& pos = indexVisible[idx];
+    if (pos.seg < segs.size() && pos.pt < segs[pos.seg].pts.size()) {
+      const trkpt_t& trkpt = segs[pos.seg].pts[pos.pt];
+      if (trkpt.idxVisible == idx && !trkpt.isHidden()) {
+        return &trkpt;
+      }
+    }
+  }
+
+  // the lookup table is outdated
   auto condition = [idx](const trkpt_t& pt) { return pt.idxVisible == idx; };
   return getTrkPtByCondition(condition);
 }
 
-const CTrackData::trkpt_t* CTrackData::getTrkPtByTotalIndex(qint32 idx) const {
-  for (const trkseg_t& seg : segs) {
-    if (seg.isEmpty() || idx < seg.pts.first().idxTotal || idx > seg.pts.last().idxTotal) {
-      continue;
+bool CTrackData::getPosByTotalIndex(qint32 idx, trkpt_pos_t& pos) const {
+  if (idx >= 0 && idx < indexTotal.size()) {
+    pos = indexTotal[idx];
+    if (pos.seg < segs.size() && pos.pt < segs[pos.seg].pts.size() && segs[pos.seg].pts[pos.pt].idxTotal == idx) {
+      return true;
     }
-
-    return &seg.pts[idx - seg.pts.first().idxTotal];
   }
 
-  return nullptr;
-}
-
-CTrackData::trkpt_t* CTrackData::getTrkPtByTotalIndex(qint32 idx) {
-  for (trkseg_t& seg : segs) {
+  // the lookup table is outdated
+  for (pos.seg = 0; pos.seg < segs.size(); pos.seg++) {
+    const trkseg_t& seg = segs[pos.seg];
     if (seg.isEmpty() || idx < seg.pts.first().idxTotal || idx > seg.pts.last().idxTotal) {
       continue;
     }
 
-    return &seg.pts[idx - seg.pts.first().idxTotal];
+    pos.pt = idx - seg.pts.first().idxTotal;
+    return true;
   }
 
-  return nullptr;
+  return false;
+}
+
+const CTrackData::trkpt_t* CTrackData::getTrkPtByTotalIndex(qint32 idx) const {
+  trkpt_pos_t pos;
+  return getPosByTotalIndex(idx, pos) ? &segs[pos.seg].pts[pos.pt] : nullptr;
+}
+
+CTrackData::trkpt_t* CTrackData::getTrkPtByTotalIndex(qint32 idx) {
+  trkpt_pos_t pos;
+  return getPosByTotalIndex(idx, pos) ? &segs[pos.seg].pts[pos.pt] : nullptr;
 }
 
 bool CTrackData::isTrkPtLastVisible(qint32 idxTotal) const {
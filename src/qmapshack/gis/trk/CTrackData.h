@@ -7,6 +7,7 @@
 
 #include "gis/GeoMath.h"
 #include "gis/IGisItem.h"
+#include "gis/trk/CTrkPtExtensions.h"
 #include "gis/proj_x.h"
 
 struct SGisLine;
@@ -163,7 +164,7 @@ class CTrackData {
     qreal elapsedSeconds;                 //< the seconds since the start of the track
     qreal elapsedSecondsMoving;           //< the seconds since the start of the track with moving speed
     IGisItem::key_t keyWpt;               //< the key of an attached waypoint
-    QHash<QString, QVariant> extensions;  //< track point extensions
+    CTrkPtExtensions extensions;          //< track point extensions
 
     static const QMap<act10_e, act20_e> act1to2;
     static const QMap<act20_e, act10_e> act2to1;
@@ -227,11 +228,20 @@ class CTrackData {
   const trkpt_t* getTrkPtByCondition(std::function<bool(const trkpt_t&)> cond) const;
   trkpt_t* getTrkPtByCondition(std::function<bool(const trkpt_t&)> cond);
 
+  /**
+     @brief Update the lookup tables of getTrkPtByTotalIndex() and getTrkPtByVisibleIndex()
+
+     Call this each time idxTotal and idxVisible of the points have been assigned.
+     The result of a lookup is checked against the point's index. Thus an outdated
+     table makes the lookup slower but never wrong.
+   */
+  void updateIndex();
+
   /**
      @brief Try to get access Nth visible point matching the idx
 
-     This will iterate over all segments and count the visible points. If the
-     count matches idx a pointer to the track point is returned.
+     The point is looked up in a table built by updateIndex(). If the table is
+     outdated this will iterate over all segments.
 
      @param idx The index into all visible points
      @return A null pointer of no point is found.
@@ -240,8 +250,8 @@ class CTrackData {
   /**
      @brief Try to get access Nth point
 
-     This will iterate over all segments. If the index matches
-     a pointer to the track point is returned.
+     The point is looked up in a table built by updateIndex(). If the table is
+     outdated this will iterate over all segments.
 
      @param idx The index into all points
      @return A null pointer of no point is found.
@@ -310,6 +320,18 @@ class CTrackData {
   iterator<const CTrackData, const trkpt_t> end() const {
     return iterator<const CTrackData, const trkpt_t>(*this, segs.count(), 0);
   }
+
+ private:
+  /// the position of a point in segs
+  struct trkpt_pos_t {
+    qint32 seg;
+    qint32 pt;
+  };
+
+  bool getPosByTotalIndex(qint32 idx, trkpt_pos_t& pos) const;
+
+  QVector<trkpt_pos_t> indexTotal;    //< the position of each point by idxTotal
+  QVector<trkpt_pos_t> indexVisible;  //< the position of each visible point by idxVisible
 };
 
 QDataStream& operator<<(QDataStream& stream, const CTrackData::trkpt_t& pt);
@@ -0,0 +1,274 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/trk/CTrackLod.h"
+
+#include <QLineF>
+#include <QStack>
+#include <QtMath>
+
+#include "gis/CGisDraw.h"
+#include "gis/GeoMath.h"
+#include "gis/proj_x.h"
+#include "gis/trk/CTrackData.h"
+
+#define LOD_LEVELS 9
+#define LOD_TOLERANCE_MIN 1.0  // tolerance of level 1 [m], each further level multiplies it by 4
+#define LOD_MAX_ERROR 0.5      // maximum deviation of the simplified line [px]
+#define CHUNK_SIZE 256         // number of points per chunk
+#define EARTH_RADIUS 6371010.0
+
+// unlike QRectF::intersects() this works for rectangles of zero width or height, too
+static bool intersects(const QRectF& rect1, const QRectF& rect2) {
+  return rect1.left() <= rect2.right() && rect1.right() >= rect2.left() && rect1.top() <= rect2.bottom() &&
+         rect1.bottom() >= rect2.top();
+}
+
+static qreal distPointSegment(const QPointF& pt, const QPointF& pt1, const QPointF& pt2) {
+  const QPointF seg = pt2 - pt1;
+  const qreal len2 = QPointF::dotProduct(seg, seg);
+  const qreal t = len2 > 0 ? qBound(0.0, QPointF::dotProduct(pt - pt1, seg) / len2, 1.0) : 0.0;
+  const QPointF d = pt - (pt1 + t * seg);
+  return qSqrt(QPointF::dotProduct(d, d));
+}
+
+QVector<qint32> CTrackLod::simplify(const QPolygonF& line, qreal tolerance) {
+  const qint32 size = line.size();
+  QVector<bool> used(size, size < 3);
+  if (size >= 3) {
+    used[0] = used[size - 1] = true;
+
+    QStack<QPair<qint32, qint32>> stack;
+    stack.push(qMakePair(0, size - 1));
+    while (!stack.isEmpty()) {
+      const QPair<qint32, qint32> seg = stack.pop();
+
+      qint32 idx = -1;
+      qreal dmax = tolerance;
+      for (qint32 i = seg.first + 1; i < seg.second; i++) {
+        const qreal d = distPointSegment(line[i], line[seg.first], line[seg.second]);
+        if (d > dmax) {
+          idx = i;
+          dmax = d;
+        }
+      }
+
+      if (idx != -1) {
+        used[idx] = true;
+        stack.push(qMakePair(seg.first, idx));
+        stack.push(qMakePair(idx, seg.second));
+      }
+    }
+  }
+
+  QVector<qint32> idx;
+  for (qint32 i = 0; i < size; i++) {
+    if (used[i]) {
+      idx << i;
+    }
+  }
+  return idx;
+}
+
+qreal CTrackLod::getTolerance(qint32 n) { return n == 0 ? 0 : LOD_TOLERANCE_MIN * qPow(4, n - 1); }
+
+QPolygonF CTrackLod::hit_t::getLine() const {
+  QPolygonF line;
+  line.reserve(size);
+  for (qint32 i = 0; i < chunks.size(); i++) {
+    // the chunk's points but the last one, as it is the first one of the next chunk
+    const QPolygonF& chunk = chunks[i];
+    const qint32 n = qMin(CHUNK_SIZE, size - 1 - i * CHUNK_SIZE);
+    if (chunk.size() == n + 1) {
+      line << chunk.mid(0, n);
+    } else {
+      // A chunk outside the viewport is replaced by its first point, which
+      // keeps the line outside the viewport.
+      line.insert(line.end(), n, chunk.first());
+    }
+  }
+
+  if (!chunks.isEmpty()) {
+    line << chunks.last().last();
+  }
+  return m2px.map(line);
+}
+
+qreal CTrackLod::getTolerance(qint32 n) { return n == 0 ? 0 : LOD_TOLERANCE_MIN * qPow(4, n - 1); }
+
+CTrackLod::level_t& CTrackLod::getLevel(const CTrackData& trk, qint32 n) {
+  level_t& level = levels[n];
+  if (level.isValid) {
+    return level;
+  }
+
+  if (n == 0) {
+    for (const CTrackData::trkpt_t& pt : trk) {
+      if (!pt.isHidden()) {
+        level.line << QPointF(pt.lon * DEG_TO_RAD, pt.lat * DEG_TO_RAD);
+      }
+    }
+  } else {
+    const QPolygonF& line = getLevel(trk, 0).line;
+
+    // Simplify the line on an equirectangular projection centered at the
+    // track. This is precise enough for drawing.
+    const QPointF& center = line.boundingRect().center();
+    const qreal scaleX = qCos(center.y()) * EARTH_RADIUS;
+
+    QPolygonF lineMeter;
+    lineMeter.reserve(line.size());
+    for (const QPointF& pt : line) {
+      lineMeter << QPointF((pt.x() - center.x()) * scaleX, (pt.y() - center.y()) * EARTH_RADIUS);
+    }
+
+    const QVector<qint32>& idx = simplify(lineMeter, getTolerance(n));
+    level.line.reserve(idx.size());
+    for (qint32 i : idx) {
+      level.line << line[i];
+    }
+  }
+
+  // the chunks overlap by one point, a single point makes a chunk of its own
+  const qint32 size = level.line.size();
+  for (qint32 i = 0; i < (size == 1 ? 1 : size - 1); i += CHUNK_SIZE) {
+    chunk_t chunk;
+    chunk.rect = QPolygonF(level.line.mid(i, CHUNK_SIZE + 1)).boundingRect();
+    level.chunks << chunk;
+  }
+
+  level.isValid = true;
+  return level;
+}
+
+QVector<bool> CTrackLod::getVisibleChunks(level_t& level, const QRectF& extViewport, const QTransform& m2px,
+                                          CGisDraw* gis) const {
+  const qint32 size = level.line.size();
+  const qint32 N = level.chunks.size();
+
+  // project the bounds of all chunks at once
+  if (N > 0 && level.chunks[0].bounds.isEmpty()) {
+    QPolygonF bounds;
+    bounds.reserve(N * 6);
+    for (qint32 i = 0; i < N; i++) {
+      const QRectF& rect = level.chunks[i].rect;
+      bounds << rect.topLeft() << rect.topRight() << rect.bottomRight() << rect.bottomLeft();
+      bounds << level.line[i * CHUNK_SIZE] << level.line[qMin((i + 1) * CHUNK_SIZE, size - 1)];
+    }
+    gis->convertRad2M(bounds);
+
+    for (qint32 i = 0; i < N; i++) {
+      level.chunks[i].bounds = bounds.mid(i * 6, 6);
+    }
+  }
+
+  const QRectF& rectViewport = extViewport.normalized();
+  QVector<bool> isVisible(N);
+  QPolygonF points;
+  for (qint32 i = 0; i < N; i++) {
+    const chunk_t& chunk = level.chunks[i];
+    const QPolygonF& corners = m2px.map(QPolygonF(chunk.bounds.mid(0, 4)));
+    isVisible[i] = intersects(corners.boundingRect(), rectViewport);
+    if (isVisible[i] && chunk.line.isEmpty()) {
+      points << level.line.mid(i * CHUNK_SIZE, CHUNK_SIZE + 1);
+    }
+  }
+
+  // project the points of all chunks visible for the first time at once
+  if (!points.isEmpty()) {
+    gis->convertRad2M(points);
+
+    qint32 k = 0;
+    for (qint32 i = 0; i < N; i++) {
+      chunk_t& chunk = level.chunks[i];
+      if (isVisible[i] && chunk.line.isEmpty()) {
+        const qint32 n = qMin(CHUNK_SIZE + 1, size - i * CHUNK_SIZE);
+        chunk.line = points.mid(k, n);
+        k += n;
+      }
+    }
+  }
+  return isVisible;
+}
+
+void CTrackLod::getLines(const CTrackData& trk, const QPolygonF& viewport, const QRectF& extViewport, CGisDraw* gis,
+                         hit_t& hit, QPolygonF& lineDraw) {
+  QMutexLocker lock(&mutex);
+
+  hit = hit_t();
+  lineDraw.clear();
+
+  if (isOutdated.fetchAndStoreOrdered(0) || levels.isEmpty()) {
+    levels = QVector<level_t>(LOD_LEVELS);
+  }
+
+  // the projected points are valid as long as the projection is the same
+  const QString& currentProjection = gis->getProjection();
+  if (currentProjection != projection) {
+    projection = currentProjection;
+    for (level_t& level : levels) {
+      for (chunk_t& chunk : level.chunks) {
+        chunk.bounds.clear();
+        chunk.line.clear();
+      }
+    }
+  }
+
+  // select the coarsest level that is still good enough for the current scale
+  const qreal meterPerPixel =
+      GPS_Math_DistanceQuick(viewport[0].x(), viewport[0].y(), viewport[2].x(), viewport[2].y()) /
+      QLineF(extViewport.topLeft(), extViewport.bottomRight()).length();
+
+  qint32 n = LOD_LEVELS - 1;
+  while (n > 0 && getTolerance(n) > meterPerPixel * LOD_MAX_ERROR) {
+    n--;
+  }
+
+  const QTransform& m2px = gis->getTransformM2Px();
+
+  level_t& level0 = getLevel(trk, 0);
+  const QVector<bool>& isVisible0 = getVisibleChunks(level0, extViewport, m2px, gis);
+
+  // the hit line is expanded to one point per track point on demand only
+  hit.size = level0.line.size();
+  hit.m2px = m2px;
+  hit.chunks.reserve(level0.chunks.size());
+  for (qint32 i = 0; i < level0.chunks.size(); i++) {
+    const chunk_t& chunk = level0.chunks[i];
+    hit.chunks << (isVisible0[i] ? chunk.line : QPolygonF(chunk.bounds.mid(4, 2)));
+  }
+
+  // keep all points of visible chunks and the first and last point of all others
+  level_t& level = getLevel(trk, n);
+  const QVector<bool>& isVisible = n == 0 ? isVisible0 : getVisibleChunks(level, extViewport, m2px, gis);
+
+  QPolygonF points;
+  for (qint32 i = 0; i < level.chunks.size(); i++) {
+    const chunk_t& chunk = level.chunks[i];
+    const bool isLast = i == level.chunks.size() - 1;
+    if (isVisible[i]) {
+      points << (isLast ? chunk.line : QPolygonF(chunk.line.mid(0, chunk.line.size() - 1)));
+    } else {
+      points << chunk.bounds[4];
+      if (isLast && level.line.size() > 1) {
+        points << chunk.bounds[5];
+      }
+    }
+  }
+  lineDraw = m2px.map(points);
+}
@@ -0,0 +1,132 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTRACKLOD_H
+#define CTRACKLOD_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QPolygonF>
+#include <QString>
+#include <QTransform>
+#include <QVector>
+
+class CTrackData;
+class CGisDraw;
+
+/**
+   @brief Levels of detail of a track line for drawing
+
+   Each level holds the visible track points left by the Douglas Peucker algorithm
+   with the level's tolerance. Level 0 is the track itself. The levels are built
+   on demand by the draw thread. Any thread can mark them outdated by clear().
+
+   Each level is split into chunks of consecutive points. Only the points of chunks
+   intersecting the viewport are projected. As the bounding rectangle of a chunk
+   contains the line between its first and last point, a chunk outside the viewport
+   can be replaced by these two points without changing what is visible.
+
+   The projected points are kept per chunk until the track or the projection changes.
+   Thus a draw pass just has to transform the points of the visible chunks to pixel.
+ */
+class CTrackLod {
+ public:
+  /**
+     @brief The data of a draw pass to build the hit line on demand
+
+     The hit line has one point per visible track point as screen pixel coordinates.
+     The points of a chunk outside the viewport are set to the chunk's first point.
+     Use it for everything that needs real track points and their index.
+   */
+  struct hit_t {
+    bool isValid() const { return size > 0; }
+    QPolygonF getLine() const;
+
+    qint32 size = 0;            //< number of points
+    QTransform m2px;            //< the draw pass' transformation from projected coordinates to pixel
+    QVector<QPolygonF> chunks;  //< the projected points of each chunk of level 0, the first and last one if not visible
+  };
+
+  CTrackLod() = default;
+  // the levels are not copied, the copy builds its own on demand
+  CTrackLod(const CTrackLod&) {}
+  CTrackLod& operator=(const CTrackLod&) {
+    clear();
+    return *this;
+  }
+  virtual ~CTrackLod() = default;
+
+  /// drop all levels, call this each time the track has changed
+  void clear() { isOutdated = 1; }
+
+  /**
+     @brief Get the track lines for the current scale
+
+     @param trk          the track
+     @param viewport     the viewport [rad]
+     @param extViewport  the viewport [px]
+     @param gis          the draw context used to project the lines
+     @param hit          the data to build the hit line by hit_t::getLine()
+     @param lineDraw     the line simplified for the current scale as screen pixel coordinates. Use
+                         it for drawing only.
+   */
+  void getLines(const CTrackData& trk, const QPolygonF& viewport, const QRectF& extViewport, CGisDraw* gis, hit_t& hit,
+                QPolygonF& lineDraw);
+
+  /**
+     @brief Simplify a line by the Douglas Peucker algorithm
+
+     Other than GPS_Math_DouglasPeucker() the distance of a point is measured to the
+     segment and not to the line through the segment's end points. Thus no point of
+     the original line is farther than the tolerance from the simplified line, even
+     if the line turns back.
+
+     @param line       the line in a metric coordinate system
+     @param tolerance  the maximum distance of a dropped point to the simplified line
+     @return The index of each point kept. The first and the last point are always kept.
+   */
+  static QVector<qint32> simplify(const QPolygonF& line, qreal tolerance);
+
+ private:
+  struct chunk_t {
+    QRectF rect;       //< bounding rectangle [rad]
+    QPolygonF bounds;  //< the corners of rect and the first and last point, projected, empty until needed
+    QPolygonF line;    //< the points, projected, empty until the chunk is visible
+  };
+
+  struct level_t {
+    bool isValid = false;
+    QPolygonF line;  //< the points [rad]
+    QVector<chunk_t> chunks;
+  };
+
+  static qreal getTolerance(qint32 n);
+  level_t& getLevel(const CTrackData& trk, qint32 n);
+  QVector<bool> getVisibleChunks(level_t& level, const QRectF& extViewport, const QTransform& m2px,
+                                 CGisDraw* gis) const;
+
+  /// serialize the draw threads of all canvases
+  QMutex mutex;
+  /// set by clear(), the levels are dropped on the next call of getLines()
+  QAtomicInt isOutdated;
+  QVector<level_t> levels;
+  /// the projection of all projected points
+  QString projection;
+};
+
+#endif  // CTRACKLOD_H
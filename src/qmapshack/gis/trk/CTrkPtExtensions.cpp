@@ -0,0 +1,102 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/trk/CTrkPtExtensions.h"
+
+#include <QMutex>
+#include <QSet>
+
+QVariant& CTrkPtExtensions::operator[](const QString& key) {
+  const qint32 idx = indexOf(key);
+  if (idx >= 0) {
+    return entries[idx].value;
+  }
+
+  entries.append({shareKey(key), QVariant()});
+  return entries.last().value;
+}
+
+qint32 CTrkPtExtensions::remove(const QString& key) {
+  const qint32 idx = indexOf(key);
+  if (idx < 0) {
+    return 0;
+  }
+  entries.remove(idx);
+  return 1;
+}
+
+QStringList CTrkPtExtensions::keys() const {
+  QStringList keys;
+  keys.reserve(entries.size());
+  for (const entry_t& entry : entries) {
+    keys << entry.key;
+  }
+  return keys;
+}
+
+bool CTrkPtExtensions::operator==(const CTrkPtExtensions& other) const {
+  if (entries.size() != other.entries.size()) {
+    return false;
+  }
+
+  for (const entry_t& entry : entries) {
+    const qint32 idx = other.indexOf(entry.key);
+    if (idx < 0 || other.entries[idx].value != entry.value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+QString CTrkPtExtensions::shareKey(const QString& key) {
+  // The number of different keys is small. Thus they are kept forever.
+  static QMutex mutex;
+  static QSet<QString> keys;
+
+  QMutexLocker lock(&mutex);
+  auto it = keys.constFind(key);
+  if (it != keys.constEnd()) {
+    return *it;
+  }
+  return *keys.insert(key);
+}
+
+QDataStream& operator<<(QDataStream& stream, const CTrkPtExtensions& exts) {
+  stream << quint32(exts.entries.size());
+  for (const CTrkPtExtensions::entry_t& entry : exts.entries) {
+    stream << entry.key << entry.value;
+  }
+  return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, CTrkPtExtensions& exts) {
+  exts.clear();
+
+  quint32 n;
+  stream >> n;
+  for (quint32 i = 0; i < n && stream.status() == QDataStream::Ok; i++) {
+    QString key;
+    QVariant value;
+    stream >> key >> value;
+    if (stream.status() == QDataStream::Ok) {
+      exts[key] = value;
+    }
+  }
+  exts.squeeze();
+  return stream;
+}
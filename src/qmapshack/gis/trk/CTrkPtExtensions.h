@@ -0,0 +1,97 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTRKPTEXTENSIONS_H
+#define CTRKPTEXTENSIONS_H
+
+#include <QDataStream>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+/**
+   @brief The extensions of a single track point
+
+   Tracks can have millions of points and most of them carry the same few
+   extensions (heart rate, cadence, temperature...). A QHash per point costs a
+   hash table and a node for each extension. And the key strings are allocated
+   again for each point. Therefore the extensions are kept as a flat list of key
+   and value. The keys are shared by all points. A point without extensions just
+   holds an empty vector.
+
+   The interface is the part of QHash used for track points. Lookup is linear,
+   which is fine for a handful of entries.
+ */
+class CTrkPtExtensions {
+ public:
+  bool isEmpty() const { return entries.isEmpty(); }
+  qint32 size() const { return entries.size(); }
+
+  bool contains(const QString& key) const { return indexOf(key) >= 0; }
+
+  QVariant value(const QString& key, const QVariant& defaultValue = QVariant()) const {
+    const qint32 idx = indexOf(key);
+    return idx < 0 ? defaultValue : entries[idx].value;
+  }
+
+  /// get the value of key, an invalid value is added if key does not exist
+  QVariant& operator[](const QString& key);
+
+  /// get the value of key without adding it
+  QVariant operator[](const QString& key) const { return value(key); }
+
+  void insert(const QString& key, const QVariant& value) { (*this)[key] = value; }
+
+  /// @return The number of removed entries (0 or 1)
+  qint32 remove(const QString& key);
+
+  QStringList keys() const;
+
+  void clear() { entries.clear(); }
+  void squeeze() { entries.squeeze(); }
+
+  bool operator==(const CTrkPtExtensions& other) const;
+  bool operator!=(const CTrkPtExtensions& other) const { return !(*this == other); }
+
+  /// written the same way as QHash<QString, QVariant>, so binary data stays compatible
+  friend QDataStream& operator<<(QDataStream& stream, const CTrkPtExtensions& exts);
+  friend QDataStream& operator>>(QDataStream& stream, CTrkPtExtensions& exts);
+
+ private:
+  struct entry_t {
+    QString key;
+    QVariant value;
+  };
+
+  // the index of key or -1 if not found
+  qint32 indexOf(const QString& key) const {
+    for (qint32 i = 0; i < entries.size(); i++) {
+      if (entries[i].key == key) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /// return a copy of key sharing its data with all other keys of the same content
+  static QString shareKey(const QString& key);
+
+  QVector<entry_t> entries;
+};
+
+#endif  // CTRKPTEXTENSIONS_H
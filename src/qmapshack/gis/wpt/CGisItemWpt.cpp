@@ -107,6 +107,7 @@ CGisItemWpt::CGisItemWpt(const CGisItemWpt& parentWpt, IGisProject* project, int
   if (clone) {
     wpt.name += tr("_Clone");
     key.clear();
+    keyChanged(this);
     history.events.clear();
     setupHistory();
   }
@@ -160,7 +161,7 @@ CGisItemWpt::CGisItemWpt(const CTwoNavProject::wpt_t& tnvWpt, IGisProject* proje
 }
 
 CGisItemWpt::CGisItemWpt(CFitStream& stream, IGisProject* project)
-    : IGisItem(project, eTypeWpt, NOIDX), proximity(NOFLOAT), posScreen(NOPOINTF) {
+    : IGisItem(project, eTypeWpt, NOIDX), proximity(NOFLOAT) {
   readWptFromFit(stream);
   detBoundingRect();
 
@@ -383,7 +384,7 @@ QString CGisItemWpt::getInfo(quint32 feature) const {
 }
 
 IScrOpt* CGisItemWpt::getScreenOptions(const QPoint& origin, IMouse* mouse) {
-  if (closeToRadius) {
+  if (screen.get().closeToRadius) {
     if (scrOptRadius.isNull()) {
       scrOptRadius = new CScrOptWptRadius(this, origin, mouse);
     }
@@ -397,11 +398,12 @@ IScrOpt* CGisItemWpt::getScreenOptions(const QPoint& origin, IMouse* mouse) {
 }
 
 QPointF CGisItemWpt::getPointCloseBy(const QPoint& point) {
-  if (closeToRadius) {
-    QPointF l = (QPointF(point) - posScreen);
-    return posScreen + l * (radius / sqrt(QPointF::dotProduct(l, l)));
+  const screen_t& current = screen.get();
+  if (current.closeToRadius) {
+    QPointF l = (QPointF(point) - current.pos);
+    return current.pos + l * (current.radius / sqrt(QPointF::dotProduct(l, l)));
   } else {
-    return posScreen;
+    return current.pos;
   }
 }
 
@@ -453,7 +455,11 @@ void CGisItemWpt::setProximity(qreal val) {
 
   detBoundingRect();
 
-  radius = NOFLOAT;  // radius is proximity in set on redraw
+  // radius is proximity in set on redraw
+  screen.modify([](screen_t& current) {
+    current.radius = NOFLOAT;
+    current.closeToRadius = false;
+  });
 }
 
 void CGisItemWpt::setIcon(const QString& name) {
@@ -500,22 +506,28 @@ void CGisItemWpt::setTimestamp(const QDateTime& datetime) {
 }
 
 bool CGisItemWpt::isCloseTo(const QPointF& pos) {
-  closeToRadius = false;
+  // test and remember the result on the same version of the screen coordinates
+  bool isClose = false;
+  screen.modify([&](screen_t& current) {
+    current.closeToRadius = false;
 
-  if (posScreen == NOPOINTF) {
-    return false;
-  }
+    if (current.pos == NOPOINTF) {
+      return;
+    }
 
-  QPointF dist = (pos - posScreen);
-  if (dist.manhattanLength() < 22) {
-    return true;
-  }
-  if (radius == NOFLOAT) {
-    return false;
-  }
+    QPointF dist = (pos - current.pos);
+    if (dist.manhattanLength() < 22) {
+      isClose = true;
+      return;
+    }
+    if (current.radius == NOFLOAT) {
+      return;
+    }
 
-  closeToRadius = abs(QPointF::dotProduct(dist, dist) / radius - radius) < 22;
-  return closeToRadius;
+    current.closeToRadius = abs(QPointF::dotProduct(dist, dist) / current.radius - current.radius) < 22;
+    isClose = current.closeToRadius;
+  });
+  return isClose;
 }
 
 bool CGisItemWpt::isWithin(const QRectF& area, selflags_t flags) {
@@ -542,27 +554,33 @@ void CGisItemWpt::editInitial() {
 }
 
 void CGisItemWpt::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw* gis) {
-  posScreen = QPointF(wpt.lon * DEG_TO_RAD, wpt.lat * DEG_TO_RAD);
+  // place the waypoint aside and publish it as a whole when done
+  screen_t next;
+  const QPointF pos(wpt.lon * DEG_TO_RAD, wpt.lat * DEG_TO_RAD);
 
-  if (proximity == NOFLOAT || proximity == 0. ? !isVisible(posScreen, viewport, gis)
+  if (proximity == NOFLOAT || proximity == 0. ? !isVisible(pos, viewport, gis)
                                               : !isVisible(boundingRect, viewport, gis)) {
-    rectBubble = QRect();
-    posScreen = NOPOINTF;
+    screen.publish(next);
     return;
   }
 
+  QPointF& posScreen = next.pos;
+  posScreen = pos;
   gis->convertRad2Px(posScreen);
 
-  if (proximity == NOFLOAT) {
-    radius = NOFLOAT;
-  } else {
+  if (proximity != NOFLOAT) {
     // remember radius for isCloseTo-method
-    radius = calcRadius(QPointF(wpt.lon * DEG_TO_RAD, wpt.lat * DEG_TO_RAD), posScreen, proximity, gis);
+    next.radius = calcRadius(pos, posScreen, proximity, gis);
 
-    drawCircle(p, posScreen, radius, !hideArea && isNogo(), false);
+    drawCircle(p, posScreen, next.radius, !hideArea && isNogo(), false);
   }
 
-  drawBubble(p);
+  drawBubble(p, next);
+  // keep the result of the last isCloseTo()
+  screen.modify([&next](screen_t& current) {
+    next.closeToRadius = current.closeToRadius && next.radius != NOFLOAT;
+    current = next;
+  });
 
   p.drawPixmap(posScreen - focus, icon);
 
@@ -570,6 +588,12 @@ void CGisItemWpt::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
 }
 
 void CGisItemWpt::drawItem(QPainter& p, const QRectF& /*viewport*/, CGisDraw* gis) {
+  const screen_t& current = screen.get();
+  const QRect& rectBubble = current.rectBubble;
+  const QRect& rectBubbleMove = current.rectBubbleMove;
+  const QRect& rectBubbleEdit = current.rectBubbleEdit;
+  const QRect& rectBubbleSize = current.rectBubbleSize;
+
   if (mouseIsOverBubble && !doBubbleMove && !doBubbleSize && rectBubble.isValid() && !isReadOnly()) {
     QPainterPath clip;
     clip.addRoundedRect(rectBubble, RECT_RADIUS, RECT_RADIUS);
@@ -603,6 +627,7 @@ void CGisItemWpt::drawLabel(QPainter& p, const QPolygonF& /*viewport*/, QList<QR
     return;
   }
 
+  const QPointF posScreen = screen.get().pos;
   if (posScreen == NOPOINTF) {
     return;
   }
@@ -636,18 +661,19 @@ void CGisItemWpt::drawLabel(QPainter& p, const QPolygonF& /*viewport*/, QList<QR
 }
 
 void CGisItemWpt::drawHighlight(QPainter& p) {
-  if (posScreen == NOPOINTF) {
+  const screen_t& current = screen.get();
+  if (current.pos == NOPOINTF) {
     return;
   }
 
-  if (closeToRadius) {
-    drawCircle(p, posScreen, radius, false, true);
+  if (current.closeToRadius) {
+    drawCircle(p, current.pos, current.radius, false, true);
   } else {
-    p.drawImage(posScreen - QPointF(31, 31), QImage("://cursors/wptHighlightRed.png"));
+    p.drawImage(current.pos - QPointF(31, 31), QImage("://cursors/wptHighlightRed.png"));
   }
 }
 
-void CGisItemWpt::drawBubble(QPainter& p) {
+void CGisItemWpt::drawBubble(QPainter& p, screen_t& next) {
   if (!(flags & eFlagWptBubble)) {
     return;
   }
@@ -666,17 +692,18 @@ void CGisItemWpt::drawBubble(QPainter& p) {
   doc.setHtml(str);
   doc.setTextWidth(widthBubble);
 
+  QRect& rectBubble = next.rectBubble;
   rectBubble.setWidth(widthBubble);
   rectBubble.setHeight(doc.size().height());
 
-  QPoint posBubble = posScreen.toPoint() + offsetBubble;
+  QPoint posBubble = next.pos.toPoint() + offsetBubble;
   rectBubble.moveTopLeft(posBubble);
 
-  rectBubbleMove.moveTopLeft(rectBubble.topLeft() + QPoint(5, 5));
-  rectBubbleEdit.moveTopLeft(rectBubbleMove.topRight() + QPoint(7, 0));
-  rectBubbleSize.moveBottomRight(rectBubble.bottomRight() - QPoint(5, 5));
+  next.rectBubbleMove.moveTopLeft(rectBubble.topLeft() + QPoint(5, 5));
+  next.rectBubbleEdit.moveTopLeft(next.rectBubbleMove.topRight() + QPoint(7, 0));
+  next.rectBubbleSize.moveBottomRight(rectBubble.bottomRight() - QPoint(5, 5));
 
-  QPolygonF frame = makePolyline(posScreen, rectBubble);
+  QPolygonF frame = makePolyline(next.pos, rectBubble);
   p.setPen(CDraw::penBorderGray);
   p.setBrush(CDraw::brushBackWhite);
   p.drawPolygon(frame);
@@ -721,8 +748,8 @@ QPolygonF CGisItemWpt::makePolyline(const QPointF& anchor, const QRectF& r) {
   poly1 << r.topLeft() << r.topRight() << r.bottomRight() << r.bottomLeft();
 
   if (!r.contains(anchor)) {
-    qreal w = rectBubble.width() >> 1;
-    qreal h = rectBubble.height() >> 1;
+    qreal w = qint32(r.width()) >> 1;
+    qreal h = qint32(r.height()) >> 1;
 
     if (w > 30) {
       w = 30;
@@ -778,6 +805,7 @@ void CGisItemWpt::mouseMove(const QPointF& pos) {
     return;
   }
 
+  const QRect rectBubble = screen.get().rectBubble;
   if (mouseIsOverBubble) {
     processMouseOverBubble(pos.toPoint());
     if (!rectBubble.contains(pos.toPoint())) {
@@ -799,23 +827,24 @@ void CGisItemWpt::mouseDragged(const QPoint& /*start*/, const QPoint& /*last*/,
   if (!canvas) {
     return;
   }
+  const screen_t& current = screen.get();
   if (!doBubbleMove && !doBubbleSize) {
-    if (rectBubbleMove.contains(pos)) {
-      offsetMouse = pos - rectBubble.topLeft();
+    if (current.rectBubbleMove.contains(pos)) {
+      offsetMouse = pos - current.rectBubble.topLeft();
       doBubbleMove = true;
-    } else if (rectBubbleSize.contains(pos)) {
-      offsetMouse = pos - rectBubble.bottomRight();
+    } else if (current.rectBubbleSize.contains(pos)) {
+      offsetMouse = pos - current.rectBubble.bottomRight();
       doBubbleSize = true;
     } else {
       return;
     }
   }
   if (doBubbleMove) {
-    offsetBubble = pos - posScreen.toPoint();
+    offsetBubble = pos - current.pos.toPoint();
     offsetBubble -= offsetMouse;
   } else if (doBubbleSize) {
     qDebug() << offsetMouse;
-    int width = pos.x() - rectBubble.left() - offsetMouse.x();
+    int width = pos.x() - current.rectBubble.left() - offsetMouse.x();
     if (width > 50) {
       widthBubble = width;
     }
@@ -829,7 +858,7 @@ void CGisItemWpt::dragFinished(const QPoint& /*pos*/) {
 }
 
 void CGisItemWpt::leftClicked(const QPoint& pos) {
-  if (rectBubbleEdit.contains(pos)) {
+  if (screen.get().rectBubbleEdit.contains(pos)) {
     CCanvas* canvas = CMainWindow::self().getVisibleCanvas();
     if (canvas) {
       doBubbleMove = doBubbleSize = false;
@@ -857,7 +886,9 @@ const searchValue_t CGisItemWpt::getValueByKeyword(searchProperty_e keyword) {
 }
 
 void CGisItemWpt::processMouseOverBubble(const QPoint& pos) {
-  if (rectBubbleMove.contains(pos) || rectBubbleEdit.contains(pos) || rectBubbleSize.contains(pos)) {
+  const screen_t& current = screen.get();
+  if (current.rectBubbleMove.contains(pos) || current.rectBubbleEdit.contains(pos) ||
+      current.rectBubbleSize.contains(pos)) {
     if (!doSpecialCursor) {
       CCanvas::setOverrideCursor(Qt::PointingHandCursor, "processMouseOverBubble");
       doSpecialCursor = true;
@@ -872,7 +903,7 @@ void CGisItemWpt::processMouseOverBubble(const QPoint& pos) {
 
 void CGisItemWpt::detBoundingRect() {
   if (proximity == NOFLOAT) {
-    boundingRect = QRectF(QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD, QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD);
+    setBoundingRect(QRectF(QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD, QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD));
   } else {
     qreal diag = proximity * 1.414213562;
     QPointF cent(wpt.lon * DEG_TO_RAD, wpt.lat * DEG_TO_RAD);
@@ -880,7 +911,7 @@ void CGisItemWpt::detBoundingRect() {
     QPointF pt1 = GPS_Math_Wpt_Projection(cent, diag, 225 * DEG_TO_RAD);
     QPointF pt2 = GPS_Math_Wpt_Projection(cent, diag, 45 * DEG_TO_RAD);
 
-    boundingRect = QRectF(pt1, pt2);
+    setBoundingRect(QRectF(pt1, pt2));
   }
 }
 
@@ -26,6 +26,7 @@
 
 #include "gis/IGisItem.h"
 #include "gis/tnv/CTwoNavProject.h"
+#include "helpers/CSnapshot.h"
 
 struct IPoiItem;
 class IGisProject;
@@ -261,7 +262,7 @@ class CGisItemWpt : public IGisItem {
 
   bool hasRadius() { return proximity < NOFLOAT; }
 
-  qreal getRadius() { return radius; }
+  qreal getRadius() { return screen.get().radius; }
 
   void gainUserFocus(bool yes) override;
 
@@ -301,6 +302,18 @@ class CGisItemWpt : public IGisItem {
   }
 
  private:
+  /// everything the draw thread has placed on the screen
+  struct screen_t {
+    QPointF pos = NOPOINTF;  //< the waypoint as screen pixel coordinates
+    qreal radius = NOFLOAT;  //< the proximity radius [px]
+    /// set by isCloseTo() if the position is close to the radius, kept by the next draw pass
+    bool closeToRadius = false;
+    QRect rectBubble;
+    QRect rectBubbleMove{0, 0, 16, 16};
+    QRect rectBubbleEdit{0, 0, 16, 16};
+    QRect rectBubbleSize{0, 0, 16, 16};
+  };
+
   void setIcon();
   void setSymbol() override;
   void readGpx(const QDomNode& xml);
@@ -308,7 +321,7 @@ class CGisItemWpt : public IGisItem {
   void readWptFromFit(CFitStream& stream);
   void readGcExt(const QDomNode& xmlCache);
   void writeGcExt(QDomNode& xmlCache);
-  void drawBubble(QPainter& p);
+  void drawBubble(QPainter& p, screen_t& next);
   QPolygonF makePolyline(const QPointF& anchor, const QRectF& r);
   void processMouseOverBubble(const QPoint& pos);
   void detBoundingRect();
@@ -318,14 +331,13 @@ class CGisItemWpt : public IGisItem {
   // --- start all waypoint data ----
   wpt_t wpt;
   qreal proximity = NOFLOAT;
-  qreal radius = NOFLOAT;
-  bool closeToRadius = false;
   bool hideArea = false;
   geocache_t geocache;
   QList<image_t> images;
 
   QPointF focus;
-  QPointF posScreen = NOPOINTF;
+  /// the waypoint of the last draw pass, written by the draw thread and read by the GUI
+  CSnapshot<screen_t> screen;
 
   // additional data, common to all IGisItems, is found in IItem //
 
@@ -338,10 +350,6 @@ class CGisItemWpt : public IGisItem {
   bool doBubbleMove = false;
   bool doBubbleSize = false;
   bool mouseIsOverBubble = false;
-  QRect rectBubble;
-  QRect rectBubbleMove{0, 0, 16, 16};
-  QRect rectBubbleEdit{0, 0, 16, 16};
-  QRect rectBubbleSize{0, 0, 16, 16};
 
   QPoint offsetMouse;
   QPoint offsetBubble{-320, -150};
@@ -0,0 +1,74 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "helpers/CCollisionGrid.h"
+
+#include <QtMath>
+
+CCollisionGrid::CCollisionGrid(qint32 cellSize) : cellSize(qMax(1, cellSize)) {}
+
+void CCollisionGrid::clear() {
+  rects.clear();
+  cells.clear();
+}
+
+template <typename F>
+void CCollisionGrid::forEachCell(const QRectF& rect, F func) const {
+  const QRectF r = rect.normalized();
+  const qint32 x1 = qFloor(r.left() / cellSize);
+  const qint32 x2 = qFloor(r.right() / cellSize);
+  const qint32 y1 = qFloor(r.top() / cellSize);
+  const qint32 y2 = qFloor(r.bottom() / cellSize);
+
+  for (qint32 y = y1; y <= y2; ++y) {
+    for (qint32 x = x1; x <= x2; ++x) {
+      if (func((quint64(quint32(x)) << 32) | quint32(y))) {
+        return;
+      }
+    }
+  }
+}
+
+bool CCollisionGrid::intersects(const QRectF& rect) const {
+  bool result = false;
+  forEachCell(rect, [&](quint64 key) {
+    auto cell = cells.constFind(key);
+    if (cell == cells.constEnd()) {
+      return false;
+    }
+
+    for (qint32 idx : *cell) {
+      if (rect.intersects(rects[idx])) {
+        result = true;
+        return true;
+      }
+    }
+    return false;
+  });
+
+  return result;
+}
+
+void CCollisionGrid::insert(const QRectF& rect) {
+  const qint32 idx = rects.size();
+  rects << rect;
+  forEachCell(rect, [&](quint64 key) {
+    cells[key] << idx;
+    return false;
+  });
+}
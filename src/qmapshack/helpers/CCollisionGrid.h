@@ -0,0 +1,70 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CCOLLISIONGRID_H
+#define CCOLLISIONGRID_H
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+/**
+   @brief Find intersections with already placed rectangles in screen space
+
+   Icons and labels are placed one by one and each one is tested against all
+   rectangles placed before. A linear search makes this O(n²). The grid
+   sorts the rectangles into square cells. Thus only the rectangles sharing
+   a cell with the tested one have to be checked.
+ */
+class CCollisionGrid {
+ public:
+  /**
+     @param cellSize  the edge length of a cell [px]
+   */
+  CCollisionGrid(qint32 cellSize = 64);
+  virtual ~CCollisionGrid() = default;
+
+  void clear();
+
+  bool isEmpty() const { return rects.isEmpty(); }
+
+  /**
+     @brief Test if a rectangle intersects with any rectangle in the grid
+     @param rect    the rectangle to test [px]
+     @return True if there is an intersection
+   */
+  bool intersects(const QRectF& rect) const;
+
+  /**
+     @brief Add a rectangle to the grid
+     @param rect    the rectangle [px]
+   */
+  void insert(const QRectF& rect);
+
+ private:
+  template <typename F>
+  void forEachCell(const QRectF& rect, F func) const;
+
+  const qint32 cellSize;
+  /// all rectangles in the order of insertion
+  QVector<QRectF> rects;
+  /// per cell the indices into rects
+  QHash<quint64, QVector<qint32>> cells;
+};
+
+#endif  // CCOLLISIONGRID_H
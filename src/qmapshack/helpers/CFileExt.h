@@ -24,9 +24,9 @@
 
 class CFileExt : public QFile {
  public:
-  CFileExt(const QString& filename) : QFile(filename), mapped(nullptr) { cnt++; }
+  CFileExt(const QString& filename) : QFile(filename), mapped(nullptr) { cnt.ref(); }
 
-  ~CFileExt() { cnt--; }
+  ~CFileExt() { cnt.deref(); }
 
 #ifndef Q_OS_WIN32
   // data access function
@@ -52,7 +52,7 @@ class CFileExt : public QFile {
 #endif
 
  private:
-  static int cnt;
+  static QAtomicInt cnt;
 
   uchar* mapped;
   QSet<uchar*> mappedSections;
@@ -0,0 +1,344 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CRTREE_H
+#define CRTREE_H
+
+#include <QList>
+#include <QRectF>
+#include <QVector>
+
+/**
+   @brief A R-tree to find values by rectangles
+
+   Each value is stored with a rectangle. A value can be stored several times
+   with different rectangles. Values are added and removed one by one. Thus the
+   tree can be kept up to date while the values change. Nodes are split by
+   Guttman's quadratic algorithm. Entries of nodes that become too small by a
+   removal are inserted again.
+
+   Rectangles are normalized. Rectangles of zero width or height, like the one of
+   a single point, are fine.
+
+   The tree is not thread safe.
+ */
+template <typename T>
+class CRTree {
+ public:
+  CRTree() = default;
+  CRTree(const CRTree&) = delete;
+  CRTree& operator=(const CRTree&) = delete;
+  virtual ~CRTree() { delete root; }
+
+  /// add a value with its rectangle
+  void insert(const QRectF& rect, const T& value) {
+    insertEntry({box_t(rect), value, nullptr});
+    count++;
+  }
+
+  /**
+     @brief Remove a value
+
+     @param rect   the rectangle as it was used to insert the value
+     @param value  the value
+     @return True if the value was found.
+   */
+  bool remove(const QRectF& rect, const T& value) {
+    QVector<entry_t> orphans;
+    if (!remove(root, box_t(rect), value, orphans)) {
+      return false;
+    }
+    count--;
+
+    while (!root->isLeaf && root->entries.size() == 1) {
+      node_t* child = root->entries[0].child;
+      root->entries.clear();
+      delete root;
+      root = child;
+    }
+    if (root->entries.isEmpty()) {
+      root->isLeaf = true;
+    }
+
+    for (const entry_t& entry : qAsConst(orphans)) {
+      insertEntry(entry);
+    }
+    return true;
+  }
+
+  /// add all values with a rectangle intersecting with rect to values
+  void search(const QRectF& rect, QList<T>& values) const { search(root, box_t(rect), values); }
+
+  /// the number of entries
+  qint32 size() const { return count; }
+
+  void clear() {
+    delete root;
+    root = new node_t();
+    count = 0;
+  }
+
+ private:
+  static constexpr qint32 kMaxEntries = 16;
+  static constexpr qint32 kMinEntries = 6;
+
+  struct box_t {
+    box_t() = default;
+    box_t(const QRectF& rect) {
+      const QRectF& r = rect.normalized();
+      left = r.left();
+      top = r.top();
+      right = r.right();
+      bottom = r.bottom();
+    }
+
+    bool operator==(const box_t& b) const {
+      return left == b.left && top == b.top && right == b.right && bottom == b.bottom;
+    }
+
+    // unlike QRectF::intersects() this works for rectangles of zero width or height, too
+    bool intersects(const box_t& b) const {
+      return left <= b.right && right >= b.left && top <= b.bottom && bottom >= b.top;
+    }
+
+    bool contains(const box_t& b) const {
+      return left <= b.left && right >= b.right && top <= b.top && bottom >= b.bottom;
+    }
+
+    box_t united(const box_t& b) const {
+      box_t u;
+      u.left = qMin(left, b.left);
+      u.top = qMin(top, b.top);
+      u.right = qMax(right, b.right);
+      u.bottom = qMax(bottom, b.bottom);
+      return u;
+    }
+
+    qreal area() const { return (right - left) * (bottom - top); }
+
+    qreal left = 0;
+    qreal top = 0;
+    qreal right = 0;
+    qreal bottom = 0;
+  };
+
+  struct node_t;
+
+  struct entry_t {
+    box_t box;
+    T value;
+    node_t* child;  //< the sub-tree of a node's entry, nullptr for a leaf's entry
+  };
+
+  struct node_t {
+    ~node_t() {
+      for (const entry_t& entry : qAsConst(entries)) {
+        delete entry.child;
+      }
+    }
+
+    bool isLeaf = true;
+    QVector<entry_t> entries;
+  };
+
+  static box_t cover(const node_t* node) {
+    box_t box = node->entries.first().box;
+    for (const entry_t& entry : node->entries) {
+      box = box.united(entry.box);
+    }
+    return box;
+  }
+
+  void insertEntry(const entry_t& entry) {
+    node_t* sibling = insert(root, entry);
+    if (sibling != nullptr) {
+      node_t* newRoot = new node_t();
+      newRoot->isLeaf = false;
+      newRoot->entries << entry_t{cover(root), T(), root} << entry_t{cover(sibling), T(), sibling};
+      root = newRoot;
+    }
+  }
+
+  // insert the entry into the sub-tree, return the new sibling if the node had to be split
+  static node_t* insert(node_t* node, const entry_t& entry) {
+    if (node->isLeaf) {
+      node->entries << entry;
+    } else {
+      // choose the sub-tree with the least enlargement, on ties the smallest one
+      qint32 best = 0;
+      qreal bestEnlargement = 0;
+      qreal bestArea = 0;
+      for (qint32 i = 0; i < node->entries.size(); i++) {
+        const box_t& box = node->entries[i].box;
+        const qreal area = box.area();
+        const qreal enlargement = box.united(entry.box).area() - area;
+        if (i == 0 || enlargement < bestEnlargement || (enlargement == bestEnlargement && area < bestArea)) {
+          best = i;
+          bestEnlargement = enlargement;
+          bestArea = area;
+        }
+      }
+
+      node_t* child = node->entries[best].child;
+      node_t* sibling = insert(child, entry);
+      node->entries[best].box = cover(child);
+      if (sibling != nullptr) {
+        node->entries << entry_t{cover(sibling), T(), sibling};
+      }
+    }
+
+    return node->entries.size() > kMaxEntries ? split(node) : nullptr;
+  }
+
+  // split the node by the quadratic algorithm, the second half is returned as new node
+  static node_t* split(node_t* node) {
+    QVector<entry_t> entries;
+    entries.swap(node->entries);
+
+    // pick the two entries that would waste the most area if put together
+    qint32 seed1 = 0;
+    qint32 seed2 = 1;
+    qreal worst = 0;
+    for (qint32 i = 0; i < entries.size(); i++) {
+      for (qint32 j = i + 1; j < entries.size(); j++) {
+        const box_t& b1 = entries[i].box;
+        const box_t& b2 = entries[j].box;
+        const qreal waste = b1.united(b2).area() - b1.area() - b2.area();
+        if ((i == 0 && j == 1) || waste > worst) {
+          seed1 = i;
+          seed2 = j;
+          worst = waste;
+        }
+      }
+    }
+
+    node_t* sibling = new node_t();
+    sibling->isLeaf = node->isLeaf;
+
+    box_t box1 = entries[seed1].box;
+    box_t box2 = entries[seed2].box;
+    node->entries << entries[seed1];
+    sibling->entries << entries[seed2];
+    entries.remove(seed2);
+    entries.remove(seed1);
+
+    while (!entries.isEmpty()) {
+      // make sure both nodes get the minimum number of entries
+      if (node->entries.size() + entries.size() == kMinEntries) {
+        node->entries << entries;
+        break;
+      }
+      if (sibling->entries.size() + entries.size() == kMinEntries) {
+        sibling->entries << entries;
+        break;
+      }
+
+      // pick the entry with the strongest preference for one of the nodes
+      qint32 next = 0;
+      qreal maxDiff = -1;
+      qreal next1 = 0;
+      qreal next2 = 0;
+      for (qint32 i = 0; i < entries.size(); i++) {
+        const qreal d1 = box1.united(entries[i].box).area() - box1.area();
+        const qreal d2 = box2.united(entries[i].box).area() - box2.area();
+        if (qAbs(d1 - d2) > maxDiff) {
+          next = i;
+          maxDiff = qAbs(d1 - d2);
+          next1 = d1;
+          next2 = d2;
+        }
+      }
+
+      const bool toNode = (next1 < next2) || (next1 == next2 && node->entries.size() <= sibling->entries.size());
+      if (toNode) {
+        box1 = box1.united(entries[next].box);
+        node->entries << entries[next];
+      } else {
+        box2 = box2.united(entries[next].box);
+        sibling->entries << entries[next];
+      }
+      entries.remove(next);
+    }
+
+    return sibling;
+  }
+
+  // remove the value from the sub-tree, entries of nodes that got too small are added to orphans
+  static bool remove(node_t* node, const box_t& box, const T& value, QVector<entry_t>& orphans) {
+    if (node->isLeaf) {
+      for (qint32 i = 0; i < node->entries.size(); i++) {
+        const entry_t& entry = node->entries[i];
+        if (entry.value == value && entry.box == box) {
+          node->entries.remove(i);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    for (qint32 i = 0; i < node->entries.size(); i++) {
+      node_t* child = node->entries[i].child;
+      if (!node->entries[i].box.contains(box) || !remove(child, box, value, orphans)) {
+        continue;
+      }
+
+      if (child->entries.size() < kMinEntries) {
+        collect(child, orphans);
+        delete child;
+        node->entries.remove(i);
+      } else {
+        node->entries[i].box = cover(child);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  // move all leaf entries of the sub-tree to entries
+  static void collect(node_t* node, QVector<entry_t>& entries) {
+    for (entry_t& entry : node->entries) {
+      if (node->isLeaf) {
+        entries << entry;
+      } else {
+        collect(entry.child, entries);
+        delete entry.child;
+      }
+      entry.child = nullptr;
+    }
+    node->entries.clear();
+  }
+
+  static void search(const node_t* node, const box_t& box, QList<T>& values) {
+    for (const entry_t& entry : node->entries) {
+      if (!entry.box.intersects(box)) {
+        continue;
+      }
+
+      if (node->isLeaf) {
+        values << entry.value;
+      } else {
+        search(entry.child, box, values);
+      }
+    }
+  }
+
+  node_t* root = new node_t();
+  qint32 count = 0;
+};
+
+#endif  // CRTREE_H
@@ -0,0 +1,74 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CSNAPSHOT_H
+#define CSNAPSHOT_H
+
+#include <QMutex>
+
+/**
+   @brief A value written by one thread and read by others
+
+   The writer builds a new version of the value and publishes it as a whole. A
+   reader gets a copy of the last version published. Thus it never sees a value
+   that is half way written. T should be implicitly shared or small, as the mutex
+   is held just for the copy.
+ */
+template <typename T>
+class CSnapshot {
+ public:
+  CSnapshot() = default;
+  CSnapshot(const T& value) : value(value) {}
+  // copy the value only, each snapshot has its own mutex
+  CSnapshot(const CSnapshot& other) : value(other.get()) {}
+  CSnapshot& operator=(const CSnapshot& other) {
+    publish(other.get());
+    return *this;
+  }
+
+  /// get a copy of the last version published
+  T get() const {
+    QMutexLocker lock(&mutex);
+    return value;
+  }
+
+  /// replace the current version by a new one
+  void publish(const T& newValue) {
+    QMutexLocker lock(&mutex);
+    value = newValue;
+  }
+
+  /**
+     @brief Change the current version in place
+
+     Use this instead of get() and publish() if the change depends on the current
+     version. Otherwise a version published in between is lost. Keep func short,
+     as all readers wait for it.
+   */
+  template <typename F>
+  void modify(F func) {
+    QMutexLocker lock(&mutex);
+    func(value);
+  }
+
+ private:
+  mutable QMutex mutex;
+  T value;
+};
+
+#endif  // CSNAPSHOT_H
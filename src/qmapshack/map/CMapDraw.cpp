@@ -29,6 +29,7 @@
 #include "map/CMapList.h"
 #include "map/CMapPathSetup.h"
 #include "map/IMap.h"
+#include "map/IMapOnline.h"
 #include "map/cache/CDiskCache.h"
 #include "poi/IPoiItem.h"
 #include "setup/IAppSetup.h"
@@ -212,6 +213,25 @@ bool CMapDraw::findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qint3
   return res;
 }
 
+void CMapDraw::getOnlineMaps(QList<QPointer<IMapOnline>>& onlineMaps) {
+  QMutexLocker lock(&CMapItem::mutexActiveMaps);
+  if (mapList) {
+    for (int i = 0; i < mapList->count(); i++) {
+      CMapItem* item = mapList->item(i);
+
+      if (!item || item->getMapfile().isNull()) {
+        // all active maps are at the top of the list
+        break;
+      }
+
+      IMapOnline* map = dynamic_cast<IMapOnline*>(item->getMapfile().data());
+      if (map != nullptr) {
+        onlineMaps << map;
+      }
+    }
+  }
+}
+
 void CMapDraw::saveConfig(QSettings& cfg) /* override */
 {
   // store group context for later use
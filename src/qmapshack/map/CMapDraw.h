@@ -19,6 +19,7 @@
 #ifndef CMAPDRAW_H
 #define CMAPDRAW_H
 
+#include <QPointer>
 #include <QStringList>
 
 #include "canvas/IDrawContext.h"
@@ -28,6 +29,7 @@ class CCanvas;
 class CMapList;
 class QSettings;
 class CMapItem;
+class IMapOnline;
 struct IPoiItem;
 
 class CMapDraw : public IDrawContext {
@@ -114,6 +116,13 @@ class CMapDraw : public IDrawContext {
    */
   bool findPolylineCloseBy(const QPointF& pt1, const QPointF& pt2, qint32 threshold, QPolygonF& polyline);
 
+  /**
+     @brief Get all active maps that request their tiles from a server
+
+     @param onlineMaps   the maps in the order of the map list
+   */
+  void getOnlineMaps(QList<QPointer<IMapOnline>>& onlineMaps);
+
   /**
      @brief Build a usable map list from a single map file
 
@@ -45,9 +45,9 @@
 
 #define STREETNAME_THRESHOLD 5.0
 
-int CFileExt::cnt = 0;
+QAtomicInt CFileExt::cnt = 0;
 
-static inline bool isCompletelyOutside(const QPolygonF& poly, const QRectF& viewport) {
+static inline QRectF getBoundingRect(const QPolygonF& poly) {
   qreal north = -90.0 * DEG_TO_RAD;
   qreal south = 90.0 * DEG_TO_RAD;
   qreal west = 180.0 * DEG_TO_RAD;
@@ -77,7 +77,33 @@ static inline bool isCompletelyOutside(const QPolygonF& poly, const QRectF& view
     ref.setHeight(0.00001);
   }
 
-  return !viewport.intersects(ref);
+  return ref;
+}
+
+static inline qint32 getMemoryUsage(const CGarminPolygon& item) {
+  // pixel and coords share the same data after decoding
+  qint32 size = sizeof(CGarminPolygon) + item.coords.capacity() * sizeof(QPointF);
+  for (const QString& label : item.labels) {
+    size += label.size() * sizeof(QChar);
+  }
+  return size;
+}
+
+static inline qint32 getMemoryUsage(const CGarminPoint& item) {
+  qint32 size = sizeof(CGarminPoint);
+  for (const QString& label : item.labels) {
+    size += label.size() * sizeof(QChar);
+  }
+  return size;
+}
+
+template <typename T>
+static inline qint32 getMemoryUsage(const QVector<T>& items) {
+  qint32 size = 0;
+  for (const T& item : items) {
+    size += getMemoryUsage(item);
+  }
+  return size;
 }
 
 static inline QImage img2line(const QImage& img, int width) {
@@ -104,21 +130,21 @@ static inline QImage img2line(const QImage& img, int width) {
   return newImage;
 }
 
-static inline bool isCluttered(QVector<QRectF>& rectPois, const QRectF& rect) {
-  for (const QRectF& rectPoi : rectPois) {
-    if (rect.intersects(rectPoi)) {
-      return true;
-    }
+static inline bool isCluttered(CCollisionGrid& rectPois, const QRectF& rect) {
+  if (rectPois.intersects(rect)) {
+    return true;
   }
-  rectPois << rect;
+  rectPois.insert(rect);
   return false;
 }
 
 CMapIMG::CMapIMG(const QString& filename, CMapDraw* parent)
-    : IMap(eFeatVisibility | eFeatVectorItems | eFeatTypFile, parent),
+    : IMap(eFeatVisibility | eFeatVectorItems | eFeatTypFile | eFeatDataCache, parent),
       filename(filename),
       fm(CMainWindow::self().getMapFont()),
       selectedLanguage(NOIDX) {
+  applyCacheSettings();
+
   qDebug() << "------------------------------";
   qDebug() << "IMG: try to open" << filename;
 
@@ -142,6 +168,11 @@ void CMapIMG::loadConfig(QSettings& cfg) {
   }
 }
 
+void CMapIMG::configureCache() {
+  QMutexLocker lock(&subdivCacheMutex);
+  subdivCache.setMaxCost(getCacheMemSize() * 1024);
+}
+
 void CMapIMG::slotSetTypeFile(const QString& filename) {
   IMap::slotSetTypeFile(filename);
   setupTyp();
@@ -1141,13 +1172,14 @@ void CMapIMG::draw(IDrawContext::buffer_t& buf) /* override */
   qreal v2 = qMin(buf.ref4.y(), buf.ref3.y());
 
   QRectF viewport(u1, v1, u2 - u1, v2 - v1);
-  QVector<QRectF> rectPois;
+  CCollisionGrid rectPois;
 
   polygons.clear();
   polylines.clear();
   pois.clear();
   points.clear();
   labels.clear();
+  labelGrid.clear();
 
   /**
      convertRad2Px() converts positions into screen coordinates. However the painter
@@ -1214,57 +1246,77 @@ void CMapIMG::draw(IDrawContext::buffer_t& buf) /* override */
 
 void CMapIMG::loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polylines, pointtype_t& points,
                               pointtype_t& pois, unsigned level, const QRectF& viewport, QPainter& p) {
-#ifndef Q_OS_WIN32
-  CFileExt file(filename);
-  if (!file.open(QIODevice::ReadOnly)) {
-    return;
-  }
-#endif
-
+  //        qDebug() << "-------";
+  //        qDebug() << (viewport.topLeft() * RAD_TO_DEG) << (viewport.bottomRight() * RAD_TO_DEG);
+  QVector<const subfile_desc_t*> visibleSubfiles;
   for (const subfile_desc_t& subfile : qAsConst(subfiles)) {
-    //        qDebug() << "-------";
-    //        qDebug() << (viewport.topLeft() * RAD_TO_DEG) << (viewport.bottomRight() * RAD_TO_DEG);
-    //        qDebug() << (subfile.area.topLeft() * RAD_TO_DEG) << (subfile.area.bottomRight() * RAD_TO_DEG);
-    //        qDebug() << subfile.area.intersects(viewport);
-
-    if (!subfile.area.intersects(viewport)) {
-      continue;
+    if (subfile.area.intersects(viewport)) {
+      visibleSubfiles << &subfile;
     }
+  }
 
-    if (map->needsRedraw()) {
-      break;
-    }
+  /*
+     Each subfile is decoded by its own task into its own set of vectors. A subfile
+     has its own string table and the task uses its own file handle. Thus the tasks
+     do not share any state but the cache of decoded subdivisions.
+   */
+  struct result_t {
+    polytype_t polygons;
+    polytype_t polylines;
+    pointtype_t points;
+    pointtype_t pois;
+    bool outOfMemory = false;
+  };
+
+  QVector<result_t> results(visibleSubfiles.size());
+  for (int n = 0; n < visibleSubfiles.size(); ++n) {
+    const subfile_desc_t* subfile = visibleSubfiles[n];
+    result_t* result = &results[n];
+
+    threadPool.start([this, subfile, result, fast, level, &viewport]() {
+      try {
+        loadSubfile(*subfile, fast, level, viewport, result->polygons, result->polylines, result->points,
+                    result->pois);
+      } catch (const exce_t& e) {
+        qWarning() << "GarminIMG:" << e.msg;
+      } catch (const std::bad_alloc&) {
+        result->outOfMemory = true;
+      }
+    });
+  }
+  threadPool.waitForDone();
 
-#ifdef Q_OS_WIN32
-    CFileExt file(filename);
-    if (!file.open(QIODevice::ReadOnly)) {
-      return;
+  // merge in the order of the subfiles to keep the order of drawing stable
+  int nPolygons = 0, nPolylines = 0, nPoints = 0, nPois = 0;
+  for (const result_t& result : qAsConst(results)) {
+    if (result.outOfMemory) {
+      throw std::bad_alloc();
     }
-#endif
-
-    QByteArray rgndata;
-    readFile(file, subfile.parts["RGN"].offset, subfile.parts["RGN"].size, rgndata);
+    nPolygons += result.polygons.size();
+    nPolylines += result.polylines.size();
+    nPoints += result.points.size();
+    nPois += result.pois.size();
+  }
 
-    // qDebug() << "rgn range" << Qt::hex << subfile.parts["RGN"].offset << (subfile.parts["RGN"].offset +
-    // subfile.parts["RGN"].size);
+  polygons.reserve(polygons.size() + nPolygons);
+  polylines.reserve(polylines.size() + nPolylines);
+  points.reserve(points.size() + nPoints);
+  pois.reserve(pois.size() + nPois);
+  for (const result_t& result : qAsConst(results)) {
+    polygons += result.polygons;
+    polylines += result.polylines;
+    points += result.points;
+    pois += result.pois;
+  }
 
-    const QVector<subdiv_desc_t>& subdivs = subfile.subdivs;
-    // collect polylines
-    for (const subdiv_desc_t& subdiv : subdivs) {
-      // if(subdiv.level == level) qDebug() << "subdiv:" << subdiv.level << level <<  subdiv.area << viewport <<
-      // subdiv.area.intersects(viewport);
+#ifdef DEBUG_SHOW_SECTION_BORDERS
+  for (const subfile_desc_t* subfile : qAsConst(visibleSubfiles)) {
+    for (const subdiv_desc_t& subdiv : subfile->subdivs) {
       if (subdiv.level != level || !subdiv.area.intersects(viewport)) {
         continue;
       }
-      if (map->needsRedraw()) {
-        break;
-      }
-      loadSubDiv(file, subdiv, subfile.strtbl, rgndata, fast, viewport, polylines, polygons, points, pois);
 
-#ifdef DEBUG_SHOW_SECTION_BORDERS
       const QRectF& a = subdiv.area;
-      qreal u[2] = {a.left(), a.right()};
-      qreal v[2] = {a.top(), a.bottom()};
 
       QPolygonF poly;
       poly << a.bottomLeft() << a.bottomRight() << a.topRight() << a.topLeft();
@@ -1274,14 +1326,16 @@ void CMapIMG::loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polyl
       p.setPen(QPen(Qt::magenta, 2));
       p.setBrush(Qt::NoBrush);
       p.drawPolygon(poly);
-#endif  // DEBUG_SHOW_SECTION_BORDERS
     }
+  }
+#endif  // DEBUG_SHOW_SECTION_BORDERS
 
 #ifdef DEBUG_SHOW_SUBDIV_BORDERS
-    QPointF p1 = subfile.area.bottomLeft();
-    QPointF p2 = subfile.area.bottomRight();
-    QPointF p3 = subfile.area.topRight();
-    QPointF p4 = subfile.area.topLeft();
+  for (const subfile_desc_t* subfile : qAsConst(visibleSubfiles)) {
+    QPointF p1 = subfile->area.bottomLeft();
+    QPointF p2 = subfile->area.bottomRight();
+    QPointF p3 = subfile->area.topRight();
+    QPointF p4 = subfile->area.topLeft();
 
     map->convertRad2Px(p1);
     map->convertRad2Px(p2);
@@ -1292,23 +1346,78 @@ void CMapIMG::loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polyl
     poly << p1 << p2 << p3 << p4;
     p.setPen(Qt::black);
     p.drawPolygon(poly);
+  }
 #endif  // DEBUG_SHOW_SUBDIV_BORDERS
+}
 
-#ifdef Q_OS_WIN32
-    file.close();
-#else
-    file.free();
-#endif
+void CMapIMG::loadSubfile(const subfile_desc_t& subfile, bool fast, unsigned level, const QRectF& viewport,
+                          polytype_t& polygons, polytype_t& polylines, pointtype_t& points, pointtype_t& pois) {
+  if (map->needsRedraw()) {
+    return;
   }
 
-#ifndef Q_OS_WIN32
-  file.close();
-#endif
+  CFileExt file(filename);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+
+  // the RGN data is read on the first subdivision not found in the cache
+  QByteArray rgndata;
+
+  // qDebug() << "rgn range" << Qt::hex << subfile.parts["RGN"].offset << (subfile.parts["RGN"].offset +
+  // subfile.parts["RGN"].size);
+
+  for (const subdiv_desc_t& subdiv : subfile.subdivs) {
+    // if(subdiv.level == level) qDebug() << "subdiv:" << subdiv.level << level <<  subdiv.area << viewport <<
+    // subdiv.area.intersects(viewport);
+    if (subdiv.level != level || !subdiv.area.intersects(viewport)) {
+      continue;
+    }
+    if (map->needsRedraw()) {
+      break;
+    }
+
+    const subdiv_key_t key(subfile.name, subdiv.n);
+    subdiv_ptr_t data;
+    {
+      QMutexLocker lock(&subdivCacheMutex);
+      const subdiv_ptr_t* cached = subdivCache.object(key);
+      // an entry decoded in fast mode lacks the labels needed for a full redraw
+      if (cached != nullptr && (fast || (*cached)->hasLabels)) {
+        data = *cached;
+        subdivCacheStats.hits++;
+        subdivCacheStats.timeSaved += data->decodeTime;
+      } else {
+        subdivCacheStats.misses++;
+      }
+    }
+
+    if (data.isNull()) {
+      if (rgndata.isEmpty()) {
+        readFile(file, subfile.parts["RGN"].offset, subfile.parts["RGN"].size, rgndata);
+      }
+
+      QElapsedTimer timer;
+      timer.start();
+      subdiv_data_t* decoded = new subdiv_data_t();
+      // labels are not drawn in fast mode, thus there is no need to decode them
+      loadSubDiv(file, subdiv, fast ? nullptr : subfile.strtbl, rgndata, *decoded);
+      decoded->decodeTime = timer.nsecsElapsed();
+      decoded->hasLabels = !fast;
+      data = subdiv_ptr_t(decoded);
+
+      const qint32 size = getMemoryUsage(data->polylines) + getMemoryUsage(data->polygons) +
+                          getMemoryUsage(data->points) + getMemoryUsage(data->pois);
+      QMutexLocker lock(&subdivCacheMutex);
+      subdivCache.insert(key, new subdiv_ptr_t(data), qMax(1, size >> 10));
+    }
+
+    collectSubDiv(*data, fast, viewport, polylines, polygons, points, pois);
+  }
 }
 
 void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStrTbl* strtbl, const QByteArray& rgndata,
-                         bool fast, const QRectF& viewport, polytype_t& polylines, polytype_t& polygons,
-                         pointtype_t& points, pointtype_t& pois) {
+                         subdiv_data_t& data) {
   if (subdiv.rgn_start == subdiv.rgn_end && !subdiv.lengthPolygons2 && !subdiv.lengthPolylines2 &&
       !subdiv.lengthPoints2) {
     return;
@@ -1370,74 +1479,60 @@ void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStr
   CGarminPolygon p;
 
   // decode points
-  if (subdiv.hasPoints && !fast && getShowPOIs()) {
+  if (subdiv.hasPoints) {
     const quint8* pData = pRawData + opnt;
     const quint8* pEnd = pRawData + (oidx ? oidx : opline ? opline : opgon ? opgon : subdiv.rgn_end);
     while (pData < pEnd) {
       CGarminPoint p;
       pData += p.decode(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, pData);
 
-      // skip points outside our current viewport
-      if (!viewport.contains(p.pos)) {
-        continue;
-      }
-
       if (strtbl) {
         p.isLbl6 ? strtbl->get(file, p.lbl_ptr, IGarminStrTbl::poi, p.labels)
                  : strtbl->get(file, p.lbl_ptr, IGarminStrTbl::norm, p.labels);
       }
 
-      points.push_back(p);
+      data.points.push_back(p);
     }
   }
 
   // decode indexed points
-  if (subdiv.hasIdxPoints && !fast && getShowPOIs()) {
+  if (subdiv.hasIdxPoints) {
     const quint8* pData = pRawData + oidx;
     const quint8* pEnd = pRawData + (opline ? opline : opgon ? opgon : subdiv.rgn_end);
     while (pData < pEnd) {
       CGarminPoint p;
       pData += p.decode(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, pData);
 
-      // skip points outside our current viewport
-      if (!viewport.contains(p.pos)) {
-        continue;
-      }
-
       if (strtbl) {
         p.isLbl6 ? strtbl->get(file, p.lbl_ptr, IGarminStrTbl::poi, p.labels)
                  : strtbl->get(file, p.lbl_ptr, IGarminStrTbl::norm, p.labels);
       }
 
-      pois.push_back(p);
+      data.pois.push_back(p);
     }
   }
 
   // decode polylines
-  if (subdiv.hasPolylines && !fast && getShowPolylines()) {
+  if (subdiv.hasPolylines) {
     CGarminPolygon::cnt = 0;
     const quint8* pData = pRawData + opline;
     const quint8* pEnd = pRawData + (opgon ? opgon : subdiv.rgn_end);
     while (pData < pEnd) {
       pData += p.decode(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, true, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (isCompletelyOutside(p.pixel, viewport)) {
-        continue;
-      }
-
       if (strtbl && !p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::norm, p.labels);
       } else if (strtbl && p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::net, p.labels);
       }
 
-      polylines.push_back(p);
+      data.polylines.push_back(p);
+      data.rectPolylines.push_back(getBoundingRect(p.pixel));
     }
   }
 
   // decode polygons
-  if (subdiv.hasPolygons && getShowPolygons()) {
+  if (subdiv.hasPolygons) {
     CGarminPolygon::cnt = 0;
     const quint8* pData = pRawData + opgon;
     const quint8* pEnd = pRawData + subdiv.rgn_end;
@@ -1445,17 +1540,13 @@ void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStr
     while (pData < pEnd) {
       pData += p.decode(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, false, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (isCompletelyOutside(p.pixel, viewport)) {
-        continue;
-      }
-
-      if (strtbl && !p.lbl_in_NET && p.lbl_info && !fast) {
+      if (strtbl && !p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::norm, p.labels);
-      } else if (strtbl && p.lbl_in_NET && p.lbl_info && !fast) {
+      } else if (strtbl && p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::net, p.labels);
       }
-      polygons.push_back(p);
+      data.polygons.push_back(p);
+      data.rectPolygons.push_back(getBoundingRect(p.pixel));
     }
   }
 
@@ -1471,47 +1562,39 @@ void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStr
   //         qDebug() << "point len: " << Qt::hex << subdiv.lengthPoints2 << dec << subdiv.lengthPoints2;
   //         qDebug() << "point end: " << Qt::hex << subdiv.lengthPoints2 + subdiv.offsetPoints2;
 
-  if (subdiv.lengthPolygons2 && getShowPolygons()) {
+  if (subdiv.lengthPolygons2) {
     const quint8* pData = pRawData + subdiv.offsetPolygons2;
     const quint8* pEnd = pData + subdiv.lengthPolygons2;
     while (pData < pEnd) {
       //             qDebug() << "rgn offset:" << Qt::hex << (rgnoff + (pData - pRawData));
       pData += p.decode2(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, false, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (isCompletelyOutside(p.pixel, viewport)) {
-        continue;
-      }
-
-      if (strtbl && !p.lbl_in_NET && p.lbl_info && !fast) {
+      if (strtbl && !p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::norm, p.labels);
       }
 
-      polygons.push_back(p);
+      data.polygons.push_back(p);
+      data.rectPolygons.push_back(getBoundingRect(p.pixel));
     }
   }
 
-  if (subdiv.lengthPolylines2 && !fast && getShowPolylines()) {
+  if (subdiv.lengthPolylines2) {
     const quint8* pData = pRawData + subdiv.offsetPolylines2;
     const quint8* pEnd = pData + subdiv.lengthPolylines2;
     while (pData < pEnd) {
       //             qDebug() << "rgn offset:" << Qt::hex << (rgnoff + (pData - pRawData));
       pData += p.decode2(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, true, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (isCompletelyOutside(p.pixel, viewport)) {
-        continue;
-      }
-
       if (strtbl && !p.lbl_in_NET && p.lbl_info) {
         strtbl->get(file, p.lbl_info, IGarminStrTbl::norm, p.labels);
       }
 
-      polylines.push_back(p);
+      data.polylines.push_back(p);
+      data.rectPolylines.push_back(getBoundingRect(p.pixel));
     }
   }
 
-  if (subdiv.lengthPoints2 && !fast && getShowPOIs()) {
+  if (subdiv.lengthPoints2) {
     const quint8* pData = pRawData + subdiv.offsetPoints2;
     const quint8* pEnd = pData + subdiv.lengthPoints2;
     while (pData < pEnd) {
@@ -1519,20 +1602,62 @@ void CMapIMG::loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStr
       //             qDebug() << "rgn offset:" << Qt::hex << (rgnoff + (pData - pRawData));
       pData += p.decode2(subdiv.iCenterLng, subdiv.iCenterLat, subdiv.shift, pData, pEnd);
 
-      // skip points outside our current viewport
-      if (!viewport.contains(p.pos)) {
-        continue;
-      }
-
       if (strtbl) {
         p.isLbl6 ? strtbl->get(file, p.lbl_ptr, IGarminStrTbl::poi, p.labels)
                  : strtbl->get(file, p.lbl_ptr, IGarminStrTbl::norm, p.labels);
       }
-      pois.push_back(p);
+      data.pois.push_back(p);
     }
   }
 }
 
+void CMapIMG::collectSubDiv(const subdiv_data_t& data, bool fast, const QRectF& viewport, polytype_t& polylines,
+                            polytype_t& polygons, pointtype_t& points, pointtype_t& pois) {
+  // copies are cheap as the coordinates and labels are implicitly shared
+  if (!fast && getShowPOIs()) {
+    for (const CGarminPoint& point : data.points) {
+      if (viewport.contains(point.pos)) {
+        points.push_back(point);
+      }
+    }
+    for (const CGarminPoint& poi : data.pois) {
+      if (viewport.contains(poi.pos)) {
+        pois.push_back(poi);
+      }
+    }
+  }
+
+  if (!fast && getShowPolylines()) {
+    const int N = data.polylines.size();
+    for (int n = 0; n < N; ++n) {
+      if (viewport.intersects(data.rectPolylines[n])) {
+        polylines.push_back(data.polylines[n]);
+      }
+    }
+  }
+
+  if (getShowPolygons()) {
+    const int N = data.polygons.size();
+    for (int n = 0; n < N; ++n) {
+      if (viewport.intersects(data.rectPolygons[n])) {
+        polygons.push_back(data.polygons[n]);
+        if (fast) {
+          polygons.last().labels.clear();
+        }
+      }
+    }
+  }
+}
+
+QString CMapIMG::getCacheStatistics() const {
+  QMutexLocker lock(&subdivCacheMutex);
+  return tr("Decoded map data: %1 MB, hits: %2, misses: %3, decoding time saved: %4 s")
+      .arg(subdivCache.totalCost() / 1024.0, 0, 'f', 1)
+      .arg(subdivCacheStats.hits)
+      .arg(subdivCacheStats.misses)
+      .arg(subdivCacheStats.timeSaved / 1e9, 0, 'f', 1);
+}
+
 void CMapIMG::drawPolygons(QPainter& p, polytype_t& lines) {
   const int N = polygonDrawOrder.size();
   for (int n = 0; n < N; ++n) {
@@ -1811,15 +1936,7 @@ void CMapIMG::collectText(const CGarminPolygon& item, const QPolygonF& line, con
   textpaths << tp;
 }
 
-bool CMapIMG::intersectsWithExistingLabel(const QRect& rect) const {
-  for (const strlbl_t& label : labels) {
-    if (label.rect.intersects(rect)) {
-      return true;
-    }
-  }
-
-  return false;
-}
+bool CMapIMG::intersectsWithExistingLabel(const QRect& rect) const { return labelGrid.intersects(rect); }
 
 void CMapIMG::addLabel(const CGarminPoint& pt, const QRect& rect, const CGarminTyp::point_property& property,
                        bool isNight) {
@@ -1835,9 +1952,11 @@ void CMapIMG::addLabel(const CGarminPoint& pt, const QRect& rect, const CGarminT
   strlbl.rect = rect;
   strlbl.property = property;
   strlbl.isNight = isNight;
+
+  labelGrid.insert(rect);
 }
 
-void CMapIMG::drawPoints(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPois) {
+void CMapIMG::drawPoints(QPainter& p, pointtype_t& pts, CCollisionGrid& rectPois) {
   pointtype_t::iterator pt = pts.begin();
   while (pt != pts.end()) {
     map->convertRad2Px(pt->pos);
@@ -1877,7 +1996,7 @@ void CMapIMG::drawPoints(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPoi
   }
 }
 
-void CMapIMG::drawPois(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPois) {
+void CMapIMG::drawPois(QPainter& p, pointtype_t& pts, CCollisionGrid& rectPois) {
   for (CGarminPoint& pt : pts) {
     map->convertRad2Px(pt.pos);
 
@@ -19,8 +19,13 @@
 #ifndef CMAPIMG_H
 #define CMAPIMG_H
 
+#include <QCache>
 #include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThreadPool>
 
+#include "helpers/CCollisionGrid.h"
 #include "map/IMap.h"
 #include "map/garmin/CGarminPoint.h"
 #include "map/garmin/CGarminPolygon.h"
@@ -120,6 +125,8 @@ class CMapIMG : public IMap {
 
   void getToolTip(const QPoint& px, QString& infotext) const override;
 
+  QString getCacheStatistics() const override;
+
   void findPOICloseBy(const QPoint&, IPoiItem& poi) const override;
 
   /**
@@ -139,8 +146,38 @@ class CMapIMG : public IMap {
  public slots:
   void slotSetTypeFile(const QString& filename) override;
 
+ protected:
+  /// apply the memory cache size to the cache of decoded subdivisions
+  void configureCache() override;
+
  private:
   enum exce_e { eErrOpen, eErrAccess, errFormat, errLock, errAbort };
+
+  /**
+     @brief All objects of a subdivision
+
+     The content does not depend on the viewport or the visibility settings. Thus
+     it can be reused for each redraw as long as the subdivision is visible.
+   */
+  struct subdiv_data_t {
+    polytype_t polylines;
+    polytype_t polygons;
+    pointtype_t points;
+    pointtype_t pois;
+    /// bounding rectangles of the polylines [rad]
+    QVector<QRectF> rectPolylines;
+    /// bounding rectangles of the polygons [rad]
+    QVector<QRectF> rectPolygons;
+    /// time needed to decode the subdivision [ns]
+    qint64 decodeTime = 0;
+    /// false if the labels have been skipped while decoding in fast mode
+    bool hasLabels = true;
+  };
+
+  /// key of a subdivision in the cache: subfile name and subdivision number
+  using subdiv_key_t = QPair<QString, quint32>;
+  /// a cached subdivision is shared by the cache and all threads collecting its items
+  using subdiv_ptr_t = QSharedPointer<const subdiv_data_t>;
   struct exce_t {
     exce_t(exce_e err, const QString& msg) : err(err), msg(msg) {}
     exce_e err;
@@ -162,15 +199,18 @@ class CMapIMG : public IMap {
   void readFile(CFileExt& file, quint32 offset, quint32 size, QByteArray& data);
   void loadVisibleData(bool fast, polytype_t& polygons, polytype_t& polylines, pointtype_t& points, pointtype_t& pois,
                        unsigned level, const QRectF& viewport, QPainter& p);
+  void loadSubfile(const subfile_desc_t& subfile, bool fast, unsigned level, const QRectF& viewport,
+                   polytype_t& polygons, polytype_t& polylines, pointtype_t& points, pointtype_t& pois);
   void loadSubDiv(CFileExt& file, const subdiv_desc_t& subdiv, IGarminStrTbl* strtbl, const QByteArray& rgndata,
-                  bool fast, const QRectF& viewport, polytype_t& polylines, polytype_t& polygons, pointtype_t& points,
-                  pointtype_t& pois);
+                  subdiv_data_t& data);
+  void collectSubDiv(const subdiv_data_t& data, bool fast, const QRectF& viewport, polytype_t& polylines,
+                     polytype_t& polygons, pointtype_t& points, pointtype_t& pois);
   bool intersectsWithExistingLabel(const QRect& rect) const;
   void addLabel(const CGarminPoint& pt, const QRect& rect, const CGarminTyp::point_property& property, bool isDay);
   void drawPolygons(QPainter& p, polytype_t& lines);
   void drawPolylines(QPainter& p, polytype_t& lines, const QPointF& scale);
-  void drawPoints(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPois);
-  void drawPois(QPainter& p, pointtype_t& pts, QVector<QRectF>& rectPois);
+  void drawPoints(QPainter& p, pointtype_t& pts, CCollisionGrid& rectPois);
+  void drawPois(QPainter& p, pointtype_t& pts, CCollisionGrid& rectPois);
   void drawLabels(QPainter& p, const QVector<strlbl_t>& lbls);
   void drawText(QPainter& p);
 
@@ -471,6 +511,24 @@ class CMapIMG : public IMap {
   pointtype_t pois;
 
   QVector<strlbl_t> labels;
+  /// the rectangles of all labels to test for intersections
+  CCollisionGrid labelGrid;
+
+  /// decode the visible subfiles in parallel
+  QThreadPool threadPool;
+
+  /// protect subdivCache and subdivCacheStats
+  mutable QMutex subdivCacheMutex;
+  /// decoded subdivisions, the cost is in [kByte]
+  QCache<subdiv_key_t, subdiv_ptr_t> subdivCache;
+
+  struct subdiv_cache_stats_t {
+    quint64 hits = 0;
+    quint64 misses = 0;
+    /// the sum of the decode time of all hits [ns]
+    qint64 timeSaved = 0;
+  };
+  subdiv_cache_stats_t subdivCacheStats;
 
   struct textpath_t {
     // QPainterPath path;
@@ -49,15 +49,25 @@ CMapPropSetup::CMapPropSetup(IMap* mapfile, CMapDraw* map) : IMapProp(mapfile, m
   connect(spinAdjustDetails, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), map,
           &CMapDraw::emitSigCanvasUpdate);
 
-  connect(spinCacheSize, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), mapfile,
-          &IMap::slotSetCacheSize);
-  connect(spinCacheExpiration, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), mapfile,
-          &IMap::slotSetCacheExpiration);
+  // the cache is reconfigured with each change, thus apply the spin boxes' values only when done
+  connect(spinCacheSize, &QSpinBox::editingFinished, mapfile,
+          [this]() { mapfile->slotSetCacheSize(spinCacheSize->value()); });
+  connect(spinCacheExpiration, &QSpinBox::editingFinished, mapfile,
+          [this]() { mapfile->slotSetCacheExpiration(spinCacheExpiration->value()); });
+  connect(spinCacheMemSize, &QSpinBox::editingFinished, mapfile,
+          [this]() { mapfile->slotSetCacheMemSize(spinCacheMemSize->value()); });
+  connect(spinDataCacheMemSize, &QSpinBox::editingFinished, mapfile,
+          [this]() { mapfile->slotSetCacheMemSize(spinDataCacheMemSize->value()); });
+  connect(comboCacheFormat, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), mapfile,
+          &IMap::slotSetCacheFormat);
+  connect(comboCacheBackend, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), mapfile,
+          &IMap::slotSetCacheBackend);
 
   connect(toolOpenTypFile, &QToolButton::pressed, this, &CMapPropSetup::slotLoadTypeFile);
   connect(toolClearTypFile, &QToolButton::pressed, this, &CMapPropSetup::slotClearTypeFile);
 
   frameVectorItems->setVisible(mapfile->hasFeatureVectorItems());
+  frameDataCache->setVisible(mapfile->hasFeatureDataCache());
   frameTileCache->setVisible(mapfile->hasFeatureTileCache());
 
   if (mapfile->hasFeatureLayers()) {
@@ -91,6 +101,7 @@ void CMapPropSetup::slotPropertiesChanged() /* override */
   checkPolylines->setChecked(mapfile->getShowPolylines());
   checkPoints->setChecked(mapfile->getShowPOIs());
   spinAdjustDetails->setValue(mapfile->getAdjustDetailLevel());
+  spinDataCacheMemSize->setValue(mapfile->getCacheMemSize());
 
   // streaming map properties
   QString lbl = mapfile->getCachePath();
@@ -98,6 +109,15 @@ void CMapPropSetup::slotPropertiesChanged() /* override */
   labelCachePath->setToolTip(lbl);
   spinCacheSize->setValue(mapfile->getCacheSize());
   spinCacheExpiration->setValue(mapfile->getCacheExpiration());
+  spinCacheMemSize->setValue(mapfile->getCacheMemSize());
+  comboCacheFormat->setCurrentIndex(mapfile->getCacheFormat());
+  comboCacheBackend->setCurrentIndex(mapfile->getCacheBackend());
+
+  // cache statistics of streaming and vector maps
+  const QString statistics = mapfile->getCacheStatistics();
+  labelCacheStatistics->setText(statistics);
+  labelCacheStatistics->setVisible(!statistics.isEmpty());
+
   if (mapfile->hasFeatureLayers()) {
     mapfile->getLayers(*listLayers);
   }
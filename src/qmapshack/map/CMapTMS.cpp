@@ -27,6 +27,7 @@
 #include "gis/proj_x.h"
 #include "helpers/CDraw.h"
 #include "map/CMapDraw.h"
+#include "map/CTileSeeder.h"
 #include "map/cache/CDiskCache.h"
 #include "units/IUnit.h"
 
@@ -140,6 +141,7 @@ CMapTMS::CMapTMS(const QString& filename, CMapDraw* parent) : IMapOnline(parent)
   // create default cache path from filename
   QFileInfo fi(filename);
   slotSetCachePath(QDir(CMapDraw::getCacheRoot()).absoluteFilePath(fi.completeBaseName()));
+  applyCacheSettings();
 
   name = fi.completeBaseName().replace("_", " ");
 
@@ -272,11 +274,6 @@ QString CMapTMS::createUrl(const layer_t& layer, int x, int y, int z) {
 
 void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
 {
-  QMutexLocker lock(&mutex);
-
-  timeLastUpdate.start();
-  urlQueue.clear();
-
   if (map->needsRedraw()) {
     return;
   }
@@ -284,6 +281,8 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
   QPointF bufferScale = buf.scale * buf.zoomFactor;
 
   if (isOutOfScale(bufferScale)) {
+    // drop all requests of former views
+    scheduleQueue({});
     return;
   }
 
@@ -311,7 +310,11 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
     x2 = 180 * DEG_TO_RAD;
   }
 
-  // draw layers
+  // collect the tiles of all layers, the tiles are drawn without the mutex locked
+  QList<tile_t> tiles;
+  QMutexLocker lock(&mutex);
+  timeLastUpdate.start();
+
   for (const layer_t& layer : qAsConst(layers)) {
     if (!layer.enabled) {
       continue;
@@ -342,34 +345,82 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
     row1 = lat2tile(y1 * RAD_TO_DEG, z) / 256;
     row2 = lat2tile(y2 * RAD_TO_DEG, z) / 256;
 
+    // the view's centre in tiles, tiles close to it are requested first
+    const qreal xc = (lon2tile(x1 * RAD_TO_DEG, z) + lon2tile(x2 * RAD_TO_DEG, z)) / 512.0;
+    const qreal yc = (lat2tile(y1 * RAD_TO_DEG, z) + lat2tile(y2 * RAD_TO_DEG, z)) / 512.0;
+
     //        qDebug() << col1 << col2 << row1 << row2 << (col2 - col1) << (row2 - row1) << ((col2 - col1) * (row2 -
     //        row1));
 
-    // start to request tiles. draw tiles in cache, queue urls of tile yet to be requested
     for (qint32 row = row1; row <= row2; row++) {
       for (qint32 col = col1; col <= col2; col++) {
         QString url = createUrl(layer, col, row, z);
         //                qDebug() << url;
 
-        if (diskCache->contains(url)) {
-          QImage img;
-          diskCache->restore(url, img);
+        QPolygonF l;
 
-          QPolygonF l;
+        qreal xx1 = tile2lon(col, z) * DEG_TO_RAD;
+        qreal yy1 = tile2lat(row, z) * DEG_TO_RAD;
+        qreal xx2 = tile2lon(col + 1, z) * DEG_TO_RAD;
+        qreal yy2 = tile2lat(row + 1, z) * DEG_TO_RAD;
 
-          qreal xx1 = tile2lon(col, z) * DEG_TO_RAD;
-          qreal yy1 = tile2lat(row, z) * DEG_TO_RAD;
-          qreal xx2 = tile2lon(col + 1, z) * DEG_TO_RAD;
-          qreal yy2 = tile2lat(row + 1, z) * DEG_TO_RAD;
-
-          l << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
-          drawTile(img, l, p);
-        } else {
-          urlQueue << url;
-        }
+        l << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
+        tiles << tile_t{url, l, QLineF(xc, yc, col + 0.5, row + 0.5).length()};
       }
     }
+  }
+  lock.unlock();
+
+  // draw tiles in cache, queue urls of tile yet to be requested
+  drawTiles(tiles, p);
+}
 
-    emit sigQueueChanged();
+QStringList CMapTMS::getSeedLevels() {
+  QMutexLocker lock(&mutex);
+
+  // the layers' zoom levels count from fine to coarse, the tile server's from coarse to fine
+  QStringList levels;
+  for (qint32 z = 21 - qMin(20, maxZoomLevel); z <= 21 - minZoomLevel; z++) {
+    levels << tr("Zoom level %1").arg(z);
+  }
+  return levels;
+}
+
+bool CMapTMS::getSeedTiles(const QList<QPolygonF>& area, qint32 level, qint32 maxTiles, QStringList& urls) {
+  QMutexLocker lock(&mutex);
+
+  const qint32 z = 21 - qMin(20, maxZoomLevel) + level;
+  if (level < 0 || z > 21 - minZoomLevel) {
+    return true;
+  }
+  const qint32 zoomLevel = 21 - z;
+
+  // the area in tiles
+  QPainterPath path;
+  path.setFillRule(Qt::WindingFill);
+  for (const QPolygonF& polygon : area) {
+    QPolygonF tiles;
+    for (const QPointF& pt : polygon) {
+      tiles << QPointF(lon2tile(pt.x() * RAD_TO_DEG, z), lat2tile(pt.y() * RAD_TO_DEG, z)) / 256.0;
+    }
+    path.addPolygon(tiles);
+    path.closeSubpath();
+  }
+
+  const QRect& range = path.boundingRect().toAlignedRect() & QRect(0, 0, 1 << z, 1 << z);
+
+  for (const layer_t& layer : qAsConst(layers)) {
+    if (!layer.enabled || zoomLevel < layer.minZoomLevel || zoomLevel > layer.maxZoomLevel) {
+      continue;
+    }
+
+    const bool ok = CTileSeeder::forEachTile(path, range, [&](qint32 col, qint32 row) {
+      urls << createUrl(layer, col, row, z);
+      return urls.size() <= maxTiles;
+    });
+    if (!ok) {
+      return false;
+    }
   }
+  return true;
 }
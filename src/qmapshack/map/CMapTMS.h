@@ -39,6 +39,9 @@ class CMapTMS : public IMapOnline {
   void saveConfig(QSettings& cfg) override;
   void loadConfig(QSettings& cfg) override;
 
+  QStringList getSeedLevels() override;
+  bool getSeedTiles(const QList<QPolygonF>& area, qint32 level, qint32 maxTiles, QStringList& urls) override;
+
  private slots:
   void slotLayersChanged(QListWidgetItem* item);
 
@@ -27,6 +27,7 @@
 #include "CMainWindow.h"
 #include "helpers/CDraw.h"
 #include "map/CMapDraw.h"
+#include "map/CTileSeeder.h"
 #include "map/cache/CDiskCache.h"
 #include "units/IUnit.h"
 
@@ -244,6 +245,7 @@ CMapWMTS::CMapWMTS(const QString& filename, CMapDraw* parent) : IMapOnline(paren
   // create default cache path from filename
   QFileInfo fi(filename);
   slotSetCachePath(QDir(CMapDraw::getCacheRoot()).absoluteFilePath(fi.completeBaseName()));
+  applyCacheSettings();
 
   name = fi.completeBaseName().replace("_", " ");
 
@@ -339,11 +341,6 @@ void CMapWMTS::slotLayersChanged(QListWidgetItem* item) {
 
 void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
 {
-  QMutexLocker lock(&mutex);
-
-  timeLastUpdate.start();
-  urlQueue.clear();
-
   if (map->needsRedraw()) {
     return;
   }
@@ -351,6 +348,8 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
   QPointF bufferScale = buf.scale * buf.zoomFactor;
 
   if (isOutOfScale(bufferScale)) {
+    // drop all requests of former views
+    scheduleQueue({});
     return;
   }
 
@@ -380,7 +379,11 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
 
   QRectF viewport(QPointF(x1, y1) * RAD_TO_DEG, QPointF(x2, y2) * RAD_TO_DEG);
 
-  // draw layers
+  // collect the tiles of all layers, the tiles are drawn without the mutex locked
+  QList<tile_t> tiles;
+  QMutexLocker lock(&mutex);
+  timeLastUpdate.start();
+
   for (const layer_t& layer : qAsConst(layers)) {
     if (!layer.boundingBox.intersects(viewport) || !layer.enabled) {
       continue;
@@ -446,6 +449,11 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
     qint32 col2 = qFloor((pt2.x() - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth));
     qint32 row2 = qFloor((pt2.y() - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight));
 
+    // the view's centre in tiles, tiles close to it are requested first
+    const QPointF& ptc = (pt1 + pt2) / 2;
+    const qreal xc = (ptc.x() - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth);
+    const qreal yc = (ptc.y() - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight);
+
     if (col1 < minCol) {
       col1 = minCol;
     }
@@ -472,36 +480,125 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
       row2 = maxRow;
     }
 
-    // start to request tiles. draw tiles in cache, queue urls of tile yet to be requested
     for (qint32 row = row1; row <= row2; row++) {
       for (qint32 col = col1; col <= col2; col++) {
-        QString url = layer.resourceURL;
-        url = url.replace("{TileMatrix}", tileMatrixId, Qt::CaseInsensitive);
-        url = url.replace("{TileRow}", QString::number(row), Qt::CaseInsensitive);
-        url = url.replace("{TileCol}", QString::number(col), Qt::CaseInsensitive);
+        const QString& url = createUrl(layer, tileMatrixId, col, row);
+
+        QPolygonF l;
+
+        qreal xx1 = col * (xscale * tilematrix.tileWidth) + tilematrix.topLeft.x();
+        qreal yy1 = row * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y();
+        qreal xx2 = (col + 1) * (xscale * tilematrix.tileWidth) + tilematrix.topLeft.x();
+        qreal yy2 = (row + 1) * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y();
+
+        l << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
+
+        tileset.proj.transform(l, PJ_FWD);
+
+        tiles << tile_t{url, l, QLineF(xc, yc, col + 0.5, row + 0.5).length()};
+      }
+    }
+  }
+  lock.unlock();
+
+  // draw tiles in cache, queue urls of tile yet to be requested
+  drawTiles(tiles, p);
+}
+
+QString CMapWMTS::createUrl(const layer_t& layer, const QString& tileMatrixId, qint32 col, qint32 row) const {
+  QString url = layer.resourceURL;
+  url = url.replace("{TileMatrix}", tileMatrixId, Qt::CaseInsensitive);
+  url = url.replace("{TileRow}", QString::number(row), Qt::CaseInsensitive);
+  url = url.replace("{TileCol}", QString::number(col), Qt::CaseInsensitive);
+  return url;
+}
+
+QStringList CMapWMTS::getSeedMatrixIds() const {
+  QMap<QString, qreal> scales;
+  for (const layer_t& layer : layers) {
+    if (!layer.enabled) {
+      continue;
+    }
 
-        if (diskCache->contains(url)) {
-          QImage img;
-          diskCache->restore(url, img);
+    const tileset_t& tileset = tilesets[layer.tileMatrixSet];
+    for (auto it = tileset.tilematrix.constBegin(); it != tileset.tilematrix.constEnd(); ++it) {
+      if (!scales.contains(it.key())) {
+        scales[it.key()] = it->scale;
+      }
+    }
+  }
+
+  QStringList ids = scales.keys();
+  std::stable_sort(ids.begin(), ids.end(),
+                   [&scales](const QString& id1, const QString& id2) { return scales[id1] > scales[id2]; });
+  return ids;
+}
 
-          QPolygonF l;
+QStringList CMapWMTS::getSeedLevels() {
+  QMutexLocker lock(&mutex);
+  return getSeedMatrixIds();
+}
 
-          qreal xx1 = col * (xscale * tilematrix.tileWidth) + tilematrix.topLeft.x();
-          qreal yy1 = row * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y();
-          qreal xx2 = (col + 1) * (xscale * tilematrix.tileWidth) + tilematrix.topLeft.x();
-          qreal yy2 = (row + 1) * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y();
+bool CMapWMTS::getSeedTiles(const QList<QPolygonF>& area, qint32 level, qint32 maxTiles, QStringList& urls) {
+  QMutexLocker lock(&mutex);
 
-          l << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
+  const QStringList& ids = getSeedMatrixIds();
+  if (level < 0 || level >= ids.size()) {
+    return true;
+  }
+  const QString& tileMatrixId = ids[level];
 
-          tileset.proj.transform(l, PJ_FWD);
+  QRectF boundingBox;
+  for (const QPolygonF& polygon : area) {
+    boundingBox |= polygon.boundingRect();
+  }
+  const QRectF viewport(boundingBox.topLeft() * RAD_TO_DEG, boundingBox.bottomRight() * RAD_TO_DEG);
 
-          drawTile(img, l, p);
-        } else {
-          urlQueue << url;
+  for (const layer_t& layer : qAsConst(layers)) {
+    const tileset_t& tileset = tilesets[layer.tileMatrixSet];
+    if (!layer.enabled || !layer.boundingBox.intersects(viewport) || !tileset.tilematrix.contains(tileMatrixId)) {
+      continue;
+    }
+
+    // the same limits as used by draw()
+    const tilematrix_t& tilematrix = tileset.tilematrix[tileMatrixId];
+    QRect range(0, 0, tilematrix.matrixWidth, tilematrix.matrixHeight);
+    if (!layer.limits.isEmpty()) {
+      if (!layer.limits.contains(tileMatrixId)) {
+        continue;
+      }
+      const limit_t& limit = layer.limits[tileMatrixId];
+      range = QRect(QPoint(limit.minTileCol, limit.minTileRow), QPoint(limit.maxTileCol, limit.maxTileRow));
+    }
+
+    // the area in tiles
+    const qreal xscale = tilematrix.scale * 0.28e-3;
+    const qreal yscale = -tilematrix.scale * 0.28e-3;
+
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    for (QPolygonF polygon : area) {
+      tileset.proj.transform(polygon, PJ_INV);
+      for (QPointF& pt : polygon) {
+        if (tileset.proj.isSrcLatLong()) {
+          pt *= RAD_TO_DEG;
         }
+        pt = QPointF((pt.x() - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth),
+                     (pt.y() - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight));
       }
+      path.addPolygon(polygon);
+      path.closeSubpath();
     }
 
-    emit sigQueueChanged();
+    range &= path.boundingRect().toAlignedRect();
+
+    const bool ok = CTileSeeder::forEachTile(path, range, [&](qint32 col, qint32 row) {
+      urls << createUrl(layer, tileMatrixId, col, row);
+      return urls.size() <= maxTiles;
+    });
+    if (!ok) {
+      return false;
+    }
   }
+  return true;
 }
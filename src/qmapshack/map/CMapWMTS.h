@@ -41,6 +41,9 @@ class CMapWMTS : public IMapOnline {
   void saveConfig(QSettings& cfg) override;
   void loadConfig(QSettings& cfg) override;
 
+  QStringList getSeedLevels() override;
+  bool getSeedTiles(const QList<QPolygonF>& area, qint32 level, qint32 maxTiles, QStringList& urls) override;
+
  private slots:
   void slotLayersChanged(QListWidgetItem* item);
 
@@ -79,6 +82,10 @@ class CMapWMTS : public IMapOnline {
   };
 
   QMap<QString, tileset_t> tilesets;
+
+  QString createUrl(const layer_t& layer, const QString& tileMatrixId, qint32 col, qint32 row) const;
+  /// the IDs of the tile matrices of all enabled layers, from coarse to fine
+  QStringList getSeedMatrixIds() const;
 };
 
 #endif  // CMAPWMTS_H
@@ -0,0 +1,163 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/CTileScheduler.h"
+
+#include <QSet>
+#include <QtNetwork>
+#include <algorithm>
+
+QHash<QString, qint32> CTileScheduler::slotsPerHost;
+QList<CTileScheduler*> CTileScheduler::schedulers;
+
+CTileScheduler::CTileScheduler(QObject* parent) : QObject(parent) {
+  accessManager = new QNetworkAccessManager(this);
+  connect(accessManager, &QNetworkAccessManager::finished, this, &CTileScheduler::slotRequestFinished);
+
+  schedulers << this;
+}
+
+CTileScheduler::~CTileScheduler() {
+  schedulers.removeOne(this);
+
+  // the replies are aborted by the access manager, free their slots
+  const QList<QString>& urls = running.keys();
+  running.clear();
+  for (const QString& url : urls) {
+    release(QUrl(url).host());
+  }
+}
+
+void CTileScheduler::setRequests(const QList<request_t>& requests) {
+  QSet<QString> wanted;
+  wanted.reserve(requests.size());
+
+  queue.clear();
+  for (const request_t& request : requests) {
+    if (wanted.contains(request.url)) {
+      continue;
+    }
+    wanted.insert(request.url);
+
+    if (!running.contains(request.url)) {
+      queue << job_t{request.url, QUrl(request.url).host(), request.priority};
+    }
+  }
+
+  std::stable_sort(queue.begin(), queue.end(), &CTileScheduler::lessThan);
+
+  // abort all requests not needed anymore
+  const QList<QString>& urls = running.keys();
+  for (const QString& url : urls) {
+    if (wanted.contains(url)) {
+      continue;
+    }
+    // remove the reply first as abort() emits the finished signal
+    QNetworkReply* reply = running.take(url);
+    release(QUrl(url).host());
+    reply->abort();
+  }
+
+  startRequests();
+}
+
+bool CTileScheduler::isPending(const QString& url) const {
+  if (running.contains(url)) {
+    return true;
+  }
+  for (const job_t& job : queue) {
+    if (job.url == url) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CTileScheduler::addRequest(const request_t& request) {
+  if (isPending(request.url)) {
+    return;
+  }
+
+  const job_t job{request.url, QUrl(request.url).host(), request.priority};
+  queue.insert(std::upper_bound(queue.begin(), queue.end(), job, &CTileScheduler::lessThan), job);
+
+  startRequests();
+}
+
+void CTileScheduler::startRequests() {
+  for (qint32 i = 0; i < queue.size();) {
+    const QString& host = queue[i].host;
+    if ((runningPerHost.value(host) >= maxPerHost) || (slotsPerHost.value(host) >= kMaxPerHost)) {
+      i++;
+      continue;
+    }
+
+    const job_t job = queue.takeAt(i);
+
+    QNetworkRequest request;
+    request.setUrl(job.url);
+    // keep the url as it was queued, QUrl might change its encoding
+    request.setAttribute(QNetworkRequest::User, job.url);
+    for (auto header = rawHeaders.constBegin(); header != rawHeaders.constEnd(); ++header) {
+      request.setRawHeader(header.key(), header.value());
+    }
+
+    running[job.url] = accessManager->get(request);
+    runningPerHost[job.host]++;
+    slotsPerHost[job.host]++;
+  }
+}
+
+void CTileScheduler::release(const QString& host) {
+  if (--runningPerHost[host] <= 0) {
+    runningPerHost.remove(host);
+  }
+  if (--slotsPerHost[host] <= 0) {
+    slotsPerHost.remove(host);
+  }
+
+  // another scheduler might wait for the slot
+  for (CTileScheduler* scheduler : qAsConst(schedulers)) {
+    if (scheduler != this) {
+      scheduler->startRequests();
+    }
+  }
+}
+
+void CTileScheduler::slotRequestFinished(QNetworkReply* reply) {
+  reply->deleteLater();
+
+  const QString& url = reply->request().attribute(QNetworkRequest::User).toString();
+  if (running.value(url) != reply) {
+    // aborted
+    return;
+  }
+  running.remove(url);
+  release(QUrl(url).host());
+
+  QByteArray data;
+  if (reply->error() == QNetworkReply::NoError) {
+    data = reply->readAll();
+  } else {
+    qDebug() << "Request to" << url << "failed:" << reply->errorString();
+  }
+
+  startRequests();
+
+  emit sigTileReceived(url, data);
+}
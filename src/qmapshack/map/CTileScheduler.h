@@ -0,0 +1,127 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILESCHEDULER_H
+#define CTILESCHEDULER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/**
+   @brief Request tiles from a tile server by priority
+
+   The scheduler gets the complete list of missing tiles with each redraw of
+   the map. Requests are started by priority. Requests of former views, e.g.
+   the ones of another zoom level or of an area the user panned away from, are
+   dropped from the queue and running requests for them are aborted. The number
+   of parallel requests per host is limited for each scheduler. Additionally all
+   schedulers share the kMaxPerHost slots of each host. Thus several maps using
+   the same tile server do not exceed the limit together.
+
+   All schedulers have to live in the same thread.
+ */
+class CTileScheduler : public QObject {
+  Q_OBJECT
+ public:
+  CTileScheduler(QObject* parent);
+  virtual ~CTileScheduler();
+
+  /// the maximum number of parallel requests to a host by all schedulers
+  static constexpr qint32 kMaxPerHost = 6;
+
+  struct request_t {
+    QString url;
+    qreal priority;  //< the distance to the view's centre in tiles, lower values are requested first
+  };
+
+  /**
+     @brief Replace all queued requests
+
+     Requests of the same priority are started in the order of the list.
+     Duplicate urls are requested once. Running requests for urls not in the
+     list are aborted.
+
+     @param requests  all tiles missing in the current view
+   */
+  void setRequests(const QList<request_t>& requests);
+
+  /**
+     @brief Add a single request to the queue
+
+     The request is ignored if the url is already queued or running.
+   */
+  void addRequest(const request_t& request);
+
+  void setRawHeader(const QByteArray& name, const QByteArray& value) { rawHeaders[name] = value; }
+
+  void setMaxPerHost(qint32 n) { maxPerHost = qMax(1, n); }
+  qint32 getMaxPerHost() const { return maxPerHost; }
+
+  /// the number of queued and running requests
+  qint32 getPending() const { return queue.size() + running.size(); }
+  /// true if the url is queued or running
+  bool isPending(const QString& url) const;
+
+ signals:
+  /**
+     @brief A request has finished
+
+     This is not emitted for aborted requests.
+
+     @param url   the requested url
+     @param data  the received data, empty on errors
+   */
+  void sigTileReceived(const QString& url, const QByteArray& data);
+
+ private slots:
+  void slotRequestFinished(QNetworkReply* reply);
+
+ private:
+  struct job_t {
+    QString url;
+    QString host;
+    qreal priority;
+  };
+
+  static bool lessThan(const job_t& j1, const job_t& j2) { return j1.priority < j2.priority; }
+  void startRequests();
+  void release(const QString& host);
+
+  QNetworkAccessManager* accessManager;
+  QHash<QByteArray, QByteArray> rawHeaders;
+
+  qint32 maxPerHost = kMaxPerHost;
+
+  /// requests not started yet, sorted by priority
+  QList<job_t> queue;
+  /// running requests by url
+  QHash<QString, QNetworkReply*> running;
+  /// number of running requests by host
+  QHash<QString, qint32> runningPerHost;
+
+  /// number of running requests of all schedulers by host
+  static QHash<QString, qint32> slotsPerHost;
+  /// all schedulers, to start queued requests when another scheduler frees a slot
+  static QList<CTileScheduler*> schedulers;
+};
+
+#endif  // CTILESCHEDULER_H
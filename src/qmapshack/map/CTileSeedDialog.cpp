@@ -0,0 +1,226 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/CTileSeedDialog.h"
+
+#include <QtWidgets>
+
+#include "CMainWindow.h"
+#include "canvas/CCanvas.h"
+#include "helpers/CSettings.h"
+#include "map/CTileSeeder.h"
+#include "map/IMapOnline.h"
+
+CTileSeedDialog::CTileSeedDialog(const QString& name, const QPolygonF& line, bool isArea, QWidget* parent)
+    : QDialog(parent), line(line), isArea(isArea) {
+  setupUi(this);
+  setAttribute(Qt::WA_DeleteOnClose);
+
+  labelArea->setText(name);
+  labelWidth->setVisible(!isArea);
+  spinWidth->setVisible(!isArea);
+
+  SETTINGS;
+  cfg.beginGroup("TileSeedDialog");
+  spinWidth->setValue(cfg.value("width", spinWidth->value()).toInt());
+  spinRate->setValue(cfg.value("rate", spinRate->value()).toInt());
+  cfg.endGroup();
+
+  CCanvas* canvas = CMainWindow::self().getVisibleCanvas();
+  if (canvas != nullptr) {
+    canvas->getOnlineMaps(maps);
+  }
+  for (const QPointer<IMapOnline>& map : qAsConst(maps)) {
+    comboMap->addItem(map->getName());
+  }
+
+  connect(comboMap, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+          &CTileSeedDialog::slotMapChanged);
+  connect(comboLevelFirst, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+          &CTileSeedDialog::slotSetupChanged);
+  connect(comboLevelLast, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+          &CTileSeedDialog::slotSetupChanged);
+  connect(spinWidth, QOverload<int>::of(&QSpinBox::valueChanged), this, &CTileSeedDialog::slotSetupChanged);
+  connect(spinRate, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int rate) {
+    if (seeder != nullptr && seeder->isRunning()) {
+      seeder->stop();
+      seeder->start(rate);
+    }
+  });
+  connect(pushEstimate, &QPushButton::clicked, this, &CTileSeedDialog::slotEstimate);
+  connect(pushStart, &QPushButton::clicked, this, &CTileSeedDialog::slotStart);
+  connect(pushStop, &QPushButton::clicked, this, &CTileSeedDialog::slotStop);
+
+  slotMapChanged(comboMap->currentIndex());
+
+  if (maps.isEmpty()) {
+    labelEstimate->setText(tr("There is no active online map (TMS or WMTS) in the current view."));
+  }
+}
+
+CTileSeedDialog::~CTileSeedDialog() {
+  // stops the job and stores its position
+  delete seeder;
+
+  SETTINGS;
+  cfg.beginGroup("TileSeedDialog");
+  cfg.setValue("width", spinWidth->value());
+  cfg.setValue("rate", spinRate->value());
+  cfg.setValue("levelFirst", comboLevelFirst->currentText());
+  cfg.setValue("levelLast", comboLevelLast->currentText());
+  cfg.endGroup();
+}
+
+void CTileSeedDialog::slotMapChanged(int idx) {
+  comboLevelFirst->clear();
+  comboLevelLast->clear();
+
+  if (idx >= 0 && idx < maps.size() && !maps[idx].isNull()) {
+    const QStringList& levels = maps[idx]->getSeedLevels();
+    comboLevelFirst->addItems(levels);
+    comboLevelLast->addItems(levels);
+
+    // by default something between a region and a street map
+    SETTINGS;
+    cfg.beginGroup("TileSeedDialog");
+    const qint32 first = levels.indexOf(cfg.value("levelFirst").toString());
+    const qint32 last = levels.indexOf(cfg.value("levelLast").toString());
+    cfg.endGroup();
+    comboLevelFirst->setCurrentIndex(first < 0 ? qMin(9, levels.size() - 1) : first);
+    comboLevelLast->setCurrentIndex(last < 0 ? qMin(15, levels.size() - 1) : last);
+  }
+
+  slotSetupChanged();
+}
+
+void CTileSeedDialog::slotSetupChanged() {
+  delete seeder;
+  seeder = nullptr;
+
+  progressBar->setValue(0);
+  labelEstimate->setText("-");
+  labelStatus->setText("-");
+  updateButtons();
+}
+
+bool CTileSeedDialog::createSeeder() {
+  if (seeder != nullptr) {
+    return true;
+  }
+
+  const qint32 idx = comboMap->currentIndex();
+  if (idx < 0 || idx >= maps.size() || maps[idx].isNull()) {
+    labelEstimate->setText(tr("The map is not active anymore."));
+    return false;
+  }
+
+  const qint32 first = comboLevelFirst->currentIndex();
+  const qint32 last = comboLevelLast->currentIndex();
+  if (first < 0 || last < first) {
+    labelEstimate->setText(tr("The first zoom level must not be finer than the last one."));
+    return false;
+  }
+
+  CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
+
+  const QList<QPolygonF>& area = isArea ? QList<QPolygonF>{line} : CTileSeeder::getCorridor(line, spinWidth->value());
+  seeder = new CTileSeeder(maps[idx], area, first, last, this);
+  connect(seeder, &CTileSeeder::sigProgress, this, &CTileSeedDialog::slotProgress);
+  connect(seeder, &CTileSeeder::sigFinished, this, &CTileSeedDialog::slotFinished);
+  connect(seeder, &CTileSeeder::sigError, this, &CTileSeedDialog::slotError);
+
+  CTileSeeder::estimate_t estimate;
+  if (!seeder->estimate(estimate)) {
+    labelEstimate->setText(tr("The area has more than %1 tiles. Please choose a smaller area or less zoom levels.")
+                               .arg(CTileSeeder::kMaxTiles));
+    delete seeder;
+    seeder = nullptr;
+    return false;
+  }
+
+  QString msg = tr("%1 tiles, %2 of them are in the cache already. About %3 MB have to be loaded.")
+                    .arg(estimate.tiles)
+                    .arg(estimate.cached)
+                    .arg(estimate.bytes / (1024.0 * 1024.0), 0, 'f', 1);
+  if (seeder->isResumed()) {
+    msg += " " + tr("A former job stopped after %1 tiles. It will be continued.").arg(seeder->getPosition());
+  }
+  labelEstimate->setText(msg);
+
+  slotProgress();
+  return true;
+}
+
+void CTileSeedDialog::slotEstimate() {
+  createSeeder();
+  updateButtons();
+}
+
+void CTileSeedDialog::slotStart() {
+  if (!createSeeder()) {
+    updateButtons();
+    return;
+  }
+
+  seeder->start(spinRate->value());
+  updateButtons();
+}
+
+void CTileSeedDialog::slotStop() {
+  if (seeder != nullptr) {
+    seeder->stop();
+  }
+  updateButtons();
+}
+
+void CTileSeedDialog::slotProgress() {
+  if (seeder == nullptr) {
+    return;
+  }
+
+  progressBar->setRange(0, qMax(1, seeder->getTotal()));
+  progressBar->setValue(seeder->getPosition());
+  labelStatus->setText(tr("Received %1 tiles (%2 MB), %3 failed.")
+                           .arg(seeder->getReceived())
+                           .arg(seeder->getBytes() / (1024.0 * 1024.0), 0, 'f', 1)
+                           .arg(seeder->getFailed()));
+}
+
+void CTileSeedDialog::slotFinished() {
+  labelStatus->setText(labelStatus->text() + " " + tr("Done."));
+  updateButtons();
+}
+
+void CTileSeedDialog::slotError(const QString& msg) {
+  updateButtons();
+  QMessageBox::warning(this, tr("Error..."), msg, QMessageBox::Ok);
+}
+
+void CTileSeedDialog::updateButtons() {
+  const bool isRunning = seeder != nullptr && seeder->isRunning();
+  const bool hasMaps = !maps.isEmpty();
+
+  pushEstimate->setEnabled(hasMaps && !isRunning);
+  pushStart->setEnabled(hasMaps && !isRunning);
+  pushStop->setEnabled(isRunning);
+
+  comboMap->setEnabled(!isRunning);
+  comboLevelFirst->setEnabled(!isRunning);
+  comboLevelLast->setEnabled(!isRunning);
+  spinWidth->setEnabled(!isRunning);
+}
@@ -0,0 +1,68 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILESEEDDIALOG_H
+#define CTILESEEDDIALOG_H
+
+#include <QDialog>
+#include <QPointer>
+
+#include "ui_ITileSeedDialog.h"
+
+class CTileSeeder;
+class IMapOnline;
+
+/**
+   @brief Seed the tile cache of an online map for an area or along a line
+
+   The dialog is not modal. The job runs while the user continues to work.
+   Closing the dialog stops the job.
+ */
+class CTileSeedDialog : public QDialog, private Ui::ITileSeedDialog {
+  Q_OBJECT
+ public:
+  /**
+     @param name    the name of the area or line
+     @param line    the area's border or the line in [rad]
+     @param isArea  true if line is the border of an area, false for a corridor along the line
+   */
+  CTileSeedDialog(const QString& name, const QPolygonF& line, bool isArea, QWidget* parent);
+  virtual ~CTileSeedDialog();
+
+ private slots:
+  void slotMapChanged(int idx);
+  void slotSetupChanged();
+  void slotEstimate();
+  void slotStart();
+  void slotStop();
+  void slotProgress();
+  void slotFinished();
+  void slotError(const QString& msg);
+
+ private:
+  bool createSeeder();
+  void updateButtons();
+
+  const QPolygonF line;
+  const bool isArea;
+
+  QList<QPointer<IMapOnline>> maps;
+  CTileSeeder* seeder = nullptr;
+};
+
+#endif  // CTILESEEDDIALOG_H
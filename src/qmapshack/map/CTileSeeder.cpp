@@ -0,0 +1,278 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/CTileSeeder.h"
+
+#include <QtGui>
+
+#include "helpers/CSettings.h"
+#include "map/IMapOnline.h"
+
+/// the number of requests sent to the server at the same time
+static constexpr qint32 kMaxPending = 4;
+
+CTileSeeder::CTileSeeder(IMapOnline* map, const QList<QPolygonF>& area, qint32 levelFirst, qint32 levelLast,
+                         QObject* parent)
+    : QObject(parent), map(map), area(area), levelFirst(levelFirst), levelLast(levelLast), level(levelFirst) {
+  timer = new QTimer(this);
+  connect(timer, &QTimer::timeout, this, &CTileSeeder::slotNextTile);
+  connect(map, &IMapOnline::sigTileSeeded, this, &CTileSeeder::slotTileSeeded);
+
+  QByteArray job;
+  QDataStream stream(&job, QIODevice::WriteOnly);
+  stream << map->getCachePath() << area << levelFirst << levelLast;
+  key = QString::fromLatin1(QCryptographicHash::hash(job, QCryptographicHash::Sha1).toHex());
+
+  SETTINGS;
+  cfg.beginGroup("TileSeeder/" + key);
+  if (cfg.contains("level")) {
+    level = qBound(levelFirst, cfg.value("level").toInt(), levelLast + 1);
+    index = cfg.value("index", 0).toInt();
+    received = cfg.value("received", 0).toInt();
+    failed = cfg.value("failed", 0).toInt();
+    bytes = cfg.value("bytes", 0).toLongLong();
+    resumed = true;
+  }
+  cfg.endGroup();
+}
+
+CTileSeeder::~CTileSeeder() { stop(); }
+
+bool CTileSeeder::estimate(estimate_t& result) {
+  result = estimate_t();
+  tilesPerLevel.clear();
+  total = 0;
+
+  if (map.isNull()) {
+    return false;
+  }
+
+  for (qint32 l = levelFirst; l <= levelLast; l++) {
+    QStringList tiles;
+    if (!map->getSeedTiles(area, l, kMaxTiles - result.tiles, tiles)) {
+      return false;
+    }
+    tilesPerLevel << tiles.size();
+    result.tiles += tiles.size();
+    result.cached += map->countCached(tiles);
+  }
+
+  total = result.tiles;
+  result.bytes = qint64(result.tiles - result.cached) * map->getAverageTileSize();
+  return true;
+}
+
+void CTileSeeder::start(qint32 tilesPerSecond) {
+  if (map.isNull() || isRunning()) {
+    return;
+  }
+
+  if (tilesPerLevel.isEmpty()) {
+    estimate_t e;
+    if (!estimate(e)) {
+      emit sigError(tr("The area has too many tiles."));
+      return;
+    }
+  }
+
+  timer->start(1000 / qBound(1, tilesPerSecond, 1000));
+}
+
+void CTileSeeder::stop() {
+  if (!isRunning()) {
+    return;
+  }
+  timer->stop();
+  saveState();
+}
+
+bool CTileSeeder::isRunning() const { return timer->isActive(); }
+
+qint32 CTileSeeder::getPosition() const {
+  if (level > levelLast) {
+    return total;
+  }
+
+  qint32 position = index;
+  for (qint32 l = levelFirst; l < level && (l - levelFirst) < tilesPerLevel.size(); l++) {
+    position += tilesPerLevel[l - levelFirst];
+  }
+  return qMin(position, total);
+}
+
+void CTileSeeder::loadLevel() {
+  urls.clear();
+  if (level <= levelLast) {
+    map->getSeedTiles(area, level, kMaxTiles, urls);
+  }
+  urlsLoaded = true;
+}
+
+void CTileSeeder::slotNextTile() {
+  if (map.isNull()) {
+    timer->stop();
+    emit sigError(tr("The map is not active anymore."));
+    return;
+  }
+
+  if (map->getSeedPending() >= kMaxPending) {
+    return;
+  }
+
+  // skip tiles already in the cache, but do not block the GUI for too long
+  for (qint32 n = 0; n < 1000 && level <= levelLast; n++) {
+    if (!urlsLoaded) {
+      loadLevel();
+    }
+
+    if (index >= urls.size()) {
+      level++;
+      index = 0;
+      urlsLoaded = false;
+      continue;
+    }
+
+    const QString& url = urls[index];
+    if (!map->isCached(url)) {
+      pending[url] = makePosition(level, index);
+      map->seedTile(url);
+      if (++index % 100 == 0) {
+        saveState();
+      }
+      emit sigProgress();
+      return;
+    }
+    index++;
+  }
+
+  if (level > levelLast && pending.isEmpty()) {
+    timer->stop();
+    urls.clear();
+    clearState();
+    emit sigProgress();
+    emit sigFinished();
+    return;
+  }
+
+  emit sigProgress();
+}
+
+void CTileSeeder::slotTileSeeded(const QString& url, qint32 size) {
+  if (pending.remove(url) == 0) {
+    return;
+  }
+
+  if (size > 0) {
+    received++;
+    bytes += size;
+  } else {
+    failed++;
+  }
+  emit sigProgress();
+}
+
+void CTileSeeder::saveState() {
+  // continue with the first tile not received yet
+  qint64 position = makePosition(level, index);
+  for (qint64 p : qAsConst(pending)) {
+    position = qMin(position, p);
+  }
+
+  SETTINGS;
+  cfg.beginGroup("TileSeeder/" + key);
+  cfg.setValue("level", qint32(position >> 32));
+  cfg.setValue("index", qint32(position & 0xFFFFFFFF));
+  cfg.setValue("received", received);
+  cfg.setValue("failed", failed);
+  cfg.setValue("bytes", bytes);
+  cfg.endGroup();
+}
+
+void CTileSeeder::clearState() {
+  SETTINGS;
+  cfg.remove("TileSeeder/" + key);
+}
+
+bool CTileSeeder::forEachTile(const QPainterPath& area, const QRect& range,
+                              const std::function<bool(qint32, qint32)>& fn) {
+  if (range.isEmpty() || !area.intersects(QRectF(range))) {
+    return true;
+  }
+
+  if ((range.width() == 1 && range.height() == 1) || area.contains(QRectF(range))) {
+    for (qint32 row = range.top(); row <= range.bottom(); row++) {
+      for (qint32 col = range.left(); col <= range.right(); col++) {
+        if (!fn(col, row)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  QRect range1 = range;
+  QRect range2 = range;
+  if (range.width() >= range.height()) {
+    range1.setWidth(range.width() / 2);
+    range2.setLeft(range1.right() + 1);
+  } else {
+    range1.setHeight(range.height() / 2);
+    range2.setTop(range1.bottom() + 1);
+  }
+  return forEachTile(area, range1, fn) && forEachTile(area, range2, fn);
+}
+
+QList<QPolygonF> CTileSeeder::getCorridor(const QPolygonF& line, qreal width) {
+  QList<QPolygonF> corridor;
+  if (line.isEmpty()) {
+    return corridor;
+  }
+
+  // the size of a track allows to use a plane with [m] as unit
+  const qreal fy = 6378137.0;
+  const qreal fx = qCos(line.boundingRect().center().y()) * fy;
+
+  // points closer than a fraction of the width do not change the corridor
+  QPainterPath path;
+  QPointF last(line.first().x() * fx, line.first().y() * fy);
+  path.moveTo(last);
+  for (qint32 i = 1; i < line.size(); i++) {
+    const QPointF pt(line[i].x() * fx, line[i].y() * fy);
+    if (i == line.size() - 1 || QLineF(last, pt).length() > width / 4) {
+      path.lineTo(pt);
+      last = pt;
+    }
+  }
+  if (line.size() == 1) {
+    path.lineTo(last);
+  }
+
+  QPainterPathStroker stroker;
+  stroker.setWidth(2 * width);
+  stroker.setCapStyle(Qt::RoundCap);
+  stroker.setJoinStyle(Qt::RoundJoin);
+
+  const QList<QPolygonF>& polygons = stroker.createStroke(path).toSubpathPolygons();
+  for (QPolygonF polygon : polygons) {
+    for (QPointF& pt : polygon) {
+      pt = QPointF(pt.x() / fx, pt.y() / fy);
+    }
+    corridor << polygon;
+  }
+  return corridor;
+}
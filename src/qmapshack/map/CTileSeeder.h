@@ -0,0 +1,163 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILESEEDER_H
+#define CTILESEEDER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QPolygonF>
+#include <QStringList>
+#include <functional>
+
+class IMapOnline;
+class QPainterPath;
+class QTimer;
+
+/**
+   @brief Fill the tile cache of an online map for an area and a range of zoom levels
+
+   Before a trip the tiles can be loaded for offline use. The job requests the
+   tiles one by one at a limited rate through the map's own request path. Tiles
+   already in the cache are skipped. Thus an interrupted job can be repeated
+   without loading tiles twice.
+
+   The position of the job is stored in the settings. A job for the same map,
+   area and zoom levels continues where the last one stopped.
+ */
+class CTileSeeder : public QObject {
+  Q_OBJECT
+ public:
+  /**
+     @param map         the map to seed
+     @param area        the area as polygons in [rad], overlapping polygons are filled by the winding rule
+     @param levelFirst  the first zoom level, an index into IMapOnline::getSeedLevels()
+     @param levelLast   the last zoom level
+   */
+  CTileSeeder(IMapOnline* map, const QList<QPolygonF>& area, qint32 levelFirst, qint32 levelLast, QObject* parent);
+  virtual ~CTileSeeder();
+
+  /// jobs with more tiles are refused to protect the tile servers
+  static constexpr qint32 kMaxTiles = 250000;
+
+  struct estimate_t {
+    qint32 tiles = 0;   //< all tiles of the job
+    qint32 cached = 0;  //< tiles already in the cache
+    qint64 bytes = 0;   //< the estimated size of the missing tiles [byte]
+  };
+
+  /**
+     @brief Count all tiles of the job and the ones already in the cache
+
+     This has to be done before start().
+
+     @return False if the job has more than kMaxTiles tiles.
+   */
+  bool estimate(estimate_t& result);
+
+  /**
+     @brief Start or continue the job
+
+     @param tilesPerSecond  the maximum number of requests per second
+   */
+  void start(qint32 tilesPerSecond);
+  /// stop the job and store its position
+  void stop();
+  bool isRunning() const;
+
+  /// the number of tiles handled so far, including the ones of former runs
+  qint32 getPosition() const;
+  /// the number of tiles of the whole job, valid after estimate()
+  qint32 getTotal() const { return total; }
+  /// true if the job continues a former one
+  bool isResumed() const { return resumed; }
+
+  qint32 getReceived() const { return received; }
+  qint32 getFailed() const { return failed; }
+  qint64 getBytes() const { return bytes; }
+
+  /**
+     @brief Call a function for all tiles covering an area
+
+     The range is split recursively. Parts outside the area are skipped, parts
+     inside the area are taken without further tests. Thus only the tiles along
+     the area's border have to be tested one by one.
+
+     @param area   the area in tile coordinates. The tile (col, row) covers the square (col, row) - (col + 1, row + 1)
+     @param range  the tiles to consider
+     @param fn     called with the column and row of each tile, return false to stop
+     @return False if stopped by fn.
+   */
+  static bool forEachTile(const QPainterPath& area, const QRect& range, const std::function<bool(qint32, qint32)>& fn);
+
+  /**
+     @brief Get the area along a line
+
+     @param line   the line in [rad]
+     @param width  the maximum distance to the line in [m]
+     @return The area as polygons in [rad]. Overlapping polygons are filled by the winding rule.
+   */
+  static QList<QPolygonF> getCorridor(const QPolygonF& line, qreal width);
+
+ signals:
+  void sigProgress();
+  void sigFinished();
+  void sigError(const QString& msg);
+
+ private slots:
+  void slotNextTile();
+  void slotTileSeeded(const QString& url, qint32 size);
+
+ private:
+  static qint64 makePosition(qint32 level, qint32 index) { return (qint64(level) << 32) | index; }
+  void loadLevel();
+  void saveState();
+  void clearState();
+
+  QPointer<IMapOnline> map;
+  const QList<QPolygonF> area;
+  const qint32 levelFirst;
+  const qint32 levelLast;
+
+  /// the key of the job's state in the settings
+  QString key;
+
+  QTimer* timer;
+
+  /// the number of tiles for each level, set by estimate()
+  QList<qint32> tilesPerLevel;
+  qint32 total = 0;
+
+  /// the current level
+  qint32 level;
+  /// all tiles of the current level
+  QStringList urls;
+  bool urlsLoaded = false;
+  /// the next tile of the current level
+  qint32 index = 0;
+  /// requested tiles not received yet with their level and index, see makePosition()
+  QHash<QString, qint64> pending;
+
+  qint32 received = 0;
+  qint32 failed = 0;
+  qint64 bytes = 0;
+  bool resumed = false;
+};
+
+#endif  // CTILESEEDER_H
@@ -23,7 +23,12 @@
 #include "map/CMapDraw.h"
 #include "map/CMapPropSetup.h"
 
-IMap::IMap(quint32 features, CMapDraw* parent) : IDrawObject(parent), map(parent), flagsFeature(features) {}
+IMap::IMap(quint32 features, CMapDraw* parent) : IDrawObject(parent), map(parent), flagsFeature(features) {
+  timerCacheSettings = new QTimer(this);
+  timerCacheSettings->setSingleShot(true);
+  timerCacheSettings->setInterval(500);
+  connect(timerCacheSettings, &QTimer::timeout, this, &IMap::applyCacheSettings);
+}
 
 IMap::~IMap() { delete setup; }
 
@@ -41,6 +46,13 @@ void IMap::saveConfig(QSettings& cfg) /* override */
   if (hasFeatureTileCache()) {
     cfg.setValue("cacheSizeMB", cacheSizeMB);
     cfg.setValue("cacheExpiration", cacheExpiration);
+    cfg.setValue("cacheMemSizeMB", cacheMemSizeMB);
+    cfg.setValue("cacheFormat", cacheFormat);
+    cfg.setValue("cacheBackend", cacheBackend);
+  }
+
+  if (hasFeatureDataCache()) {
+    cfg.setValue("cacheMemSizeMB", cacheMemSizeMB);
   }
 
   if (hasFeatureTypFile()) {
@@ -56,8 +68,15 @@ void IMap::loadConfig(QSettings& cfg) /* override */
   slotSetShowPolylines(cfg.value("showPolylines", getShowPolylines()).toBool());
   slotSetShowPOIs(cfg.value("showPOIs", getShowPOIs()).toBool());
   slotSetAdjustDetailLevel(cfg.value("adjustDetailLevel", getAdjustDetailLevel()).toInt());
-  slotSetCacheSize(cfg.value("cacheSizeMB", getCacheSize()).toInt());
-  slotSetCacheExpiration(cfg.value("cacheExpiration", getCacheExpiration()).toInt());
+
+  // reconfiguring the cache can be expensive, thus do it only once for all settings
+  cacheSizeMB = cfg.value("cacheSizeMB", getCacheSize()).toInt();
+  cacheExpiration = cfg.value("cacheExpiration", getCacheExpiration()).toInt();
+  cacheMemSizeMB = cfg.value("cacheMemSizeMB", getCacheMemSize()).toInt();
+  cacheFormat = cfg.value("cacheFormat", getCacheFormat()).toInt();
+  cacheBackend = cfg.value("cacheBackend", getCacheBackend()).toInt();
+  applyCacheSettings();
+
   slotSetTypeFile(cfg.value("typeFile", getTypeFile()).toString());
 }
 
@@ -76,3 +95,17 @@ void IMap::convertM2Rad(QPointF& p) const { proj.transform(p, PJ_FWD); }
 bool IMap::findPolylineCloseBy(const QPointF&, const QPointF&, qint32, QPolygonF&) { return false; }
 
 void IMap::drawTile(const QImage& img, QPolygonF& l, QPainter& p) { drawTileLQ(img, l, p, *map, proj); }
+
+void IMap::requestCacheSettings() { timerCacheSettings->start(); }
+
+void IMap::applyCacheSettings() {
+  timerCacheSettings->stop();
+
+  const QVariantList settings = {cachePath, cacheSizeMB, cacheExpiration, cacheMemSizeMB, cacheFormat, cacheBackend};
+  if (settings == appliedCacheSettings) {
+    return;
+  }
+
+  appliedCacheSettings = settings;
+  configureCache();
+}
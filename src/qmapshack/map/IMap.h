@@ -22,6 +22,7 @@
 #include <QImage>
 #include <QMutex>
 #include <QPointer>
+#include <QVariantList>
 
 #include "canvas/IDrawContext.h"
 #include "canvas/IDrawObject.h"
@@ -29,6 +30,7 @@
 
 class CMapDraw;
 class IMapProp;
+class QTimer;
 struct IPoiItem;
 
 class IMap : public IDrawObject {
@@ -46,7 +48,8 @@ class IMap : public IDrawObject {
     eFeatVectorItems = 0x00000002,
     eFeatTileCache = 0x00000004,
     eFeatLayers = 0x00000008,
-    eFeatTypFile = 0x00000010
+    eFeatTypFile = 0x00000010,
+    eFeatDataCache = 0x00000020
   };
 
   virtual void draw(IDrawContext::buffer_t& buf) = 0;
@@ -86,6 +89,8 @@ class IMap : public IDrawObject {
 
   bool hasFeatureTypFile() const { return flagsFeature & eFeatTypFile; }
 
+  bool hasFeatureDataCache() const { return flagsFeature & eFeatDataCache; }
+
   bool getShowPolygons() const { return showPolygons; }
 
   bool getShowPolylines() const { return showPolylines; }
@@ -98,6 +103,18 @@ class IMap : public IDrawObject {
 
   qint32 getCacheExpiration() const { return cacheExpiration; }
 
+  qint32 getCacheMemSize() const { return cacheMemSizeMB; }
+
+  qint32 getCacheFormat() const { return cacheFormat; }
+
+  qint32 getCacheBackend() const { return cacheBackend; }
+
+  /**
+     @brief Get a human readable summary of the cache usage (hits, misses, evictions)
+     @return An empty string if the map has no cache
+   */
+  virtual QString getCacheStatistics() const { return QString(); }
+
   qint32 getAdjustDetailLevel() const { return adjustDetailLevel; }
 
   const QString& getTypeFile() const { return typeFile; }
@@ -123,15 +140,27 @@ class IMap : public IDrawObject {
 
   void slotSetCachePath(const QString& path) {
     cachePath = path;
-    configureCache();
+    requestCacheSettings();
   }
   void slotSetCacheSize(qint32 size) {
     cacheSizeMB = size;
-    configureCache();
+    requestCacheSettings();
   }
   void slotSetCacheExpiration(qint32 days) {
     cacheExpiration = days;
-    configureCache();
+    requestCacheSettings();
+  }
+  void slotSetCacheMemSize(qint32 size) {
+    cacheMemSizeMB = size;
+    requestCacheSettings();
+  }
+  void slotSetCacheFormat(qint32 format) {
+    cacheFormat = format;
+    requestCacheSettings();
+  }
+  void slotSetCacheBackend(qint32 backend) {
+    cacheBackend = backend;
+    requestCacheSettings();
   }
 
   void slotSetAdjustDetailLevel(qint32 level) { adjustDetailLevel = level; }
@@ -158,6 +187,14 @@ class IMap : public IDrawObject {
    */
   void drawTile(const QImage& img, QPolygonF& l, QPainter& p);
 
+  /**
+     @brief Apply all cache settings at once
+
+     configureCache() is called only if a setting has changed since the last call.
+     Changes requested by the slots but not applied yet are applied, too.
+   */
+  void applyCacheSettings();
+
  protected:
   /// the drawcontext this map belongs to
   CMapDraw* map;
@@ -187,10 +224,21 @@ class IMap : public IDrawObject {
   QString cachePath;           //< streaming map only: path to cached tiles
   qint32 cacheSizeMB = 100;    //< streaming map only: maximum size of all tiles in cache [MByte]
   qint32 cacheExpiration = 8;  //< streaming map only: maximum age of tiles in cache [days]
+  qint32 cacheMemSizeMB = 64;  //< streaming and vector maps: maximum size of decoded data held in memory [MByte]
+  qint32 cacheFormat = 0;      //< streaming map only: encoding of tiles on disk, see CDiskCache::format_e
+  qint32 cacheBackend = 0;     //< streaming map only: storage of tiles on disk, see CDiskCache::backend_e
 
   QString copyright;  //< a copyright string to be displayed as tool tip
 
   QString typeFile;
+
+ private:
+  /// apply the cache settings with a short delay, to collect several changes
+  void requestCacheSettings();
+
+  /// the cache settings passed to configureCache() last time
+  QVariantList appliedCacheSettings;
+  QTimer* timerCacheSettings;
 };
 
 #endif  // IMAP_H
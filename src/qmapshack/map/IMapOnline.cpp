@@ -20,6 +20,7 @@
 #include "map/IMapOnline.h"
 
 #include <QMessageBox>
+#include <QThread>
 #include <QtNetwork>
 
 #include "CMainWindow.h"
@@ -27,8 +28,13 @@
 #include "map/cache/CDiskCache.h"
 
 IMapOnline::IMapOnline(CMapDraw* parent) : IMap(eFeatVisibility | eFeatTileCache, parent) {
-  accessManager = new QNetworkAccessManager(parent->thread());
-  connect(accessManager, &QNetworkAccessManager::finished, this, &IMapOnline::slotRequestFinished);
+  scheduler = new CTileScheduler(this);
+  connect(scheduler, &CTileScheduler::sigTileReceived, this, &IMapOnline::slotTileReceived);
+
+  seedScheduler = new CTileScheduler(this);
+  // be nice to the server, seeding is not urgent
+  seedScheduler->setMaxPerHost(2);
+  connect(seedScheduler, &CTileScheduler::sigTileReceived, this, &IMapOnline::slotTileSeeded);
 
   connect(this, &IMapOnline::sigQueueChanged, this, &IMapOnline::slotQueueChanged);
 }
@@ -46,79 +52,161 @@ bool IMapOnline::httpsCheck(const QString& url) {
   return true;
 }
 
-void IMapOnline::slotQueueChanged() {
+QSharedPointer<CDiskCache> IMapOnline::getDiskCache() const {
   QMutexLocker lock(&mutex);
+  return diskCache;
+}
 
-  if (!urlQueue.isEmpty() && urlPending.size() < 6) {
-    // request up to 6 pending request
-    for (int i = 0; i < (6 - urlPending.size()); i++) {
-      QString url = urlQueue.dequeue();
-      lastRequest = urlQueue.isEmpty();
+void IMapOnline::drawTiles(const QList<tile_t>& tiles, QPainter& p) {
+  const QSharedPointer<CDiskCache>& cache = getDiskCache();
 
-      QNetworkRequest request;
-      request.setUrl(url);
-      for (const rawHeaderItem_t& item : qAsConst(rawHeaderItems)) {
-        request.setRawHeader(item.name.toLatin1(), item.value.toLatin1());
-      }
-      accessManager->get(request);
-      urlPending << url;
+  QList<CTileScheduler::request_t> requests;
+  for (const tile_t& tile : tiles) {
+    if (cache->contains(tile.url)) {
+      QImage img;
+      cache->restore(tile.url, img);
+
+      QPolygonF l = tile.area;
+      drawTile(img, l, p);
+    } else {
+      requests << CTileScheduler::request_t{tile.url, tile.distance};
+    }
+  }
+
+  scheduleQueue(requests);
+}
+
+void IMapOnline::scheduleQueue(const QList<CTileScheduler::request_t>& requests) {
+  QMutexLocker lock(&mutex);
+  urlQueue = requests;
+  urlQueueChanged = true;
+  emit sigQueueChanged();
+}
 
-      if (lastRequest) {
-        break;
+void IMapOnline::slotQueueChanged() {
+  QMutexLocker lock(&mutex);
+
+  // several signals can be pending for a single draw
+  if (urlQueueChanged) {
+    urlQueueChanged = false;
+    scheduler->setRequests(urlQueue);
+    urlQueue.clear();
+
+    // seeded tiles dropped by the current view have to be requested by the seed scheduler
+    for (auto url = seedByView.begin(); url != seedByView.end();) {
+      if (scheduler->isPending(*url)) {
+        ++url;
+        continue;
       }
+      seedScheduler->addRequest({*url, 0});
+      url = seedByView.erase(url);
     }
-  } else if (lastRequest && urlPending.isEmpty()) {
-    lastRequest = false;
-    // if all tiles are received the map layer can be redrawn with all tiles from cache
-    map->emitSigCanvasUpdate();
   }
 
-  if (timeLastUpdate.elapsed() > 2000) {
+  reportPending();
+}
+
+void IMapOnline::slotTileReceived(const QString& url, const QByteArray& data) {
+  QImage img;
+  img.loadFromData(data);
+  // always store image to cache, the cache will take care of NULL images
+  getDiskCache()->store(url, data, img);
+
+  if (seedByView.remove(url)) {
+    emit sigTileSeeded(url, img.isNull() ? 0 : data.size());
+  }
+
+  QMutexLocker lock(&mutex);
+  // if all tiles are received the map layer can be redrawn with all tiles from cache
+  if (scheduler->getPending() == 0 || timeLastUpdate.elapsed() > 2000) {
     timeLastUpdate.start();
     map->emitSigCanvasUpdate();
   }
 
-  // report status of pending tiles
-  int pending = urlQueue.size() + urlPending.size();
-  if (pending) {
-    map->reportStatusToCanvas(name, tr("<b>%1</b>: %2 tiles pending<br/>").arg(name).arg(pending));
-  } else {
-    map->reportStatusToCanvas(name, "");
+  reportPending();
+}
+
+void IMapOnline::seedTile(const QString& url) {
+  if (scheduler->isPending(url)) {
+    // the tile is requested for the current view already
+    seedByView.insert(url);
+    return;
   }
+  seedScheduler->addRequest({url, 0});
 }
 
-void IMapOnline::slotRequestFinished(QNetworkReply* reply) {
-  QMutexLocker lock(&mutex);
+void IMapOnline::slotTileSeeded(const QString& url, const QByteArray& data) {
+  QImage img;
+  img.loadFromData(data);
+  getDiskCache()->store(url, data, img);
 
-  QString url = reply->url().toString();
-  if (urlPending.contains(url)) {
-    QImage img;
-    // only take good responses
-    if (!reply->error()) {
-      // read image data
-      img.loadFromData(reply->readAll());
-    }
-    // always store image to cache, the cache will take care of NULL images
-    diskCache->store(url, img);
+  emit sigTileSeeded(url, img.isNull() ? 0 : data.size());
+}
 
-    urlPending.removeAll(url);
-  }
+bool IMapOnline::isCached(const QString& url) { return getDiskCache()->contains(url); }
+
+qint32 IMapOnline::countCached(const QStringList& urls) {
+  const QSharedPointer<CDiskCache>& cache = getDiskCache();
 
-  // debug output any error
-  if (reply->error()) {
-    qDebug() << "Request to" << url << "failed:" << reply->errorString();
+  qint32 cached = 0;
+  for (const QString& url : urls) {
+    if (cache->contains(url)) {
+      cached++;
+    }
   }
+  return cached;
+}
 
-  // delete reply object
-  reply->deleteLater();
+qint32 IMapOnline::getAverageTileSize() {
+  const CDiskCache::stats_t& stats = getDiskCache()->getStatistics();
+  if (stats.diskTiles == 0) {
+    // a guess for an empty cache
+    return 20000;
+  }
+  return stats.tileBytes / stats.diskTiles;
+}
 
-  // check for more items to be queued
-  slotQueueChanged();
+void IMapOnline::reportPending() {
+  const qint32 pending = scheduler->getPending();
+  if (pending) {
+    map->reportStatusToCanvas(name, tr("<b>%1</b>: %2 tiles pending<br/>").arg(name).arg(pending));
+  } else {
+    map->reportStatusToCanvas(name, "");
+  }
 }
 
 void IMapOnline::configureCache() {
+  CDiskCache* cache =
+      new CDiskCache(getCachePath(), getCacheSize(), getCacheExpiration(), getCacheMemSize(),
+                     CDiskCache::format_e(getCacheFormat()), CDiskCache::backend_e(getCacheBackend()), nullptr);
+
+  // The draw thread might still use the old cache. In that case it releases
+  // the last reference and the cache is deleted by the GUI thread's event loop.
+  QSharedPointer<CDiskCache> ptr(cache, [](CDiskCache* cache) {
+    if (QThread::currentThread() == cache->thread()) {
+      delete cache;
+    } else {
+      cache->deleteLater();
+    }
+  });
+
   QMutexLocker lock(&mutex);
+  diskCache.swap(ptr);
+}
+
+QString IMapOnline::getCacheStatistics() const {
+  const QSharedPointer<CDiskCache>& cache = getDiskCache();
+  if (cache.isNull()) {
+    return QString();
+  }
 
-  delete diskCache;
-  diskCache = new CDiskCache(getCachePath(), getCacheSize(), getCacheExpiration(), this);
+  const CDiskCache::stats_t& stats = cache->getStatistics();
+  return tr("Disk: %6 MB, memory: %1 MB, hits: %2 (memory) %3 (disk) %7 (pending), misses: %4, evictions: %5")
+      .arg(stats.memBytes / (1024.0 * 1024.0), 0, 'f', 1)
+      .arg(stats.memHits)
+      .arg(stats.diskHits)
+      .arg(stats.misses)
+      .arg(stats.evictions)
+      .arg(stats.diskBytes / (1024.0 * 1024.0), 0, 'f', 1)
+      .arg(stats.pendingHits);
 }
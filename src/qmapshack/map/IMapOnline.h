@@ -21,13 +21,14 @@
 #define IMAPONLINE_H
 #include <QElapsedTimer>
 #include <QMutex>
-#include <QQueue>
+#include <QPolygonF>
+#include <QSet>
+#include <QSharedPointer>
 
+#include "map/CTileScheduler.h"
 #include "map/IMap.h"
 
 class CDiskCache;
-class QNetworkAccessManager;
-class QNetworkReply;
 
 class IMapOnline : public IMap {
   Q_OBJECT
@@ -35,44 +36,115 @@ class IMapOnline : public IMap {
   IMapOnline(CMapDraw* parent);
   virtual ~IMapOnline() {}
 
+  QString getCacheStatistics() const override;
+
+  const QString& getName() const { return name; }
+
+  /// the names of the zoom levels available to seed the cache, from coarse to fine
+  virtual QStringList getSeedLevels() = 0;
+
+  /**
+     @brief Get the urls of all tiles of a zoom level covering an area
+
+     @param area      the area as polygons in [rad], overlapping polygons are filled by the winding rule
+     @param level     the index into getSeedLevels()
+     @param maxTiles  the maximum number of tiles
+     @param urls      the urls of the tiles of all enabled layers
+     @return False if there are more than maxTiles tiles.
+   */
+  virtual bool getSeedTiles(const QList<QPolygonF>& area, qint32 level, qint32 maxTiles, QStringList& urls) = 0;
+
+  /**
+     @brief Request a tile for the cache only
+
+     Seeded tiles are requested in parallel to the tiles of the current view. A tile
+     already requested for the current view is not requested twice. The result is
+     reported by sigTileSeeded().
+   */
+  void seedTile(const QString& url);
+  /// the number of seeded tiles not received yet
+  qint32 getSeedPending() const { return seedScheduler->getPending() + seedByView.size(); }
+
+  bool isCached(const QString& url);
+  /// the number of tiles in the cache, all urls are tested with a single access to the cache
+  qint32 countCached(const QStringList& urls);
+  /// the average size of the cached tiles [byte]
+  qint32 getAverageTileSize();
+
  signals:
   void sigQueueChanged();
+  /**
+     @brief A seeded tile has been received
 
- protected:
-  struct rawHeaderItem_t {
-    QString name;
-    QString value;
-  };
-
-  QList<rawHeaderItem_t> rawHeaderItems;
+     @param url   the tile's url
+     @param size  the size of the received data [byte], 0 on errors
+   */
+  void sigTileSeeded(const QString& url, qint32 size);
 
-  /// Mutex to control access to url queue
-  QRecursiveMutex mutex;
-  /// a queue with all tile urls to request
-  QQueue<QString> urlQueue;
-  /// the tile cache
-  CDiskCache* diskCache = nullptr;
-  /// access manager to request tiles
-  QNetworkAccessManager* accessManager = nullptr;
-  QList<QString> urlPending;
+ protected:
+  /**
+     @brief Mutex to control access to the url queue and the layer state
+
+     The disk cache is not accessed with this mutex locked. It has locks of it's own.
+   */
+  mutable QRecursiveMutex mutex;
+  /// all tiles missing in the current view
+  QList<CTileScheduler::request_t> urlQueue;
+  /// true if urlQueue has to be passed to the scheduler
+  bool urlQueueChanged = false;
+  /// the tile cache, replaced as a whole if the cache settings change
+  QSharedPointer<CDiskCache> diskCache;
+  /// request tiles by priority
+  CTileScheduler* scheduler = nullptr;
+  /// request tiles to seed the cache
+  CTileScheduler* seedScheduler = nullptr;
+  /// seeded tiles that are requested by scheduler for the current view
+  QSet<QString> seedByView;
 
-  bool lastRequest = false;
   QElapsedTimer timeLastUpdate;
   QString name;
 
   static bool httpsCheck(const QString& url);
 
   void registerHeaderItem(const QString& name, const QString& value) {
-    struct rawHeaderItem_t item;
-    item.name = name;
-    item.value = value;
-    rawHeaderItems << item;
+    scheduler->setRawHeader(name.toLatin1(), value.toLatin1());
+    seedScheduler->setRawHeader(name.toLatin1(), value.toLatin1());
   }
 
+  /// a tile of the current view
+  struct tile_t {
+    QString url;
+    /// the tile's corners in the map's projection
+    QPolygonF area;
+    /// the distance of the tile's centre to the view's centre in tiles
+    qreal distance;
+  };
+
+  /// get the current tile cache, it stays valid as long as the pointer is kept
+  QSharedPointer<CDiskCache> getDiskCache() const;
+
+  /**
+     @brief Draw all tiles found in the cache and request the missing ones
+
+     This must be called without the mutex locked. Thus the GUI thread can store
+     received tiles while the tiles are restored and drawn.
+
+     @param tiles  the tiles of the current view
+     @param p      the painter to draw the tiles on
+   */
+  void drawTiles(const QList<tile_t>& tiles, QPainter& p);
+
+  /// pass the missing tiles to the scheduler, to be called at the end of draw()
+  void scheduleQueue(const QList<CTileScheduler::request_t>& requests);
+
   void configureCache() override;
 
   void slotQueueChanged();
-  void slotRequestFinished(QNetworkReply* reply);
+  void slotTileReceived(const QString& url, const QByteArray& data);
+  void slotTileSeeded(const QString& url, const QByteArray& data);
+
+ private:
+  void reportPending();
 };
 
 #endif  // IMAPONLINE_H
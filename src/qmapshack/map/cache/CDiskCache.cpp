@@ -21,13 +21,22 @@
 #include <QtWidgets>
 
 #include "map/CMapDraw.h"
+#include "map/cache/CDiskCacheStoreFiles.h"
+#include "map/cache/CDiskCacheStorePack.h"
 #include "version.h"
 
-CDiskCache::CDiskCache(const QString& path, qint32 maxSizeMB, qint32 expirationDays, QObject* parent)
-    : QObject(parent), dir(path), maxSizeMB(maxSizeMB), expirationDays(expirationDays) {
+CDiskCache::CDiskCache(const QString& path, qint32 maxSizeMB, qint32 expirationDays, qint32 memSizeMB,
+                       format_e format, backend_e backend, QObject* parent)
+    : QObject(parent),
+      dir(path),
+      maxSizeMB(maxSizeMB),
+      expirationDays(expirationDays),
+      format(format),
+      backend(backend) {
   dummy.fill(Qt::transparent);
 
   dir.mkpath(dir.path());
+  absolutePath = dir.absolutePath();
 
   QFile IDfile(dir.absoluteFilePath("QMS_cache"));
   if (!IDfile.exists()) {
@@ -36,105 +45,442 @@ CDiskCache::CDiskCache(const QString& path, qint32 maxSizeMB, qint32 expirationD
     }
   }
 
-  const QFileInfoList& files = dir.entryInfoList(QStringList("*.png"), QDir::Files);
-  for (const QFileInfo& fileinfo : files) {
-    QString hash = fileinfo.baseName();
-    table[hash] = fileinfo.fileName();
+  if (backend == eBackendPack) {
+    storage = new CDiskCacheStorePack(absolutePath);
+  } else {
+    storage = new CDiskCacheStoreFiles(absolutePath);
+  }
+
+  // split the memory budget equally over all shards
+  const qint32 maxCostShard = qMax(1, memSizeMB * 1024 / N_SHARDS);
+  for (shard_t& shard : shards) {
+    shard.cache.setMaxCost(maxCostShard);
+  }
+
+  index.open(dir.absoluteFilePath(storage->getIndexName()));
+  if (index.isEmpty()) {
+    // a cache from a previous version or a lost index
+    importStore();
   }
 
+  index.load([this](const CDiskCacheIndex::tile_t& tile) {
+    shard_t& shard = getShard(tile.hash);
+    entry_t& entry = shard.table[tile.hash];
+    entry.size = tile.size;
+    entry.location = tile.location;
+    shard.stats.tileBytes += tile.size;
+    storage->restored(tile);
+  });
+  storage->loaded();
+
   timer = new QTimer(this);
   timer->setSingleShot(false);
   timer->start(20000);
   connect(timer, &QTimer::timeout, this, &CDiskCache::slotCleanup);
+
+  writer.start();
 }
 
-void CDiskCache::store(const QString& key, QImage& img) {
-  QMutexLocker lock(&mutex);
+CDiskCache::~CDiskCache() {
+  writer.stop();
+  flushJournal();
+  delete storage;
+  delete otherStorage;
+  delete otherIndex;
+}
 
+void CDiskCache::importStore() {
+  QHash<QString, CDiskCacheIndex::record_t> journal;
+  storage->import(journal);
+  if (journal.isEmpty()) {
+    return;
+  }
+
+  qDebug() << "import" << journal.size() << "tiles into cache index" << dir.path();
+  index.apply(journal);
+}
+
+QString CDiskCache::getHash(const QString& key) {
   QCryptographicHash md5(QCryptographicHash::Md5);
   md5.addData(key.toLatin1());
+  return md5.result().toHex();
+}
 
-  QString hash = md5.result().toHex();
-  QString filename = QString("%1.png").arg(hash);
+void CDiskCache::insertIntoMemory(shard_t& shard, const QString& hash, const QImage& img) {
+  // The dummy image is implicitly shared by all failed tiles. It does not
+  // consume extra memory and therefore gets the minimum cost.
+  const qint32 cost = img.cacheKey() == dummy.cacheKey() ? 1 : qint32(qMax(qsizetype(1024), img.sizeInBytes()) / 1024);
 
-  if (!img.isNull()) {
-    img.save(dir.absoluteFilePath(filename));
-    table[hash] = filename;
-    cache[hash] = img;
-  } else {
-    cache[hash] = dummy;
+  const qint32 expected = shard.cache.count() + (shard.cache.contains(hash) ? 0 : 1);
+  shard.cache.insert(hash, new QImage(img), cost);
+  shard.stats.evictions += qMax(0, expected - shard.cache.count());
+}
+
+void CDiskCache::addToJournal(shard_t& shard, const QString& hash, CDiskCacheIndex::record_t::op_e op,
+                              const entry_t& entry) {
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  CDiskCacheIndex::record_t& record = shard.journal[hash];
+
+  switch (op) {
+    case CDiskCacheIndex::record_t::eOpStore:
+      record.size = entry.size;
+      record.location = entry.location;
+      record.created = now;
+      break;
+
+    case CDiskCacheIndex::record_t::eOpAccess:
+      // a pending store or removal is not altered by an access
+      if (record.op != CDiskCacheIndex::record_t::eOpAccess) {
+        record.accessed = now;
+        return;
+      }
+      break;
+
+    case CDiskCacheIndex::record_t::eOpRemove:
+      break;
+
+    case CDiskCacheIndex::record_t::eOpMove:
+      // a pending store is just moved, the time of last access is kept
+      record.location = entry.location;
+      if (record.op != CDiskCacheIndex::record_t::eOpStore) {
+        record.op = op;
+      }
+      return;
   }
+
+  record.op = op;
+  record.accessed = now;
 }
 
-void CDiskCache::restore(const QString& key, QImage& img) {
-  QMutexLocker lock(&mutex);
+void CDiskCache::store(const QString& key, const QByteArray& data, const QImage& img) {
+  const QString& hash = getHash(key);
+  shard_t& shard = getShard(hash);
 
-  QCryptographicHash md5(QCryptographicHash::Md5);
-  md5.addData(key.toLatin1());
+  QMutexLocker lock(&shard.mutex);
+  if (img.isNull()) {
+    insertIntoMemory(shard, hash, dummy);
+    return;
+  }
 
-  QString hash = md5.result().toHex();
+  insertIntoMemory(shard, hash, img);
+  shard.pending[hash] = img;
+  lock.unlock();
+
+  if (!writer.enqueue({hash, data, img})) {
+    // the writer is too far behind, the tile is served from memory only
+    lock.relock();
+    shard.pending.remove(hash);
+  }
+}
 
-  if (cache.contains(hash)) {
-    img = cache[hash];
-  } else if (table.contains(hash)) {
-    img.load(dir.absoluteFilePath(table[hash]));
-    if (!cache.contains(hash)) {
-      cache[hash] = img;
+void CDiskCache::writeTile(const CDiskCacheWriter::job_t& job) {
+  QByteArray data = job.data;
+  if ((format != eFormatOriginal) || data.isEmpty()) {
+    data.clear();
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    // for PNG the quality is mapped to the zlib compression level, 80 is level 1
+    job.img.save(&buffer, "PNG", format == eFormatPng ? -1 : 80);
+  }
+
+  shard_t& shard = getShard(job.hash);
+  entry_t entry;
+  const bool success = storage->write(job.hash, data, entry.location);
+
+  QMutexLocker lock(&shard.mutex);
+  shard.pending.remove(job.hash);
+  if (success) {
+    entry.size = data.size();
+    // release the data of a tile that is replaced
+    if (shard.table.contains(job.hash)) {
+      const entry_t& old = shard.table[job.hash];
+      shard.stats.tileBytes -= old.size;
+      if (old.location != entry.location) {
+        storage->remove({job.hash, old.size, old.location});
+      }
     }
-  } else {
+
+    shard.stats.tileBytes += entry.size;
+    shard.table[job.hash] = entry;
+    addToJournal(shard, job.hash, CDiskCacheIndex::record_t::eOpStore, entry);
+  }
+}
+
+void CDiskCache::copyTiles(const CDiskCacheWriter::job_t& job) {
+  const bool relocate = job.source == storage;
+
+  for (const CDiskCacheIndex::tile_t& tile : job.tiles) {
+    const QByteArray& data = job.source->read(tile);
+    entry_t entry;
+    if (data.isEmpty() || !storage->write(tile.hash, data, entry.location)) {
+      continue;
+    }
+    entry.size = data.size();
+
+    shard_t& shard = getShard(tile.hash);
+    QMutexLocker lock(&shard.mutex);
+    // Drop the copy if the tile has been replaced or removed in the meantime. A migrated
+    // tile is dropped if it has been stored again already.
+    bool obsolete = false;
+    if (relocate) {
+      obsolete = !shard.table.contains(tile.hash) || (shard.table[tile.hash].location != tile.location);
+    } else {
+      obsolete = shard.table.contains(tile.hash) || shard.pending.contains(tile.hash);
+    }
+
+    if (obsolete) {
+      storage->remove({tile.hash, entry.size, entry.location});
+      continue;
+    }
+
+    shard.table[tile.hash] = entry;
+    if (relocate) {
+      storage->remove(tile);
+      addToJournal(shard, tile.hash, CDiskCacheIndex::record_t::eOpMove, entry);
+    } else {
+      shard.stats.tileBytes += entry.size;
+      addToJournal(shard, tile.hash, CDiskCacheIndex::record_t::eOpStore, entry);
+    }
+  }
+
+  copyPending.storeRelease(0);
+}
+
+void CDiskCache::restore(const QString& key, QImage& img) {
+  const QString& hash = getHash(key);
+  shard_t& shard = getShard(hash);
+
+  QMutexLocker lock(&shard.mutex);
+  // QCache::object() moves the tile to the front of the LRU list
+  const QImage* cached = shard.cache.object(hash);
+  if (cached != nullptr) {
+    shard.stats.memHits++;
+    img = *cached;
+    if (shard.table.contains(hash)) {
+      addToJournal(shard, hash, CDiskCacheIndex::record_t::eOpAccess);
+    }
+    return;
+  }
+
+  if (shard.pending.contains(hash)) {
+    shard.stats.pendingHits++;
+    img = shard.pending[hash];
+    insertIntoMemory(shard, hash, img);
+    return;
+  }
+
+  if (!shard.table.contains(hash)) {
+    shard.stats.misses++;
     img = QImage();
+    return;
+  }
+
+  // do not block the shard while reading and decoding the tile
+  const entry_t entry = shard.table[hash];
+  lock.unlock();
+  img.loadFromData(storage->read({hash, entry.size, entry.location}));
+  lock.relock();
+
+  if (img.isNull()) {
+    shard.stats.misses++;
+    // The tile is gone or broken, drop it from the index. Unless it
+    // has been replaced in the meantime.
+    const entry_t& current = shard.table.value(hash);
+    if ((current.location == entry.location) && (current.size == entry.size)) {
+      shard.table.remove(hash);
+      shard.stats.tileBytes -= entry.size;
+      storage->remove({hash, entry.size, entry.location});
+      addToJournal(shard, hash, CDiskCacheIndex::record_t::eOpRemove);
+    }
+    return;
+  }
+
+  shard.stats.diskHits++;
+  addToJournal(shard, hash, CDiskCacheIndex::record_t::eOpAccess);
+  if (!shard.cache.contains(hash)) {
+    insertIntoMemory(shard, hash, img);
   }
 }
 
 bool CDiskCache::contains(const QString& key) const {
-  QMutexLocker lock(&mutex);
+  const QString& hash = getHash(key);
+  const shard_t& shard = getShard(hash);
 
-  QCryptographicHash md5(QCryptographicHash::Md5);
-  md5.addData(key.toLatin1());
+  QMutexLocker lock(&shard.mutex);
+  return shard.table.contains(hash) || shard.cache.contains(hash) || shard.pending.contains(hash);
+}
+
+CDiskCache::stats_t CDiskCache::getStatistics() const {
+  stats_t total;
+  for (const shard_t& shard : shards) {
+    QMutexLocker lock(&shard.mutex);
+    total.memHits += shard.stats.memHits;
+    total.diskHits += shard.stats.diskHits;
+    total.pendingHits += shard.stats.pendingHits;
+    total.misses += shard.stats.misses;
+    total.evictions += shard.stats.evictions;
+    total.memBytes += qint64(shard.cache.totalCost()) * 1024;
+    total.tileBytes += shard.stats.tileBytes;
+    total.diskTiles += shard.table.size();
+  }
 
-  QString hash = md5.result().toHex();
-  return table.contains(hash) || cache.contains(hash);
+  const qint64 diskUsage = storage->getDiskUsage();
+  total.diskBytes = diskUsage < 0 ? total.tileBytes : diskUsage;
+  return total;
 }
 
-void CDiskCache::removeCacheFile(const QFileInfo& fileinfo) {
-  QString hash = fileinfo.baseName();
-  table.remove(hash);
-  cache.remove(hash);
-  QFile::remove(fileinfo.absoluteFilePath());
+qint64 CDiskCache::getTileBytes() const {
+  qint64 bytes = 0;
+  for (const shard_t& shard : shards) {
+    QMutexLocker lock(&shard.mutex);
+    bytes += shard.stats.tileBytes;
+  }
+  return bytes;
 }
 
-void CDiskCache::slotCleanup() {
-  QMutexLocker lock(&mutex);
-
-  const QFileInfoList& files = dir.entryInfoList(QStringList("*.png"), QDir::Files);
-  QDateTime now = QDateTime::currentDateTime();
-  qint32 maxSizeBytes = maxSizeMB * 1024 * 1024;
-  qint32 tmpSize = 0;
-  // expire old files and calculate cache size
-  for (const QFileInfo& fileinfo : files) {
-    if (fileinfo.lastModified().daysTo(now) > expirationDays) {
-      removeCacheFile(fileinfo);
-      qDebug() << "remove tile" << fileinfo.lastModified() << fileinfo.absoluteFilePath() << "(reason: expired)";
+void CDiskCache::flushJournal() {
+  QHash<QString, CDiskCacheIndex::record_t> journal;
+  for (shard_t& shard : shards) {
+    QMutexLocker lock(&shard.mutex);
+    for (auto record = shard.journal.constBegin(); record != shard.journal.constEnd(); ++record) {
+      journal.insert(record.key(), record.value());
+    }
+    shard.journal.clear();
+  }
+
+  index.apply(journal);
+}
+
+void CDiskCache::removeTiles(const QList<CDiskCacheIndex::tile_t>& tiles, const QString& reason) {
+  if (tiles.isEmpty()) {
+    return;
+  }
+
+  for (const CDiskCacheIndex::tile_t& tile : tiles) {
+    shard_t& shard = getShard(tile.hash);
+    QMutexLocker lock(&shard.mutex);
+    // the tile has been stored again since the journal was flushed
+    if (shard.pending.contains(tile.hash) ||
+        (shard.journal.value(tile.hash).op == CDiskCacheIndex::record_t::eOpStore)) {
+      continue;
+    }
+
+    if (shard.table.contains(tile.hash)) {
+      const entry_t& entry = shard.table.take(tile.hash);
+      shard.stats.tileBytes -= entry.size;
+      storage->remove({tile.hash, entry.size, entry.location});
+    }
+    shard.cache.remove(tile.hash);
+  }
+
+  qDebug() << "removed" << tiles.size() << "tiles from" << dir.path() << "(reason:" << reason << ")";
+}
+
+void CDiskCache::openOtherBackend() {
+  const bool isPack = backend == eBackendPack;
+  if (dir.entryList(QStringList(isPack ? "*.png" : "QMS_cache_*.pack"), QDir::Files).isEmpty()) {
+    // no tiles to migrate, just remove a stale index
+    if (isPack) {
+      CDiskCacheStoreFiles::purge(absolutePath);
     } else {
-      tmpSize += fileinfo.size();
+      CDiskCacheStorePack::purge(absolutePath);
     }
+    return;
+  }
+
+  if (isPack) {
+    otherStorage = new CDiskCacheStoreFiles(absolutePath);
+  } else {
+    otherStorage = new CDiskCacheStorePack(absolutePath);
   }
+  otherIndex = new CDiskCacheIndex();
+  otherIndex->open(dir.absoluteFilePath(otherStorage->getIndexName()));
+  if (otherIndex->isEmpty()) {
+    // tiles of a previous version without index
+    QHash<QString, CDiskCacheIndex::record_t> journal;
+    otherStorage->import(journal);
+    otherIndex->apply(journal);
+  }
+  qDebug() << "migrate tiles of the other store type in" << dir.path();
+}
 
-  if (tmpSize > maxSizeBytes) {
-    const QFileInfoList& files = dir.entryInfoList(QStringList("*.png"), QDir::Files, QDir::Time | QDir::Reversed);
-    // if cache is still too large remove oldest files
-    for (const QFileInfo& fileinfo : files) {
-      removeCacheFile(fileinfo);
-      qDebug() << "remove tile" << fileinfo.lastModified() << fileinfo.absoluteFilePath()
-               << "(reason: cache size limit)";
+void CDiskCache::migrateTiles() {
+  if ((otherIndex == nullptr) || (copyPending.loadAcquire() != 0)) {
+    return;
+  }
 
-      tmpSize -= fileinfo.size();
+  // the most recent tiles first, if the cache is full the older ones are dropped anyway
+  CDiskCacheWriter::job_t job;
+  job.source = otherStorage;
+  job.tiles = otherIndex->takeMostRecentlyUsed(kMigrateBytes);
+  if (!job.tiles.isEmpty()) {
+    copyPending.storeRelease(1);
+    writer.enqueue(job);
+    return;
+  }
+
+  // all tiles copied, the index has to be closed before it's file can be removed
+  delete otherIndex;
+  otherIndex = nullptr;
+  delete otherStorage;
+  otherStorage = nullptr;
+
+  if (backend == eBackendPack) {
+    CDiskCacheStoreFiles::purge(absolutePath);
+  } else {
+    CDiskCacheStorePack::purge(absolutePath);
+  }
+}
 
-      if (tmpSize < maxSizeBytes) {
-        break;
+void CDiskCache::compactStore(bool force) {
+  if ((copyPending.loadAcquire() != 0) || !storage->selectForCompaction(force)) {
+    return;
+  }
+
+  CDiskCacheWriter::job_t job;
+  job.source = storage;
+  for (shard_t& shard : shards) {
+    QMutexLocker lock(&shard.mutex);
+    for (auto entry = shard.table.constBegin(); entry != shard.table.constEnd(); ++entry) {
+      if (storage->needsRelocation(entry->location)) {
+        job.tiles << CDiskCacheIndex::tile_t{entry.key(), entry->size, entry->location};
       }
     }
   }
+
+  if (!job.tiles.isEmpty()) {
+    qDebug() << "compact" << job.tiles.size() << "tiles in" << dir.path();
+    copyPending.storeRelease(1);
+    writer.enqueue(job);
+  }
+}
+
+void CDiskCache::slotCleanup() {
+  // A map creates and replaces it's cache several times while loading
+  // it's configuration. Thus wait for the first cleanup to be sure this
+  // is the backend in use before touching data of the other one.
+  if (!otherBackendChecked) {
+    openOtherBackend();
+    otherBackendChecked = true;
+  }
+
+  flushJournal();
+
+  // expire old files
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  removeTiles(index.takeExpired(now - qint64(expirationDays) * 24 * 3600 * 1000), "expired");
+
+  // if cache is still too large remove least recently used files
+  const qint64 maxSizeBytes = qint64(maxSizeMB) * 1024 * 1024;
+  const qint64 excess = getTileBytes() - maxSizeBytes;
+  if (excess > 0) {
+    removeTiles(index.takeLeastRecentlyUsed(excess), "cache size limit");
+  }
+
+  // The space of removed tiles is reclaimed by compaction. Force it if the
+  // files exceed the limit, as the tiles alone are within the limit by now.
+  compactStore(storage->getDiskUsage() > maxSizeBytes);
+  migrateTiles();
 }
 
 void CDiskCache::cleanupRemovedMaps(const QSet<QString>& maps) {
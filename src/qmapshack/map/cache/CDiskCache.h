@@ -19,46 +19,170 @@
 #ifndef CDISKCACHE_H
 #define CDISKCACHE_H
 
+#include <QAtomicInt>
+#include <QCache>
 #include <QDir>
 #include <QHash>
 #include <QImage>
 #include <QMutex>
 
+#include "map/cache/CDiskCacheIndex.h"
+#include "map/cache/CDiskCacheWriter.h"
+
+class IDiskCacheStore;
 class QTimer;
 
+/**
+   @brief A two tier tile cache for online maps
+
+   Tiles are stored on disk and limited by size and age. Restored tiles are
+   kept decoded in a memory tier that is limited by a byte budget. The least recently
+   used tiles are dropped from memory first.
+
+   Size, age and last access of the files are tracked by a persistent index. Changes
+   are collected in a journal and written to the index by the periodic cleanup. Thus
+   the cleanup does not need to scan the cache directory.
+
+   New tiles are written to disk by a CDiskCacheWriter thread. Until then they
+   are served from a list of pending tiles.
+
+   The tile data is kept by a IDiskCacheStore. This can be either one file per
+   tile or a few large container files. Container files are compacted by the
+   writer thread. If the store type is changed the tiles of the other type are
+   copied by the writer thread, too. Their files are removed when all tiles are copied.
+
+   All data is split into shards by the tile's hash. Each shard has it's own mutex. Thus
+   the GUI thread and the draw thread only block each other if they access the same shard.
+ */
 class CDiskCache : public QObject {
   Q_OBJECT
  public:
-  CDiskCache(const QString& path, qint32 size, qint32 days, QObject* parent);
-  virtual ~CDiskCache() = default;
-
-  void store(const QString& key, QImage& img);
+  /// the way tiles are encoded on disk
+  enum format_e {
+    eFormatOriginal = 0,  //< the data as received from the server
+    eFormatPngFast = 1,   //< PNG with low compression
+    eFormatPng = 2        //< PNG with default compression
+  };
+
+  /// the storage backend
+  enum backend_e {
+    eBackendFiles = 0,  //< one file per tile, see CDiskCacheStoreFiles
+    eBackendPack = 1    //< a few container files, see CDiskCacheStorePack
+  };
+
+  CDiskCache(const QString& path, qint32 size, qint32 days, qint32 memSizeMB, format_e format, backend_e backend,
+             QObject* parent);
+  virtual ~CDiskCache();
+
+  struct stats_t {
+    quint64 memHits = 0;      //< tiles restored from memory
+    quint64 diskHits = 0;     //< tiles restored from disk
+    quint64 pendingHits = 0;  //< tiles restored from the tiles waiting to be written
+    quint64 misses = 0;       //< tiles not found at all
+    quint64 evictions = 0;    //< tiles dropped from memory to stay within budget
+    qint64 memBytes = 0;      //< current memory usage [byte]
+    qint64 diskBytes = 0;     //< current disk usage including unused space of the store [byte]
+    qint64 tileBytes = 0;     //< size of all tiles on disk [byte]
+    qint64 diskTiles = 0;     //< number of tiles on disk
+  };
+
+  /**
+     @brief Add a tile to the cache
+
+     The tile is available in memory immediately. It is written to disk in the background.
+
+     @param key   the tile's key, usually the URL
+     @param data  the raw data as received from the server
+     @param img   the decoded tile. A NULL image marks a tile that failed to load
+   */
+  void store(const QString& key, const QByteArray& data, const QImage& img);
   void restore(const QString& key, QImage& img);
   bool contains(const QString& key) const;
 
+  /**
+     @brief Get a snapshot of the cache counters summed over all shards
+   */
+  stats_t getStatistics() const;
+
   static void cleanupRemovedMaps(const QSet<QString>& maps);
 
  private slots:
   void slotCleanup();
 
  private:
-  void removeCacheFile(const QFileInfo& fileinfo);
+  friend class CDiskCacheWriter;
+
+  static constexpr qint32 N_SHARDS = 16;
+  /// the amount of tiles copied from the other store type with each cleanup
+  static constexpr qint64 kMigrateBytes = 32 * 1024 * 1024;
+
+  /// a tile in the store
+  struct entry_t {
+    qint64 size = 0;
+    qint64 location = 0;
+  };
+
+  struct shard_t {
+    mutable QMutex mutex;
+    /// hash table of all images in the store
+    QHash<QString, entry_t> table;
+    /// LRU cache of decoded images, the cost is the image size in kByte
+    QCache<QString, QImage> cache;
+    /// tiles queued for the writer thread
+    QHash<QString, QImage> pending;
+    /// changes not yet written to the index
+    QHash<QString, CDiskCacheIndex::record_t> journal;
+    stats_t stats;
+  };
+
+  static QString getHash(const QString& key);
+  shard_t& getShard(const QString& hash) { return shards[qHash(hash) % N_SHARDS]; }
+  const shard_t& getShard(const QString& hash) const { return shards[qHash(hash) % N_SHARDS]; }
+  void insertIntoMemory(shard_t& shard, const QString& hash, const QImage& img);
+  void addToJournal(shard_t& shard, const QString& hash, CDiskCacheIndex::record_t::op_e op,
+                    const entry_t& entry = entry_t());
+  void flushJournal();
+  /// called by the writer thread to encode and write a tile
+  void writeTile(const CDiskCacheWriter::job_t& job);
+  /// called by the writer thread to copy tiles to the store, either to compact it or to migrate them
+  void copyTiles(const CDiskCacheWriter::job_t& job);
+  void importStore();
+  /// open the store of the other backend if it has any tiles left
+  void openOtherBackend();
+  /// copy a batch of tiles from the other backend, remove it's files once it is empty
+  void migrateTiles();
+  /// relocate the tiles of the store's sparsest part
+  void compactStore(bool force);
+  void removeTiles(const QList<CDiskCacheIndex::tile_t>& tiles, const QString& reason);
+  qint64 getTileBytes() const;
 
   QDir dir;
+  /// the absolute path of dir, safe to use from all threads
+  QString absolutePath;
 
   const qint32 maxSizeMB;       //< maximum cache size in MB
   const qint32 expirationDays;  //< expiration time in days
+  const format_e format;
+  const backend_e backend;
+  bool otherBackendChecked = false;
+
+  IDiskCacheStore* storage = nullptr;
+  CDiskCacheIndex index;
+
+  /// the store and index of the other backend while its tiles are migrated
+  IDiskCacheStore* otherStorage = nullptr;
+  CDiskCacheIndex* otherIndex = nullptr;
+
+  /// set while a copy job is queued, only one at a time
+  QAtomicInt copyPending = 0;
 
-  /// hash table to cache images as files on disc
-  QHash<QString, QString> table;
-  /// hash table to cache loaded images in memory
-  QHash<QString, QImage> cache;
+  shard_t shards[N_SHARDS];
 
   QTimer* timer;
 
   QImage dummy{256, 256, QImage::Format_ARGB32};
 
-  mutable QMutex mutex;
+  CDiskCacheWriter writer{*this};
 };
 
 #endif  // CDISKCACHE_H
@@ -0,0 +1,207 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CDiskCacheIndex.h"
+
+#include <QtSql>
+
+#include "gis/db/macros.h"
+
+#define INDEX_VERSION 1
+
+static bool execQuery(QSqlQuery& query) {
+  QUERY_EXEC(return false);
+  return true;
+}
+
+bool CDiskCacheIndex::open(const QString& filename) {
+  connectionName = "DiskCacheIndex_" + filename;
+  db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+  db.setDatabaseName(filename);
+  if (!db.open()) {
+    qWarning() << "failed to open disk cache index" << filename << db.lastError();
+    return false;
+  }
+
+  QSqlQuery query(db);
+  QUERY_RUN("PRAGMA temp_store=MEMORY", NO_CMD)
+  QUERY_RUN("PRAGMA synchronous=off", NO_CMD)
+  QUERY_RUN("PRAGMA journal_mode=WAL", NO_CMD)
+
+  QUERY_RUN("PRAGMA user_version", return false)
+  const qint32 version = query.next() ? query.value(0).toInt() : 0;
+
+  if (version == 0 && query.exec("SELECT hash FROM tiles LIMIT 1")) {
+    // migrate index of version 0 (no location)
+    QUERY_RUN("ALTER TABLE tiles ADD COLUMN location INTEGER NOT NULL DEFAULT 0", return false)
+  }
+
+  QUERY_RUN(
+      "CREATE TABLE IF NOT EXISTS tiles ("
+      "hash           TEXT PRIMARY KEY NOT NULL,"
+      "size           INTEGER NOT NULL,"
+      "created        INTEGER NOT NULL,"
+      "accessed       INTEGER NOT NULL,"
+      "location       INTEGER NOT NULL DEFAULT 0"
+      ")",
+      return false)
+  QUERY_RUN("CREATE INDEX IF NOT EXISTS tiles_created ON tiles (created)", return false)
+  QUERY_RUN("CREATE INDEX IF NOT EXISTS tiles_accessed ON tiles (accessed)", return false)
+  QUERY_RUN(QString("PRAGMA user_version=%1").arg(INDEX_VERSION), return false)
+
+  return true;
+}
+
+CDiskCacheIndex::~CDiskCacheIndex() {
+  if (connectionName.isEmpty()) {
+    return;
+  }
+
+  db.close();
+  // the connection must not be in use when it is removed
+  db = QSqlDatabase();
+  QSqlDatabase::removeDatabase(connectionName);
+}
+
+bool CDiskCacheIndex::isEmpty() const {
+  QSqlQuery query(db);
+  QUERY_RUN("SELECT hash FROM tiles LIMIT 1", return true)
+  return !query.next();
+}
+
+void CDiskCacheIndex::load(std::function<void(const tile_t&)> func) const {
+  QSqlQuery query(db);
+  query.setForwardOnly(true);
+  QUERY_RUN("SELECT hash, size, location FROM tiles", return )
+  while (query.next()) {
+    func(tile_t{query.value(0).toString(), query.value(1).toLongLong(), query.value(2).toLongLong()});
+  }
+}
+
+void CDiskCacheIndex::apply(const QHash<QString, record_t>& journal) {
+  if (journal.isEmpty()) {
+    return;
+  }
+
+  QSqlQuery query(db);
+  QUERY_RUN("BEGIN TRANSACTION", return )
+
+  QSqlQuery queryStore(db);
+  queryStore.prepare(
+      "INSERT OR REPLACE INTO tiles (hash, size, location, created, accessed) "
+      "VALUES (:hash, :size, :location, :created, :accessed)");
+  QSqlQuery queryAccess(db);
+  queryAccess.prepare("UPDATE tiles SET accessed=:accessed WHERE hash=:hash");
+  QSqlQuery queryRemove(db);
+  queryRemove.prepare("DELETE FROM tiles WHERE hash=:hash");
+  QSqlQuery queryMove(db);
+  queryMove.prepare("UPDATE tiles SET location=:location, accessed=MAX(accessed, :accessed) WHERE hash=:hash");
+
+  for (auto record = journal.constBegin(); record != journal.constEnd(); ++record) {
+    switch (record->op) {
+      case record_t::eOpStore:
+        queryStore.bindValue(":hash", record.key());
+        queryStore.bindValue(":size", record->size);
+        queryStore.bindValue(":location", record->location);
+        queryStore.bindValue(":created", record->created);
+        queryStore.bindValue(":accessed", record->accessed);
+        execQuery(queryStore);
+        break;
+
+      case record_t::eOpAccess:
+        queryAccess.bindValue(":hash", record.key());
+        queryAccess.bindValue(":accessed", record->accessed);
+        execQuery(queryAccess);
+        break;
+
+      case record_t::eOpRemove:
+        queryRemove.bindValue(":hash", record.key());
+        execQuery(queryRemove);
+        break;
+
+      case record_t::eOpMove:
+        queryMove.bindValue(":hash", record.key());
+        queryMove.bindValue(":location", record->location);
+        queryMove.bindValue(":accessed", record->accessed);
+        execQuery(queryMove);
+        break;
+    }
+  }
+
+  QUERY_RUN("COMMIT", NO_CMD)
+}
+
+QList<CDiskCacheIndex::tile_t> CDiskCacheIndex::takeExpired(qint64 limit) {
+  QList<tile_t> tiles;
+
+  QSqlQuery query(db);
+  query.setForwardOnly(true);
+  query.prepare("SELECT hash, size, location FROM tiles WHERE created < :limit");
+  query.bindValue(":limit", limit);
+  QUERY_EXEC(return tiles)
+  while (query.next()) {
+    tiles << tile_t{query.value(0).toString(), query.value(1).toLongLong(), query.value(2).toLongLong()};
+  }
+  query.finish();
+
+  query.prepare("DELETE FROM tiles WHERE created < :limit");
+  query.bindValue(":limit", limit);
+  QUERY_EXEC(NO_CMD)
+
+  return tiles;
+}
+
+QList<CDiskCacheIndex::tile_t> CDiskCacheIndex::takeLeastRecentlyUsed(qint64 bytes) {
+  return takeByAccess(bytes, "ASC");
+}
+
+QList<CDiskCacheIndex::tile_t> CDiskCacheIndex::takeMostRecentlyUsed(qint64 bytes) {
+  return takeByAccess(bytes, "DESC");
+}
+
+QList<CDiskCacheIndex::tile_t> CDiskCacheIndex::takeByAccess(qint64 bytes, const QString& order) {
+  QList<tile_t> tiles;
+
+  QSqlQuery query(db);
+  query.setForwardOnly(true);
+  QUERY_RUN("SELECT hash, size, location FROM tiles ORDER BY accessed " + order, return tiles)
+  while ((bytes > 0) && query.next()) {
+    const qint64 size = query.value(1).toLongLong();
+    tiles << tile_t{query.value(0).toString(), size, query.value(2).toLongLong()};
+    bytes -= size;
+  }
+  query.finish();
+
+  remove(tiles);
+  return tiles;
+}
+
+void CDiskCacheIndex::remove(const QList<tile_t>& tiles) {
+  if (tiles.isEmpty()) {
+    return;
+  }
+
+  QSqlQuery query(db);
+  QUERY_RUN("BEGIN TRANSACTION", return )
+  query.prepare("DELETE FROM tiles WHERE hash=:hash");
+  for (const tile_t& tile : tiles) {
+    query.bindValue(":hash", tile.hash);
+    QUERY_EXEC(NO_CMD)
+  }
+  QUERY_RUN("COMMIT", NO_CMD)
+}
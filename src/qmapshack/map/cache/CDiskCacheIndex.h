@@ -0,0 +1,107 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CDISKCACHEINDEX_H
+#define CDISKCACHEINDEX_H
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <functional>
+
+/**
+   @brief Persistent index of all tiles in a disk cache
+
+   The index is a small SQLite database in the cache directory. It keeps size,
+   time of creation and time of last access of each tile. With the index the
+   cache can be restored on startup and cleaned up without touching the files.
+
+   All methods must be called from the thread that created the index.
+ */
+class CDiskCacheIndex {
+ public:
+  CDiskCacheIndex() = default;
+  virtual ~CDiskCacheIndex();
+
+  /**
+     @brief Open the index database and create the tables if needed
+     @param filename  the database file
+     @return Return false if the database could not be opened
+   */
+  bool open(const QString& filename);
+
+  /// a pending change to the index
+  struct record_t {
+    /// eOpMove changes the location only, e.g. if the store is compacted
+    enum op_e { eOpStore, eOpAccess, eOpRemove, eOpMove };
+    op_e op = eOpAccess;
+    qint64 size = 0;      //< tile size [byte]
+    qint64 location = 0;  //< position of the tile in the store, see IDiskCacheStore
+    qint64 created = 0;   //< [ms since epoch]
+    qint64 accessed = 0;  //< [ms since epoch]
+  };
+
+  struct tile_t {
+    QString hash;
+    qint64 size;
+    qint64 location;
+  };
+
+  bool isEmpty() const;
+
+  /**
+     @brief Iterate over all tiles in the index
+     @param func  called for each tile
+   */
+  void load(std::function<void(const tile_t&)> func) const;
+
+  /**
+     @brief Apply a set of pending changes within a single transaction
+     @param journal  the changes keyed by the tile's hash
+   */
+  void apply(const QHash<QString, record_t>& journal);
+
+  /**
+     @brief Remove all tiles created before a given time from the index
+     @param limit   the time limit [ms since epoch]
+     @return A list of the removed tiles
+   */
+  QList<tile_t> takeExpired(qint64 limit);
+
+  /**
+     @brief Remove the least recently used tiles from the index
+     @param bytes   the minimum number of bytes to remove
+     @return A list of the removed tiles
+   */
+  QList<tile_t> takeLeastRecentlyUsed(qint64 bytes);
+
+  /**
+     @brief Remove the most recently used tiles from the index
+     @param bytes   the minimum number of bytes to remove
+     @return A list of the removed tiles
+   */
+  QList<tile_t> takeMostRecentlyUsed(qint64 bytes);
+
+ private:
+  QList<tile_t> takeByAccess(qint64 bytes, const QString& order);
+  void remove(const QList<tile_t>& tiles);
+
+  QString connectionName;
+  QSqlDatabase db;
+};
+
+#endif  // CDISKCACHEINDEX_H
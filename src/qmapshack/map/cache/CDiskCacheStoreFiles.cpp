@@ -0,0 +1,71 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CDiskCacheStoreFiles.h"
+
+#include <QtCore>
+
+CDiskCacheStoreFiles::CDiskCacheStoreFiles(const QString& path) : IDiskCacheStore(path) {}
+
+void CDiskCacheStoreFiles::import(QHash<QString, CDiskCacheIndex::record_t>& journal) {
+  const QFileInfoList& files = QDir(path).entryInfoList(QStringList("*.png"), QDir::Files);
+  for (const QFileInfo& fileinfo : files) {
+    CDiskCacheIndex::record_t& record = journal[fileinfo.baseName()];
+    record.op = CDiskCacheIndex::record_t::eOpStore;
+    record.size = fileinfo.size();
+    record.created = fileinfo.lastModified().toMSecsSinceEpoch();
+    record.accessed = record.created;
+  }
+}
+
+bool CDiskCacheStoreFiles::write(const QString& hash, const QByteArray& data, qint64& location) {
+  // The file name's suffix is always .png. The image reader will detect
+  // the real format by the file's content.
+  const QString& filename = getFilename(hash);
+  QFile file(filename);
+  const bool success = file.open(QIODevice::WriteOnly) && (file.write(data) == data.size());
+  file.close();
+  if (!success) {
+    qWarning() << "failed to write tile" << filename << file.errorString();
+    QFile::remove(filename);
+  }
+
+  location = 0;
+  return success;
+}
+
+QByteArray CDiskCacheStoreFiles::read(const CDiskCacheIndex::tile_t& tile) const {
+  QFile file(getFilename(tile.hash));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return QByteArray();
+  }
+  return file.readAll();
+}
+
+void CDiskCacheStoreFiles::remove(const CDiskCacheIndex::tile_t& tile) { QFile::remove(getFilename(tile.hash)); }
+
+void CDiskCacheStoreFiles::purge(const QString& path) {
+  QDir dir(path);
+  const QStringList& files = dir.entryList(QStringList() << "*.png"
+                                                         << "QMS_cache.db*",
+                                           QDir::Files);
+  qDebug() << "purge" << files.size() << "files from" << path;
+  for (const QString& file : files) {
+    dir.remove(file);
+  }
+}
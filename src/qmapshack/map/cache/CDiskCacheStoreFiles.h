@@ -0,0 +1,48 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CDISKCACHESTOREFILES_H
+#define CDISKCACHESTOREFILES_H
+
+#include "map/cache/IDiskCacheStore.h"
+
+/**
+   @brief Store each tile as a single file named by it's hash
+
+   The location of a tile is not used.
+ */
+class CDiskCacheStoreFiles : public IDiskCacheStore {
+ public:
+  CDiskCacheStoreFiles(const QString& path);
+  virtual ~CDiskCacheStoreFiles() = default;
+
+  QString getIndexName() const override { return "QMS_cache.db"; }
+
+  void import(QHash<QString, CDiskCacheIndex::record_t>& journal) override;
+  bool write(const QString& hash, const QByteArray& data, qint64& location) override;
+  QByteArray read(const CDiskCacheIndex::tile_t& tile) const override;
+  void remove(const CDiskCacheIndex::tile_t& tile) override;
+
+  /// remove all tiles and the index of this store type from the directory
+  static void purge(const QString& path);
+
+ private:
+  QString getFilename(const QString& hash) const { return path + "/" + hash + ".png"; }
+};
+
+#endif  // CDISKCACHESTOREFILES_H
@@ -0,0 +1,160 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CDiskCacheStorePack.h"
+
+#include <QtCore>
+
+CDiskCacheStorePack::CDiskCacheStorePack(const QString& path) : IDiskCacheStore(path) {}
+
+void CDiskCacheStorePack::restored(const CDiskCacheIndex::tile_t& tile) {
+  QMutexLocker lock(&mutex);
+  liveBytes[getSegment(tile.location)] += tile.size;
+}
+
+void CDiskCacheStorePack::loaded() {
+  QMutexLocker lock(&mutex);
+
+  // remove segments without any tile in the index
+  QDir dir(path);
+  const QStringList& files = dir.entryList(QStringList("QMS_cache_*.pack"), QDir::Files);
+  for (const QString& file : files) {
+    const quint32 segment = file.mid(10, 6).toUInt();
+    if (!liveBytes.contains(segment)) {
+      qDebug() << "remove unused segment" << file;
+      dir.remove(file);
+    } else {
+      fileBytes[segment] = QFileInfo(dir, file).size();
+    }
+  }
+
+  // always start a new segment to keep a damaged one from previous sessions untouched
+  for (quint32 segment : liveBytes.keys()) {
+    currentSegment = qMax(currentSegment, segment + 1);
+  }
+}
+
+bool CDiskCacheStorePack::write(const QString& hash, const QByteArray& data, qint64& location) {
+  Q_UNUSED(hash)
+  QMutexLocker lock(&mutex);
+
+  if (file.isOpen() && (file.size() + data.size() > MAX_SEGMENT_SIZE)) {
+    file.close();
+    currentSegment++;
+  }
+
+  if (!file.isOpen()) {
+    file.setFileName(getFilename(currentSegment));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+      qWarning() << "failed to open segment" << file.fileName() << file.errorString();
+      return false;
+    }
+  }
+
+  const qint64 offset = file.size();
+  if ((file.write(data) != data.size()) || !file.flush()) {
+    qWarning() << "failed to write tile to segment" << file.fileName() << file.errorString();
+    // the segment is in an unknown state, start a new one
+    file.close();
+    currentSegment++;
+    return false;
+  }
+
+  liveBytes[currentSegment] += data.size();
+  fileBytes[currentSegment] = offset + data.size();
+  location = (qint64(currentSegment) << OFFSET_BITS) | offset;
+  return true;
+}
+
+QByteArray CDiskCacheStorePack::read(const CDiskCacheIndex::tile_t& tile) const {
+  // each read uses it's own file handle to not block other threads
+  QFile segment(getFilename(getSegment(tile.location)));
+  if (!segment.open(QIODevice::ReadOnly) || !segment.seek(getOffset(tile.location))) {
+    return QByteArray();
+  }
+
+  const QByteArray& data = segment.read(tile.size);
+  return data.size() == tile.size ? data : QByteArray();
+}
+
+void CDiskCacheStorePack::remove(const CDiskCacheIndex::tile_t& tile) {
+  QMutexLocker lock(&mutex);
+
+  const quint32 segment = getSegment(tile.location);
+  if (!liveBytes.contains(segment)) {
+    return;
+  }
+
+  qint64& bytes = liveBytes[segment];
+  bytes -= tile.size;
+  if ((bytes <= 0) && (segment != currentSegment)) {
+    liveBytes.remove(segment);
+    fileBytes.remove(segment);
+    QFile::remove(getFilename(segment));
+    if (compactSegment == segment) {
+      compactSegment = -1;
+    }
+  }
+}
+
+qint64 CDiskCacheStorePack::getDiskUsage() const {
+  QMutexLocker lock(&mutex);
+
+  qint64 bytes = 0;
+  for (qint64 size : fileBytes) {
+    bytes += size;
+  }
+  return bytes;
+}
+
+bool CDiskCacheStorePack::selectForCompaction(bool force) {
+  QMutexLocker lock(&mutex);
+
+  // pick the segment with the lowest ratio of bytes in use
+  compactSegment = -1;
+  qreal minRatio = force ? 1.0 : kMinLiveRatio;
+  for (auto segment = liveBytes.constBegin(); segment != liveBytes.constEnd(); ++segment) {
+    const qint64 size = fileBytes.value(segment.key());
+    if ((segment.key() == currentSegment) || (size <= 0)) {
+      continue;
+    }
+
+    const qreal ratio = qreal(segment.value()) / size;
+    if (ratio < minRatio) {
+      minRatio = ratio;
+      compactSegment = segment.key();
+    }
+  }
+  return compactSegment >= 0;
+}
+
+bool CDiskCacheStorePack::needsRelocation(qint64 location) const {
+  QMutexLocker lock(&mutex);
+  return (compactSegment >= 0) && (getSegment(location) == compactSegment);
+}
+
+void CDiskCacheStorePack::purge(const QString& path) {
+  QDir dir(path);
+  const QStringList& files = dir.entryList(QStringList() << "QMS_cache_*.pack"
+                                                         << "QMS_pack.db*",
+                                           QDir::Files);
+  qDebug() << "purge" << files.size() << "files from" << path;
+  for (const QString& file : files) {
+    dir.remove(file);
+  }
+}
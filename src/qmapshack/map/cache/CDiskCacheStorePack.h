@@ -0,0 +1,84 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CDISKCACHESTOREPACK_H
+#define CDISKCACHESTOREPACK_H
+
+#include <QFile>
+#include <QMutex>
+
+#include "map/cache/IDiskCacheStore.h"
+
+/**
+   @brief Store all tiles in a few append-only container files
+
+   Tiles are appended to the current segment file. If the segment exceeds
+   a size limit a new segment is started. The location of a tile is the
+   segment number in the upper bits and the byte offset in the lower 40 bits.
+
+   Removed tiles leave holes in their segment. A segment file is deleted as
+   soon as it has no tiles left. Segments with less than kMinLiveRatio of
+   their size in use are selected for compaction. The cache then writes their
+   tiles again into the current segment. Thus the disk usage is bound by the
+   size of the tiles.
+ */
+class CDiskCacheStorePack : public IDiskCacheStore {
+ public:
+  CDiskCacheStorePack(const QString& path);
+  virtual ~CDiskCacheStorePack() = default;
+
+  QString getIndexName() const override { return "QMS_pack.db"; }
+
+  void restored(const CDiskCacheIndex::tile_t& tile) override;
+  void loaded() override;
+  bool write(const QString& hash, const QByteArray& data, qint64& location) override;
+  QByteArray read(const CDiskCacheIndex::tile_t& tile) const override;
+  void remove(const CDiskCacheIndex::tile_t& tile) override;
+  qint64 getDiskUsage() const override;
+  bool selectForCompaction(bool force) override;
+  bool needsRelocation(qint64 location) const override;
+
+  /// remove all segments and the index of this store type from the directory
+  static void purge(const QString& path);
+
+ private:
+  static constexpr qint64 MAX_SEGMENT_SIZE = 64 * 1024 * 1024;
+  static constexpr qint32 OFFSET_BITS = 40;
+  /// segments with less bytes in use are compacted
+  static constexpr qreal kMinLiveRatio = 0.5;
+
+  QString getFilename(quint32 segment) const {
+    return QString("%1/QMS_cache_%2.pack").arg(path).arg(segment, 6, 10, QChar('0'));
+  }
+  static quint32 getSegment(qint64 location) { return quint32(location >> OFFSET_BITS); }
+  static qint64 getOffset(qint64 location) { return location & ((qint64(1) << OFFSET_BITS) - 1); }
+
+  mutable QMutex mutex;
+  /// the number of bytes still in use for each segment
+  QHash<quint32, qint64> liveBytes;
+  /// the file size of each segment
+  QHash<quint32, qint64> fileBytes;
+  /// the segment selected for compaction, -1 for none
+  qint64 compactSegment = -1;
+  /// the segment tiles are appended to
+  quint32 currentSegment = 0;
+  /// the file of the current segment, used by the writer thread only
+  QFile file;
+};
+
+#endif  // CDISKCACHESTOREPACK_H
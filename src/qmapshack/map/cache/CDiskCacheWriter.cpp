@@ -0,0 +1,75 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CDiskCacheWriter.h"
+
+#include "map/cache/CDiskCache.h"
+
+CDiskCacheWriter::CDiskCacheWriter(CDiskCache& cache) : cache(cache) {}
+
+CDiskCacheWriter::~CDiskCacheWriter() { stop(); }
+
+bool CDiskCacheWriter::enqueue(const job_t& job) {
+  QMutexLocker lock(&mutex);
+  if (!keepGoing) {
+    return false;
+  }
+
+  // the tiles waiting to be written are kept in memory, drop new ones instead of
+  // blocking the thread receiving them
+  if ((job.source == nullptr) && (queue.size() >= kMaxQueue)) {
+    return false;
+  }
+
+  queue.enqueue(job);
+  condition.wakeOne();
+  return true;
+}
+
+void CDiskCacheWriter::stop() {
+  {
+    QMutexLocker lock(&mutex);
+    keepGoing = false;
+    condition.wakeOne();
+  }
+  wait();
+}
+
+void CDiskCacheWriter::run() {
+  while (1) {
+    job_t job;
+    {
+      QMutexLocker lock(&mutex);
+      while (queue.isEmpty() && keepGoing) {
+        condition.wait(&mutex);
+      }
+
+      // stop only after all pending tiles have been written
+      if (queue.isEmpty()) {
+        return;
+      }
+      job = queue.dequeue();
+    }
+
+    if (job.source != nullptr) {
+      cache.copyTiles(job);
+    } else {
+      cache.writeTile(job);
+    }
+  }
+}
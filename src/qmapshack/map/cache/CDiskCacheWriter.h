@@ -0,0 +1,89 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CDISKCACHEWRITER_H
+#define CDISKCACHEWRITER_H
+
+#include <QImage>
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "map/cache/CDiskCacheIndex.h"
+
+class CDiskCache;
+class IDiskCacheStore;
+
+/**
+   @brief Write-behind queue for CDiskCache
+
+   Tiles are encoded and written to disk by this thread. Thus the thread
+   receiving the tiles never waits for the encoder or the disk.
+ */
+class CDiskCacheWriter : public QThread {
+  Q_OBJECT
+ public:
+  CDiskCacheWriter(CDiskCache& cache);
+  virtual ~CDiskCacheWriter();
+
+  struct job_t {
+    QString hash;
+    QByteArray data;  //< the tile as received from the server
+    QImage img;       //< the decoded tile
+
+    /// copy these tiles as they are from source instead of writing a new tile
+    QList<CDiskCacheIndex::tile_t> tiles;
+    IDiskCacheStore* source = nullptr;
+  };
+
+  /**
+     @brief Queue a tile to be written
+
+     This never blocks. If the writer falls behind by more than kMaxQueue tiles the
+     tile is dropped. It is still kept in the memory cache and will be requested
+     again once it is gone from there. Jobs to copy tiles are always queued.
+     Tiles queued after stop() are not written.
+
+     @return False if the job has been dropped.
+   */
+  bool enqueue(const job_t& job);
+
+  /**
+     @brief Write all queued tiles and stop the thread for good
+
+     This will block until the queue is empty.
+   */
+  void stop();
+
+ protected:
+  void run() override;
+
+ private:
+  CDiskCache& cache;
+
+  /// the maximum number of tiles waiting to be written
+  static constexpr qint32 kMaxQueue = 128;
+
+  QMutex mutex;
+  QWaitCondition condition;
+  QQueue<job_t> queue;
+  bool keepGoing = true;
+};
+
+#endif  // CDISKCACHEWRITER_H
@@ -0,0 +1,122 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef IDISKCACHESTORE_H
+#define IDISKCACHESTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+#include "map/cache/CDiskCacheIndex.h"
+
+/**
+   @brief Interface of the storage backend used by CDiskCache
+
+   A store keeps the raw tile data. All bookkeeping is done by CDiskCache and
+   CDiskCacheIndex. Each tile has a location that is defined by the store and
+   kept in the index.
+
+   write() is called by the writer thread only. read() is called by any thread.
+   All other methods are called from the thread owning the cache. A store has
+   to be thread-safe with respect to this.
+ */
+class IDiskCacheStore {
+ public:
+  IDiskCacheStore(const QString& path) : path(path) {}
+  virtual ~IDiskCacheStore() = default;
+
+  /// the name of the index database used together with this store
+  virtual QString getIndexName() const = 0;
+
+  /**
+     @brief Add all tiles of the store to the journal
+
+     This is called if the index is empty, e.g. for caches of a previous version.
+
+     @param journal   a journal to be applied to the index
+   */
+  virtual void import(QHash<QString, CDiskCacheIndex::record_t>& journal) { Q_UNUSED(journal) }
+
+  /**
+     @brief Tell the store about a tile listed in the index
+
+     This is called on startup for each tile in the index.
+   */
+  virtual void restored(const CDiskCacheIndex::tile_t& tile) { Q_UNUSED(tile) }
+
+  /**
+     @brief Called on startup after all tiles have been passed to restored()
+   */
+  virtual void loaded() {}
+
+  /**
+     @brief Write a tile
+     @param hash      the tile's hash
+     @param data      the encoded tile
+     @param location  returns the location of the data in the store
+     @return Return true on success
+   */
+  virtual bool write(const QString& hash, const QByteArray& data, qint64& location) = 0;
+
+  /**
+     @brief Read a tile
+     @param tile      the tile's hash, size and location
+     @return The tile's data. An empty array on failure.
+   */
+  virtual QByteArray read(const CDiskCacheIndex::tile_t& tile) const = 0;
+
+  /**
+     @brief Release a tile's data
+     @param tile      the tile's hash, size and location
+   */
+  virtual void remove(const CDiskCacheIndex::tile_t& tile) = 0;
+
+  /**
+     @brief Get the space used on disk
+     @return The size of all files [byte]. -1 if it is the size of all tiles.
+   */
+  virtual qint64 getDiskUsage() const { return -1; }
+
+  /**
+     @brief Select a part of the store to be compacted
+
+     Stores that keep the space of removed tiles select the part with the most
+     unused space. The tiles in that part are found by needsRelocation(). They
+     have to be written again and removed from their old location.
+
+     @param force     select a part with unused space even if it is below the store's threshold
+     @return Return true if a part has been selected
+   */
+  virtual bool selectForCompaction(bool force) {
+    Q_UNUSED(force)
+    return false;
+  }
+
+  /// Return true if the tile at location is in the part selected by selectForCompaction()
+  virtual bool needsRelocation(qint64 location) const {
+    Q_UNUSED(location)
+    return false;
+  }
+
+ protected:
+  /// the absolute path of the cache directory
+  const QString path;
+};
+
+#endif  // IDISKCACHESTORE_H
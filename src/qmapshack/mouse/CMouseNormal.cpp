@@ -259,7 +259,7 @@ void CMouseNormal::draw(QPainter& p, CCanvas::redraw_e needsRedraw, const QRect&
       screenUnclutter->clear();
 
       QList<IGisItem*> items;
-      CGisWorkspace::self().getItemsByPos(mouse->getPoint(), items);
+      CGisWorkspace::self().getItemsByPos(mouse->getPoint(), gis, items);
 
       if (items.empty() || items.size() > 8) {
         stateItemSel = eStateIdle;
@@ -46,8 +46,6 @@ void CMouseWptBubble::leftClicked(const QPoint& pos) {
 }
 
 void CMouseWptBubble::mouseMoved(const QPoint& pos) {
-  QMutexLocker lock(&IGisItem::mutexItems);
-
   CGisItemWpt* wpt = dynamic_cast<CGisItemWpt*>(CGisWorkspace::self().getItemByKey(key));
   if (wpt) {
     wpt->mouseMove(pos);
@@ -27,6 +27,7 @@
 #include "helpers/CDraw.h"
 #include "helpers/CProgressDialog.h"
 #include "helpers/CSettings.h"
+#include "print/CTiledImageWriter.h"
 
 CPrintDialog::CPrintDialog(type_e type, const QRectF& area, CCanvas* source)
     : QDialog(&CMainWindow::self()), type(type), rectSelArea(area) {
@@ -227,28 +228,15 @@ void CPrintDialog::slotPrint() {
 }
 
 void CPrintDialog::slotSave() {
-  QPointF pt1 = rectSelArea.topLeft();
-  QPointF pt2 = rectSelArea.bottomRight();
-
-  canvas->convertRad2Px(pt1);
-  canvas->convertRad2Px(pt2);
-
-  QRectF rect(pt1, pt2);
-  QImage img(rect.size().toSize(), QImage::Format_ARGB32);
-
-  QPainter p(&img);
-  USE_ANTI_ALIASING(p, true);
-
-  canvas->print(p, rect, rectSelArea.center());
-
   SETTINGS;
   QString path = cfg.value("Paths/lastImagePath", "./").toString();
 
   QString filterPNG = "PNG Image (*.png)";
   QString filterJPG = "JPEG Image (*.jpg)";
+  QString filterTIF = "TIFF Image (*.tif)";
   QString filter = filterPNG;
-  QString filename =
-      QFileDialog::getSaveFileName(this, tr("Save map..."), path, filterPNG + ";; " + filterJPG, &filter);
+  QString filename = QFileDialog::getSaveFileName(this, tr("Save map..."), path,
+                                                  filterPNG + ";; " + filterJPG + ";; " + filterTIF, &filter);
   if (filename.isEmpty()) {
     return;
   }
@@ -258,6 +246,8 @@ void CPrintDialog::slotSave() {
     expectedSuffix = "png";
   } else if (filter == filterJPG) {
     expectedSuffix = "jpg";
+  } else if (filter == filterTIF) {
+    expectedSuffix = "tif";
   }
 
   QFileInfo fi(filename);
@@ -265,7 +255,66 @@ void CPrintDialog::slotSave() {
     filename += "." + expectedSuffix;
   }
 
-  img.save(filename);
+  QPointF pt1 = rectSelArea.topLeft();
+  QPointF pt2 = rectSelArea.bottomRight();
+
+  canvas->convertRad2Px(pt1);
+  canvas->convertRad2Px(pt2);
+
+  const QSize sizeImage = QRectF(pt1, pt2).size().toSize();
+
+  // The image is not kept in memory. It is streamed tile by tile to the file.
+  CTiledImageWriter writer(filename, sizeImage);
+  if (!writer.isValid()) {
+    QMessageBox::critical(this, tr("Error..."), writer.getError(), QMessageBox::Ok);
+    return;
+  }
+
+  bool canceled = false;
+  bool success = false;
+  {  // open context for progress dialog
+    PROGRESS_SETUP(tr("Saving map."), 0, CCanvas::getPrintTiles(sizeImage).size(), this);
+    int n = 0;
+
+    // A tile is written by a second thread while the next one is drawn. Not more,
+    // as the memory used must not depend on the number of tiles.
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    QAtomicInt failed = 0;
+
+    auto sink = [&](const QImage& tile, const QPoint& pos) {
+      threadPool.waitForDone();
+      if (failed.loadAcquire() != 0) {
+        return false;
+      }
+
+      threadPool.start([&writer, &failed, tile, pos]() {
+        if (!writer.writeTile(tile, pos)) {
+          failed.storeRelease(1);
+        }
+      });
+
+      PROGRESS(++n, canceled = true);
+      return !canceled;
+    };
+
+    const bool done = canvas->printTiles(sizeImage, rectSelArea.center(), true, sink);
+    threadPool.waitForDone();
+
+    if (done && failed.loadAcquire() == 0) {
+      CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
+      success = writer.finish();
+    }
+  }
+
+  if (canceled) {
+    return;
+  }
+
+  if (!success) {
+    QMessageBox::critical(this, tr("Error..."), writer.getError(), QMessageBox::Ok);
+    return;
+  }
 
   cfg.setValue("Paths/lastImagePath", fi.absolutePath());
 
@@ -0,0 +1,147 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "print/CTiledImageWriter.h"
+
+#include <cpl_conv.h>
+#include <gdal_priv.h>
+
+#include <QtGui>
+
+CTiledImageWriter::CTiledImageWriter(const QString& filename, const QSize& size) : filename(filename), size(size) {
+  const QString& suffix = QFileInfo(filename).suffix().toLower();
+  if (suffix == "png") {
+    driverName = "PNG";
+  } else if (suffix == "jpg" || suffix == "jpeg") {
+    driverName = "JPEG";
+    bands = 3;
+  } else if (suffix == "tif" || suffix == "tiff") {
+    driverName = "GTiff";
+  } else {
+    error = tr("Unsupported image format: %1").arg(suffix);
+    return;
+  }
+
+  QString filenameTiles = filename;
+  if (driverName != "GTiff") {
+    temp.setFileTemplate(QDir::temp().filePath("qms_print_XXXXXX.tif"));
+    if (!temp.open()) {
+      error = tr("Failed to create temporary file: %1").arg(temp.errorString());
+      return;
+    }
+    // GDAL creates the file again, just keep the name
+    temp.close();
+    filenameTiles = temp.fileName();
+  }
+
+  GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+  if (driver == nullptr) {
+    error = tr("GDAL has no TIFF driver.");
+    return;
+  }
+
+  const char* cargs[] = {"TILED=YES", "COMPRESS=LZW", "BIGTIFF=IF_SAFER", bands == 4 ? "ALPHA=YES" : nullptr, nullptr};
+  CPLErrorReset();
+  dataset = driver->Create(filenameTiles.toUtf8(), size.width(), size.height(), bands, GDT_Byte, (char**)cargs);
+  if (dataset == nullptr) {
+    error = tr("Failed to create file: %1\n%2").arg(filenameTiles, CPLGetLastErrorMsg());
+  }
+}
+
+CTiledImageWriter::~CTiledImageWriter() {
+  if (dataset == nullptr) {
+    return;
+  }
+
+  // not finished, drop the incomplete image
+  GDALClose(dataset);
+  if (driverName == "GTiff") {
+    QFile::remove(filename);
+  }
+}
+
+bool CTiledImageWriter::writeTile(const QImage& tile, const QPoint& pos) {
+  QMutexLocker lock(&mutex);
+  if (dataset == nullptr) {
+    return false;
+  }
+
+  const QRect& rect = QRect(pos, tile.size()).intersected(QRect(QPoint(0, 0), size));
+  if (rect.isEmpty()) {
+    return true;
+  }
+
+  // GDAL needs the bands byte by byte in the order of R, G, B (and A)
+  QImage image;
+  if (bands == 4) {
+    image = tile.convertToFormat(QImage::Format_RGBA8888);
+  } else {
+    image = QImage(tile.size(), QImage::Format_RGB888);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.drawImage(0, 0, tile);
+  }
+
+  const qint32 bytesPerLine = image.bytesPerLine();
+  uchar* data = image.bits() + (rect.y() - pos.y()) * bytesPerLine + (rect.x() - pos.x()) * bands;
+  int bandMap[] = {1, 2, 3, 4};
+
+  CPLErrorReset();
+  CPLErr err = dataset->RasterIO(GF_Write, rect.x(), rect.y(), rect.width(), rect.height(), data, rect.width(),
+                                 rect.height(), GDT_Byte, bands, bandMap, bands, bytesPerLine, 1, nullptr);
+  if (err != CE_None) {
+    error = tr("Failed to write tile: %1").arg(CPLGetLastErrorMsg());
+    return false;
+  }
+  return true;
+}
+
+bool CTiledImageWriter::finish() {
+  QMutexLocker lock(&mutex);
+  if (dataset == nullptr) {
+    return false;
+  }
+
+  if (driverName == "GTiff") {
+    GDALClose(dataset);
+    dataset = nullptr;
+    return true;
+  }
+
+  CPLErrorReset();
+  GDALDataset* target = nullptr;
+  GDALDriver* driver = GetGDALDriverManager()->GetDriverByName(driverName.toLatin1());
+  if (driver != nullptr) {
+    // the copy is read line by line from the tiles, no need for an *.aux.xml file next to the image
+    CPLSetThreadLocalConfigOption("GDAL_PAM_ENABLED", "NO");
+    target = driver->CreateCopy(filename.toUtf8(), dataset, FALSE, nullptr, nullptr, nullptr);
+    CPLSetThreadLocalConfigOption("GDAL_PAM_ENABLED", nullptr);
+  }
+
+  GDALClose(dataset);
+  dataset = nullptr;
+
+  if (target == nullptr) {
+    error = tr("Failed to write file: %1\n%2").arg(filename, CPLGetLastErrorMsg());
+    QFile::remove(filename);
+    return false;
+  }
+
+  GDALClose(target);
+  return true;
+}
@@ -0,0 +1,90 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILEDIMAGEWRITER_H
+#define CTILEDIMAGEWRITER_H
+
+#include <QCoreApplication>
+#include <QImage>
+#include <QMutex>
+#include <QTemporaryFile>
+
+class GDALDataset;
+
+/**
+   @brief Write an image of any size tile by tile
+
+   The tiles are written to a tiled TIFF file by GDAL. Nothing but GDAL's block cache is kept in
+   memory. TIFF files are written in place. PNG and JPEG files can't be written in parts. Their
+   tiles go to a temporary TIFF file. finish() converts it line by line into the target format.
+
+   Tiles can be written from any thread.
+ */
+class CTiledImageWriter {
+  Q_DECLARE_TR_FUNCTIONS(CTiledImageWriter)
+ public:
+  /**
+     @brief Create the file to write to
+
+     @param filename  the image file, the format is derived from the suffix (png, jpg, jpeg, tif, tiff)
+     @param size      the size of the image in [px]
+   */
+  CTiledImageWriter(const QString& filename, const QSize& size);
+  virtual ~CTiledImageWriter();
+
+  /// Return false if the file could not be created. See getError().
+  bool isValid() const { return dataset != nullptr; }
+
+  const QString& getError() const { return error; }
+
+  /**
+     @brief Write a tile
+
+     Parts of the tile outside of the image are dropped. Transparent parts are put on white
+     for JPEG files.
+
+     @param tile      the tile, usually of format QImage::Format_ARGB32
+     @param pos       the position of the tile's top left corner in the image in [px]
+     @return False on error. See getError().
+   */
+  bool writeTile(const QImage& tile, const QPoint& pos);
+
+  /**
+     @brief Close the image file
+
+     Without a call to finish() the file is removed again.
+
+     @return False on error. See getError().
+   */
+  bool finish();
+
+ private:
+  QString filename;
+  QString driverName;
+  QSize size;
+  qint32 bands = 4;
+
+  /// the temporary TIFF file for formats that can't be written in parts
+  QTemporaryFile temp;
+  GDALDataset* dataset = nullptr;
+
+  QMutex mutex;
+  QString error;
+};
+
+#endif  // CTILEDIMAGEWRITER_H
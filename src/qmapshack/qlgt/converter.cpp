@@ -113,7 +113,7 @@ CGisItemWpt::CGisItemWpt(const CQlgtWpt& wpt1, IGisProject* project) : IGisItem(
 
     images << image;
   }
-  boundingRect = QRectF(QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD, QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD);
+  setBoundingRect(QRectF(QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD, QPointF(wpt.lon, wpt.lat) * DEG_TO_RAD));
   setIcon();
   CGisItemWpt::genKey();
   setupHistory();
@@ -174,17 +174,19 @@ CGisItemTrk::CGisItemTrk(const CQlgtTrack& trk1, IGisProject* project)
     event.comment = tr("Copy flag information from QLandkarte GT track");
     event.icon = "://icons/48x48/PointHide.png";
 
-    QDataStream stream(&event.data, QIODevice::WriteOnly);
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
     stream.setByteOrder(QDataStream::LittleEndian);
     stream.setVersion(QDataStream::Qt_5_2);
 
     *this >> stream;
 
     QCryptographicHash md5(QCryptographicHash::Md5);
-    md5.addData(event.data);
+    md5.addData(data);
     event.hash = md5.result().toHex();
 
     history.histIdxCurrent = history.events.size() - 1;
+    history.setData(history.histIdxCurrent, data);
   }
 }
 
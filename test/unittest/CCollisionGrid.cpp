@@ -0,0 +1,110 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "helpers/CCollisionGrid.h"
+
+#include <QtCore>
+
+/*
+   A dense viewport: 5000 icons of 16x16 px and labels of 80x16 px
+   on a 1920x1080 screen. The positions are pseudo random but the same
+   for each run.
+ */
+static QVector<QRectF> denseViewport()
+{
+    QVector<QRectF> rects;
+    quint32 seed = 1;
+    auto next = [&seed](quint32 max) { seed = seed * 1103515245 + 12345; return (seed >> 16) % max; };
+
+    for(int i = 0; i < 5000; i++)
+    {
+        const qreal x = next(1920);
+        const qreal y = next(1080);
+        rects << QRectF(x, y, 16, 16) << QRectF(x - 32, y + 16, 80, 16);
+    }
+    return rects;
+}
+
+static QVector<QRectF> placeLinear(const QVector<QRectF> &rects)
+{
+    QVector<QRectF> placed;
+    for(const QRectF &rect : rects)
+    {
+        bool cluttered = false;
+        for(const QRectF &other : placed)
+        {
+            if(rect.intersects(other))
+            {
+                cluttered = true;
+                break;
+            }
+        }
+        if(!cluttered)
+        {
+            placed << rect;
+        }
+    }
+    return placed;
+}
+
+static QVector<QRectF> placeGrid(const QVector<QRectF> &rects)
+{
+    CCollisionGrid grid;
+    QVector<QRectF> placed;
+    for(const QRectF &rect : rects)
+    {
+        if(!grid.intersects(rect))
+        {
+            grid.insert(rect);
+            placed << rect;
+        }
+    }
+    return placed;
+}
+
+void test_QMapShack::_placeLabelsCollisionGrid()
+{
+    const QVector<QRectF> &rects = denseViewport();
+
+    // the grid must place exactly the same rectangles as the linear search
+    const QVector<QRectF> &expected = placeLinear(rects);
+    const QVector<QRectF> &placed = placeGrid(rects);
+    VERIFY_EQUAL(expected.size(), placed.size());
+    for(int i = 0; i < expected.size(); i++)
+    {
+        SUBVERIFY(expected[i] == placed[i], QString("Rectangle %1 differs from the linear search").arg(i));
+    }
+
+    QBENCHMARK
+    {
+        placeGrid(rects);
+    }
+}
+
+void test_QMapShack::_placeLabelsLinear()
+{
+    const QVector<QRectF> &rects = denseViewport();
+
+    QBENCHMARK
+    {
+        placeLinear(rects);
+    }
+}
@@ -0,0 +1,157 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "dem/CDemKernels.h"
+#include "units/IUnit.h"
+
+#include <QtCore>
+
+#define TILE_SIZE   1201    // a SRTM3 tile
+#define TILE_SCALE  90.0    // [m/px]
+#define TILE_NODATA -32768.0f
+
+/*
+   A fixed tile of the size of a SRTM3 tile with a border of one pixel. The
+   terrain is a mix of ridges and valleys with a void in the middle. It's the
+   same for each run.
+ */
+static QVector<float> srtmTile()
+{
+    const int wp2 = TILE_SIZE + 2;
+    QVector<float> data(wp2 * wp2);
+    for(int y = 0; y < wp2; y++)
+    {
+        for(int x = 0; x < wp2; x++)
+        {
+            data[x + y * wp2] = 1500 + 900 * qSin(x * 0.013) * qCos(y * 0.011) + 80 * qSin(x * 0.21 + y * 0.17);
+        }
+    }
+
+    for(int y = 580; y < 620; y++)
+    {
+        for(int x = 560; x < 650; x++)
+        {
+            data[x + y * wp2] = TILE_NODATA;
+        }
+    }
+    return data;
+}
+
+static CDemKernels::row_t tileRow(const QVector<float> &data, int m)
+{
+    const int wp2 = TILE_SIZE + 2;
+    const float *row = data.constData() + m * wp2;
+    return {row - wp2, row, row + wp2, TILE_SIZE};
+}
+
+static void runKernels(const CDemKernels::kernels_t &kernels, const QVector<float> &data, QVector<quint8> &shade, QVector<qreal> &slope, QVector<qreal> &maximum)
+{
+    const CDemKernels::nodata_t nodata = {true, TILE_NODATA};
+    for(int m = 1; m <= TILE_SIZE; m++)
+    {
+        const CDemKernels::row_t row = tileRow(data, m);
+        const int offset = (m - 1) * TILE_SIZE;
+        kernels.hillshade(row, TILE_SCALE, TILE_SCALE, nodata, shade.data() + offset);
+        kernels.slope(row, TILE_SCALE, TILE_SCALE, nodata, slope.data() + offset);
+        kernels.maximum(row, nodata, maximum.data() + offset);
+    }
+}
+
+/*
+   The hillshading as it was done for each pixel before there were kernels.
+ */
+static quint8 hillshadeReference(const float *win)
+{
+    if(win[4] == TILE_NODATA)
+    {
+        return 255;
+    }
+
+    qreal dx = ((win[0] + win[3] + win[3] + win[6]) - (win[2] + win[5] + win[5] + win[8])) / TILE_SCALE;
+    qreal dy = ((win[6] + win[7] + win[7] + win[8]) - (win[0] + win[1] + win[1] + win[2])) / TILE_SCALE;
+    qreal aspect = qAtan2(dy, dx);
+    qreal xx_plus_yy = dx * dx + dy * dy;
+    qreal cang = (qSin(qDegreesToRadians(45.0)) - 0.125 * qCos(qDegreesToRadians(45.0)) * qSqrt(xx_plus_yy) * qSin(aspect - qDegreesToRadians(315.0)))
+                 / qSqrt(1 + 0.125 * 0.125 * xx_plus_yy);
+
+    return cang <= 0.0 ? 1 : quint8(1.0 + 254.0 * cang);
+}
+
+void test_QMapShack::_demKernelsMatchReference()
+{
+    const QVector<float> &data = srtmTile();
+    const int wp2 = TILE_SIZE + 2;
+
+    for(const CDemKernels::kernels_t *kernels : CDemKernels::getAll())
+    {
+        QVector<quint8> shade(TILE_SIZE * TILE_SIZE);
+        QVector<qreal> slope(TILE_SIZE * TILE_SIZE);
+        QVector<qreal> maximum(TILE_SIZE * TILE_SIZE);
+        runKernels(*kernels, data, shade, slope, maximum);
+
+        for(int m = 1; m <= TILE_SIZE; m++)
+        {
+            for(int n = 1; n <= TILE_SIZE; n++)
+            {
+                float win[9];
+                bool hasNoData = false;
+                qreal meters = -2.0;
+                for(int i = 0; i < 9; i++)
+                {
+                    win[i] = data[(n - 1 + i % 3) + (m - 1 + i / 3) * wp2];
+                    hasNoData |= win[i] == TILE_NODATA;
+                    if(win[i] != TILE_NODATA && win[i] > meters)
+                    {
+                        meters = win[i];
+                    }
+                }
+
+                const int idx = (n - 1) + (m - 1) * TILE_SIZE;
+                SUBVERIFY(qAbs(hillshadeReference(win) - shade[idx]) <= 1, QString("%1: hillshade at %2,%3").arg(kernels->name).arg(n).arg(m));
+                SUBVERIFY(hasNoData == (slope[idx] == NOFLOAT), QString("%1: slope at %2,%3").arg(kernels->name).arg(n).arg(m));
+                VERIFY_EQUAL(meters, maximum[idx]);
+            }
+        }
+    }
+}
+
+static void benchKernels(const CDemKernels::kernels_t &kernels)
+{
+    const QVector<float> &data = srtmTile();
+    QVector<quint8> shade(TILE_SIZE * TILE_SIZE);
+    QVector<qreal> slope(TILE_SIZE * TILE_SIZE);
+    QVector<qreal> maximum(TILE_SIZE * TILE_SIZE);
+
+    QBENCHMARK
+    {
+        runKernels(kernels, data, shade, slope, maximum);
+    }
+}
+
+void test_QMapShack::_demKernelsBaseline()
+{
+    benchKernels(*CDemKernels::getAll().first());
+}
+
+void test_QMapShack::_demKernelsBest()
+{
+    benchKernels(CDemKernels::get());
+}
@@ -23,6 +23,7 @@
 
 #include "gis/prj/IGisProject.h"
 #include "gis/fit/CFitProject.h"
+#include "gis/fit/CFitStream.h"
 
 void test_QMapShack::_readValidFitFiles()
 {
@@ -31,3 +32,26 @@ void test_QMapShack::_readValidFitFiles()
     delete readProjFile("2016-03-12_15-16-50_4_20.fit");
 }
 
+
+void test_QMapShack::_decodeFitFiles()
+{
+    const QStringList files =
+    {
+        "2015-05-07-22-03-17.fit"
+        , "Warisouderghem_course.fit"
+        , "2016-03-12_15-16-50_4_20.fit"
+    };
+
+    QBENCHMARK
+    {
+        for(const QString &name : files)
+        {
+            QFile file(fileToPath(name));
+            SUBVERIFY(file.open(QIODevice::ReadOnly), "Failed to open " + name);
+
+            CFitStream stream(file);
+            stream.decodeFile();
+            SUBVERIFY(stream.hasMoreMesg(), "No messages decoded from " + name);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/CGisKeyIndex.h"
+#include "gis/prj/IGisProject.h"
+
+#include <QTreeWidget>
+#include <QtCore>
+
+static void verifyItems(CGisKeyIndex &index, const IGisProject *proj)
+{
+    for(int i = 0; i < proj->childCount(); i++)
+    {
+        IGisItem *item = dynamic_cast<IGisItem*>(proj->child(i));
+        SUBVERIFY(index.getItemByKey(item->getKey()) == item, QString("Item %1 of %2 not found").arg(i).arg(proj->getName()));
+    }
+}
+
+void test_QMapShack::_keyIndex()
+{
+    QTreeWidget tree;
+    CGisKeyIndex index(&tree);
+
+    // insert
+    IGisProject *proj1 = readProjFile("qtt_gpx_file0.gpx");
+    IGisProject *proj2 = readProjFile("gpx_ext_GarminTPX1_gpxtpx.gpx");
+    SUBVERIFY(proj1->childCount() > 2, "Project has too few items");
+    tree.addTopLevelItem(proj1);
+    tree.addTopLevelItem(proj2);
+
+    SUBVERIFY(index.getProjectByKey(proj1->getKey()) == proj1, "Project 1 not found");
+    SUBVERIFY(index.getProjectByKey(proj2->getKey()) == proj2, "Project 2 not found");
+    verifyItems(index, proj1);
+    verifyItems(index, proj2);
+
+    // remove
+    IGisItem *item = dynamic_cast<IGisItem*>(proj1->child(0));
+    const IGisItem::key_t key = item->getKey();
+    delete item;
+    SUBVERIFY(index.getItemByKey(key) == nullptr, "Deleted item still found");
+    verifyItems(index, proj1);
+
+    // move an item within its project
+    item = dynamic_cast<IGisItem*>(proj1->takeChild(proj1->childCount() - 1));
+    SUBVERIFY(index.getItemByKey(item->getKey()) == nullptr, "Taken item still found");
+    proj1->insertChild(0, item);
+    SUBVERIFY(index.getItemByKey(item->getKey()) == item, "Moved item not found");
+    verifyItems(index, proj1);
+
+    // move a project
+    tree.insertTopLevelItem(0, tree.takeTopLevelItem(1));
+    SUBVERIFY(tree.topLevelItem(0) == proj2, "Project 2 not moved");
+    SUBVERIFY(index.getProjectByKey(proj2->getKey()) == proj2, "Moved project not found");
+    verifyItems(index, proj1);
+    verifyItems(index, proj2);
+
+    // the same project twice, the first one in the tree wins
+    IGisProject *proj3 = readProjFile("gpx_ext_GarminTPX1_gpxtpx.gpx");
+    tree.addTopLevelItem(proj3);
+    SUBVERIFY(index.getProjectByKey(proj3->getKey()) == proj2, "Project 2 is not the first one");
+    verifyItems(index, proj2);
+
+    delete proj2;
+    SUBVERIFY(index.getProjectByKey(proj3->getKey()) == proj3, "Project 3 does not replace project 2");
+    verifyItems(index, proj3);
+
+    // remove a project with its items
+    const IGisItem::key_t key1 = dynamic_cast<IGisItem*>(proj1->child(0))->getKey();
+    delete proj1;
+    SUBVERIFY(index.getItemByKey(key1) == nullptr, "Item of deleted project still found");
+    verifyItems(index, proj3);
+
+    delete proj3;
+}
@@ -20,6 +20,10 @@
 #include "test_QMapShack.h"
 
 #include "gis/gpx/CGpxProject.h"
+#include "gis/ovl/CGisItemOvlArea.h"
+#include "gis/rte/CGisItemRte.h"
+#include "gis/trk/CGisItemTrk.h"
+#include "gis/wpt/CGisItemWpt.h"
 
 void test_QMapShack::writeReadGpxFile(const QString &file)
 {
@@ -47,3 +51,97 @@ void test_QMapShack::_writeReadGpxFile()
     writeReadGpxFile("V1.6.0_file2.qms");
 }
 
+
+// build the complete DOM of the project, the way files have been written before
+static QByteArray saveGpxDom(IGisProject &proj)
+{
+    QDomDocument doc;
+    QDomNode gpx = proj.writeMetadata(doc, false);
+
+    for(int i = 0; i < proj.childCount(); i++)
+    {
+        CGisItemWpt *item = dynamic_cast<CGisItemWpt*>(proj.child(i));
+        if(nullptr != item)
+        {
+            item->save(gpx, false);
+        }
+    }
+    for(int i = 0; i < proj.childCount(); i++)
+    {
+        CGisItemRte *item = dynamic_cast<CGisItemRte*>(proj.child(i));
+        if(nullptr != item)
+        {
+            item->save(gpx, false);
+        }
+    }
+    for(int i = 0; i < proj.childCount(); i++)
+    {
+        CGisItemTrk *item = dynamic_cast<CGisItemTrk*>(proj.child(i));
+        if(nullptr != item)
+        {
+            item->save(gpx, false);
+        }
+    }
+
+    QDomElement xmlExt = doc.createElement("extensions");
+    gpx.appendChild(xmlExt);
+    for(int i = 0; i < proj.childCount(); i++)
+    {
+        CGisItemOvlArea *item = dynamic_cast<CGisItemOvlArea*>(proj.child(i));
+        if(nullptr != item)
+        {
+            item->save(xmlExt, false);
+        }
+    }
+
+    auto appendTag = [&](const QString &tag, const QString &value)
+    {
+        QDomElement elem = doc.createElement(tag);
+        xmlExt.appendChild(elem);
+        elem.appendChild(doc.createTextNode(value));
+    };
+    if(!proj.getKey().isEmpty())
+    {
+        appendTag("ql:key", proj.getKey());
+    }
+    appendTag("ql:sortingRoadbook", QString::number(proj.getSortingRoadbook()));
+    appendTag("ql:sortingFolder", QString::number(proj.getSortingFolder()));
+    appendTag("ql:correlation", QString::number(proj.doCorrelation()));
+    appendTag("ql:invalidDataOk", QString::number(proj.getInvalidDataOk()));
+
+    QString str;
+    QTextStream out(&str);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\" ?>" << Qt::endl;
+    out << doc.toString();
+    out.flush();
+    return str.toUtf8();
+}
+
+void test_QMapShack::writeGpxFileStreamed(const QString &file)
+{
+    IGisProject *proj = readProjFile(file);
+
+    QString tmpFile = TestHelper::getTempFileName("gpx");
+    CGpxProject::saveAs(tmpFile, *proj, false);
+    const QByteArray &expected = saveGpxDom(*proj);
+
+    delete proj;
+
+    QFile f(tmpFile);
+    SUBVERIFY(f.open(QIODevice::ReadOnly), "Failed to open " + tmpFile);
+    const QByteArray &written = f.readAll();
+    f.close();
+    f.remove();
+
+    SUBVERIFY(written == expected, "Streamed output of `" + file + "` differs from the DOM output");
+}
+
+void test_QMapShack::_writeGpxFileStreamed()
+{
+    writeGpxFileStreamed("qtt_gpx_file0.gpx");
+    writeGpxFileStreamed("gpx_ext_GarminTPX1_gpxtpx.gpx");
+    writeGpxFileStreamed("gpx_ext_GarminTPX1_tp1.gpx");
+    writeGpxFileStreamed("gpx_ext_GarminTPX1_cns.gpx");
+    writeGpxFileStreamed("V1.6.0_file1.qms");
+    writeGpxFileStreamed("V1.6.0_file2.qms");
+}
@@ -55,3 +55,92 @@ void test_QMapShack::_writeReadQmsFile()
     }
 }
 
+
+void test_QMapShack::_projectSnapshot()
+{
+    for(const QString &file : inputFiles)
+    {
+        IGisProject *proj = readProjFile(file);
+        IGisProject::snapshot_t snapshot = proj->getSnapshot();
+        const QByteArray &fingerprint = snapshot.getFingerprint();
+        delete proj;
+
+        // the snapshot is written like the project, even after the project is gone
+        QString tmpFile = TestHelper::getTempFileName("qms");
+        QFile qms(tmpFile);
+        SUBVERIFY(qms.open(QIODevice::WriteOnly), "Failed to open " + tmpFile);
+        QDataStream out(&qms);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out.setVersion(QDataStream::Qt_5_2);
+        out << snapshot;
+        qms.close();
+
+        proj = readProjFile(tmpFile, true, false);
+        verify(file, *proj);
+        delete proj;
+
+        QFile(tmpFile).remove();
+
+        // any change of the serialized data changes the fingerprint
+        SUBVERIFY(snapshot.getFingerprint() == fingerprint, "Fingerprint of " + file + " is not stable");
+        snapshot.metadata.desc += "*";
+        SUBVERIFY(snapshot.getFingerprint() != fingerprint, "Fingerprint of " + file + " ignores the metadata");
+        if(!snapshot.items.isEmpty())
+        {
+            const QByteArray &before = snapshot.getFingerprint();
+            snapshot.items.last().changed ^= IGisItem::eMarkChanged;
+            SUBVERIFY(snapshot.getFingerprint() != before, "Fingerprint of " + file + " ignores the items");
+
+            // cutting the history drops the data of older events only
+            IGisItem::history_t &history = snapshot.items.last().history;
+            if(history.events.size() > 1 && !history.events.first().data.isEmpty())
+            {
+                const QByteArray &beforeCut = snapshot.getFingerprint();
+                history.clearData(0);
+                SUBVERIFY(snapshot.getFingerprint() != beforeCut, "Fingerprint of " + file + " ignores the history's data");
+            }
+        }
+    }
+}
+
+void test_QMapShack::_restorePendingItems()
+{
+    for(const QString &file : inputFiles)
+    {
+        IGisProject *proj = readProjFile(file);
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out.setVersion(QDataStream::Qt_5_2);
+        *proj >> out;
+        const int N = proj->childCount();
+        delete proj;
+
+        QDataStream in(&data, QIODevice::ReadOnly);
+        in.setByteOrder(QDataStream::LittleEndian);
+        in.setVersion(QDataStream::Qt_5_2);
+        IGisProject::snapshot_t snapshot;
+        SUBVERIFY(IGisProject::readSnapshot(in, snapshot, false), "Failed to read " + file);
+        SUBVERIFY(snapshot.items.isEmpty(), "Items of " + file + " have been decoded");
+
+        proj = new CQmsProject("pending", (CGisListWks*) nullptr);
+        proj->restoreSnapshot(snapshot);
+        SUBVERIFY(proj->childCount() == 0, "Items of " + file + " have been restored");
+        SUBVERIFY(proj->hasPendingItems() == (N > 0), "Items of " + file + " are not pending");
+
+        // a project with pending items is written unchanged
+        QByteArray data2;
+        QDataStream out2(&data2, QIODevice::WriteOnly);
+        out2.setByteOrder(QDataStream::LittleEndian);
+        out2.setVersion(QDataStream::Qt_5_2);
+        *proj >> out2;
+        SUBVERIFY(data2 == data, "Pending items of " + file + " are not written unchanged");
+
+        proj->restorePendingItems();
+        SUBVERIFY(!proj->hasPendingItems(), "Items of " + file + " are still pending");
+        VERIFY_EQUAL(N, proj->childCount());
+        verify(file, *proj);
+
+        delete proj;
+    }
+}
@@ -0,0 +1,127 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "helpers/CRTree.h"
+
+#include <QtCore>
+
+/*
+   10000 items on a 1000 x 1000 area. Every third item is a point, the others
+   have a size of up to 20 x 20. The rectangles are pseudo random but the same
+   for each run.
+ */
+static QVector<QRectF> workspaceItems()
+{
+    QVector<QRectF> rects;
+    quint32 seed = 1;
+    auto next = [&seed](quint32 max) { seed = seed * 1103515245 + 12345; return (seed >> 16) % max; };
+
+    for(int i = 0; i < 10000; i++)
+    {
+        const qreal size = (i % 3) ? next(20) : 0;
+        rects << QRectF(next(1000), next(1000), size, size);
+    }
+    return rects;
+}
+
+static QSet<int> searchLinear(const QVector<QRectF> &rects, const QSet<int> &values, const QRectF &area)
+{
+    QSet<int> found;
+    for(int value : values)
+    {
+        const QRectF &rect = rects[value];
+        if(rect.left() <= area.right() && rect.right() >= area.left() && rect.top() <= area.bottom() && rect.bottom() >= area.top())
+        {
+            found << value;
+        }
+    }
+    return found;
+}
+
+void test_QMapShack::_rtreeMatchesLinear()
+{
+    const QVector<QRectF> &rects = workspaceItems();
+    QSet<int> values;
+
+    CRTree<int> tree;
+    for(int i = 0; i < rects.size(); i++)
+    {
+        tree.insert(rects[i], i);
+        values << i;
+    }
+
+    // remove every second item to exercise the reinsertion of entries
+    for(int i = 0; i < rects.size(); i += 2)
+    {
+        SUBVERIFY(tree.remove(rects[i], i), QString("remove %1").arg(i));
+        values.remove(i);
+    }
+    SUBVERIFY(!tree.remove(rects[0], 0), "remove a value twice");
+    VERIFY_EQUAL(values.size(), tree.size());
+
+    for(int y = 0; y < 1000; y += 50)
+    {
+        for(int x = 0; x < 1000; x += 50)
+        {
+            const QRectF area(x, y, 30, 30);
+            QList<int> found;
+            tree.search(area, found);
+            SUBVERIFY(QSet<int>(found.begin(), found.end()) == searchLinear(rects, values, area), QString("search at %1,%2").arg(x).arg(y));
+        }
+    }
+}
+
+void test_QMapShack::_rtreeSearch()
+{
+    const QVector<QRectF> &rects = workspaceItems();
+    CRTree<int> tree;
+    for(int i = 0; i < rects.size(); i++)
+    {
+        tree.insert(rects[i], i);
+    }
+
+    QBENCHMARK
+    {
+        QList<int> found;
+        for(int x = 0; x < 1000; x += 10)
+        {
+            tree.search(QRectF(x, x, 2, 2), found);
+        }
+    }
+}
+
+void test_QMapShack::_rtreeSearchLinear()
+{
+    const QVector<QRectF> &rects = workspaceItems();
+    QSet<int> values;
+    for(int i = 0; i < rects.size(); i++)
+    {
+        values << i;
+    }
+
+    QBENCHMARK
+    {
+        for(int x = 0; x < 1000; x += 10)
+        {
+            searchLinear(rects, values, QRectF(x, x, 2, 2));
+        }
+    }
+}
@@ -0,0 +1,252 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "map/CTileScheduler.h"
+
+#include <QtCore>
+#include <QtNetwork>
+#include <QSignalSpy>
+
+/*
+   A stand-in for a tile server on localhost. Each request is answered with its
+   path as body after a delay. The server records the order of the requests and
+   the maximum number of parallel requests per host.
+ */
+class CTileServer
+{
+public:
+    CTileServer(int delay) : delay(delay)
+    {
+        server.listen(QHostAddress::LocalHost);
+        QObject::connect(&server, &QTcpServer::newConnection, &server, [this]()
+        {
+            while(server.hasPendingConnections())
+            {
+                QTcpSocket *socket = server.nextPendingConnection();
+                QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { readRequest(socket); });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    bool isListening() const
+    {
+        return server.isListening();
+    }
+
+    quint16 port() const
+    {
+        return server.serverPort();
+    }
+
+    QString url(const QString &host, const QString &path) const
+    {
+        return QString("http://%1:%2%3").arg(host).arg(port()).arg(path);
+    }
+
+    QStringList paths;
+    QHash<QString, int> maxActive;
+
+private:
+    void readRequest(QTcpSocket *socket)
+    {
+        const QByteArray &header = socket->property("header").toByteArray() + socket->readAll();
+        socket->setProperty("header", header);
+        if(!header.contains("\r\n\r\n") || socket->property("host").isValid())
+        {
+            return;
+        }
+
+        const QList<QByteArray> &lines = header.split('\n');
+        const QString path = lines[0].split(' ').value(1);
+        QString host;
+        for(const QByteArray &line : lines)
+        {
+            if(line.toLower().startsWith("host:"))
+            {
+                host = QString::fromLatin1(line.mid(5).trimmed());
+            }
+        }
+        socket->setProperty("host", host);
+
+        paths << path;
+        maxActive[host] = qMax(maxActive[host], ++active[host]);
+
+        // either answered or aborted by the client
+        auto done = [this, socket, host]()
+        {
+            if(!socket->property("done").toBool())
+            {
+                socket->setProperty("done", true);
+                active[host]--;
+            }
+        };
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, done);
+
+        QTimer::singleShot(delay, socket, [socket, path, done]()
+        {
+            done();
+            const QByteArray &body = path.toUtf8();
+            socket->write("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: close\r\n");
+            socket->write("Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+            socket->disconnectFromHost();
+        });
+    }
+
+    QTcpServer server;
+    QHash<QString, int> active;
+    int delay;
+};
+
+static void waitForTiles(QSignalSpy &spy, int count)
+{
+    while(spy.count() < count && spy.wait(5000))
+    {
+    }
+}
+
+static QStringList receivedData(const QSignalSpy &spy)
+{
+    QStringList data;
+    for(const QList<QVariant> &args : spy)
+    {
+        data << QString::fromUtf8(args[1].toByteArray());
+    }
+    return data;
+}
+
+void test_QMapShack::_tileSchedulerPriority()
+{
+    CTileServer server(20);
+    SUBVERIFY(server.isListening(), "Failed to start tile server");
+
+    CTileScheduler scheduler(nullptr);
+    scheduler.setMaxPerHost(1);
+    QSignalSpy spy(&scheduler, &CTileScheduler::sigTileReceived);
+
+    const QString host = "127.0.0.1";
+    scheduler.setRequests({
+        {server.url(host, "/3"), 3.0},
+        {server.url(host, "/1"), 1.0},
+        {server.url(host, "/2"), 2.0},
+        {server.url(host, "/0"), 1.0},
+        {server.url(host, "/1"), 1.0}
+    });
+    VERIFY_EQUAL(4, scheduler.getPending());
+
+    waitForTiles(spy, 4);
+    VERIFY_EQUAL(4, spy.count());
+    VERIFY_EQUAL(0, scheduler.getPending());
+
+    // equal priorities keep the order of the list, duplicates are requested once
+    const QStringList expected = {"/1", "/0", "/2", "/3"};
+    SUBVERIFY(server.paths == expected, server.paths.join(","));
+    SUBVERIFY(receivedData(spy) == expected, receivedData(spy).join(","));
+}
+
+void test_QMapShack::_tileSchedulerCancel()
+{
+    CTileServer server(300);
+    SUBVERIFY(server.isListening(), "Failed to start tile server");
+
+    CTileScheduler scheduler(nullptr);
+    scheduler.setMaxPerHost(1);
+    QSignalSpy spy(&scheduler, &CTileScheduler::sigTileReceived);
+
+    const QString host = "127.0.0.1";
+    scheduler.setRequests({{server.url(host, "/a"), 0}, {server.url(host, "/b"), 1}});
+
+    // wait for the first request to arrive at the server
+    QElapsedTimer timer;
+    timer.start();
+    while(server.paths.isEmpty() && timer.elapsed() < 5000)
+    {
+        QTest::qWait(10);
+    }
+    SUBVERIFY(server.paths == QStringList{"/a"}, server.paths.join(","));
+
+    // the view changed: /a is aborted, /b is dropped
+    scheduler.setRequests({{server.url(host, "/c"), 0}});
+    VERIFY_EQUAL(1, scheduler.getPending());
+
+    waitForTiles(spy, 1);
+    QTest::qWait(500);
+    SUBVERIFY(receivedData(spy) == QStringList{"/c"}, receivedData(spy).join(","));
+    SUBVERIFY(server.paths == QStringList({"/a", "/c"}), server.paths.join(","));
+    VERIFY_EQUAL(0, scheduler.getPending());
+}
+
+void test_QMapShack::_tileSchedulerHostLimit()
+{
+    CTileServer server(100);
+    SUBVERIFY(server.isListening(), "Failed to start tile server");
+
+    CTileScheduler scheduler(nullptr);
+    scheduler.setMaxPerHost(2);
+    QSignalSpy spy(&scheduler, &CTileScheduler::sigTileReceived);
+
+    const QStringList hosts = {"127.0.0.1", "localhost"};
+    QList<CTileScheduler::request_t> requests;
+    for(int i = 0; i < 12; i++)
+    {
+        requests << CTileScheduler::request_t{server.url(hosts[i % 2], QString("/%1").arg(i)), qreal(i)};
+    }
+    scheduler.setRequests(requests);
+
+    waitForTiles(spy, 12);
+    VERIFY_EQUAL(12, spy.count());
+
+    for(const QString &host : hosts)
+    {
+        VERIFY_EQUAL(2, server.maxActive.value(QString("%1:%2").arg(host).arg(server.port())));
+    }
+}
+
+void test_QMapShack::_tileSchedulerSharedHostLimit()
+{
+    CTileServer server(100);
+    SUBVERIFY(server.isListening(), "Failed to start tile server");
+
+    // two maps using the same tile server
+    CTileScheduler scheduler1(nullptr);
+    CTileScheduler scheduler2(nullptr);
+    QSignalSpy spy1(&scheduler1, &CTileScheduler::sigTileReceived);
+    QSignalSpy spy2(&scheduler2, &CTileScheduler::sigTileReceived);
+
+    const QString host = "127.0.0.1";
+    QList<CTileScheduler::request_t> requests1;
+    QList<CTileScheduler::request_t> requests2;
+    for(int i = 0; i < 12; i++)
+    {
+        requests1 << CTileScheduler::request_t{server.url(host, QString("/a%1").arg(i)), qreal(i)};
+        requests2 << CTileScheduler::request_t{server.url(host, QString("/b%1").arg(i)), qreal(i)};
+    }
+    scheduler1.setRequests(requests1);
+    scheduler2.setRequests(requests2);
+
+    waitForTiles(spy1, 12);
+    waitForTiles(spy2, 12);
+    VERIFY_EQUAL(12, spy1.count());
+    VERIFY_EQUAL(12, spy2.count());
+
+    // both schedulers together stay within the limit of the host
+    VERIFY_EQUAL(CTileScheduler::kMaxPerHost, server.maxActive.value(QString("%1:%2").arg(host).arg(server.port())));
+}
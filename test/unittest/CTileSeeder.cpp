@@ -0,0 +1,120 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "map/CTileSeeder.h"
+
+#include <QtCore>
+#include <QtGui>
+
+void test_QMapShack::_tileSeederForEachTile()
+{
+    // a concave polygon and a separate triangle, in tiles
+    QPainterPath area;
+    area.setFillRule(Qt::WindingFill);
+    area.addPolygon(QPolygonF({{2.5, 2.5}, {40.2, 2.5}, {40.2, 10.7}, {12.3, 10.7}, {12.3, 50.1}, {2.5, 50.1}}));
+    area.closeSubpath();
+    area.addPolygon(QPolygonF({{45.5, 30.5}, {60.5, 55.5}, {35.5, 60.5}}));
+    area.closeSubpath();
+
+    const QRect range(0, 0, 64, 64);
+
+    QSet<QPair<qint32, qint32> > expected;
+    for(qint32 row = range.top(); row <= range.bottom(); row++)
+    {
+        for(qint32 col = range.left(); col <= range.right(); col++)
+        {
+            if(area.intersects(QRectF(col, row, 1, 1)))
+            {
+                expected << qMakePair(col, row);
+            }
+        }
+    }
+
+    QSet<QPair<qint32, qint32> > tiles;
+    qint32 calls = 0;
+    const bool ok = CTileSeeder::forEachTile(area, range, [&](qint32 col, qint32 row)
+    {
+        tiles << qMakePair(col, row);
+        calls++;
+        return true;
+    });
+    SUBVERIFY(ok, "forEachTile() stopped");
+    VERIFY_EQUAL(calls, tiles.size());
+    VERIFY_EQUAL(expected.size(), tiles.size());
+    SUBVERIFY(expected == tiles, "Tiles differ from the ones found by testing each tile");
+
+    // the range limits the tiles
+    tiles.clear();
+    CTileSeeder::forEachTile(area, QRect(0, 0, 8, 8), [&](qint32 col, qint32 row)
+    {
+        tiles << qMakePair(col, row);
+        return true;
+    });
+    VERIFY_EQUAL(36, tiles.size());
+
+    // stop after 10 tiles
+    calls = 0;
+    SUBVERIFY(!CTileSeeder::forEachTile(area, range, [&](qint32, qint32) { return ++calls < 10; }), "Not stopped");
+    VERIFY_EQUAL(10, calls);
+}
+
+void test_QMapShack::_tileSeederCorridor()
+{
+    const qreal R = 6378137.0;
+    const qreal lat = qDegreesToRadians(47.0);
+    const qreal lon = qDegreesToRadians(11.0);
+    // [m] to [rad]
+    const qreal dy = 1.0 / R;
+    const qreal dx = 1.0 / (R * qCos(lat));
+
+    // 10 km to the east, then 5 km to the north
+    QPolygonF line;
+    for(qint32 i = 0; i <= 100; i++)
+    {
+        line << QPointF(lon + i * 100 * dx, lat);
+    }
+    for(qint32 i = 1; i <= 50; i++)
+    {
+        line << QPointF(lon + 10000 * dx, lat + i * 100 * dy);
+    }
+
+    const QList<QPolygonF> &corridor = CTileSeeder::getCorridor(line, 500);
+    SUBVERIFY(!corridor.isEmpty(), "No corridor");
+
+    QPainterPath path;
+    path.setFillRule(Qt::WindingFill);
+    for(const QPolygonF &polygon : corridor)
+    {
+        path.addPolygon(polygon);
+        path.closeSubpath();
+    }
+
+    for(const QPointF &pt : line)
+    {
+        SUBVERIFY(path.contains(pt), "Line is not within the corridor");
+    }
+
+    SUBVERIFY(path.contains(QPointF(lon + 5000 * dx, lat + 400 * dy)), "Point 400 m off the line is outside");
+    SUBVERIFY(path.contains(QPointF(lon + 10400 * dx, lat + 2500 * dy)), "Point 400 m off the line is outside");
+    SUBVERIFY(!path.contains(QPointF(lon + 5000 * dx, lat + 600 * dy)), "Point 600 m off the line is inside");
+    SUBVERIFY(!path.contains(QPointF(lon + 5000 * dx, lat + 2500 * dy)), "Point inside the bend is inside");
+    SUBVERIFY(!path.contains(QPointF(lon - 600 * dx, lat)), "Point 600 m before the start is inside");
+}
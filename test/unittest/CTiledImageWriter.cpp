@@ -0,0 +1,107 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "canvas/CCanvas.h"
+#include "print/CTiledImageWriter.h"
+
+#include <QtCore>
+#include <QtGui>
+
+void test_QMapShack::_printTiles()
+{
+    SUBVERIFY(CCanvas::getPrintTiles(QSize(0, 100)).isEmpty(), "Tiles for an empty area");
+
+    // an area smaller than a tile is a single tile of the area's size
+    QList<QRect> tiles = CCanvas::getPrintTiles(QSize(301, 77));
+    VERIFY_EQUAL(1, tiles.size());
+    SUBVERIFY(QRect(0, 0, 301, 77) == tiles.first(), "Wrong tile for a small area");
+
+    // all tiles have the same size, the last row and column exceed the area
+    const QSize area(5000, 3000);
+    tiles = CCanvas::getPrintTiles(area, 2048);
+    VERIFY_EQUAL(6, tiles.size());
+    SUBVERIFY(QRect(0, 0, 2048, 2048) == tiles[0], "Wrong first tile");
+    SUBVERIFY(QRect(4096, 0, 2048, 2048) == tiles[2], "Wrong last tile of first row");
+    SUBVERIFY(QRect(0, 2048, 2048, 2048) == tiles[3], "Wrong first tile of second row");
+
+    QRegion covered;
+    for(const QRect& tile : qAsConst(tiles))
+    {
+        SUBVERIFY(!covered.intersects(tile), "Tiles overlap");
+        covered += tile;
+    }
+    SUBVERIFY(covered.contains(QRect(QPoint(0, 0), area)), "Tiles do not cover the area");
+}
+
+void test_QMapShack::_tiledImageWriter()
+{
+    const QSize size(300, 200);
+    QImage expected(size, QImage::Format_ARGB32);
+    for(qint32 y = 0; y < size.height(); y++)
+    {
+        for(qint32 x = 0; x < size.width(); x++)
+        {
+            expected.setPixel(x, y, qRgba(x % 256, y, (x + y) % 256, x < 20 ? 0 : 255));
+        }
+    }
+
+    QTemporaryDir dir;
+    SUBVERIFY(dir.isValid(), "Failed to create temporary directory");
+
+    SUBVERIFY(!CTiledImageWriter(dir.filePath("map.bmp"), size).isValid(), "Unsupported format accepted");
+
+    for(const QString& name : QStringList({"map.png", "map.jpg"}))
+    {
+        const QString& filename = dir.filePath(name);
+        CTiledImageWriter writer(filename, size);
+        SUBVERIFY(writer.isValid(), writer.getError());
+
+        // the tiles of the last row and column exceed the image
+        for(const QRect& tile : CCanvas::getPrintTiles(size, 128))
+        {
+            const QImage& image = expected.copy(tile);
+            SUBVERIFY(writer.writeTile(image, tile.topLeft()), writer.getError());
+        }
+        SUBVERIFY(writer.finish(), writer.getError());
+        SUBVERIFY(!QFile::exists(filename + ".aux.xml"), "Side car file written");
+
+        QImage image(filename);
+        SUBVERIFY(size == image.size(), "Wrong image size");
+        if(name == "map.png")
+        {
+            SUBVERIFY(image.convertToFormat(QImage::Format_ARGB32) == expected, "PNG differs from the tiles");
+        }
+        else
+        {
+            // lossy, but transparent parts are white
+            const QRgb pixel = image.pixel(5, 100);
+            SUBVERIFY(qRed(pixel) > 240 && qGreen(pixel) > 240 && qBlue(pixel) > 240, "Transparency not on white");
+        }
+    }
+
+    // not finished, no file
+    {
+        CTiledImageWriter writer(dir.filePath("map.tif"), size);
+        SUBVERIFY(writer.isValid(), writer.getError());
+        SUBVERIFY(writer.writeTile(expected, QPoint(0, 0)), writer.getError());
+    }
+    SUBVERIFY(!QFile::exists(dir.filePath("map.tif")), "Incomplete file not removed");
+}
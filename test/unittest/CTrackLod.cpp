@@ -0,0 +1,115 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/GeoMath.h"
+#include "gis/trk/CTrackLod.h"
+
+#include <QtCore>
+
+/*
+   A random walk of 20000 steps of up to 10 m. The track turns back
+   on itself every now and then. The positions are pseudo random but
+   the same for each run.
+ */
+static QPolygonF randomWalk()
+{
+    QPolygonF line;
+    quint32 seed = 1;
+    auto next = [&seed](quint32 max) { seed = seed * 1103515245 + 12345; return qreal((seed >> 16) % max); };
+
+    QPointF pt(0, 0);
+    for(int i = 0; i < 20000; i++)
+    {
+        line << pt;
+        pt += QPointF(next(21) - 10, next(21) - 10);
+    }
+    return line;
+}
+
+static void verifySimplified(const QPolygonF &line, qreal tolerance)
+{
+    const QVector<qint32> &idx = CTrackLod::simplify(line, tolerance);
+
+    SUBVERIFY(!idx.isEmpty(), QString("Tolerance %1: no points kept").arg(tolerance));
+    VERIFY_EQUAL(0, idx.first());
+    VERIFY_EQUAL(line.size() - 1, idx.last());
+
+    QPolygonF simple;
+    for(int i = 0; i < idx.size(); i++)
+    {
+        SUBVERIFY(i == 0 || idx[i] > idx[i - 1], QString("Tolerance %1: index %2 out of order").arg(tolerance).arg(i));
+        simple << line[idx[i]];
+    }
+
+    // GPS_Math_DistPointPolyline() returns the squared distance
+    for(int i = 0; i < line.size(); i++)
+    {
+        const qreal dist = qSqrt(GPS_Math_DistPointPolyline(simple, line[i]));
+        SUBVERIFY(dist <= tolerance + 1e-9, QString("Tolerance %1: point %2 is %3 off").arg(tolerance).arg(i).arg(dist));
+    }
+}
+
+void test_QMapShack::_trackLodSimplify()
+{
+    // a line turning back on itself must keep the turning point
+    QPolygonF turn;
+    turn << QPointF(0, 0) << QPointF(100, 0) << QPointF(-50, 0);
+    VERIFY_EQUAL(3, CTrackLod::simplify(turn, 1).size());
+    verifySimplified(turn, 1);
+
+    const QPolygonF &line = randomWalk();
+    for(qreal tolerance : {1.0, 4.0, 16.0, 64.0, 256.0})
+    {
+        verifySimplified(line, tolerance);
+    }
+
+    SUBVERIFY(CTrackLod::simplify(line, 64).size() < line.size() / 10, "The line is hardly simplified");
+}
+
+void test_QMapShack::_trackLodHitLine()
+{
+    // 600 points make three chunks of 256, 256 and 88 points
+    const QPolygonF &line = randomWalk().mid(0, 600);
+
+    CTrackLod::hit_t hit;
+    hit.size = line.size();
+    hit.m2px.translate(10, 20);
+    hit.chunks << QPolygonF(line.mid(0, 257));             // visible
+    hit.chunks << (QPolygonF() << line[256] << line[512]); // outside the viewport
+    hit.chunks << QPolygonF(line.mid(512));                // visible
+    SUBVERIFY(hit.isValid(), "Hit line data is not valid");
+
+    const QPolygonF &lineHit = hit.getLine();
+    VERIFY_EQUAL(line.size(), lineHit.size());
+    for(int i = 0; i < line.size(); i++)
+    {
+        const QPointF &expected = ((i >= 256) && (i < 512) ? line[256] : line[i]) + QPointF(10, 20);
+        SUBVERIFY(lineHit[i] == expected, QString("Point %1 is wrong").arg(i));
+    }
+
+    // a single point
+    hit.size = 1;
+    hit.chunks = {QPolygonF() << line[0]};
+    VERIFY_EQUAL(1, hit.getLine().size());
+
+    SUBVERIFY(!CTrackLod::hit_t().isValid(), "Empty hit line data is valid");
+    VERIFY_EQUAL(0, CTrackLod::hit_t().getLine().size());
+}
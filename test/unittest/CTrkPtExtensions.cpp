@@ -0,0 +1,72 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/trk/CTrkPtExtensions.h"
+
+#include <QtCore>
+
+void test_QMapShack::_trkPtExtensions()
+{
+    CTrkPtExtensions exts;
+    SUBVERIFY(exts.isEmpty(), "New extensions are not empty");
+
+    exts["gpxtpx:TrackPointExtension|gpxtpx:hr"] = 120;
+    exts["speed"] = 3.5;
+    exts.insert("gpxtpx:TrackPointExtension|gpxtpx:hr", 121);
+    VERIFY_EQUAL(2, exts.size());
+    VERIFY_EQUAL(121, exts.value("gpxtpx:TrackPointExtension|gpxtpx:hr").toInt());
+    VERIFY_EQUAL(42, exts.value("gpxtpx:TrackPointExtension|gpxtpx:cad", 42).toInt());
+    SUBVERIFY(!exts.contains("gpxtpx:TrackPointExtension|gpxtpx:cad"), "Reading a value added the key");
+
+    // the stream format has to match the one of QHash, as used by older versions
+    QHash<QString, QVariant> hash;
+    hash["speed"] = 3.5;
+    hash["gpxtpx:TrackPointExtension|gpxtpx:hr"] = 121;
+
+    QByteArray buffer;
+    {
+        QDataStream out(&buffer, QIODevice::WriteOnly);
+        out << hash;
+    }
+    CTrkPtExtensions read;
+    {
+        QDataStream in(buffer);
+        in >> read;
+    }
+    SUBVERIFY(read == exts, "Extensions read from a QHash differ");
+
+    buffer.clear();
+    {
+        QDataStream out(&buffer, QIODevice::WriteOnly);
+        out << exts;
+    }
+    QHash<QString, QVariant> readHash;
+    {
+        QDataStream in(buffer);
+        in >> readHash;
+    }
+    SUBVERIFY(readHash == hash, "Extensions written as QHash differ");
+
+    VERIFY_EQUAL(1, exts.remove("speed"));
+    VERIFY_EQUAL(0, exts.remove("speed"));
+    SUBVERIFY(exts.keys() == QStringList("gpxtpx:TrackPointExtension|gpxtpx:hr"), "Removing a key failed");
+    SUBVERIFY(read != exts, "Extensions with different keys are equal");
+}
@@ -0,0 +1,137 @@
+/**********************************************************************************************
+    Copyright (C) 2023 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/IGisItem.h"
+
+#include <QtCore>
+
+/*
+   The serialized item of version n: 100 KB of data with a small local change
+   for each version.
+ */
+static QByteArray itemVersion(int n)
+{
+    QByteArray data(100000, 'x');
+    for(int i = 0; i <= n; i++)
+    {
+        data[(i * 7919) % data.size()] = char('a' + i % 26);
+    }
+    if(n % 5 == 4)
+    {
+        data.remove(50000, 100);
+    }
+    return data;
+}
+
+void test_QMapShack::_historyDeltas()
+{
+    IGisItem::history_t history;
+    for(int i = 0; i < 50; i++)
+    {
+        history.events << IGisItem::history_event_t();
+        history.setData(i, itemVersion(i));
+    }
+
+    int size = 0;
+    for(int i = 0; i < 50; i++)
+    {
+        SUBVERIFY(history.getData(i) == itemVersion(i), QString("data of event %1").arg(i));
+        size += history.events[i].data.size();
+    }
+    SUBVERIFY(size < 5 * itemVersion(0).size(), QString("the history takes %1 bytes").arg(size));
+
+    // change a full event with deltas based on it
+    SUBVERIFY(!history.events[0].isDelta, "the first event is a full one");
+    history.setData(0, QByteArray(2000, 'y'));
+    SUBVERIFY(history.getData(0) == QByteArray(2000, 'y'), "changed data of event 0");
+
+    // drop the data of events as cutHistoryBefore() does
+    for(int i = 0; i < 25; i++)
+    {
+        history.clearData(i);
+    }
+
+    for(int i = 0; i < 50; i++)
+    {
+        SUBVERIFY(history.getData(i) == (i < 25 ? QByteArray() : itemVersion(i)), QString("data of event %1 after cut").arg(i));
+    }
+
+    // a history as it was written before deltas
+    IGisItem::history_t history2;
+    history2.histIdxInitial = 0;
+    history2.histIdxCurrent = 9;
+    for(int i = 0; i < 10; i++)
+    {
+        history2.events << IGisItem::history_event_t();
+        history2.events[i].data = itemVersion(i);
+    }
+    history2.compress();
+
+    for(int i = 0; i < 10; i++)
+    {
+        SUBVERIFY(history2.getData(i) == itemVersion(i), QString("data of event %1 after compress").arg(i));
+    }
+}
+
+void test_QMapShack::_historyRoundTrip()
+{
+    IGisItem::history_t history;
+    history.histIdxInitial = 0;
+    for(int i = 0; i < 3; i++)
+    {
+        history.events << IGisItem::history_event_t();
+        history.setData(i, itemVersion(i));
+    }
+    history.histIdxCurrent = 2;
+
+    // changing a base and changing it back leaves a full event in the middle
+    history.setData(0, QByteArray(2000, 'y'));
+    history.setData(0, itemVersion(0));
+    SUBVERIFY(!history.events[1].isDelta, "event 1 is a full event");
+    SUBVERIFY(history.events[2].isDelta, "event 2 is a delta to event 1");
+
+    QByteArray buffer;
+    QDataStream out(&buffer, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.setVersion(QDataStream::Qt_5_2);
+    out << history;
+
+    IGisItem::history_t history2;
+    QDataStream in(buffer);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setVersion(QDataStream::Qt_5_2);
+    in >> history2;
+
+    VERIFY_EQUAL(3, history2.events.size());
+    for(int i = 0; i < 3; i++)
+    {
+        SUBVERIFY(history2.getData(i) == itemVersion(i), QString("data of event %1 after loading").arg(i));
+        SUBVERIFY(history2.events[i].isDelta == history.events[i].isDelta, QString("encoding of event %1 after loading").arg(i));
+    }
+
+    // compressing such a history has to keep the deltas based on the middle event
+    history.compress();
+    SUBVERIFY(history.events[1].isDelta, "event 1 is a delta after compress");
+    for(int i = 0; i < 3; i++)
+    {
+        SUBVERIFY(history.getData(i) == itemVersion(i), QString("data of event %1 after compress").arg(i));
+    }
+}
@@ -53,6 +53,8 @@ class test_QMapShack : public QObject
     // CGpxProject
     void writeReadGpxFile(const QString &file);
     void _writeReadGpxFile();
+    void writeGpxFileStreamed(const QString &file);
+    void _writeGpxFileStreamed();
 
     // CKnownExtension
     void _readExtGarminTPX1_tp1();
@@ -63,23 +65,94 @@ class test_QMapShack : public QObject
     // CQmsProject
     void _readQmsFile_1_6_0();
     void _writeReadQmsFile();
+    void _projectSnapshot();
+    void _restorePendingItems();
 
     // CFitProject
     void _readValidFitFiles();
+    void _decodeFitFiles();
 
     // CGisItemTrk
     void _filterDeleteExtension();
 
+    // CCollisionGrid
+    void _placeLabelsCollisionGrid();
+    void _placeLabelsLinear();
+
+    // CDemKernels
+    void _demKernelsMatchReference();
+    void _demKernelsBaseline();
+    void _demKernelsBest();
+
+    // IGisItem
+    void _historyDeltas();
+    void _historyRoundTrip();
+
+    // CGisKeyIndex
+    void _keyIndex();
+
+    // CRTree
+    void _rtreeMatchesLinear();
+    void _rtreeSearch();
+    void _rtreeSearchLinear();
+
+    // CTrkPtExtensions
+    void _trkPtExtensions();
+
+    // CTrackLod
+    void _trackLodSimplify();
+    void _trackLodHitLine();
+
+    // CTileScheduler
+    void _tileSchedulerPriority();
+    void _tileSchedulerCancel();
+    void _tileSchedulerHostLimit();
+    void _tileSchedulerSharedHostLimit();
+
+    // CTileSeeder
+    void _tileSeederForEachTile();
+    void _tileSeederCorridor();
+
+    // CTiledImageWriter
+    void _printTiles();
+    void _tiledImageWriter();
+
 private slots:
     void initTestCase();
 
     void testreadValidSLFFile()         { TCWRAPPER( _readValidSLFFile()         ) }
     void testreadNonExistingSLFFile()   { TCWRAPPER( _readNonExistingSLFFile()   ) }
     void testwriteReadGpxFile()         { TCWRAPPER( _writeReadGpxFile()         ) }
+    void testwriteGpxFileStreamed()     { TCWRAPPER( _writeGpxFileStreamed()     ) }
     void testreadQmsFile_1_6_0()        { TCWRAPPER( _readQmsFile_1_6_0()        ) }
     void testwriteReadQmsFile()         { TCWRAPPER( _writeReadQmsFile()         ) }
+    void testprojectSnapshot()          { TCWRAPPER( _projectSnapshot()          ) }
+    void testrestorePendingItems()      { TCWRAPPER( _restorePendingItems()      ) }
     void testreadExtGarminTPX1_gpxtpx() { TCWRAPPER( _readExtGarminTPX1_gpxtpx() ) }
     void testreadExtGarminTPX1_tp1()    { TCWRAPPER( _readExtGarminTPX1_tp1()    ) }
     void testreadValidFitFiles()        { TCWRAPPER( _readValidFitFiles()        ) }
+    void benchdecodeFitFiles()          { TCWRAPPER( _decodeFitFiles()           ) }
     void testfilterDeleteExtension()    { TCWRAPPER( _filterDeleteExtension()    ) }
+    void benchplaceLabelsCollisionGrid() { TCWRAPPER( _placeLabelsCollisionGrid() ) }
+    void benchplaceLabelsLinear()       { TCWRAPPER( _placeLabelsLinear()         ) }
+    void testdemKernelsMatchReference() { TCWRAPPER( _demKernelsMatchReference() ) }
+    void benchdemKernelsBaseline()      { TCWRAPPER( _demKernelsBaseline()       ) }
+    void benchdemKernelsBest()          { TCWRAPPER( _demKernelsBest()           ) }
+    void testhistoryDeltas()            { TCWRAPPER( _historyDeltas()            ) }
+    void testhistoryRoundTrip()         { TCWRAPPER( _historyRoundTrip()         ) }
+    void testkeyIndex()                 { TCWRAPPER( _keyIndex()                 ) }
+    void testrtreeMatchesLinear()       { TCWRAPPER( _rtreeMatchesLinear()       ) }
+    void benchrtreeSearch()             { TCWRAPPER( _rtreeSearch()              ) }
+    void benchrtreeSearchLinear()       { TCWRAPPER( _rtreeSearchLinear()        ) }
+    void testtrkPtExtensions()          { TCWRAPPER( _trkPtExtensions()          ) }
+    void testtrackLodSimplify()         { TCWRAPPER( _trackLodSimplify()         ) }
+    void testtrackLodHitLine()          { TCWRAPPER( _trackLodHitLine()          ) }
+    void testtileSchedulerPriority()    { TCWRAPPER( _tileSchedulerPriority()    ) }
+    void testtileSchedulerCancel()      { TCWRAPPER( _tileSchedulerCancel()      ) }
+    void testtileSchedulerHostLimit()   { TCWRAPPER( _tileSchedulerHostLimit()   ) }
+    void testtileSchedulerSharedHostLimit() { TCWRAPPER( _tileSchedulerSharedHostLimit() ) }
+    void testtileSeederForEachTile()    { TCWRAPPER( _tileSeederForEachTile()    ) }
+    void testtileSeederCorridor()       { TCWRAPPER( _tileSeederCorridor()       ) }
+    void testprintTiles()               { TCWRAPPER( _printTiles()               ) }
+    void testtiledImageWriter()         { TCWRAPPER( _tiledImageWriter()         ) }
 };